@@ -442,8 +442,7 @@ bool CPDF_CIDFont::Load() {
     auto pAcc =
         pdfium::MakeRetain<CPDF_StreamAcc>(pdfium::WrapRetain(pEncodingStream));
     pAcc->LoadAllDataFiltered();
-    pdfium::span<const uint8_t> span = pAcc->GetSpan();
-    m_pCMap = pdfium::MakeRetain<CPDF_CMap>(span);
+    m_pCMap = pFontGlobals->GetEmbeddedCMap(pAcc.Get());
   } else {
     DCHECK(pEncoding->IsName());
     ByteString cmap = pEncoding->GetString();
@@ -516,8 +515,16 @@ bool CPDF_CIDFont::Load() {
 }
 
 FX_RECT CPDF_CIDFont::GetCharBBox(uint32_t charcode) {
-  if (charcode < 256 && m_CharBBox[charcode].right != -1)
-    return m_CharBBox[charcode];
+  if (charcode < 256) {
+    if (m_CharBBox[charcode].right != -1)
+      return m_CharBBox[charcode];
+  } else {
+    // Multi-byte encodings mostly use codes above 255. Cache those too, so
+    // repeated text layout does not load the same glyph from FreeType again.
+    auto it = m_ExtCharBBoxMap.find(charcode);
+    if (it != m_ExtCharBBoxMap.end())
+      return it->second;
+  }
 
   FX_RECT rect;
   bool bVert = false;
@@ -586,6 +593,8 @@ FX_RECT CPDF_CIDFont::GetCharBBox(uint32_t charcode) {
   }
   if (charcode < 256)
     m_CharBBox[charcode] = rect;
+  else
+    m_ExtCharBBoxMap[charcode] = rect;
 
   return rect;
 }
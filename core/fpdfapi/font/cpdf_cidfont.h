@@ -9,6 +9,7 @@
 
 #include <stdint.h>
 
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -91,6 +92,7 @@ class CPDF_CIDFont final : public CPDF_Font {
   std::vector<int> m_WidthList;
   std::vector<int> m_VertMetrics;
   FX_RECT m_CharBBox[256];
+  std::map<uint32_t, FX_RECT> m_ExtCharBBoxMap;
 };
 
 #endif  // CORE_FPDFAPI_FONT_CPDF_CIDFONT_H_
@@ -13,6 +13,7 @@
 
 #include "core/fpdfapi/font/cpdf_cidfont.h"
 #include "core/fxcrt/fixed_zeroed_data_vector.h"
+#include "core/fxcrt/observed_ptr.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "third_party/base/span.h"
@@ -32,7 +33,7 @@ enum class CIDCoding : uint8_t {
   kUTF16,
 };
 
-class CPDF_CMap final : public Retainable {
+class CPDF_CMap final : public Retainable, public Observable {
  public:
   static constexpr size_t kDirectMapTableSize = 65536;
 
@@ -210,8 +210,10 @@ void CPDF_Font::LoadFontDescriptor(const CPDF_Dictionary* pFontDesc) {
   if (!m_pFontFile)
     return;
 
-  if (!m_Font.LoadEmbedded(m_pFontFile->GetSpan(), IsVertWriting(), key))
+  if (!m_Font.LoadEmbedded(m_pFontFile->GetSpan(), m_pFontFile->ComputeDigest(),
+                           IsVertWriting(), key)) {
     m_pDocument->MaybePurgeFontFileStreamAcc(std::move(m_pFontFile));
+  }
 }
 
 void CPDF_Font::CheckFontMetrics() {
@@ -16,6 +16,7 @@
 #include "core/fpdfapi/font/cpdf_cid2unicodemap.h"
 #include "core/fpdfapi/font/cpdf_cmap.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdfapi/parser/cpdf_stream_acc.h"
 #include "third_party/base/check.h"
 #include "third_party/base/containers/contains.h"
 
@@ -23,10 +24,10 @@ namespace {
 
 CPDF_FontGlobals* g_FontGlobals = nullptr;
 
-RetainPtr<const CPDF_CMap> LoadPredefinedCMap(ByteStringView name) {
+ByteStringView NormalizePredefinedCMapName(ByteStringView name) {
   if (!name.IsEmpty() && name[0] == '/')
     name = name.Last(name.GetLength() - 1);
-  return pdfium::MakeRetain<CPDF_CMap>(name);
+  return name;
 }
 
 }  // namespace
@@ -119,17 +120,51 @@ void CPDF_FontGlobals::LoadEmbeddedKorea1CMaps() {
 
 RetainPtr<const CPDF_CMap> CPDF_FontGlobals::GetPredefinedCMap(
     const ByteString& name) {
-  auto it = m_CMaps.find(name);
+  // Key on the normalized name so "/UniGB-UCS2-H" and "UniGB-UCS2-H" share
+  // the same entry.
+  ByteString key(NormalizePredefinedCMapName(name.AsStringView()));
+  auto it = m_CMaps.find(key);
   if (it != m_CMaps.end())
     return it->second;
 
-  RetainPtr<const CPDF_CMap> pCMap = LoadPredefinedCMap(name.AsStringView());
-  if (!name.IsEmpty())
-    m_CMaps[name] = pCMap;
+  RetainPtr<const CPDF_CMap> pCMap =
+      pdfium::MakeRetain<CPDF_CMap>(key.AsStringView());
+  if (!key.IsEmpty())
+    m_CMaps[key] = pCMap;
 
   return pCMap;
 }
 
+RetainPtr<const CPDF_CMap> CPDF_FontGlobals::GetEmbeddedCMap(
+    const CPDF_StreamAcc* pAcc) {
+  ByteString digest = pAcc->ComputeDigest();
+  auto it = m_EmbeddedCMaps.find(digest);
+  if (it != m_EmbeddedCMaps.end() && it->second)
+    return pdfium::WrapRetain(it->second.Get());
+
+  // Drop entries whose CMap has already been destroyed before adding a new
+  // one, so the map only grows with the number of live CMaps.
+  for (auto dead = m_EmbeddedCMaps.begin(); dead != m_EmbeddedCMaps.end();) {
+    if (!dead->second)
+      dead = m_EmbeddedCMaps.erase(dead);
+    else
+      ++dead;
+  }
+
+  auto pCMap = pdfium::MakeRetain<CPDF_CMap>(pAcc->GetSpan());
+  m_EmbeddedCMaps[digest].Reset(pCMap.Get());
+  return pCMap;
+}
+
+size_t CPDF_FontGlobals::GetLiveEmbeddedCMapCountForTesting() const {
+  size_t count = 0;
+  for (const auto& entry : m_EmbeddedCMaps) {
+    if (entry.second)
+      ++count;
+  }
+  return count;
+}
+
 CPDF_CID2UnicodeMap* CPDF_FontGlobals::GetCID2UnicodeMap(CIDSet charset) {
   if (!m_CID2UnicodeMaps[charset]) {
     m_CID2UnicodeMaps[charset] = std::make_unique<CPDF_CID2UnicodeMap>(charset);
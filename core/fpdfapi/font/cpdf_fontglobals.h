@@ -13,12 +13,14 @@
 
 #include "core/fpdfapi/cmaps/fpdf_cmaps.h"
 #include "core/fpdfapi/font/cpdf_cidfont.h"
+#include "core/fxcrt/observed_ptr.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxge/cfx_fontmapper.h"
 #include "third_party/base/span.h"
 
 class CFX_StockFontArray;
 class CPDF_Font;
+class CPDF_StreamAcc;
 
 class CPDF_FontGlobals {
  public:
@@ -51,6 +53,12 @@ class CPDF_FontGlobals {
   }
 
   RetainPtr<const CPDF_CMap> GetPredefinedCMap(const ByteString& name);
+
+  // Returns a CMap parsed from the fully loaded |pAcc|. CMaps are shared
+  // across documents by content digest, so identical embedded CMap streams
+  // are only parsed once while any font still references them.
+  RetainPtr<const CPDF_CMap> GetEmbeddedCMap(const CPDF_StreamAcc* pAcc);
+  size_t GetLiveEmbeddedCMapCountForTesting() const;
   CPDF_CID2UnicodeMap* GetCID2UnicodeMap(CIDSet charset);
 
  private:
@@ -63,6 +71,9 @@ class CPDF_FontGlobals {
   void LoadEmbeddedKorea1CMaps();
 
   std::map<ByteString, RetainPtr<const CPDF_CMap>> m_CMaps;
+  // Not owned, so that an embedded CMap goes away with the last font using
+  // it, no matter which document or in what order that font is destroyed.
+  std::map<ByteString, ObservedPtr<CPDF_CMap>> m_EmbeddedCMaps;
   std::unique_ptr<CPDF_CID2UnicodeMap> m_CID2UnicodeMaps[CIDSET_NUM_SETS];
   pdfium::span<const fxcmap::CMap> m_EmbeddedCharsets[CIDSET_NUM_SETS];
   pdfium::span<const uint16_t> m_EmbeddedToUnicodes[CIDSET_NUM_SETS];
@@ -0,0 +1,83 @@
+// Copyright 2023 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/font/cpdf_fontglobals.h"
+
+#include "core/fpdfapi/font/cpdf_cmap.h"
+#include "core/fpdfapi/page/test_with_page_module.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_stream_acc.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+RetainPtr<CPDF_StreamAcc> MakeLoadedStreamAcc(ByteStringView data) {
+  auto stream = pdfium::MakeRetain<CPDF_Stream>();
+  stream->SetData(data.raw_span());
+  auto stream_acc = pdfium::MakeRetain<CPDF_StreamAcc>(std::move(stream));
+  stream_acc->LoadAllDataFiltered();
+  return stream_acc;
+}
+
+}  // namespace
+
+using CPDF_FontGlobalsTest = TestWithPageModule;
+
+TEST_F(CPDF_FontGlobalsTest, PredefinedCMapIsShared) {
+  auto* globals = CPDF_FontGlobals::GetInstance();
+  RetainPtr<const CPDF_CMap> cmap1 = globals->GetPredefinedCMap("GBK-EUC-H");
+  ASSERT_TRUE(cmap1);
+  EXPECT_TRUE(cmap1->IsLoaded());
+  EXPECT_EQ(cmap1, globals->GetPredefinedCMap("GBK-EUC-H"));
+  EXPECT_EQ(cmap1, globals->GetPredefinedCMap("/GBK-EUC-H"));
+  EXPECT_NE(cmap1, globals->GetPredefinedCMap("GBK-EUC-V"));
+}
+
+TEST_F(CPDF_FontGlobalsTest, EmbeddedCMapSharedByContent) {
+  static constexpr char kCMap1[] =
+      "1 begincodespacerange <00> <ff> endcodespacerange "
+      "1 begincidrange <20> <7e> 1 endcidrange";
+  static constexpr char kCMap2[] =
+      "1 begincodespacerange <00> <ff> endcodespacerange "
+      "1 begincidrange <20> <7e> 2 endcidrange";
+
+  auto* globals = CPDF_FontGlobals::GetInstance();
+  RetainPtr<const CPDF_CMap> cmap1 =
+      globals->GetEmbeddedCMap(MakeLoadedStreamAcc(kCMap1).Get());
+  ASSERT_TRUE(cmap1);
+  EXPECT_EQ(1u, cmap1->CIDFromCharCode(0x20));
+
+  // A different stream object with identical contents shares the CMap.
+  RetainPtr<const CPDF_CMap> cmap2 =
+      globals->GetEmbeddedCMap(MakeLoadedStreamAcc(kCMap1).Get());
+  EXPECT_EQ(cmap1, cmap2);
+
+  RetainPtr<const CPDF_CMap> cmap3 =
+      globals->GetEmbeddedCMap(MakeLoadedStreamAcc(kCMap2).Get());
+  ASSERT_TRUE(cmap3);
+  EXPECT_NE(cmap1, cmap3);
+  EXPECT_EQ(2u, cmap3->CIDFromCharCode(0x20));
+}
+
+TEST_F(CPDF_FontGlobalsTest, EmbeddedCMapReleasedWithLastReference) {
+  static constexpr char kCMap[] =
+      "1 begincodespacerange <00> <ff> endcodespacerange "
+      "1 begincidrange <20> <7e> 3 endcidrange";
+
+  auto* globals = CPDF_FontGlobals::GetInstance();
+  const size_t initial_count = globals->GetLiveEmbeddedCMapCountForTesting();
+  RetainPtr<const CPDF_CMap> cmap =
+      globals->GetEmbeddedCMap(MakeLoadedStreamAcc(kCMap).Get());
+  ASSERT_TRUE(cmap);
+  EXPECT_EQ(initial_count + 1, globals->GetLiveEmbeddedCMapCountForTesting());
+
+  cmap.Reset();
+  EXPECT_EQ(initial_count, globals->GetLiveEmbeddedCMapCountForTesting());
+
+  // The stale entry does not get in the way of parsing the CMap again.
+  cmap = globals->GetEmbeddedCMap(MakeLoadedStreamAcc(kCMap).Get());
+  ASSERT_TRUE(cmap);
+  EXPECT_EQ(3u, cmap->CIDFromCharCode(0x20));
+}
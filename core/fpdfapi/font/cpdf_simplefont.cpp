@@ -104,6 +104,44 @@ void CPDF_SimpleFont::LoadCharMetrics(int charcode) {
   }
 }
 
+void CPDF_SimpleFont::LoadCharWidthsFromFace() {
+  // Fills in every missing width at once. FT_Get_Advance() with
+  // FT_LOAD_NO_SCALE reads advances straight from the font's metrics tables
+  // where possible, so this avoids a full glyph load per character, which
+  // LoadCharMetrics() only needs for bounding boxes.
+  if (m_bFaceWidthsLoaded || !m_bUseFontWidth)
+    return;
+
+  m_bFaceWidthsLoaded = true;
+  FXFT_FaceRec* face = m_Font.GetFaceRec();
+  if (!face)
+    return;
+
+  for (size_t charcode = 0; charcode < kInternalTableSize; ++charcode) {
+    if (m_CharWidth[charcode] != 0xffff || m_GlyphIndex[charcode] == 0xffff)
+      continue;
+
+    FT_Fixed advance;
+    if (FT_Get_Advance(face, m_GlyphIndex[charcode],
+                       FT_LOAD_NO_SCALE | FT_LOAD_IGNORE_GLOBAL_ADVANCE_WIDTH,
+                       &advance) == 0) {
+      m_CharWidth[charcode] = TT2PDF(advance, face);
+    }
+  }
+
+  // Matches LoadCharMetrics(), where non-embedded fonts fall back to the
+  // space width for characters without a glyph.
+  if (m_pFontFile)
+    return;
+
+  for (size_t charcode = 0; charcode < kInternalTableSize; ++charcode) {
+    if (m_CharWidth[charcode] == 0xffff && m_GlyphIndex[charcode] == 0xffff &&
+        charcode != 32) {
+      m_CharWidth[charcode] = m_CharWidth[32];
+    }
+  }
+}
+
 void CPDF_SimpleFont::LoadCharWidths(const CPDF_Dictionary* font_desc) {
   RetainPtr<const CPDF_Array> width_array = m_pFontDict->GetArrayFor("Widths");
   m_bUseFontWidth = !width_array;
@@ -202,7 +240,7 @@ int CPDF_SimpleFont::GetCharWidthF(uint32_t charcode) {
     charcode = 0;
 
   if (m_CharWidth[charcode] == 0xffff) {
-    LoadCharMetrics(charcode);
+    LoadCharWidthsFromFace();
     if (m_CharWidth[charcode] == 0xffff) {
       m_CharWidth[charcode] = 0;
     }
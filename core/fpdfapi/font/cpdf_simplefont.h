@@ -42,6 +42,7 @@ class CPDF_SimpleFont : public CPDF_Font {
   bool LoadCommon();
   void LoadSubstFont();
   void LoadCharMetrics(int charcode);
+  void LoadCharWidthsFromFace();
   void LoadCharWidths(const CPDF_Dictionary* font_desc);
   void LoadDifferences(const CPDF_Dictionary* encoding);
   void LoadPDFEncoding(bool bEmbedded, bool bTrueType);
@@ -49,6 +50,7 @@ class CPDF_SimpleFont : public CPDF_Font {
   CPDF_FontEncoding m_Encoding{FontEncoding::kBuiltin};
   FontEncoding m_BaseEncoding = FontEncoding::kBuiltin;
   bool m_bUseFontWidth = false;
+  bool m_bFaceWidthsLoaded = false;
   std::vector<ByteString> m_CharNames;
   uint16_t m_GlyphIndex[kInternalTableSize];
   uint16_t m_CharWidth[kInternalTableSize];
@@ -270,12 +270,23 @@ class CPDF_SeparationCS final : public CPDF_BasedCS {
   uint32_t v_Load(CPDF_Document* pDoc,
                   const CPDF_Array* pArray,
                   std::set<const CPDF_Object*>* pVisited) override;
+  void TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                          pdfium::span<const uint8_t> src_span,
+                          int pixels,
+                          int image_width,
+                          int image_height,
+                          bool bTransMask) const override;
 
  private:
   CPDF_SeparationCS();
 
+  // Returns false if some tint value can't be converted.
+  bool LoadImageLUT() const;
+
   bool m_IsNoneType = false;
+  mutable bool m_bImageLUTLoaded = false;
   std::unique_ptr<const CPDF_Function> m_pFunc;
+  mutable DataVector<uint8_t> m_ImageLUT;  // BGR for each 8-bit tint value.
 };
 
 class CPDF_DeviceNCS final : public CPDF_BasedCS {
@@ -295,11 +306,31 @@ class CPDF_DeviceNCS final : public CPDF_BasedCS {
   uint32_t v_Load(CPDF_Document* pDoc,
                   const CPDF_Array* pArray,
                   std::set<const CPDF_Object*>* pVisited) override;
+  void TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                          pdfium::span<const uint8_t> src_span,
+                          int pixels,
+                          int image_width,
+                          int image_height,
+                          bool bTransMask) const override;
 
  private:
   CPDF_DeviceNCS();
 
+  // Number of samples per component in |m_ImageGrid|.
+  uint32_t GetImageGridLevels() const;
+
+  // Returns false if the grid can't be computed.
+  bool LoadImageGrid() const;
+
+  void TranslateWithImageGrid(pdfium::span<uint8_t> dest_span,
+                              pdfium::span<const uint8_t> src_span,
+                              int pixels) const;
+
+  mutable bool m_bImageGridLoaded = false;
   std::unique_ptr<const CPDF_Function> m_pFunc;
+
+  // RGB values of the tint transform sampled on a regular grid.
+  mutable std::vector<float> m_ImageGrid;
 };
 
 class Vector_3by1 {
@@ -424,6 +455,40 @@ void XYZ_to_sRGB_WhitePoint(float X,
   *B = RGB_Conversion(RGB.c);
 }
 
+// Largest DeviceN space whose images get converted through a sampled grid.
+constexpr uint32_t kMaxImageGridComponents = 4;
+
+// Whether an image is large enough to make sampling |table_size| colors up
+// front cheaper than converting each pixel. Same trade-off as in
+// CPDF_ICCBasedCS::TranslateImageLine().
+bool IsWorthImageTable(int image_width, int image_height, size_t table_size) {
+  FX_SAFE_SIZE_T nPixelCount = image_width;
+  nPixelCount *= image_height;
+  return nPixelCount.IsValid() &&
+         nPixelCount.ValueOrDie() >= table_size * 3 / 2;
+}
+
+// Evaluates |pFunc| on each set of inputs and converts the results through
+// |pBaseCS|, like CPDF_DeviceNCS::GetRGB() does for a single color.
+bool GetTintTransformRGBs(const CPDF_Function* pFunc,
+                          const CPDF_ColorSpace* pBaseCS,
+                          pdfium::span<const float> inputs,
+                          pdfium::span<float> rgbs) {
+  const size_t count = inputs.size() / pFunc->CountInputs();
+  std::vector<float> results(Fx2DSizeOrDie(count, pFunc->CountOutputs()));
+  if (!pFunc->CallBatch(inputs, results).has_value())
+    return false;
+
+  pBaseCS->GetRGBs(results, pFunc->CountOutputs(), rgbs.first(count * 3));
+  return true;
+}
+
+void WriteBGR(float R, float G, float B, uint8_t* dest_buf) {
+  dest_buf[0] = static_cast<int32_t>(B * 255);
+  dest_buf[1] = static_cast<int32_t>(G * 255);
+  dest_buf[2] = static_cast<int32_t>(R * 255);
+}
+
 }  // namespace
 
 PatternValue::PatternValue() = default;
@@ -575,6 +640,20 @@ uint32_t CPDF_ColorSpace::CountComponents() const {
   return m_nComponents;
 }
 
+void CPDF_ColorSpace::GetRGBs(pdfium::span<const float> pBuf,
+                              size_t stride,
+                              pdfium::span<float> rgbs) const {
+  for (size_t n = 0; n < rgbs.size() / 3; n++) {
+    float R = 0.0f;
+    float G = 0.0f;
+    float B = 0.0f;
+    GetRGB(pBuf.subspan(n * stride, stride), &R, &G, &B);
+    rgbs[n * 3] = R;
+    rgbs[n * 3 + 1] = G;
+    rgbs[n * 3 + 2] = B;
+  }
+}
+
 void CPDF_ColorSpace::GetDefaultValue(int iComponent,
                                       float* value,
                                       float* min,
@@ -1162,6 +1241,54 @@ bool CPDF_SeparationCS::GetRGB(pdfium::span<const float> pBuf,
   return false;
 }
 
+void CPDF_SeparationCS::TranslateImageLine(
+    pdfium::span<uint8_t> dest_span,
+    pdfium::span<const uint8_t> src_span,
+    int pixels,
+    int image_width,
+    int image_height,
+    bool bTransMask) const {
+  if (!m_bImageLUTLoaded &&
+      !IsWorthImageTable(image_width, image_height, 256)) {
+    CPDF_ColorSpace::TranslateImageLine(dest_span, src_span, pixels,
+                                        image_width, image_height, bTransMask);
+    return;
+  }
+  if (!LoadImageLUT()) {
+    CPDF_ColorSpace::TranslateImageLine(dest_span, src_span, pixels,
+                                        image_width, image_height, bTransMask);
+    return;
+  }
+
+  uint8_t* dest_buf = dest_span.data();
+  for (int i = 0; i < pixels; i++) {
+    const uint8_t* bgr = &m_ImageLUT[src_span[i] * 3];
+    *dest_buf++ = bgr[0];
+    *dest_buf++ = bgr[1];
+    *dest_buf++ = bgr[2];
+  }
+}
+
+bool CPDF_SeparationCS::LoadImageLUT() const {
+  if (m_bImageLUTLoaded)
+    return !m_ImageLUT.empty();
+
+  m_bImageLUTLoaded = true;
+  DataVector<uint8_t> lut(256 * 3);
+  for (int i = 0; i < 256; i++) {
+    float tint = static_cast<float>(i) / 255;
+    float R;
+    float G;
+    float B;
+    if (!GetRGB(pdfium::make_span(&tint, 1), &R, &G, &B))
+      return false;
+
+    WriteBGR(R, G, B, &lut[i * 3]);
+  }
+  m_ImageLUT = std::move(lut);
+  return true;
+}
+
 CPDF_DeviceNCS::CPDF_DeviceNCS() : CPDF_BasedCS(Family::kDeviceN) {}
 
 CPDF_DeviceNCS::~CPDF_DeviceNCS() = default;
@@ -1218,3 +1345,138 @@ bool CPDF_DeviceNCS::GetRGB(pdfium::span<const float> pBuf,
 
   return m_pBaseCS->GetRGB(results, R, G, B);
 }
+
+void CPDF_DeviceNCS::TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                                        pdfium::span<const uint8_t> src_span,
+                                        int pixels,
+                                        int image_width,
+                                        int image_height,
+                                        bool bTransMask) const {
+  const uint32_t nComponents = CountComponents();
+  if (pixels <= 0 || !m_pFunc || m_pFunc->CountInputs() != nComponents) {
+    CPDF_ColorSpace::TranslateImageLine(dest_span, src_span, pixels,
+                                        image_width, image_height, bTransMask);
+    return;
+  }
+
+  if (nComponents <= kMaxImageGridComponents) {
+    size_t grid_size = 1;
+    for (uint32_t i = 0; i < nComponents; i++)
+      grid_size *= GetImageGridLevels();
+    if ((m_bImageGridLoaded ||
+         IsWorthImageTable(image_width, image_height, grid_size)) &&
+        LoadImageGrid()) {
+      TranslateWithImageGrid(dest_span, src_span, pixels);
+      return;
+    }
+  }
+
+  // Otherwise convert the whole line at once, with the same results as the
+  // per-pixel GetRGB() calls.
+  std::vector<float> inputs(Fx2DSizeOrDie(pixels, nComponents));
+  for (size_t i = 0; i < inputs.size(); i++)
+    inputs[i] = static_cast<float>(src_span[i]) / 255;
+  std::vector<float> rgbs(Fx2DSizeOrDie(pixels, 3));
+  if (!GetTintTransformRGBs(m_pFunc.get(), m_pBaseCS.Get(), inputs, rgbs)) {
+    CPDF_ColorSpace::TranslateImageLine(dest_span, src_span, pixels,
+                                        image_width, image_height, bTransMask);
+    return;
+  }
+  for (int i = 0; i < pixels; i++)
+    WriteBGR(rgbs[i * 3], rgbs[i * 3 + 1], rgbs[i * 3 + 2], &dest_span[i * 3]);
+}
+
+uint32_t CPDF_DeviceNCS::GetImageGridLevels() const {
+  // With one or two components every 8-bit value gets its own sample, so the
+  // grid is exact. Otherwise sample 17 levels and interpolate between them.
+  return CountComponents() <= 2 ? 256 : 17;
+}
+
+bool CPDF_DeviceNCS::LoadImageGrid() const {
+  if (m_bImageGridLoaded)
+    return !m_ImageGrid.empty();
+
+  m_bImageGridLoaded = true;
+  const uint32_t nComponents = CountComponents();
+  const uint32_t levels = GetImageGridLevels();
+  size_t grid_size = 1;
+  for (uint32_t i = 0; i < nComponents; i++)
+    grid_size *= levels;
+
+  // The first component varies slowest.
+  std::vector<float> inputs(Fx2DSizeOrDie(grid_size, nComponents));
+  size_t input_index = 0;
+  for (size_t i = 0; i < grid_size; i++) {
+    size_t order = grid_size / levels;
+    size_t color = i;
+    for (uint32_t c = 0; c < nComponents; c++) {
+      inputs[input_index++] = static_cast<float>(color / order) / (levels - 1);
+      color %= order;
+      order /= levels;
+    }
+  }
+  std::vector<float> grid(Fx2DSizeOrDie(grid_size, 3));
+  if (!GetTintTransformRGBs(m_pFunc.get(), m_pBaseCS.Get(), inputs, grid))
+    return false;
+
+  m_ImageGrid = std::move(grid);
+  return true;
+}
+
+void CPDF_DeviceNCS::TranslateWithImageGrid(
+    pdfium::span<uint8_t> dest_span,
+    pdfium::span<const uint8_t> src_span,
+    int pixels) const {
+  const uint32_t nComponents = CountComponents();
+  const uint32_t levels = GetImageGridLevels();
+  uint8_t* dest_buf = dest_span.data();
+  const uint8_t* src_buf = src_span.data();
+  if (levels == 256) {
+    for (int i = 0; i < pixels; i++) {
+      size_t index = 0;
+      for (uint32_t c = 0; c < nComponents; c++)
+        index = index * 256 + *src_buf++;
+      const float* rgb = &m_ImageGrid[index * 3];
+      WriteBGR(rgb[0], rgb[1], rgb[2], dest_buf);
+      dest_buf += 3;
+    }
+    return;
+  }
+
+  // Multilinear interpolation between the 2^n surrounding samples.
+  size_t base_index[kMaxImageGridComponents];
+  size_t strides[kMaxImageGridComponents];
+  float fractions[kMaxImageGridComponents];
+  size_t stride = 1;
+  for (uint32_t c = nComponents; c > 0; c--) {
+    strides[c - 1] = stride;
+    stride *= levels;
+  }
+  for (int i = 0; i < pixels; i++) {
+    for (uint32_t c = 0; c < nComponents; c++) {
+      float pos = static_cast<float>(*src_buf++) * (levels - 1) / 255;
+      uint32_t lower = std::min(static_cast<uint32_t>(pos), levels - 2);
+      base_index[c] = lower * strides[c];
+      fractions[c] = pos - lower;
+    }
+    float rgb[3] = {};
+    for (uint32_t corner = 0; corner < (1u << nComponents); corner++) {
+      float weight = 1.0f;
+      size_t index = 0;
+      for (uint32_t c = 0; c < nComponents; c++) {
+        const bool upper = corner & (1u << c);
+        weight *= upper ? fractions[c] : 1.0f - fractions[c];
+        index += base_index[c] + (upper ? strides[c] : 0);
+      }
+      if (weight == 0)
+        continue;
+
+      const float* sample = &m_ImageGrid[index * 3];
+      rgb[0] += sample[0] * weight;
+      rgb[1] += sample[1] * weight;
+      rgb[2] += sample[2] * weight;
+    }
+    WriteBGR(rgb[0], rgb[1], rgb[2], dest_buf);
+    dest_buf += 3;
+  }
+}
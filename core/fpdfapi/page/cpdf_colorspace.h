@@ -100,6 +100,14 @@ class CPDF_ColorSpace : public Retainable, public Observable {
                       float* G,
                       float* B) const = 0;
 
+  // Converts rgbs.size() / 3 colors, the n-th one starting at
+  // |pBuf|[n * |stride|] and spanning |stride| values, to RGB triples in
+  // |rgbs|. Equivalent to calling GetRGB() on each color with R, G and B
+  // starting out at 0.
+  virtual void GetRGBs(pdfium::span<const float> pBuf,
+                       size_t stride,
+                       pdfium::span<float> rgbs) const;
+
   virtual void GetDefaultValue(int iComponent,
                                float* value,
                                float* min,
@@ -7,9 +7,96 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "core/fpdfapi/page/test_with_page_module.h"
+#include "core/fpdfapi/parser/cpdf_array.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+void AppendNumbers(CPDF_Array* pArray, const std::vector<float>& values) {
+  for (float value : values)
+    pArray->AppendNew<CPDF_Number>(value);
+}
+
+// Returns a Type 4 function stream with |nInputs| inputs in [0, 1] that
+// computes three outputs with |program|.
+RetainPtr<CPDF_Stream> MakePSFunction(uint32_t nInputs, const char* program) {
+  auto pDict = pdfium::MakeRetain<CPDF_Dictionary>();
+  pDict->SetNewFor<CPDF_Number>("FunctionType", 4);
+  CPDF_Array* pDomain = pDict->SetNewFor<CPDF_Array>("Domain").Get();
+  for (uint32_t i = 0; i < nInputs; ++i)
+    AppendNumbers(pDomain, {0, 1});
+  AppendNumbers(pDict->SetNewFor<CPDF_Array>("Range").Get(),
+                {0, 1, 0, 1, 0, 1});
+  ByteStringView source(program);
+  return pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(source.begin(), source.end()), std::move(pDict));
+}
+
+RetainPtr<CPDF_ColorSpace> LoadTintedCS(uint32_t nInputs, const char* program) {
+  auto pArray = pdfium::MakeRetain<CPDF_Array>();
+  if (nInputs == 1) {
+    pArray->AppendNew<CPDF_Name>("Separation");
+    pArray->AppendNew<CPDF_Name>("Spot");
+  } else {
+    pArray->AppendNew<CPDF_Name>("DeviceN");
+    CPDF_Array* pNames = pArray->AppendNew<CPDF_Array>().Get();
+    for (uint32_t i = 0; i < nInputs; ++i)
+      pNames->AppendNew<CPDF_Name>(ByteString::Format("Spot%u", i));
+  }
+  pArray->AppendNew<CPDF_Name>("DeviceRGB");
+  pArray->Append(MakePSFunction(nInputs, program));
+  std::set<const CPDF_Object*> visited;
+  return CPDF_ColorSpace::Load(nullptr, pArray.Get(), &visited);
+}
+
+// Converts |count| pixels of |pCS| with TranslateImageLine() and compares
+// the result with GetRGB() on each pixel, allowing |tolerance| per channel.
+void CheckTranslateImageLine(const CPDF_ColorSpace* pCS,
+                             const std::vector<uint8_t>& src,
+                             int image_width,
+                             int image_height,
+                             int tolerance) {
+  const uint32_t nComponents = pCS->CountComponents();
+  const int pixels = src.size() / nComponents;
+  std::vector<uint8_t> dst(pixels * 3, 0xbd);
+  pCS->TranslateImageLine(dst, src, pixels, image_width, image_height, false);
+
+  std::vector<float> color(nComponents);
+  for (int i = 0; i < pixels; ++i) {
+    for (uint32_t c = 0; c < nComponents; ++c)
+      color[c] = static_cast<float>(src[i * nComponents + c]) / 255;
+    float R;
+    float G;
+    float B;
+    ASSERT_TRUE(pCS->GetRGB(color, &R, &G, &B));
+    EXPECT_NEAR(static_cast<int32_t>(B * 255), dst[i * 3], tolerance) << i;
+    EXPECT_NEAR(static_cast<int32_t>(G * 255), dst[i * 3 + 1], tolerance) << i;
+    EXPECT_NEAR(static_cast<int32_t>(R * 255), dst[i * 3 + 2], tolerance) << i;
+  }
+}
+
+std::vector<uint8_t> MakeRamp(size_t size) {
+  std::vector<uint8_t> src(size);
+  for (size_t i = 0; i < size; ++i)
+    src[i] = static_cast<uint8_t>(i * 37 + i / 256);
+  return src;
+}
+
+}  // namespace
+
+using CPDF_TintedColorSpaceTest = TestWithPageModule;
+
 TEST(CPDF_CalGray, TranslateImageLine) {
   const uint8_t kSrc[12] = {255, 0, 0, 0, 255, 0, 0, 0, 255, 128, 128, 128};
   const uint8_t kExpect[12] = {255, 255, 255, 0, 0, 0, 0, 0, 0, 0, 0, 0};
@@ -50,3 +137,37 @@ TEST(CPDF_CalRGB, TranslateImageLine) {
   for (size_t i = 0; i < 12; ++i)
     EXPECT_EQ(dst[i], kExpectNomask[i]) << " at " << i;
 }
+
+TEST_F(CPDF_TintedColorSpaceTest, SeparationTranslateImageLine) {
+  RetainPtr<CPDF_ColorSpace> pCS =
+      LoadTintedCS(1, "{ dup dup mul exch 2 div 1 }");
+  ASSERT_TRUE(pCS);
+
+  // Small images convert each pixel, large ones go through a lookup table.
+  // Both are exact.
+  CheckTranslateImageLine(pCS.Get(), MakeRamp(256), 16, 16, 0);
+  CheckTranslateImageLine(pCS.Get(), MakeRamp(256), 1000, 1000, 0);
+}
+
+TEST_F(CPDF_TintedColorSpaceTest, DeviceNTranslateImageLine) {
+  RetainPtr<CPDF_ColorSpace> pCS =
+      LoadTintedCS(2, "{ 2 copy mul 3 1 roll sqrt exch 1 exch sub }");
+  ASSERT_TRUE(pCS);
+
+  // With two components, the sampled grid covers every 8-bit color.
+  CheckTranslateImageLine(pCS.Get(), MakeRamp(512), 16, 16, 0);
+  CheckTranslateImageLine(pCS.Get(), MakeRamp(512), 1000, 1000, 0);
+}
+
+TEST_F(CPDF_TintedColorSpaceTest, DeviceNTranslateImageLineInterpolated) {
+  RetainPtr<CPDF_ColorSpace> pCS =
+      LoadTintedCS(3, "{ 3 1 roll 2 div exch 0.5 mul 0.25 add }");
+  ASSERT_TRUE(pCS);
+
+  // Small images are converted exactly.
+  CheckTranslateImageLine(pCS.Get(), MakeRamp(768), 16, 16, 0);
+
+  // Large images interpolate in a sampled grid, which is exact up to
+  // rounding for this linear tint transform.
+  CheckTranslateImageLine(pCS.Get(), MakeRamp(768), 1000, 1000, 1);
+}
@@ -56,16 +56,20 @@ CPDF_ContentParser::CPDF_ContentParser(CPDF_Page* pPage)
   HandlePageContentFailure();
 }
 
-CPDF_ContentParser::CPDF_ContentParser(RetainPtr<const CPDF_Stream> pStream,
-                                       CPDF_PageObjectHolder* pPageObjectHolder,
-                                       const CPDF_AllStates* pGraphicStates,
-                                       const CFX_Matrix* pParentMatrix,
-                                       CPDF_Type3Char* pType3Char,
-                                       std::set<const uint8_t*>* pParsedSet)
+CPDF_ContentParser::CPDF_ContentParser(
+    RetainPtr<const CPDF_Stream> pStream,
+    CPDF_PageObjectHolder* pPageObjectHolder,
+    const CPDF_AllStates* pGraphicStates,
+    const CFX_Matrix* pParentMatrix,
+    CPDF_Type3Char* pType3Char,
+    CPDF_Form::RecursionState* recursion_state)
     : m_CurrentStage(Stage::kParse),
       m_pPageObjectHolder(pPageObjectHolder),
       m_pType3Char(pType3Char) {
   DCHECK(m_pPageObjectHolder);
+  if (!recursion_state)
+    recursion_state = &m_RecursionState;
+
   CFX_Matrix form_matrix =
       m_pPageObjectHolder->GetDict()->GetMatrixFor("Matrix");
   if (pGraphicStates)
@@ -95,7 +99,7 @@ CPDF_ContentParser::CPDF_ContentParser(RetainPtr<const CPDF_Stream> pStream,
       m_pPageObjectHolder->GetMutablePageResources(),
       m_pPageObjectHolder->GetMutableResources(), pParentMatrix,
       m_pPageObjectHolder, std::move(pResources), form_bbox, pGraphicStates,
-      pParsedSet);
+      recursion_state);
   m_pParser->GetCurStates()->m_CTM = form_matrix;
   m_pParser->GetCurStates()->m_ParentMatrix = form_matrix;
   if (ClipPath.HasRef()) {
@@ -109,8 +113,13 @@ CPDF_ContentParser::CPDF_ContentParser(RetainPtr<const CPDF_Stream> pStream,
     pState->SetFillAlpha(1.0f);
     pState->SetSoftMask(nullptr);
   }
-  m_pSingleStream = pdfium::MakeRetain<CPDF_StreamAcc>(std::move(pStream));
-  m_pSingleStream->LoadAllDataFiltered();
+  RetainPtr<CPDF_StreamAcc>& pDecoded =
+      recursion_state->decoded_streams[pStream];
+  if (!pDecoded) {
+    pDecoded = pdfium::MakeRetain<CPDF_StreamAcc>(std::move(pStream));
+    pDecoded->LoadAllDataFiltered();
+  }
+  m_pSingleStream = pDecoded;
   m_Data = m_pSingleStream->GetSpan();
 }
 
@@ -197,12 +206,12 @@ CPDF_ContentParser::Stage CPDF_ContentParser::PrepareContent() {
 
 CPDF_ContentParser::Stage CPDF_ContentParser::Parse() {
   if (!m_pParser) {
-    m_ParsedSet.clear();
+    m_RecursionState.parsed_set.clear();
     m_pParser = std::make_unique<CPDF_StreamContentParser>(
         m_pPageObjectHolder->GetDocument(),
         m_pPageObjectHolder->GetMutablePageResources(), nullptr, nullptr,
         m_pPageObjectHolder, m_pPageObjectHolder->GetMutableResources(),
-        m_pPageObjectHolder->GetBBox(), nullptr, &m_ParsedSet);
+        m_pPageObjectHolder->GetBBox(), nullptr, &m_RecursionState);
     m_pParser->GetCurStates()->m_ColorState.SetDefault();
   }
   if (m_CurrentOffset >= GetData().size())
@@ -75,6 +75,40 @@ bool CPDF_DeviceCS::GetRGB(pdfium::span<const float> pBuf,
   }
 }
 
+void CPDF_DeviceCS::GetRGBs(pdfium::span<const float> pBuf,
+                            size_t stride,
+                            pdfium::span<float> rgbs) const {
+  // Same conversions as GetRGB(), with the family switch out of the loop for
+  // the cheap families.
+  const size_t count = rgbs.size() / 3;
+  switch (GetFamily()) {
+    case Family::kDeviceGray:
+      for (size_t n = 0; n < count; n++) {
+        const float gray = NormalizeChannel(pBuf[n * stride]);
+        rgbs[n * 3] = gray;
+        rgbs[n * 3 + 1] = gray;
+        rgbs[n * 3 + 2] = gray;
+      }
+      return;
+    case Family::kDeviceRGB:
+      for (size_t n = 0; n < count; n++) {
+        pdfium::span<const float> color = pBuf.subspan(n * stride, 3);
+        rgbs[n * 3] = NormalizeChannel(color[0]);
+        rgbs[n * 3 + 1] = NormalizeChannel(color[1]);
+        rgbs[n * 3 + 2] = NormalizeChannel(color[2]);
+      }
+      return;
+    case Family::kDeviceCMYK:
+      for (size_t n = 0; n < count; n++) {
+        GetRGB(pBuf.subspan(n * stride, 4), &rgbs[n * 3], &rgbs[n * 3 + 1],
+               &rgbs[n * 3 + 2]);
+      }
+      return;
+    default:
+      NOTREACHED_NORETURN();
+  }
+}
+
 void CPDF_DeviceCS::TranslateImageLine(pdfium::span<uint8_t> dest_span,
                                        pdfium::span<const uint8_t> src_span,
                                        int pixels,
@@ -22,6 +22,9 @@ class CPDF_DeviceCS final : public CPDF_ColorSpace {
               float* R,
               float* G,
               float* B) const override;
+  void GetRGBs(pdfium::span<const float> pBuf,
+               size_t stride,
+               pdfium::span<float> rgbs) const override;
   void TranslateImageLine(pdfium::span<uint8_t> dest_span,
                           pdfium::span<const uint8_t> src_span,
                           int pixels,
@@ -6,6 +6,8 @@
 
 #include "core/fpdfapi/page/cpdf_devicecs.h"
 
+#include <vector>
+
 #include "core/fxcrt/retain_ptr.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -117,3 +119,27 @@ TEST(CPDF_DeviceCSTest, GetRGBFromCMYK) {
   EXPECT_FLOAT_EQ(0.552941f, G);
   EXPECT_FLOAT_EQ(0.15686275f, B);
 }
+
+TEST(CPDF_DeviceCSTest, GetRGBs) {
+  // Colors padded out to a stride of 5, with out of range components.
+  const std::vector<float> buf = {0.1f, 0.2f,  0.3f, 0.4f,  9.0f,
+                                  1.5f, -0.5f, 0.7f, 0.05f, 9.0f,
+                                  0.0f, 1.0f,  0.5f, 0.25f, 9.0f};
+  for (auto family : {CPDF_ColorSpace::Family::kDeviceGray,
+                      CPDF_ColorSpace::Family::kDeviceRGB,
+                      CPDF_ColorSpace::Family::kDeviceCMYK}) {
+    auto device_cs = pdfium::MakeRetain<CPDF_DeviceCS>(family);
+    std::vector<float> rgbs(9);
+    device_cs->GetRGBs(buf, /*stride=*/5, rgbs);
+    for (size_t n = 0; n < 3; ++n) {
+      float R;
+      float G;
+      float B;
+      ASSERT_TRUE(device_cs->GetRGB(pdfium::make_span(buf).subspan(n * 5, 5),
+                                    &R, &G, &B));
+      EXPECT_FLOAT_EQ(R, rgbs[n * 3]);
+      EXPECT_FLOAT_EQ(G, rgbs[n * 3 + 1]);
+      EXPECT_FLOAT_EQ(B, rgbs[n * 3 + 2]);
+    }
+  }
+}
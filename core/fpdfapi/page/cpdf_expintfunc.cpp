@@ -67,3 +67,22 @@ bool CPDF_ExpIntFunc::v_Call(pdfium::span<const float> inputs,
   }
   return true;
 }
+
+bool CPDF_ExpIntFunc::v_CallBatch(pdfium::span<const float> inputs,
+                                  size_t count,
+                                  pdfium::span<float> results) const {
+  DataVector<float> deltas(m_nOrigOutputs);
+  for (uint32_t j = 0; j < m_nOrigOutputs; j++)
+    deltas[j] = m_EndValues[j] - m_BeginValues[j];
+
+  for (size_t n = 0; n < count; n++) {
+    pdfium::span<const float> input = inputs.subspan(n * m_nInputs, m_nInputs);
+    pdfium::span<float> result = results.subspan(n * m_nOutputs, m_nOutputs);
+    for (uint32_t i = 0; i < m_nInputs; i++) {
+      const float factor = powf(input[i], m_Exponent);
+      for (uint32_t j = 0; j < m_nOrigOutputs; j++)
+        result[i * m_nOrigOutputs + j] = m_BeginValues[j] + factor * deltas[j];
+    }
+  }
+  return true;
+}
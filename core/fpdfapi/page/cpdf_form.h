@@ -7,6 +7,7 @@
 #ifndef CORE_FPDFAPI_PAGE_CPDF_FORM_H_
 #define CORE_FPDFAPI_PAGE_CPDF_FORM_H_
 
+#include <map>
 #include <set>
 #include <utility>
 
@@ -19,11 +20,27 @@ class CPDF_AllStates;
 class CPDF_Dictionary;
 class CPDF_Document;
 class CPDF_Stream;
+class CPDF_StreamAcc;
 class CPDF_Type3Char;
 
 class CPDF_Form final : public CPDF_PageObjectHolder,
                         public CPDF_Font::FormIface {
  public:
+  // State shared by a page or form and all the forms nested within it while
+  // they are parsed.
+  struct RecursionState {
+    RecursionState();
+    ~RecursionState();
+
+    // The content currently being parsed, to stop forms that draw themselves.
+    std::set<const uint8_t*> parsed_set;
+
+    // Decoded content of the forms parsed so far, so a form that is drawn
+    // many times is only decoded once.
+    std::map<RetainPtr<const CPDF_Stream>, RetainPtr<CPDF_StreamAcc>>
+        decoded_streams;
+  };
+
   // Helper method to choose the first non-null resources dictionary.
   static CPDF_Dictionary* ChooseResourcesDict(CPDF_Dictionary* pResources,
                                               CPDF_Dictionary* pParentResources,
@@ -48,7 +65,7 @@ class CPDF_Form final : public CPDF_PageObjectHolder,
   void ParseContent();
   void ParseContent(const CPDF_AllStates* pGraphicStates,
                     const CFX_Matrix* pParentMatrix,
-                    std::set<const uint8_t*>* pParsedSet);
+                    RecursionState* recursion_state);
 
   RetainPtr<const CPDF_Stream> GetStream() const;
 
@@ -56,9 +73,8 @@ class CPDF_Form final : public CPDF_PageObjectHolder,
   void ParseContentInternal(const CPDF_AllStates* pGraphicStates,
                             const CFX_Matrix* pParentMatrix,
                             CPDF_Type3Char* pType3Char,
-                            std::set<const uint8_t*>* pParsedSet);
+                            RecursionState* recursion_state);
 
-  std::set<const uint8_t*> m_ParsedSet;
   RetainPtr<CPDF_Stream> const m_pFormStream;
 };
 
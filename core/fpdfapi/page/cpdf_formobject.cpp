@@ -15,7 +15,9 @@ CPDF_FormObject::CPDF_FormObject(int32_t content_stream,
                                  const CFX_Matrix& matrix)
     : CPDF_PageObject(content_stream),
       m_pForm(std::move(pForm)),
-      m_FormMatrix(matrix) {}
+      m_FormMatrix(matrix) {
+  m_pForm->SetOwnerObject(this);
+}
 
 CPDF_FormObject::~CPDF_FormObject() = default;
 
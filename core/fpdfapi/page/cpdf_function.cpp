@@ -160,6 +160,58 @@ absl::optional<uint32_t> CPDF_Function::Call(
   return m_nOutputs;
 }
 
+absl::optional<uint32_t> CPDF_Function::CallBatch(
+    pdfium::span<const float> inputs,
+    pdfium::span<float> results) const {
+  if (inputs.size() % m_nInputs != 0)
+    return absl::nullopt;
+
+  const size_t count = inputs.size() / m_nInputs;
+  FX_SAFE_SIZE_T results_needed = count;
+  results_needed *= m_nOutputs;
+  if (!results_needed.IsValid() || results.size() < results_needed.ValueOrDie())
+    return absl::nullopt;
+
+  for (uint32_t i = 0; i < m_nInputs; i++) {
+    if (m_Domains[i * 2] > m_Domains[i * 2 + 1])
+      return absl::nullopt;
+  }
+  std::vector<float> clamped_inputs(inputs.begin(), inputs.end());
+  for (size_t n = 0; n < clamped_inputs.size(); n++) {
+    uint32_t i = n % m_nInputs;
+    clamped_inputs[n] = pdfium::clamp(clamped_inputs[n], m_Domains[i * 2],
+                                      m_Domains[i * 2 + 1]);
+  }
+  if (!v_CallBatch(clamped_inputs, count, results))
+    return absl::nullopt;
+
+  if (m_Ranges.empty())
+    return m_nOutputs;
+
+  for (uint32_t i = 0; i < m_nOutputs; i++) {
+    if (m_Ranges[i * 2] > m_Ranges[i * 2 + 1])
+      return absl::nullopt;
+  }
+  for (size_t n = 0; n < results_needed.ValueOrDie(); n++) {
+    uint32_t i = n % m_nOutputs;
+    results[n] =
+        pdfium::clamp(results[n], m_Ranges[i * 2], m_Ranges[i * 2 + 1]);
+  }
+  return m_nOutputs;
+}
+
+bool CPDF_Function::v_CallBatch(pdfium::span<const float> inputs,
+                                size_t count,
+                                pdfium::span<float> results) const {
+  for (size_t n = 0; n < count; n++) {
+    if (!v_Call(inputs.subspan(n * m_nInputs, m_nInputs),
+                results.subspan(n * m_nOutputs, m_nOutputs))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // See PDF Reference 1.7, page 170.
 float CPDF_Function::Interpolate(float x,
                                  float xmin,
@@ -38,6 +38,14 @@ class CPDF_Function {
 
   absl::optional<uint32_t> Call(pdfium::span<const float> inputs,
                                 pdfium::span<float> results) const;
+
+  // Evaluates the function once for every CountInputs() values in |inputs|,
+  // writing CountOutputs() values per evaluation to |results|. Gives the same
+  // results as calling Call() on each set of inputs in turn, without paying
+  // for the per-call setup. Returns the number of outputs per evaluation, or
+  // nullopt if any evaluation fails.
+  absl::optional<uint32_t> CallBatch(pdfium::span<const float> inputs,
+                                     pdfium::span<float> results) const;
   uint32_t CountInputs() const { return m_nInputs; }
   uint32_t CountOutputs() const { return m_nOutputs; }
   float GetDomain(int i) const { return m_Domains[i]; }
@@ -66,6 +74,12 @@ class CPDF_Function {
   virtual bool v_Call(pdfium::span<const float> inputs,
                       pdfium::span<float> results) const = 0;
 
+  // Evaluates |count| sets of domain-clamped inputs. The default
+  // implementation calls v_Call() for each set.
+  virtual bool v_CallBatch(pdfium::span<const float> inputs,
+                           size_t count,
+                           pdfium::span<float> results) const;
+
   const Type m_Type;
   uint32_t m_nInputs = 0;
   uint32_t m_nOutputs = 0;
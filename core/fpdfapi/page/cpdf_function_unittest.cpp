@@ -4,12 +4,56 @@
 
 #include "core/fpdfapi/page/cpdf_function.h"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+void AppendNumbers(CPDF_Array* pArray, std::initializer_list<float> numbers) {
+  for (float number : numbers)
+    pArray->AppendNew<CPDF_Number>(number);
+}
+
+RetainPtr<CPDF_Dictionary> CreateExpIntFunctionDict(float c0, float c1) {
+  auto pDict = pdfium::MakeRetain<CPDF_Dictionary>();
+  pDict->SetNewFor<CPDF_Number>("FunctionType", 2);
+  AppendNumbers(pDict->SetNewFor<CPDF_Array>("Domain").Get(), {0, 1});
+  AppendNumbers(pDict->SetNewFor<CPDF_Array>("C0").Get(), {c0, 1 - c0});
+  AppendNumbers(pDict->SetNewFor<CPDF_Array>("C1").Get(), {c1, 1 - c1});
+  pDict->SetNewFor<CPDF_Number>("N", 2);
+  return pDict;
+}
+
+// Checks that CallBatch() on |inputs| gives what Call() gives on each of them.
+void CheckCallBatch(const CPDF_Function& func,
+                    const std::vector<float>& inputs) {
+  const uint32_t nInputs = func.CountInputs();
+  const uint32_t nOutputs = func.CountOutputs();
+  const size_t count = inputs.size() / nInputs;
+  std::vector<float> batch_results(count * nOutputs);
+  ASSERT_EQ(nOutputs, func.CallBatch(inputs, batch_results));
+
+  std::vector<float> results(nOutputs);
+  for (size_t n = 0; n < count; ++n) {
+    ASSERT_EQ(nOutputs,
+              func.Call(pdfium::make_span(inputs).subspan(n * nInputs, nInputs),
+                        results));
+    for (uint32_t i = 0; i < nOutputs; ++i)
+      EXPECT_EQ(results[i], batch_results[n * nOutputs + i]);
+  }
+}
+
+}  // namespace
+
 TEST(CPDFFunction, BadFunctionType) {
   auto pDict = pdfium::MakeRetain<CPDF_Dictionary>();
   pDict->SetNewFor<CPDF_Number>("FunctionType", -2);
@@ -41,3 +85,53 @@ TEST(CPDFFunction, NoRange) {
   pArray->AppendNew<CPDF_Number>(10);
   EXPECT_FALSE(CPDF_Function::Load(pDict));
 }
+
+TEST(CPDFFunction, CallBatchExpInt) {
+  std::unique_ptr<CPDF_Function> pFunc =
+      CPDF_Function::Load(CreateExpIntFunctionDict(0.25f, 0.75f));
+  ASSERT_TRUE(pFunc);
+  CheckCallBatch(*pFunc, {-1.0f, 0.0f, 0.1f, 0.5f, 0.9f, 1.0f, 2.0f});
+}
+
+TEST(CPDFFunction, CallBatchSampled) {
+  auto pDict = pdfium::MakeRetain<CPDF_Dictionary>();
+  pDict->SetNewFor<CPDF_Number>("FunctionType", 0);
+  AppendNumbers(pDict->SetNewFor<CPDF_Array>("Domain").Get(), {0, 1, 0, 1});
+  AppendNumbers(pDict->SetNewFor<CPDF_Array>("Range").Get(), {0, 1, 0, 1});
+  AppendNumbers(pDict->SetNewFor<CPDF_Array>("Size").Get(), {3, 2});
+  pDict->SetNewFor<CPDF_Number>("BitsPerSample", 8);
+  DataVector<uint8_t> samples = {0,   255, 64,  128, 128, 64,
+                                 255, 0,   32,  16,  200, 100};
+  auto pStream =
+      pdfium::MakeRetain<CPDF_Stream>(std::move(samples), std::move(pDict));
+  std::unique_ptr<CPDF_Function> pFunc = CPDF_Function::Load(pStream);
+  ASSERT_TRUE(pFunc);
+  CheckCallBatch(*pFunc, {0.0f,  0.0f, 0.3f, 0.7f, 0.5f,  1.0f, 1.0f, 0.2f,
+                          -1.0f, 2.0f, 0.9f, 0.9f, 0.66f, 0.0f});
+}
+
+TEST(CPDFFunction, CallBatchStitch) {
+  auto pDict = pdfium::MakeRetain<CPDF_Dictionary>();
+  pDict->SetNewFor<CPDF_Number>("FunctionType", 3);
+  AppendNumbers(pDict->SetNewFor<CPDF_Array>("Domain").Get(), {0, 1});
+  auto pFunctions = pDict->SetNewFor<CPDF_Array>("Functions");
+  pFunctions->Append(CreateExpIntFunctionDict(0.0f, 0.5f));
+  pFunctions->Append(CreateExpIntFunctionDict(0.5f, 1.0f));
+  AppendNumbers(pDict->SetNewFor<CPDF_Array>("Bounds").Get(), {0.4f});
+  AppendNumbers(pDict->SetNewFor<CPDF_Array>("Encode").Get(), {0, 1, 1, 0});
+  std::unique_ptr<CPDF_Function> pFunc = CPDF_Function::Load(pDict);
+  ASSERT_TRUE(pFunc);
+  // Runs on both sides of the bound, and inputs that jump back and forth.
+  CheckCallBatch(*pFunc, {0.0f, 0.1f, 0.2f, 0.4f, 0.6f, 0.8f, 1.0f, 0.3f,
+                          0.7f, 0.1f, -5.0f, 5.0f});
+}
+
+TEST(CPDFFunction, CallBatchResultsTooSmall) {
+  std::unique_ptr<CPDF_Function> pFunc =
+      CPDF_Function::Load(CreateExpIntFunctionDict(0.0f, 1.0f));
+  ASSERT_TRUE(pFunc);
+  std::vector<float> results(4);
+  EXPECT_EQ(2u, pFunc->CallBatch(std::vector<float>{0.5f, 0.5f}, results));
+  // Not enough room for the results.
+  EXPECT_FALSE(pFunc->CallBatch(std::vector<float>{0.5f, 0.5f, 0.5f}, results));
+}
@@ -263,6 +263,14 @@ CFX_Matrix* CPDF_GeneralState::GetMutableMatrix() {
   return &m_Ref.GetPrivateCopy()->m_Matrix;
 }
 
+bool CPDF_GeneralState::operator==(const CPDF_GeneralState& that) const {
+  if (m_Ref == that.m_Ref)
+    return true;
+  if (!m_Ref || !that.m_Ref)
+    return false;
+  return *m_Ref.GetObject() == *that.m_Ref.GetObject();
+}
+
 CPDF_GeneralState::StateData::StateData() = default;
 
 CPDF_GeneralState::StateData::StateData(const StateData& that)
@@ -290,6 +298,23 @@ CPDF_GeneralState::StateData::StateData(const StateData& that)
 
 CPDF_GeneralState::StateData::~StateData() = default;
 
+bool CPDF_GeneralState::StateData::operator==(const StateData& that) const {
+  return m_BlendMode == that.m_BlendMode && m_BlendType == that.m_BlendType &&
+         m_pSoftMask == that.m_pSoftMask &&
+         m_SMaskMatrix == that.m_SMaskMatrix &&
+         m_StrokeAlpha == that.m_StrokeAlpha &&
+         m_FillAlpha == that.m_FillAlpha && m_pTR == that.m_pTR &&
+         m_pTransferFunc == that.m_pTransferFunc &&
+         m_Matrix == that.m_Matrix && m_RenderIntent == that.m_RenderIntent &&
+         m_StrokeAdjust == that.m_StrokeAdjust &&
+         m_AlphaSource == that.m_AlphaSource &&
+         m_TextKnockout == that.m_TextKnockout &&
+         m_StrokeOP == that.m_StrokeOP && m_FillOP == that.m_FillOP &&
+         m_OPMode == that.m_OPMode && m_pBG == that.m_pBG &&
+         m_pUCR == that.m_pUCR && m_pHT == that.m_pHT &&
+         m_Flatness == that.m_Flatness && m_Smoothness == that.m_Smoothness;
+}
+
 RetainPtr<CPDF_GeneralState::StateData> CPDF_GeneralState::StateData::Clone()
     const {
   return pdfium::MakeRetain<CPDF_GeneralState::StateData>(*this);
@@ -24,6 +24,13 @@ class CPDF_GeneralState {
   CPDF_GeneralState(const CPDF_GeneralState& that);
   ~CPDF_GeneralState();
 
+  // Returns true when both states hold the same values. Objects referenced by
+  // the states are compared by identity.
+  bool operator==(const CPDF_GeneralState& that) const;
+  bool operator!=(const CPDF_GeneralState& that) const {
+    return !(*this == that);
+  }
+
   void Emplace() { m_Ref.Emplace(); }
   bool HasRef() const { return !!m_Ref; }
 
@@ -86,6 +93,8 @@ class CPDF_GeneralState {
 
     RetainPtr<StateData> Clone() const;
 
+    bool operator==(const StateData& that) const;
+
     ByteString m_BlendMode = pdfium::transparency::kNormal;
     BlendMode m_BlendType = BlendMode::kNormal;
     RetainPtr<CPDF_Dictionary> m_pSoftMask;
@@ -6,6 +6,7 @@
 
 #include "core/fpdfapi/page/cpdf_pageobject.h"
 
+#include "core/fpdfapi/page/cpdf_pageobjectholder.h"
 #include "core/fxcrt/fx_coordinates.h"
 
 CPDF_PageObject::CPDF_PageObject(int32_t content_stream)
@@ -75,10 +76,27 @@ const CPDF_FormObject* CPDF_PageObject::AsForm() const {
 
 void CPDF_PageObject::CopyData(const CPDF_PageObject* pSrc) {
   CopyStates(*pSrc);
-  m_Rect = pSrc->m_Rect;
+  SetRect(pSrc->m_Rect);
   m_bDirty = true;
 }
 
+void CPDF_PageObject::SetDirty(bool value) {
+  m_bDirty = value;
+  if (value)
+    NotifyHolderOfModification();
+}
+
+void CPDF_PageObject::NotifyHolderOfModification() {
+  if (m_pHolder)
+    m_pHolder->OnPageObjectModified();
+}
+
+void CPDF_PageObject::SetRect(const CFX_FloatRect& rect) {
+  m_Rect = rect;
+  if (m_pHolder)
+    m_pHolder->OnPageObjectRectChanged();
+}
+
 void CPDF_PageObject::TransformClipPath(const CFX_Matrix& matrix) {
   if (!m_ClipPath.HasRef())
     return;
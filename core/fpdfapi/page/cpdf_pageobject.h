@@ -13,9 +13,11 @@
 #include "core/fpdfapi/page/cpdf_graphicstates.h"
 #include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/unowned_ptr.h"
 
 class CPDF_FormObject;
 class CPDF_ImageObject;
+class CPDF_PageObjectHolder;
 class CPDF_PathObject;
 class CPDF_ShadingObject;
 class CPDF_TextObject;
@@ -59,14 +61,14 @@ class CPDF_PageObject : public CPDF_GraphicStates {
   virtual CPDF_FormObject* AsForm();
   virtual const CPDF_FormObject* AsForm() const;
 
-  void SetDirty(bool value) { m_bDirty = value; }
+  void SetDirty(bool value);
   bool IsDirty() const { return m_bDirty; }
   void TransformClipPath(const CFX_Matrix& matrix);
   void TransformGeneralState(const CFX_Matrix& matrix);
 
   void SetOriginalRect(const CFX_FloatRect& rect) { m_OriginalRect = rect; }
   const CFX_FloatRect& GetOriginalRect() const { return m_OriginalRect; }
-  void SetRect(const CFX_FloatRect& rect) { m_Rect = rect; }
+  void SetRect(const CFX_FloatRect& rect);
   const CFX_FloatRect& GetRect() const { return m_Rect; }
   FX_RECT GetBBox() const;
   FX_RECT GetTransformedBBox(const CFX_Matrix& matrix) const;
@@ -89,6 +91,11 @@ class CPDF_PageObject : public CPDF_GraphicStates {
     m_ContentStream = new_content_stream;
   }
 
+  // Set by the holder that owns the object, which needs to know when the
+  // object's rect or content changes.
+  void SetHolder(CPDF_PageObjectHolder* holder) { m_pHolder = holder; }
+  void NotifyHolderOfModification();
+
   const ByteString& GetResourceName() const { return m_ResourceName; }
   void SetResourceName(const ByteString& resource_name) {
     m_ResourceName = resource_name;
@@ -112,6 +119,7 @@ class CPDF_PageObject : public CPDF_GraphicStates {
   int32_t m_ContentStream;
   ByteString m_ResourceName;          // The resource name for this object.
   ByteString m_GraphicsResourceName;  // Like `m_ResourceName` but for graphics.
+  UnownedPtr<CPDF_PageObjectHolder> m_pHolder;
 };
 
 #endif  // CORE_FPDFAPI_PAGE_CPDF_PAGEOBJECT_H_
@@ -13,6 +13,7 @@
 #include "core/fpdfapi/page/cpdf_allstates.h"
 #include "core/fpdfapi/page/cpdf_contentparser.h"
 #include "core/fpdfapi/page/cpdf_pageobject.h"
+#include "core/fpdfapi/page/cpdf_pageobjectindex.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fxcrt/fx_extension.h"
@@ -20,6 +21,13 @@
 #include "third_party/base/check.h"
 #include "third_party/base/check_op.h"
 
+namespace {
+
+// Below this, testing every object is about as fast as querying an index.
+constexpr size_t kMinIndexedObjectCount = 128;
+
+}  // namespace
+
 bool GraphicsData::operator<(const GraphicsData& other) const {
   if (!FXSYS_SafeEQ(fillAlpha, other.fillAlpha))
     return FXSYS_SafeLT(fillAlpha, other.fillAlpha);
@@ -136,7 +144,13 @@ CPDF_PageObject* CPDF_PageObjectHolder::GetPageObjectByIndex(
 
 void CPDF_PageObjectHolder::AppendPageObject(
     std::unique_ptr<CPDF_PageObject> pPageObj) {
+  if (pPageObj)
+    pPageObj->SetHolder(this);
+  if (m_ParseState == ParseState::kParsing)
+    ++m_ParseAllocationCounts.page_objects;
   m_PageObjectList.push_back(std::move(pPageObj));
+  m_pObjectIndex.reset();
+  OnPageObjectModified();
 }
 
 std::unique_ptr<CPDF_PageObject> CPDF_PageObjectHolder::RemovePageObject(
@@ -148,6 +162,9 @@ std::unique_ptr<CPDF_PageObject> CPDF_PageObjectHolder::RemovePageObject(
 
   std::unique_ptr<CPDF_PageObject> result = std::move(*it);
   m_PageObjectList.erase(it);
+  m_pObjectIndex.reset();
+  result->SetHolder(nullptr);
+  OnPageObjectModified();
 
   int32_t content_stream = pPageObj->GetContentStream();
   if (content_stream >= 0)
@@ -161,5 +178,38 @@ bool CPDF_PageObjectHolder::ErasePageObjectAtIndex(size_t index) {
     return false;
 
   m_PageObjectList.erase(m_PageObjectList.begin() + index);
+  m_pObjectIndex.reset();
+  OnPageObjectModified();
   return true;
 }
+
+absl::optional<std::vector<uint32_t>>
+CPDF_PageObjectHolder::FindPageObjectsInRect(const CFX_FloatRect& rect) const {
+  if (m_ParseState != ParseState::kParsed ||
+      m_PageObjectList.size() < kMinIndexedObjectCount) {
+    return absl::nullopt;
+  }
+
+  if (!m_pObjectIndex) {
+    std::vector<CFX_FloatRect> rects;
+    rects.reserve(m_PageObjectList.size());
+    for (const auto& pPageObj : m_PageObjectList)
+      rects.push_back(pPageObj ? pPageObj->GetRect() : CFX_FloatRect());
+    m_pObjectIndex = std::make_unique<CPDF_PageObjectIndex>(rects);
+  }
+  return m_pObjectIndex->Find(rect);
+}
+
+void CPDF_PageObjectHolder::OnPageObjectRectChanged() {
+  m_pObjectIndex.reset();
+}
+
+void CPDF_PageObjectHolder::OnPageObjectModified() {
+  // Objects are added while parsing, which is not a modification.
+  if (m_ParseState != ParseState::kParsed)
+    return;
+
+  m_bContentModified = true;
+  if (m_pOwnerObject)
+    m_pOwnerObject->NotifyHolderOfModification();
+}
@@ -29,6 +29,7 @@
 class CPDF_ContentParser;
 class CPDF_Document;
 class CPDF_PageObject;
+class CPDF_PageObjectIndex;
 class PauseIndicatorIface;
 
 // These structs are used to keep track of resources that have already been
@@ -52,6 +53,16 @@ class CPDF_PageObjectHolder {
  public:
   enum class ParseState : uint8_t { kNotParsed, kParsing, kParsed };
 
+  // Heap allocations made while parsing the content stream, for measuring
+  // the parsing cost of pages with many objects.
+  struct ParseAllocationCounts {
+    // One per page object appended while parsing.
+    size_t page_objects = 0;
+    // Point buffers of parsed paths, including growth of the parser's
+    // scratch buffer.
+    size_t path_point_buffers = 0;
+  };
+
   using iterator = std::deque<std::unique_ptr<CPDF_PageObject>>::iterator;
   using const_iterator =
       std::deque<std::unique_ptr<CPDF_PageObject>>::const_iterator;
@@ -67,6 +78,10 @@ class CPDF_PageObjectHolder {
   void StartParse(std::unique_ptr<CPDF_ContentParser> pParser);
   void ContinueParse(PauseIndicatorIface* pPause);
   ParseState GetParseState() const { return m_ParseState; }
+  const ParseAllocationCounts& GetParseAllocationCounts() const {
+    return m_ParseAllocationCounts;
+  }
+  void CountPathPointBuffer() { ++m_ParseAllocationCounts.path_point_buffers; }
 
   CPDF_Document* GetDocument() const { return m_pDocument; }
   RetainPtr<const CPDF_Dictionary> GetDict() const { return m_pDict; }
@@ -90,6 +105,24 @@ class CPDF_PageObjectHolder {
   std::unique_ptr<CPDF_PageObject> RemovePageObject(CPDF_PageObject* pPageObj);
   bool ErasePageObjectAtIndex(size_t index);
 
+  // Returns the indexes of the page objects whose rects may intersect |rect|,
+  // in drawing order, or nullopt if the caller should test every object.
+  // Uses a spatial index, built on first use once the holder is parsed and
+  // dropped when objects are added, removed or change their rects.
+  absl::optional<std::vector<uint32_t>> FindPageObjectsInRect(
+      const CFX_FloatRect& rect) const;
+  void OnPageObjectRectChanged();
+
+  // Whether objects were added, removed or changed after parsing, either
+  // directly or inside a nested form. Caches of rendered content use this to
+  // tell that the objects no longer match the content stream.
+  bool IsContentModified() const { return m_bContentModified; }
+  void OnPageObjectModified();
+
+  // Set for the holder of a form to the form object that draws it, so that
+  // modifications are reported to the holder of that form object as well.
+  void SetOwnerObject(CPDF_PageObject* pOwner) { m_pOwnerObject = pOwner; }
+
   iterator begin() { return m_PageObjectList.begin(); }
   const_iterator begin() const { return m_PageObjectList.begin(); }
 
@@ -131,13 +164,17 @@ class CPDF_PageObjectHolder {
 
  private:
   bool m_bBackgroundAlphaNeeded = false;
+  bool m_bContentModified = false;
   ParseState m_ParseState = ParseState::kNotParsed;
+  ParseAllocationCounts m_ParseAllocationCounts;
   RetainPtr<CPDF_Dictionary> const m_pDict;
   UnownedPtr<CPDF_Document> m_pDocument;
   std::vector<CFX_FloatRect> m_MaskBoundingBoxes;
   std::unique_ptr<CPDF_ContentParser> m_pParser;
   std::deque<std::unique_ptr<CPDF_PageObject>> m_PageObjectList;
+  mutable std::unique_ptr<CPDF_PageObjectIndex> m_pObjectIndex;
   CFX_Matrix m_LastCTM;
+  UnownedPtr<CPDF_PageObject> m_pOwnerObject;
 
   // The indexes of Content streams that are dirty and need to be regenerated.
   std::set<int32_t> m_DirtyStreams;
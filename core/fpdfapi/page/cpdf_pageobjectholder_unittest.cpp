@@ -8,8 +8,16 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <vector>
 
+#include "core/fpdfapi/page/cpdf_form.h"
+#include "core/fpdfapi/page/cpdf_pathobject.h"
+#include "core/fpdfapi/page/test_with_page_module.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_test_document.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_extension.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -81,3 +89,88 @@ TEST(CPDFPageObjectHolder, GraphicsDataAsKey) {
   }
   EXPECT_EQ(0u, graphics_map.size());
 }
+
+using CPDFPageObjectHolderTest = TestWithPageModule;
+
+TEST_F(CPDFPageObjectHolderTest, FindPageObjectsInRect) {
+  auto pDoc = std::make_unique<CPDF_TestDocument>();
+  pDoc->CreateNewDoc();
+  auto pStream =
+      pdfium::MakeRetain<CPDF_Stream>(pdfium::MakeRetain<CPDF_Dictionary>());
+  auto pForm = std::make_unique<CPDF_Form>(pDoc.get(), nullptr, pStream);
+  pForm->ParseContent();
+  ASSERT_EQ(CPDF_PageObjectHolder::ParseState::kParsed,
+            pForm->GetParseState());
+
+  // A 20 by 20 grid of 10 by 10 objects, 20 units apart.
+  std::vector<CPDF_PageObject*> objects;
+  for (int i = 0; i < 400; ++i) {
+    auto pPathObj = std::make_unique<CPDF_PathObject>();
+    float left = (i % 20) * 20.0f;
+    float bottom = (i / 20) * 20.0f;
+    pPathObj->SetRect(CFX_FloatRect(left, bottom, left + 10, bottom + 10));
+    objects.push_back(pPathObj.get());
+    pForm->AppendPageObject(std::move(pPathObj));
+  }
+
+  absl::optional<std::vector<uint32_t>> found =
+      pForm->FindPageObjectsInRect(CFX_FloatRect(0, 0, 5, 5));
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(0u, found->front());
+  EXPECT_FALSE(std::binary_search(found->begin(), found->end(), 399u));
+
+  // Moving an object updates the index.
+  objects[399]->SetRect(CFX_FloatRect(1, 1, 2, 2));
+  found = pForm->FindPageObjectsInRect(CFX_FloatRect(0, 0, 5, 5));
+  ASSERT_TRUE(found.has_value());
+  EXPECT_TRUE(std::binary_search(found->begin(), found->end(), 399u));
+
+  // So does removing one.
+  std::unique_ptr<CPDF_PageObject> removed =
+      pForm->RemovePageObject(objects[0]);
+  ASSERT_TRUE(removed);
+  removed->SetRect(CFX_FloatRect(300, 300, 310, 310));
+  found = pForm->FindPageObjectsInRect(CFX_FloatRect(0, 0, 5, 5));
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(398u, found->back());
+
+  // Small lists are not indexed.
+  while (pForm->GetPageObjectCount() > 100)
+    pForm->ErasePageObjectAtIndex(0);
+  EXPECT_FALSE(
+      pForm->FindPageObjectsInRect(CFX_FloatRect(0, 0, 5, 5)).has_value());
+}
+
+TEST_F(CPDFPageObjectHolderTest, ParsedPathPoints) {
+  auto pDoc = std::make_unique<CPDF_TestDocument>();
+  pDoc->CreateNewDoc();
+  ByteString content;
+  for (int i = 0; i < 500; ++i)
+    content += "0 0 m 10 10 l 20 0 l h f ";
+  auto pStream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(content.raw_span().begin(),
+                          content.raw_span().end()),
+      pdfium::MakeRetain<CPDF_Dictionary>());
+  auto pForm = std::make_unique<CPDF_Form>(pDoc.get(), nullptr, pStream);
+  pForm->ParseContent();
+  ASSERT_EQ(500u, pForm->GetPageObjectCount());
+
+  // Each path gets its own points, although the parser reuses its buffer.
+  for (size_t i : {0u, 499u}) {
+    const CPDF_Path& path = pForm->GetPageObjectByIndex(i)->AsPath()->path();
+    ASSERT_EQ(4u, path.GetPoints().size());
+    EXPECT_EQ(CFX_PointF(20, 0), path.GetPoint(2));
+    EXPECT_TRUE(path.GetPoints().back().m_CloseFigure);
+  }
+
+  // One buffer per path, plus a few while the scratch buffer grows.
+  const CPDF_PageObjectHolder::ParseAllocationCounts& counts =
+      pForm->GetParseAllocationCounts();
+  EXPECT_EQ(500u, counts.page_objects);
+  EXPECT_GE(counts.path_point_buffers, 501u);
+  EXPECT_LE(counts.path_point_buffers, 505u);
+
+  // Objects added after parsing are not counted.
+  pForm->AppendPageObject(std::make_unique<CPDF_PathObject>());
+  EXPECT_EQ(500u, pForm->GetParseAllocationCounts().page_objects);
+}
@@ -0,0 +1,162 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_pageobjectindex.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "core/fxcrt/fx_system.h"
+#include "third_party/base/cxx17_backports.h"
+
+namespace {
+
+constexpr size_t kRectsPerCell = 4;
+constexpr size_t kMaxCellCount = 256 * 256;
+constexpr int kMaxCellsPerRect = 16;
+
+bool IsFiniteRect(const CFX_FloatRect& rect) {
+  return isfinite(rect.left) && isfinite(rect.right) &&
+         isfinite(rect.bottom) && isfinite(rect.top);
+}
+
+}  // namespace
+
+CPDF_PageObjectIndex::CPDF_PageObjectIndex(
+    pdfium::span<const CFX_FloatRect> rects) {
+  bool has_bounds = false;
+  for (const CFX_FloatRect& rect : rects) {
+    if (!IsFiniteRect(rect))
+      continue;
+    CFX_FloatRect normalized = rect;
+    normalized.Normalize();
+    if (has_bounds) {
+      m_Bounds.Union(normalized);
+    } else {
+      m_Bounds = normalized;
+      has_bounds = true;
+    }
+  }
+  if (!has_bounds)
+    return;
+
+  // Aim for square cells.
+  const size_t cell_count = pdfium::clamp<size_t>(rects.size() / kRectsPerCell,
+                                                  1, kMaxCellCount);
+  const float width = m_Bounds.Width();
+  const float height = m_Bounds.Height();
+  float columns = sqrtf(static_cast<float>(cell_count));
+  if (width > 0 && height > 0)
+    columns = sqrtf(cell_count * width / height);
+  else if (width > 0)
+    columns = cell_count;
+  else if (height > 0)
+    columns = 1;
+  m_Columns = pdfium::clamp<int>(FXSYS_roundf(columns), 1, cell_count);
+  m_Rows = std::max<int>(cell_count / m_Columns, 1);
+
+  // Count the entries of each cell, then fill them in object order so each
+  // cell lists its objects in ascending order.
+  std::vector<CellRange> ranges(rects.size());
+  m_CellStarts.resize(GetCellCount() + 1);
+  for (size_t i = 0; i < rects.size(); ++i) {
+    if (!IsFiniteRect(rects[i])) {
+      m_UnboundedEntries.push_back(static_cast<uint32_t>(i));
+      ranges[i].min_column = -1;
+      continue;
+    }
+    CellRange& range = ranges[i];
+    range = GetCellRange(rects[i]);
+    if ((range.max_column - range.min_column + 1) *
+            (range.max_row - range.min_row + 1) >
+        kMaxCellsPerRect) {
+      m_UnboundedEntries.push_back(static_cast<uint32_t>(i));
+      range.min_column = -1;
+      continue;
+    }
+    for (int row = range.min_row; row <= range.max_row; ++row) {
+      for (int column = range.min_column; column <= range.max_column; ++column)
+        ++m_CellStarts[row * m_Columns + column + 1];
+    }
+  }
+  if (m_UnboundedEntries.size() > rects.size() / 2)
+    return;
+
+  for (size_t i = 1; i < m_CellStarts.size(); ++i)
+    m_CellStarts[i] += m_CellStarts[i - 1];
+  m_CellEntries.resize(m_CellStarts.back());
+  std::vector<uint32_t> cell_ends(m_CellStarts.begin(),
+                                  m_CellStarts.end() - 1);
+  for (size_t i = 0; i < rects.size(); ++i) {
+    const CellRange& range = ranges[i];
+    if (range.min_column < 0)
+      continue;
+    for (int row = range.min_row; row <= range.max_row; ++row) {
+      for (int column = range.min_column; column <= range.max_column;
+           ++column) {
+        m_CellEntries[cell_ends[row * m_Columns + column]++] =
+            static_cast<uint32_t>(i);
+      }
+    }
+  }
+  m_bUseful = true;
+}
+
+CPDF_PageObjectIndex::~CPDF_PageObjectIndex() = default;
+
+absl::optional<std::vector<uint32_t>> CPDF_PageObjectIndex::Find(
+    const CFX_FloatRect& rect) const {
+  if (!m_bUseful || !IsFiniteRect(rect))
+    return absl::nullopt;
+
+  const CellRange range = GetCellRange(rect);
+  const size_t query_cells =
+      static_cast<size_t>(range.max_column - range.min_column + 1) *
+      static_cast<size_t>(range.max_row - range.min_row + 1);
+  if (query_cells > GetCellCount() / 2)
+    return absl::nullopt;
+
+  std::vector<uint32_t> result = m_UnboundedEntries;
+  for (int row = range.min_row; row <= range.max_row; ++row) {
+    const size_t first_cell = row * m_Columns + range.min_column;
+    const size_t last_cell = row * m_Columns + range.max_column;
+    result.insert(result.end(),
+                  m_CellEntries.begin() + m_CellStarts[first_cell],
+                  m_CellEntries.begin() + m_CellStarts[last_cell + 1]);
+  }
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+CPDF_PageObjectIndex::CellRange CPDF_PageObjectIndex::GetCellRange(
+    const CFX_FloatRect& rect) const {
+  CFX_FloatRect normalized = rect;
+  normalized.Normalize();
+  CellRange range;
+  range.min_column =
+      GetCell(normalized.left, m_Bounds.left, m_Bounds.Width(), m_Columns);
+  range.max_column =
+      GetCell(normalized.right, m_Bounds.left, m_Bounds.Width(), m_Columns);
+  range.min_row =
+      GetCell(normalized.bottom, m_Bounds.bottom, m_Bounds.Height(), m_Rows);
+  range.max_row =
+      GetCell(normalized.top, m_Bounds.bottom, m_Bounds.Height(), m_Rows);
+  return range;
+}
+
+// static
+int CPDF_PageObjectIndex::GetCell(float pos, float min, float size, int count) {
+  if (size <= 0)
+    return 0;
+
+  // The mapping only has to be monotonic, so that touching rects share a cell.
+  double cell = (static_cast<double>(pos) - min) * count / size;
+  if (cell < 0)
+    return 0;
+  if (cell >= count)
+    return count - 1;
+  return static_cast<int>(cell);
+}
@@ -0,0 +1,59 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_PAGEOBJECTINDEX_H_
+#define CORE_FPDFAPI_PAGE_CPDF_PAGEOBJECTINDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/base/span.h"
+
+// Uniform grid over the rects of a page object list, so rendering a small
+// part of a page with many objects, such as a zoomed-in tile of a map, does
+// not have to visit every object. Objects spanning many cells, and objects
+// with rects that are not finite, are kept in a separate list that every
+// query returns.
+class CPDF_PageObjectIndex {
+ public:
+  explicit CPDF_PageObjectIndex(pdfium::span<const CFX_FloatRect> rects);
+  ~CPDF_PageObjectIndex();
+
+  // Returns the ascending indexes of the rects that may intersect |rect|,
+  // including rects that only touch it. Callers still need to test each rect.
+  // Returns nullopt when the query would visit most of the rects anyway.
+  absl::optional<std::vector<uint32_t>> Find(const CFX_FloatRect& rect) const;
+
+  size_t GetCellCount() const {
+    return static_cast<size_t>(m_Columns) * static_cast<size_t>(m_Rows);
+  }
+
+ private:
+  struct CellRange {
+    int min_column;
+    int max_column;
+    int min_row;
+    int max_row;
+  };
+
+  CellRange GetCellRange(const CFX_FloatRect& rect) const;
+  static int GetCell(float pos, float min, float size, int count);
+
+  CFX_FloatRect m_Bounds;
+  int m_Columns = 0;
+  int m_Rows = 0;
+  bool m_bUseful = false;
+
+  // Entries of cell i are |m_CellEntries[m_CellStarts[i]]| up to
+  // |m_CellEntries[m_CellStarts[i + 1]]|, in ascending order.
+  std::vector<uint32_t> m_CellStarts;
+  std::vector<uint32_t> m_CellEntries;
+  std::vector<uint32_t> m_UnboundedEntries;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_PAGEOBJECTINDEX_H_
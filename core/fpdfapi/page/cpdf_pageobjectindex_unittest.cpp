@@ -0,0 +1,116 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_pageobjectindex.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// A 20 by 20 grid of 10 by 10 squares, 20 units apart.
+std::vector<CFX_FloatRect> MakeGrid() {
+  std::vector<CFX_FloatRect> rects;
+  for (int row = 0; row < 20; ++row) {
+    for (int column = 0; column < 20; ++column) {
+      rects.emplace_back(column * 20.0f, row * 20.0f, column * 20.0f + 10,
+                         row * 20.0f + 10);
+    }
+  }
+  return rects;
+}
+
+void ExpectFindsIntersecting(const CPDF_PageObjectIndex& index,
+                             const std::vector<CFX_FloatRect>& rects,
+                             const CFX_FloatRect& query) {
+  absl::optional<std::vector<uint32_t>> found = index.Find(query);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_TRUE(std::is_sorted(found->begin(), found->end()));
+  EXPECT_EQ(found->end(), std::adjacent_find(found->begin(), found->end()));
+  for (size_t i = 0; i < rects.size(); ++i) {
+    const CFX_FloatRect& rect = rects[i];
+    if (rect.left > query.right || rect.right < query.left ||
+        rect.bottom > query.top || rect.top < query.bottom) {
+      continue;
+    }
+    EXPECT_TRUE(std::binary_search(found->begin(), found->end(), i)) << i;
+  }
+}
+
+}  // namespace
+
+TEST(CPDF_PageObjectIndex, Find) {
+  const std::vector<CFX_FloatRect> rects = MakeGrid();
+  CPDF_PageObjectIndex index(rects);
+  EXPECT_EQ(100u, index.GetCellCount());
+
+  absl::optional<std::vector<uint32_t>> found =
+      index.Find(CFX_FloatRect(0, 0, 5, 5));
+  ASSERT_TRUE(found.has_value());
+  EXPECT_LE(found->size(), 9u);
+  ASSERT_FALSE(found->empty());
+  EXPECT_EQ(0u, found->front());
+
+  ExpectFindsIntersecting(index, rects, CFX_FloatRect(0, 0, 5, 5));
+  ExpectFindsIntersecting(index, rects, CFX_FloatRect(123, 45, 167, 89));
+  ExpectFindsIntersecting(index, rects, CFX_FloatRect(380, 380, 500, 500));
+  ExpectFindsIntersecting(index, rects, CFX_FloatRect(-50, 100, -10, 140));
+
+  // Rects that only touch the query are still found.
+  ExpectFindsIntersecting(index, rects, CFX_FloatRect(10, 10, 20, 20));
+  found = index.Find(CFX_FloatRect(50, 50, 60, 60));
+  ASSERT_TRUE(found.has_value());
+  EXPECT_TRUE(std::binary_search(found->begin(), found->end(), 2u * 20 + 2));
+
+  // Unnormalized queries behave like normalized ones.
+  EXPECT_EQ(index.Find(CFX_FloatRect(123, 45, 167, 89)),
+            index.Find(CFX_FloatRect(167, 89, 123, 45)));
+}
+
+TEST(CPDF_PageObjectIndex, FindLargeArea) {
+  const std::vector<CFX_FloatRect> rects = MakeGrid();
+  CPDF_PageObjectIndex index(rects);
+  EXPECT_FALSE(index.Find(CFX_FloatRect(0, 0, 400, 400)).has_value());
+  EXPECT_FALSE(
+      index.Find(CFX_FloatRect(-1000, -1000, 1000, 1000)).has_value());
+
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float inf = std::numeric_limits<float>::infinity();
+  EXPECT_FALSE(index.Find(CFX_FloatRect(nan, 0, 10, 10)).has_value());
+  EXPECT_FALSE(index.Find(CFX_FloatRect(0, 0, inf, 10)).has_value());
+}
+
+TEST(CPDF_PageObjectIndex, Unbounded) {
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float inf = std::numeric_limits<float>::infinity();
+  std::vector<CFX_FloatRect> rects = MakeGrid();
+  rects[7] = CFX_FloatRect(nan, nan, nan, nan);
+  rects[300] = CFX_FloatRect(-inf, 0, 10, 10);
+  rects[301] = CFX_FloatRect(0, 0, 390, 390);
+  CPDF_PageObjectIndex index(rects);
+
+  absl::optional<std::vector<uint32_t>> found =
+      index.Find(CFX_FloatRect(200, 200, 205, 205));
+  ASSERT_TRUE(found.has_value());
+  EXPECT_TRUE(std::binary_search(found->begin(), found->end(), 7u));
+  EXPECT_TRUE(std::binary_search(found->begin(), found->end(), 300u));
+  EXPECT_TRUE(std::binary_search(found->begin(), found->end(), 301u));
+  EXPECT_TRUE(std::binary_search(found->begin(), found->end(), 210u));
+  EXPECT_FALSE(std::binary_search(found->begin(), found->end(), 0u));
+}
+
+TEST(CPDF_PageObjectIndex, NotUseful) {
+  // Too many objects cover the whole page for an index to help.
+  std::vector<CFX_FloatRect> rects(100, CFX_FloatRect(0, 0, 100, 100));
+  for (int i = 0; i < 80; ++i)
+    rects.emplace_back(i * 1.25f, 0, i * 1.25f + 1, 1);
+  CPDF_PageObjectIndex index(rects);
+  EXPECT_FALSE(index.Find(CFX_FloatRect(0, 0, 1, 1)).has_value());
+
+  CPDF_PageObjectIndex empty_index({});
+  EXPECT_FALSE(empty_index.Find(CFX_FloatRect(0, 0, 1, 1)).has_value());
+}
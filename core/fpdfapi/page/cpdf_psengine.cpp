@@ -15,9 +15,11 @@
 #include "core/fpdfapi/parser/cpdf_simple_parser.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_string.h"
+#include "core/fxcrt/unowned_ptr.h"
 #include "third_party/base/check.h"
 #include "third_party/base/check_op.h"
 #include "third_party/base/notreached.h"
+#include "third_party/base/ptr_util.h"
 
 namespace {
 
@@ -82,6 +84,158 @@ float RoundHalfUp(float f) {
   return floor(f + 0.5f);
 }
 
+bool IsUnaryOperator(PDF_PSOP op) {
+  switch (op) {
+    case PSOP_NEG:
+    case PSOP_ABS:
+    case PSOP_CEILING:
+    case PSOP_FLOOR:
+    case PSOP_ROUND:
+    case PSOP_TRUNCATE:
+    case PSOP_SQRT:
+    case PSOP_SIN:
+    case PSOP_COS:
+    case PSOP_LN:
+    case PSOP_LOG:
+    case PSOP_CVI:
+    case PSOP_NOT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsBinaryOperator(PDF_PSOP op) {
+  switch (op) {
+    case PSOP_ADD:
+    case PSOP_SUB:
+    case PSOP_MUL:
+    case PSOP_DIV:
+    case PSOP_IDIV:
+    case PSOP_MOD:
+    case PSOP_ATAN:
+    case PSOP_EXP:
+    case PSOP_EQ:
+    case PSOP_NE:
+    case PSOP_GT:
+    case PSOP_GE:
+    case PSOP_LT:
+    case PSOP_LE:
+    case PSOP_AND:
+    case PSOP_OR:
+    case PSOP_XOR:
+    case PSOP_BITSHIFT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the result of a one-operand operator applied to |d1|.
+float ApplyUnaryOperator(PDF_PSOP op, float d1) {
+  switch (op) {
+    case PSOP_NEG:
+      return -d1;
+    case PSOP_ABS:
+      return fabs(d1);
+    case PSOP_CEILING:
+      return ceil(d1);
+    case PSOP_FLOOR:
+      return floor(d1);
+    case PSOP_ROUND:
+      return RoundHalfUp(d1);
+    case PSOP_TRUNCATE:
+    case PSOP_CVI:
+      return static_cast<int>(d1);
+    case PSOP_SQRT:
+      return sqrt(d1);
+    case PSOP_SIN:
+      return sin(d1 * FXSYS_PI / 180.0f);
+    case PSOP_COS:
+      return cos(d1 * FXSYS_PI / 180.0f);
+    case PSOP_LN:
+      return log(d1);
+    case PSOP_LOG:
+      return log10(d1);
+    case PSOP_NOT:
+      return !static_cast<int>(d1);
+    default:
+      NOTREACHED_NORETURN();
+  }
+}
+
+// Returns the result of a two-operand operator, where |d2| is the operand on
+// top of the stack and |d1| the one below it.
+float ApplyBinaryOperator(PDF_PSOP op, float d1, float d2) {
+  FX_SAFE_INT32 result;
+  switch (op) {
+    case PSOP_ADD:
+      return d2 + d1;
+    case PSOP_SUB:
+      return d1 - d2;
+    case PSOP_MUL:
+      return d2 * d1;
+    case PSOP_DIV:
+      return d2 ? d1 / d2 : 0;
+    case PSOP_IDIV: {
+      int i2 = static_cast<int>(d2);
+      if (!i2)
+        return 0;
+      result = static_cast<int>(d1);
+      result /= i2;
+      return result.ValueOrDefault(0);
+    }
+    case PSOP_MOD: {
+      int i2 = static_cast<int>(d2);
+      if (!i2)
+        return 0;
+      result = static_cast<int>(d1);
+      result %= i2;
+      return result.ValueOrDefault(0);
+    }
+    case PSOP_ATAN:
+      d1 = atan2(d1, d2) * 180.0 / FXSYS_PI;
+      if (d1 < 0) {
+        d1 += 360;
+      }
+      return d1;
+    case PSOP_EXP:
+      return powf(d1, d2);
+    case PSOP_EQ:
+      return d1 == d2;
+    case PSOP_NE:
+      return d1 != d2;
+    case PSOP_GT:
+      return d1 > d2;
+    case PSOP_GE:
+      return d1 >= d2;
+    case PSOP_LT:
+      return d1 < d2;
+    case PSOP_LE:
+      return d1 <= d2;
+    case PSOP_AND:
+      return static_cast<int>(d2) & static_cast<int>(d1);
+    case PSOP_OR:
+      return static_cast<int>(d2) | static_cast<int>(d1);
+    case PSOP_XOR:
+      return static_cast<int>(d2) ^ static_cast<int>(d1);
+    case PSOP_BITSHIFT: {
+      int shift = static_cast<int>(d2);
+      result = static_cast<int>(d1);
+      if (shift > 0) {
+        result <<= shift;
+      } else {
+        // Avoids unsafe negation of INT_MIN.
+        FX_SAFE_INT32 safe_shift = shift;
+        result >>= (-safe_shift).ValueOrDefault(0);
+      }
+      return result.ValueOrDefault(0);
+    }
+    default:
+      NOTREACHED_NORETURN();
+  }
+}
+
 }  // namespace
 
 CPDF_PSOP::CPDF_PSOP()
@@ -214,180 +368,20 @@ bool CPDF_PSEngine::Parse(pdfium::span<const uint8_t> input) {
 }
 
 bool CPDF_PSEngine::DoOperator(PDF_PSOP op) {
-  int i1;
-  int i2;
+  if (IsUnaryOperator(op)) {
+    Push(ApplyUnaryOperator(op, Pop()));
+    return true;
+  }
+  if (IsBinaryOperator(op)) {
+    float d2 = Pop();
+    float d1 = Pop();
+    Push(ApplyBinaryOperator(op, d1, d2));
+    return true;
+  }
+
   float d1;
   float d2;
-  FX_SAFE_INT32 result;
   switch (op) {
-    case PSOP_ADD:
-      d1 = Pop();
-      d2 = Pop();
-      Push(d1 + d2);
-      break;
-    case PSOP_SUB:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 - d2);
-      break;
-    case PSOP_MUL:
-      d1 = Pop();
-      d2 = Pop();
-      Push(d1 * d2);
-      break;
-    case PSOP_DIV:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d2 ? d1 / d2 : 0);
-      break;
-    case PSOP_IDIV:
-      i2 = PopInt();
-      i1 = PopInt();
-      if (i2) {
-        result = i1;
-        result /= i2;
-        Push(result.ValueOrDefault(0));
-      } else {
-        Push(0);
-      }
-      break;
-    case PSOP_MOD:
-      i2 = PopInt();
-      i1 = PopInt();
-      if (i2) {
-        result = i1;
-        result %= i2;
-        Push(result.ValueOrDefault(0));
-      } else {
-        Push(0);
-      }
-      break;
-    case PSOP_NEG:
-      d1 = Pop();
-      Push(-d1);
-      break;
-    case PSOP_ABS:
-      d1 = Pop();
-      Push(fabs(d1));
-      break;
-    case PSOP_CEILING:
-      d1 = Pop();
-      Push(ceil(d1));
-      break;
-    case PSOP_FLOOR:
-      d1 = Pop();
-      Push(floor(d1));
-      break;
-    case PSOP_ROUND:
-      d1 = Pop();
-      Push(RoundHalfUp(d1));
-      break;
-    case PSOP_TRUNCATE:
-      i1 = PopInt();
-      Push(i1);
-      break;
-    case PSOP_SQRT:
-      d1 = Pop();
-      Push(sqrt(d1));
-      break;
-    case PSOP_SIN:
-      d1 = Pop();
-      Push(sin(d1 * FXSYS_PI / 180.0f));
-      break;
-    case PSOP_COS:
-      d1 = Pop();
-      Push(cos(d1 * FXSYS_PI / 180.0f));
-      break;
-    case PSOP_ATAN:
-      d2 = Pop();
-      d1 = Pop();
-      d1 = atan2(d1, d2) * 180.0 / FXSYS_PI;
-      if (d1 < 0) {
-        d1 += 360;
-      }
-      Push(d1);
-      break;
-    case PSOP_EXP:
-      d2 = Pop();
-      d1 = Pop();
-      Push(powf(d1, d2));
-      break;
-    case PSOP_LN:
-      d1 = Pop();
-      Push(log(d1));
-      break;
-    case PSOP_LOG:
-      d1 = Pop();
-      Push(log10(d1));
-      break;
-    case PSOP_CVI:
-      i1 = PopInt();
-      Push(i1);
-      break;
-    case PSOP_CVR:
-      break;
-    case PSOP_EQ:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 == d2);
-      break;
-    case PSOP_NE:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 != d2);
-      break;
-    case PSOP_GT:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 > d2);
-      break;
-    case PSOP_GE:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 >= d2);
-      break;
-    case PSOP_LT:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 < d2);
-      break;
-    case PSOP_LE:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 <= d2);
-      break;
-    case PSOP_AND:
-      i1 = PopInt();
-      i2 = PopInt();
-      Push(i1 & i2);
-      break;
-    case PSOP_OR:
-      i1 = PopInt();
-      i2 = PopInt();
-      Push(i1 | i2);
-      break;
-    case PSOP_XOR:
-      i1 = PopInt();
-      i2 = PopInt();
-      Push(i1 ^ i2);
-      break;
-    case PSOP_NOT:
-      i1 = PopInt();
-      Push(!i1);
-      break;
-    case PSOP_BITSHIFT: {
-      int shift = PopInt();
-      result = PopInt();
-      if (shift > 0) {
-        result <<= shift;
-      } else {
-        // Avoids unsafe negation of INT_MIN.
-        FX_SAFE_INT32 safe_shift = shift;
-        result >>= (-safe_shift).ValueOrDefault(0);
-      }
-      Push(result.ValueOrDefault(0));
-      break;
-    }
     case PSOP_TRUE:
       Push(1);
       break;
@@ -447,3 +441,412 @@ bool CPDF_PSEngine::DoOperator(PDF_PSOP op) {
   }
   return true;
 }
+
+// Compiles a procedure by running it on an abstract stack that only tracks
+// which entries hold known constants. The entry at stack position N lives in
+// register N; constants get written to their register only once an
+// instruction needs them there.
+class CPDF_PSProgram::Compiler {
+ public:
+  explicit Compiler(CPDF_PSProgram* program) : m_pProgram(program) {}
+
+  void Start() {
+    m_pProgram->m_nLoadedInputs =
+        std::min(m_pProgram->m_nInputs, CPDF_PSEngine::kPSEngineStackSize);
+    for (uint32_t i = 0; i < m_pProgram->m_nLoadedInputs; ++i)
+      Push(Entry::Runtime());
+  }
+
+  bool Finish() {
+    const uint32_t nOutputs = m_pProgram->m_nOutputs;
+    if (m_Stack.size() < nOutputs)
+      return false;
+
+    m_pProgram->m_FirstOutput =
+        static_cast<uint32_t>(m_Stack.size()) - nOutputs;
+    for (size_t i = m_pProgram->m_FirstOutput; i < m_Stack.size(); ++i)
+      Materialize(i);
+    return true;
+  }
+
+  // Returns false if the stack layout after |proc| is not known statically.
+  bool CompileProc(const CPDF_PSProc& proc) {
+    pdfium::span<const std::unique_ptr<CPDF_PSOP>> ops = proc.operators();
+    for (size_t i = 0; i < ops.size(); ++i) {
+      const PDF_PSOP op = ops[i]->GetOp();
+      if (op == PSOP_PROC)
+        continue;
+
+      if (op == PSOP_CONST) {
+        Push(Entry::Const(ops[i]->GetFloatValue()));
+        continue;
+      }
+
+      bool ok;
+      if (op == PSOP_IF) {
+        // Like CPDF_PSProc::Execute(), a malformed "if" ends the procedure.
+        if (i == 0 || ops[i - 1]->GetOp() != PSOP_PROC)
+          return true;
+
+        ok = CompileBranch(ops[i - 1]->GetProc(), nullptr);
+      } else if (op == PSOP_IFELSE) {
+        if (i < 2 || ops[i - 1]->GetOp() != PSOP_PROC ||
+            ops[i - 2]->GetOp() != PSOP_PROC) {
+          return true;
+        }
+        ok = CompileBranch(ops[i - 2]->GetProc(), ops[i - 1]->GetProc());
+      } else {
+        ok = CompileOperator(op);
+      }
+      if (!ok)
+        return false;
+    }
+    return true;
+  }
+
+ private:
+  struct Entry {
+    static Entry Const(float value) { return {true, value}; }
+    static Entry Runtime() { return {false, 0}; }
+
+    bool is_const;
+    float value;
+  };
+
+  // Same as CPDF_PSEngine::Push(), which drops values once the stack is full.
+  void Push(Entry entry) {
+    if (m_Stack.size() >= CPDF_PSEngine::kPSEngineStackSize)
+      return;
+
+    m_Stack.push_back(entry);
+    m_pProgram->m_nRegisters = std::max(
+        m_pProgram->m_nRegisters, static_cast<uint32_t>(m_Stack.size()));
+  }
+
+  // Same as CPDF_PSEngine::Pop(), which yields 0 once the stack is empty.
+  Entry Pop() {
+    if (m_Stack.empty())
+      return Entry::Const(0);
+
+    Entry entry = m_Stack.back();
+    m_Stack.pop_back();
+    return entry;
+  }
+
+  bool PopConstInt(int* value) {
+    Entry entry = Pop();
+    if (!entry.is_const)
+      return false;
+
+    *value = static_cast<int>(entry.value);
+    return true;
+  }
+
+  size_t Emit(Code code, PDF_PSOP op, size_t dst, size_t a, size_t b) {
+    Instruction instruction = {};
+    instruction.code = code;
+    instruction.op = op;
+    instruction.dst = static_cast<uint8_t>(dst);
+    instruction.a = static_cast<uint8_t>(a);
+    instruction.b = static_cast<uint8_t>(b);
+    m_pProgram->m_Code.push_back(instruction);
+    return m_pProgram->m_Code.size() - 1;
+  }
+
+  void Materialize(size_t slot) {
+    if (!m_Stack[slot].is_const)
+      return;
+
+    size_t index = Emit(Code::kConst, PSOP_CONST, slot, 0, 0);
+    m_pProgram->m_Code[index].value = m_Stack[slot].value;
+    m_Stack[slot] = Entry::Runtime();
+  }
+
+  void MaterializeAll() {
+    for (size_t i = 0; i < m_Stack.size(); ++i)
+      Materialize(i);
+  }
+
+  bool AllConst(size_t count) const {
+    DCHECK_LE(count, m_Stack.size());
+    return std::all_of(m_Stack.end() - count, m_Stack.end(),
+                       [](const Entry& entry) { return entry.is_const; });
+  }
+
+  // Compiles "{then} if" when |else_proc| is null, "{then} {else} ifelse"
+  // otherwise.
+  bool CompileBranch(const CPDF_PSProc* then_proc,
+                     const CPDF_PSProc* else_proc) {
+    if (m_Stack.empty() || m_Stack.back().is_const) {
+      int condition;
+      PopConstInt(&condition);
+      if (condition)
+        return CompileProc(*then_proc);
+      return !else_proc || CompileProc(*else_proc);
+    }
+
+    // Both paths have to leave every value in its register.
+    MaterializeAll();
+    m_Stack.pop_back();
+    m_pProgram->m_bHasBranches = true;
+    const size_t skip_then = Emit(Code::kJumpIfZero, PSOP_IF, 0,
+                                  m_Stack.size(), 0);
+    const size_t depth = m_Stack.size();
+    if (!CompileProc(*then_proc))
+      return false;
+
+    MaterializeAll();
+    if (!else_proc) {
+      m_pProgram->m_Code[skip_then].target = m_pProgram->m_Code.size();
+      return m_Stack.size() == depth;
+    }
+
+    const size_t then_depth = m_Stack.size();
+    const size_t skip_else = Emit(Code::kJump, PSOP_IFELSE, 0, 0, 0);
+    m_pProgram->m_Code[skip_then].target = m_pProgram->m_Code.size();
+    m_Stack.assign(depth, Entry::Runtime());
+    if (!CompileProc(*else_proc))
+      return false;
+
+    MaterializeAll();
+    m_pProgram->m_Code[skip_else].target = m_pProgram->m_Code.size();
+    return m_Stack.size() == then_depth;
+  }
+
+  bool CompileOperator(PDF_PSOP op) {
+    const size_t depth = m_Stack.size();
+    if (IsUnaryOperator(op)) {
+      if (depth >= 1 && !AllConst(1)) {
+        Emit(Code::kUnary, op, depth - 1, depth - 1, 0);
+        return true;
+      }
+      Push(Entry::Const(ApplyUnaryOperator(op, Pop().value)));
+      return true;
+    }
+
+    if (IsBinaryOperator(op)) {
+      if (depth >= 2 && !AllConst(2)) {
+        Materialize(depth - 2);
+        Materialize(depth - 1);
+        Emit(Code::kBinary, op, depth - 2, depth - 2, depth - 1);
+        m_Stack.pop_back();
+        return true;
+      }
+      if (!AllConst(std::min<size_t>(depth, 2)))
+        return false;
+
+      float d2 = Pop().value;
+      float d1 = Pop().value;
+      Push(Entry::Const(ApplyBinaryOperator(op, d1, d2)));
+      return true;
+    }
+
+    switch (op) {
+      case PSOP_TRUE:
+        Push(Entry::Const(1));
+        return true;
+      case PSOP_FALSE:
+        Push(Entry::Const(0));
+        return true;
+      case PSOP_POP:
+        Pop();
+        return true;
+      case PSOP_EXCH: {
+        if (depth >= 2 && !AllConst(2)) {
+          Materialize(depth - 2);
+          Materialize(depth - 1);
+          Emit(Code::kExch, op, 0, depth - 2, depth - 1);
+          return true;
+        }
+        if (!AllConst(std::min<size_t>(depth, 2)))
+          return false;
+
+        Entry d2 = Pop();
+        Entry d1 = Pop();
+        Push(d2);
+        Push(d1);
+        return true;
+      }
+      case PSOP_DUP: {
+        if (depth >= 1 && !AllConst(1)) {
+          if (depth < CPDF_PSEngine::kPSEngineStackSize) {
+            Emit(Code::kMove, op, depth, depth - 1, 0);
+            Push(Entry::Runtime());
+          }
+          return true;
+        }
+        Entry d1 = Pop();
+        Push(d1);
+        Push(d1);
+        return true;
+      }
+      case PSOP_COPY: {
+        int n;
+        if (!PopConstInt(&n))
+          return false;
+
+        const size_t count = m_Stack.size();
+        if (n < 0 || count + n > CPDF_PSEngine::kPSEngineStackSize ||
+            n > static_cast<int>(count)) {
+          return true;
+        }
+        for (size_t i = count - n; i < count; ++i)
+          CopyToTop(i);
+        return true;
+      }
+      case PSOP_INDEX: {
+        int n;
+        if (!PopConstInt(&n))
+          return false;
+
+        const size_t count = m_Stack.size();
+        if (n < 0 || n >= static_cast<int>(count))
+          return true;
+
+        CopyToTop(count - n - 1);
+        return true;
+      }
+      case PSOP_ROLL: {
+        int j;
+        int n;
+        if (!PopConstInt(&j) || !PopConstInt(&n))
+          return false;
+
+        const size_t count = m_Stack.size();
+        if (j == 0 || n == 0 || count == 0)
+          return true;
+        if (n < 0 || n > static_cast<int>(count))
+          return true;
+
+        j %= n;
+        if (j > 0)
+          j -= n;
+        if (j == 0)
+          return true;
+
+        auto begin_it = m_Stack.end() - n;
+        if (!AllConst(n)) {
+          for (size_t i = count - n; i < count; ++i)
+            Materialize(i);
+          size_t index = Emit(Code::kRoll, op, 0, count - n, n);
+          m_pProgram->m_Code[index].shift = -j;
+        }
+        std::rotate(begin_it, begin_it - j, m_Stack.end());
+        return true;
+      }
+      default:
+        return true;
+    }
+  }
+
+  // Pushes a copy of the entry at |slot|.
+  void CopyToTop(size_t slot) {
+    if (m_Stack.size() >= CPDF_PSEngine::kPSEngineStackSize)
+      return;
+
+    if (!m_Stack[slot].is_const)
+      Emit(Code::kMove, PSOP_CONST, m_Stack.size(), slot, 0);
+    Push(m_Stack[slot]);
+  }
+
+  UnownedPtr<CPDF_PSProgram> const m_pProgram;
+  std::vector<Entry> m_Stack;
+};
+
+// static
+std::unique_ptr<CPDF_PSProgram> CPDF_PSProgram::Compile(
+    const CPDF_PSProc& proc,
+    uint32_t nInputs,
+    uint32_t nOutputs) {
+  // Outputs are read from registers, which fit in the engine's stack.
+  if (nOutputs > CPDF_PSEngine::kPSEngineStackSize)
+    return nullptr;
+
+  auto program = pdfium::WrapUnique(new CPDF_PSProgram());
+  program->m_nInputs = nInputs;
+  program->m_nOutputs = nOutputs;
+  Compiler compiler(program.get());
+  compiler.Start();
+  if (!compiler.CompileProc(proc) || !compiler.Finish())
+    return nullptr;
+  return program;
+}
+
+CPDF_PSProgram::CPDF_PSProgram() = default;
+
+CPDF_PSProgram::~CPDF_PSProgram() = default;
+
+void CPDF_PSProgram::Run(pdfium::span<const float> inputs,
+                         size_t count,
+                         pdfium::span<float> results) const {
+  // Branches are taken per set of inputs, so those programs run one set at a
+  // time. Otherwise each register holds one value per set.
+  static constexpr size_t kMaxLanes = 64;
+  const size_t stride = m_bHasBranches ? 1 : std::min(count, kMaxLanes);
+  m_Registers.resize(std::max<size_t>(m_nRegisters, 1) * stride);
+  float* registers = m_Registers.data();
+  for (size_t base = 0; base < count; base += stride) {
+    const size_t lanes = std::min(stride, count - base);
+    for (uint32_t i = 0; i < m_nLoadedInputs; ++i) {
+      float* reg = registers + i * stride;
+      for (size_t lane = 0; lane < lanes; ++lane)
+        reg[lane] = inputs[(base + lane) * m_nInputs + i];
+    }
+    Execute(registers, stride, lanes);
+    for (uint32_t i = 0; i < m_nOutputs; ++i) {
+      const float* reg = registers + (m_FirstOutput + i) * stride;
+      for (size_t lane = 0; lane < lanes; ++lane)
+        results[(base + lane) * m_nOutputs + i] = reg[lane];
+    }
+  }
+}
+
+void CPDF_PSProgram::Execute(float* registers,
+                             size_t stride,
+                             size_t lanes) const {
+  size_t pc = 0;
+  while (pc < m_Code.size()) {
+    const Instruction& instruction = m_Code[pc++];
+    float* dst = registers + instruction.dst * stride;
+    float* a = registers + instruction.a * stride;
+    float* b = registers + instruction.b * stride;
+    switch (instruction.code) {
+      case Code::kConst:
+        std::fill_n(dst, lanes, instruction.value);
+        break;
+      case Code::kMove:
+        std::copy_n(a, lanes, dst);
+        break;
+      case Code::kExch:
+        std::swap_ranges(a, a + lanes, b);
+        break;
+      case Code::kRoll:
+        for (size_t lane = 0; lane < lanes; ++lane) {
+          float values[CPDF_PSEngine::kPSEngineStackSize];
+          for (size_t i = 0; i < instruction.b; ++i)
+            values[i] = a[i * stride + lane];
+          std::rotate(values, values + instruction.shift,
+                      values + instruction.b);
+          for (size_t i = 0; i < instruction.b; ++i)
+            a[i * stride + lane] = values[i];
+        }
+        break;
+      case Code::kUnary:
+        for (size_t lane = 0; lane < lanes; ++lane)
+          dst[lane] = ApplyUnaryOperator(instruction.op, a[lane]);
+        break;
+      case Code::kBinary:
+        for (size_t lane = 0; lane < lanes; ++lane)
+          dst[lane] = ApplyBinaryOperator(instruction.op, a[lane], b[lane]);
+        break;
+      case Code::kJumpIfZero:
+        DCHECK_EQ(lanes, 1u);
+        if (!static_cast<int>(a[0]))
+          pc = instruction.target;
+        break;
+      case Code::kJump:
+        pc = instruction.target;
+        break;
+    }
+  }
+}
@@ -78,6 +78,7 @@ class CPDF_PSOP {
   void Execute(CPDF_PSEngine* pEngine);
   float GetFloatValue() const;
   PDF_PSOP GetOp() const { return m_op; }
+  const CPDF_PSProc* GetProc() const { return m_proc.get(); }
 
  private:
   const PDF_PSOP m_op;
@@ -92,6 +93,9 @@ class CPDF_PSProc {
 
   bool Parse(CPDF_SimpleParser* parser, int depth);
   bool Execute(CPDF_PSEngine* pEngine);
+  pdfium::span<const std::unique_ptr<CPDF_PSOP>> operators() const {
+    return m_Operators;
+  }
 
   // These methods are exposed for testing.
   void AddOperatorForTesting(ByteStringView word);
@@ -121,13 +125,80 @@ class CPDF_PSEngine {
   float Pop();
   int PopInt();
   uint32_t GetStackSize() const { return m_StackCount; }
+  const CPDF_PSProc& GetMainProc() const { return m_MainProc; }
 
- private:
   static constexpr uint32_t kPSEngineStackSize = 100;
 
+ private:
   uint32_t m_StackCount = 0;
   CPDF_PSProc m_MainProc;
   float m_Stack[kPSEngineStackSize] = {};
 };
 
+// A CPDF_PSProc lowered into flat code for a fixed number of inputs. The
+// stack depth at every instruction is worked out at compile time, so each
+// stack slot becomes a register and no bounds checks are left at run time.
+// Operators whose operands are all constants are folded, and the procedures
+// run by "if" and "ifelse" become jumps. Running the program gives exactly
+// the same results as executing the procedure on a CPDF_PSEngine.
+class CPDF_PSProgram {
+ public:
+  // Returns nullptr if the stack layout of |proc| depends on its inputs, e.g.
+  // for a computed "copy" count or "ifelse" branches of different depths, or
+  // if it leaves fewer than |nOutputs| values on the stack.
+  static std::unique_ptr<CPDF_PSProgram> Compile(const CPDF_PSProc& proc,
+                                                 uint32_t nInputs,
+                                                 uint32_t nOutputs);
+
+  ~CPDF_PSProgram();
+
+  // Evaluates |count| sets of inputs, like pushing each set onto a fresh
+  // CPDF_PSEngine, executing the procedure and popping the results. Programs
+  // without branches evaluate many sets per instruction.
+  void Run(pdfium::span<const float> inputs,
+           size_t count,
+           pdfium::span<float> results) const;
+
+  size_t num_instructions() const { return m_Code.size(); }
+  bool has_branches() const { return m_bHasBranches; }
+
+ private:
+  class Compiler;
+
+  enum class Code : uint8_t {
+    kConst,       // dst = value
+    kMove,        // dst = a
+    kExch,        // swap(a, b)
+    kRoll,        // rotate |b| registers from |a| by |shift|
+    kUnary,       // dst = op(a)
+    kBinary,      // dst = op(a, b)
+    kJumpIfZero,  // if (!int(a)) goto target
+    kJump,        // goto target
+  };
+
+  struct Instruction {
+    Code code;
+    PDF_PSOP op;
+    uint8_t dst;
+    uint8_t a;
+    uint8_t b;
+    int shift;
+    float value;
+    uint32_t target;
+  };
+
+  CPDF_PSProgram();
+
+  void Execute(float* registers, size_t stride, size_t lanes) const;
+
+  std::vector<Instruction> m_Code;
+  uint32_t m_nInputs = 0;
+  uint32_t m_nOutputs = 0;
+  uint32_t m_nLoadedInputs = 0;
+  uint32_t m_nRegisters = 0;
+  uint32_t m_FirstOutput = 0;
+  bool m_bHasBranches = false;
+  mutable std::vector<float> m_Registers;  // Scratch space for Run().
+};
+
 #endif  // CORE_FPDFAPI_PAGE_CPDF_PSENGINE_H_
@@ -4,9 +4,14 @@
 
 #include "core/fpdfapi/page/cpdf_psengine.h"
 
+#include <math.h>
+
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <vector>
 
+#include "core/fxcrt/bytestring.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace {
@@ -38,6 +43,62 @@ float DoOperator2(CPDF_PSEngine* engine, float v1, float v2, PDF_PSOP op) {
   return ret;
 }
 
+void ExpectSameFloat(float expected, float actual) {
+  if (isnan(expected))
+    EXPECT_TRUE(isnan(actual));
+  else
+    EXPECT_EQ(expected, actual);
+}
+
+std::unique_ptr<CPDF_PSProgram> Compile(CPDF_PSEngine* engine,
+                                        const char* source,
+                                        uint32_t nInputs,
+                                        uint32_t nOutputs) {
+  EXPECT_TRUE(engine->Parse(ByteStringView(source).raw_span()));
+  return CPDF_PSProgram::Compile(engine->GetMainProc(), nInputs, nOutputs);
+}
+
+// Checks |program| against the interpreter for every value in |values|,
+// broadcast to all |nInputs| inputs after scaling input i by (i + 1).
+void CheckCompiledMatchesEngine(const char* source,
+                                uint32_t nInputs,
+                                uint32_t nOutputs,
+                                const std::vector<float>& values) {
+  SCOPED_TRACE(source);
+  CPDF_PSEngine engine;
+  std::unique_ptr<CPDF_PSProgram> program =
+      Compile(&engine, source, nInputs, nOutputs);
+  ASSERT_TRUE(program);
+
+  std::vector<float> inputs;
+  std::vector<float> expected;
+  for (float value : values) {
+    engine.Reset();
+    for (uint32_t i = 0; i < nInputs; ++i) {
+      inputs.push_back(value * (i + 1));
+      engine.Push(inputs.back());
+    }
+    engine.Execute();
+    ASSERT_GE(engine.GetStackSize(), nOutputs);
+    expected.resize(expected.size() + nOutputs);
+    for (uint32_t i = 0; i < nOutputs; ++i)
+      expected[expected.size() - i - 1] = engine.Pop();
+  }
+
+  std::vector<float> results(expected.size());
+  program->Run(inputs, values.size(), results);
+  for (size_t i = 0; i < expected.size(); ++i)
+    ExpectSameFloat(expected[i], results[i]);
+
+  std::vector<float> single(nOutputs);
+  for (size_t n = 0; n < values.size(); ++n) {
+    program->Run(pdfium::make_span(inputs).subspan(n * nInputs, nInputs), 1,
+                 single);
+    for (uint32_t i = 0; i < nOutputs; ++i)
+      ExpectSameFloat(expected[n * nOutputs + i], single[i]);
+  }
+}
+
 }  // namespace
 
 TEST(CPDF_PSProc, AddOperator) {
@@ -281,3 +342,74 @@ TEST(CPDF_PSEngine, MathFunctions) {
   EXPECT_FLOAT_EQ(3.0f, DoOperator1(&engine, 1000.0f, PSOP_LOG));
   EXPECT_FLOAT_EQ(2.302585f, DoOperator1(&engine, 10.0f, PSOP_LN));
 }
+
+TEST(CPDF_PSProgram, MatchesEngine) {
+  std::vector<float> values;
+  for (int i = -100; i <= 100; ++i)
+    values.push_back(i * 0.37f);
+
+  static const char* const kStraightLine[] = {
+      "{ 2 mul 1 add }",
+      "{ dup mul exch sqrt }",
+      "{ 1 255 div mul 0.5 exch sub abs }",
+      "{ 3 1 roll exch 2 index add }",
+      "{ 2 copy add 3 1 roll sub mul }",
+      "{ dup 0 gt exch 10 lt and }",
+      "{ 4 2 roll 1 index ne cvi }",
+      "{ atan dup cos exch sin }",
+      "{ 7 idiv 3 mod neg truncate round floor ceiling }",
+      "{ true false or not 4 bitshift 2 exp ln log add }",
+      "{ pop pop pop add 1 }",
+      "{ exch }",
+  };
+  for (const char* source : kStraightLine) {
+    CheckCompiledMatchesEngine(source, 2, 1, values);
+    CheckCompiledMatchesEngine(source, 3, 2, values);
+  }
+
+  static const char* const kBranches[] = {
+      "{ dup 0 lt { neg } if }",
+      "{ 0 gt { 1 } { 2 } ifelse 3 mul }",
+      "{ dup 5 gt { dup 10 gt { 2 mul } { 3 mul } ifelse } if }",
+      "{ true { 1 add } { 1 sub } ifelse }",
+      "{ 1 { pop 4 } if }",
+      "{ dup { 1 add if } if }",
+  };
+  for (const char* source : kBranches) {
+    CheckCompiledMatchesEngine(source, 1, 1, values);
+    CheckCompiledMatchesEngine(source, 2, 2, values);
+  }
+}
+
+TEST(CPDF_PSProgram, FoldsConstants) {
+  CPDF_PSEngine engine;
+  std::unique_ptr<CPDF_PSProgram> program =
+      Compile(&engine, "{ 1 255 div 2 3 exch sub mul true { 4 } if }", 0, 2);
+  ASSERT_TRUE(program);
+  EXPECT_EQ(2u, program->num_instructions());
+  EXPECT_FALSE(program->has_branches());
+
+  float results[2];
+  program->Run({}, 1, results);
+  EXPECT_FLOAT_EQ(1.0f / 255, results[0]);
+  EXPECT_FLOAT_EQ(4.0f, results[1]);
+}
+
+TEST(CPDF_PSProgram, DynamicStackLayout) {
+  static const char* const kSources[] = {
+      // Computed copy, index and roll counts.
+      "{ dup copy }",
+      "{ 0 index index }",
+      "{ 2 exch roll }",
+      // Branches that leave different amounts on the stack.
+      "{ dup 0 gt { dup } if }",
+      "{ dup 0 gt { 1 2 } { 3 } ifelse }",
+      // Too few results.
+      "{ pop }",
+  };
+  for (const char* source : kSources) {
+    SCOPED_TRACE(source);
+    CPDF_PSEngine engine;
+    EXPECT_FALSE(Compile(&engine, source, 1, 1));
+  }
+}
@@ -17,11 +17,21 @@ bool CPDF_PSFunc::v_Init(const CPDF_Object* pObj, VisitedSet* pVisited) {
   auto pAcc =
       pdfium::MakeRetain<CPDF_StreamAcc>(pdfium::WrapRetain(pObj->AsStream()));
   pAcc->LoadAllDataFiltered();
-  return m_PS.Parse(pAcc->GetSpan());
+  if (!m_PS.Parse(pAcc->GetSpan()))
+    return false;
+
+  m_pProgram =
+      CPDF_PSProgram::Compile(m_PS.GetMainProc(), m_nInputs, m_nOutputs);
+  return true;
 }
 
 bool CPDF_PSFunc::v_Call(pdfium::span<const float> inputs,
                          pdfium::span<float> results) const {
+  if (m_pProgram) {
+    m_pProgram->Run(inputs, 1, results);
+    return true;
+  }
+
   m_PS.Reset();
   for (uint32_t i = 0; i < m_nInputs; i++)
     m_PS.Push(inputs[i]);
@@ -32,3 +42,13 @@ bool CPDF_PSFunc::v_Call(pdfium::span<const float> inputs,
     results[m_nOutputs - i - 1] = m_PS.Pop();
   return true;
 }
+
+bool CPDF_PSFunc::v_CallBatch(pdfium::span<const float> inputs,
+                              size_t count,
+                              pdfium::span<float> results) const {
+  if (!m_pProgram)
+    return CPDF_Function::v_CallBatch(inputs, count, results);
+
+  m_pProgram->Run(inputs, count, results);
+  return true;
+}
@@ -34,6 +34,9 @@ class CPDF_SampledFunc final : public CPDF_Function {
   bool v_Init(const CPDF_Object* pObj, VisitedSet* pVisited) override;
   bool v_Call(pdfium::span<const float> inputs,
               pdfium::span<float> results) const override;
+  bool v_CallBatch(pdfium::span<const float> inputs,
+                   size_t count,
+                   pdfium::span<float> results) const override;
 
   const std::vector<SampleEncodeInfo>& GetEncodeInfo() const {
     return m_EncodeInfo;
@@ -50,6 +53,10 @@ class CPDF_SampledFunc final : public CPDF_Function {
   uint32_t m_nBitsPerSample = 0;
   uint32_t m_SampleMax = 0;
   RetainPtr<CPDF_StreamAcc> m_pSampleStream;
+
+  // The samples unpacked from |m_pSampleStream|, if the table is small enough
+  // to be worth unpacking. Used by v_CallBatch().
+  std::vector<float> m_DecodedSamples;
 };
 
 #endif  // CORE_FPDFAPI_PAGE_CPDF_SAMPLEDFUNC_H_
@@ -120,3 +120,42 @@ bool CPDF_StitchFunc::v_Call(pdfium::span<const float> inputs,
       ->Call(pdfium::make_span(&input, 1), results)
       .has_value();
 }
+
+bool CPDF_StitchFunc::v_CallBatch(pdfium::span<const float> inputs,
+                                  size_t count,
+                                  pdfium::span<float> results) const {
+  // Encode every input for its sub-function, then hand each run of inputs
+  // that share a sub-function to that sub-function in one batch. Shadings
+  // sample their domain in order, so runs are long.
+  std::vector<float> encoded(count);
+  std::vector<size_t> sub_index(count);
+  for (size_t n = 0; n < count; n++) {
+    float input = inputs[n];
+    size_t i;
+    for (i = 0; i < m_pSubFunctions.size() - 1; i++) {
+      if (input < m_bounds[i + 1])
+        break;
+    }
+    encoded[n] = Interpolate(input, m_bounds[i], m_bounds[i + 1],
+                             m_encode[i * 2], m_encode[i * 2 + 1]);
+    sub_index[n] = i;
+  }
+  size_t run_start = 0;
+  while (run_start < count) {
+    const size_t i = sub_index[run_start];
+    size_t run_end = run_start + 1;
+    while (run_end < count && sub_index[run_end] == i)
+      run_end++;
+
+    pdfium::span<const float> run_inputs =
+        pdfium::make_span(encoded).subspan(run_start, run_end - run_start);
+    pdfium::span<float> run_results =
+        results.subspan(run_start * m_nOutputs,
+                        (run_end - run_start) * m_nOutputs);
+    if (!m_pSubFunctions[i]->CallBatch(run_inputs, run_results).has_value())
+      return false;
+
+    run_start = run_end;
+  }
+  return true;
+}
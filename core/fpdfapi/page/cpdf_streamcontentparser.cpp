@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -43,7 +44,6 @@
 #include "core/fxge/cfx_graphstatedata.h"
 #include "third_party/base/check.h"
 #include "third_party/base/containers/contains.h"
-#include "third_party/base/no_destructor.h"
 #include "third_party/base/notreached.h"
 #include "third_party/base/span.h"
 
@@ -250,7 +250,7 @@ CPDF_StreamContentParser::CPDF_StreamContentParser(
     RetainPtr<CPDF_Dictionary> pResources,
     const CFX_FloatRect& rcBBox,
     const CPDF_AllStates* pStates,
-    std::set<const uint8_t*>* pParsedSet)
+    CPDF_Form::RecursionState* recursion_state)
     : m_pDocument(pDocument),
       m_pPageResources(pPageResources),
       m_pParentResources(pParentResources),
@@ -258,7 +258,7 @@ CPDF_StreamContentParser::CPDF_StreamContentParser(
                                                   pParentResources.Get(),
                                                   pPageResources.Get())),
       m_pObjectHolder(pObjHolder),
-      m_ParsedSet(pParsedSet),
+      m_RecursionState(recursion_state),
       m_BBox(rcBBox),
       m_pCurStates(std::make_unique<CPDF_AllStates>()) {
   if (pmtContentToUser)
@@ -286,9 +286,6 @@ int CPDF_StreamContentParser::GetNextParamPos() {
     if (m_ParamStartPos == kParamBufSize) {
       m_ParamStartPos = 0;
     }
-    if (m_ParamBuf[m_ParamStartPos].m_Type == ContentParam::Type::kObject)
-      m_ParamBuf[m_ParamStartPos].m_pObject.Reset();
-
     return m_ParamStartPos;
   }
   int index = m_ParamStartPos + m_ParamCount;
@@ -301,27 +298,32 @@ int CPDF_StreamContentParser::GetNextParamPos() {
 
 void CPDF_StreamContentParser::AddNameParam(ByteStringView bsName) {
   ContentParam& param = m_ParamBuf[GetNextParamPos()];
-  param.m_Type = ContentParam::Type::kName;
-  param.m_Name = PDF_NameDecode(bsName);
+  if (bsName.GetLength() > ContentParam::Name::kMaxSize) {
+    param.m_Value = m_pDocument->New<CPDF_Name>(PDF_NameDecode(bsName));
+    return;
+  }
+  auto& name = param.m_Value.emplace<ContentParam::Name>();
+  name.size = static_cast<uint8_t>(
+      PDF_NameDecodeToBuffer(bsName, pdfium::make_span(name.chars)));
 }
 
 void CPDF_StreamContentParser::AddNumberParam(ByteStringView str) {
   ContentParam& param = m_ParamBuf[GetNextParamPos()];
-  param.m_Type = ContentParam::Type::kNumber;
-  param.m_Number = FX_Number(str);
+  param.m_Value = FX_Number(str);
 }
 
 void CPDF_StreamContentParser::AddObjectParam(RetainPtr<CPDF_Object> pObj) {
   ContentParam& param = m_ParamBuf[GetNextParamPos()];
-  param.m_Type = ContentParam::Type::kObject;
-  param.m_pObject = std::move(pObj);
+  param.m_Value = std::move(pObj);
 }
 
 void CPDF_StreamContentParser::ClearAllParams() {
   uint32_t index = m_ParamStartPos;
   for (uint32_t i = 0; i < m_ParamCount; i++) {
-    if (m_ParamBuf[index].m_Type == ContentParam::Type::kObject)
-      m_ParamBuf[index].m_pObject.Reset();
+    auto* pObj =
+        absl::get_if<RetainPtr<CPDF_Object>>(&m_ParamBuf[index].m_Value);
+    if (pObj)
+      pObj->Reset();
     index++;
     if (index == kParamBufSize)
       index = 0;
@@ -339,23 +341,17 @@ RetainPtr<CPDF_Object> CPDF_StreamContentParser::GetObject(uint32_t index) {
     real_index -= kParamBufSize;
   }
   ContentParam& param = m_ParamBuf[real_index];
-  if (param.m_Type == ContentParam::Type::kNumber) {
-    param.m_Type = ContentParam::Type::kObject;
-    param.m_pObject =
-        param.m_Number.IsInteger()
-            ? pdfium::MakeRetain<CPDF_Number>(param.m_Number.GetSigned())
-            : pdfium::MakeRetain<CPDF_Number>(param.m_Number.GetFloat());
-    return param.m_pObject;
+  if (const auto* number = absl::get_if<FX_Number>(&param.m_Value)) {
+    param.m_Value =
+        number->IsInteger()
+            ? pdfium::MakeRetain<CPDF_Number>(number->GetSigned())
+            : pdfium::MakeRetain<CPDF_Number>(number->GetFloat());
+  } else if (const auto* name =
+                 absl::get_if<ContentParam::Name>(&param.m_Value)) {
+    param.m_Value =
+        m_pDocument->New<CPDF_Name>(ByteString(name->AsStringView()));
   }
-  if (param.m_Type == ContentParam::Type::kName) {
-    param.m_Type = ContentParam::Type::kObject;
-    param.m_pObject = m_pDocument->New<CPDF_Name>(param.m_Name);
-    return param.m_pObject;
-  }
-  if (param.m_Type == ContentParam::Type::kObject)
-    return param.m_pObject;
-
-  NOTREACHED_NORETURN();
+  return absl::get<RetainPtr<CPDF_Object>>(param.m_Value);
 }
 
 ByteString CPDF_StreamContentParser::GetString(uint32_t index) const {
@@ -367,11 +363,12 @@ ByteString CPDF_StreamContentParser::GetString(uint32_t index) const {
     real_index -= kParamBufSize;
 
   const ContentParam& param = m_ParamBuf[real_index];
-  if (param.m_Type == ContentParam::Type::kName)
-    return param.m_Name;
+  if (const auto* name = absl::get_if<ContentParam::Name>(&param.m_Value))
+    return ByteString(name->AsStringView());
 
-  if (param.m_Type == ContentParam::Type::kObject && param.m_pObject)
-    return param.m_pObject->GetString();
+  const auto* pObj = absl::get_if<RetainPtr<CPDF_Object>>(&param.m_Value);
+  if (pObj && *pObj)
+    return (*pObj)->GetString();
 
   return ByteString();
 }
@@ -385,11 +382,12 @@ float CPDF_StreamContentParser::GetNumber(uint32_t index) const {
     real_index -= kParamBufSize;
 
   const ContentParam& param = m_ParamBuf[real_index];
-  if (param.m_Type == ContentParam::Type::kNumber)
-    return param.m_Number.GetFloat();
+  if (const auto* number = absl::get_if<FX_Number>(&param.m_Value))
+    return number->GetFloat();
 
-  if (param.m_Type == ContentParam::Type::kObject && param.m_pObject)
-    return param.m_pObject->GetNumber();
+  const auto* pObj = absl::get_if<RetainPtr<CPDF_Object>>(&param.m_Value);
+  if (pObj && *pObj)
+    return (*pObj)->GetNumber();
 
   return 0;
 }
@@ -430,9 +428,15 @@ void CPDF_StreamContentParser::SetGraphicStates(CPDF_PageObject* pObj,
 }
 
 // static
-CPDF_StreamContentParser::OpCodes
-CPDF_StreamContentParser::InitializeOpCodes() {
-  return OpCodes({
+constexpr size_t CPDF_StreamContentParser::OpCodeHash(uint32_t id) {
+  // The multiplier was picked so that no two operators share a slot.
+  return static_cast<uint32_t>(id * 0x2a4327e7u) >> 24;
+}
+
+// static
+constexpr CPDF_StreamContentParser::OpCodeTable
+CPDF_StreamContentParser::BuildOpCodeTable() {
+  constexpr OpCode kOpCodes[] = {
       {FXBSTR_ID('"', 0, 0, 0),
        &CPDF_StreamContentParser::Handle_NextLineShowText_Space},
       {FXBSTR_ID('\'', 0, 0, 0),
@@ -547,16 +551,25 @@ CPDF_StreamContentParser::InitializeOpCodes() {
       {FXBSTR_ID('v', 0, 0, 0), &CPDF_StreamContentParser::Handle_CurveTo_23},
       {FXBSTR_ID('w', 0, 0, 0), &CPDF_StreamContentParser::Handle_SetLineWidth},
       {FXBSTR_ID('y', 0, 0, 0), &CPDF_StreamContentParser::Handle_CurveTo_13},
-  });
+  };
+
+  OpCodeTable table = {};
+  for (const OpCode& op : kOpCodes) {
+    OpCode& slot = table[OpCodeHash(op.id)];
+    // Fails to compile if two operators share a slot.
+    CHECK(!slot.handler);
+    slot = op;
+  }
+  return table;
 }
 
 void CPDF_StreamContentParser::OnOperator(ByteStringView op) {
-  static const pdfium::base::NoDestructor<OpCodes> s_OpCodes(
-      InitializeOpCodes());
+  static constexpr OpCodeTable kOpCodeTable = BuildOpCodeTable();
 
-  auto it = s_OpCodes->find(op.GetID());
-  if (it != s_OpCodes->end())
-    (this->*it->second)();
+  const uint32_t id = op.GetID();
+  const OpCode& opcode = kOpCodeTable[OpCodeHash(id)];
+  if (opcode.handler && opcode.id == id)
+    (this->*opcode.handler)();
 }
 
 void CPDF_StreamContentParser::Handle_CloseFillStrokePath() {
@@ -772,7 +785,7 @@ void CPDF_StreamContentParser::AddForm(RetainPtr<CPDF_Stream> pStream,
   status.m_TextState = m_pCurStates->m_TextState;
   auto form = std::make_unique<CPDF_Form>(
       m_pDocument, m_pPageResources, std::move(pStream), m_pResources.Get());
-  form->ParseContent(&status, nullptr, m_ParsedSet);
+  form->ParseContent(&status, nullptr, m_RecursionState);
 
   CFX_Matrix matrix = m_pCurStates->m_CTM * m_mtContentToUser;
   auto pFormObj = std::make_unique<CPDF_FormObject>(GetCurrentStreamIndex(),
@@ -1447,7 +1460,7 @@ void CPDF_StreamContentParser::AddPathPoint(const CFX_PointF& point,
   } else if (m_PathPoints.empty()) {
     return;
   }
-  m_PathPoints.emplace_back(point, type, /*close=*/false);
+  PushPathPoint(point, type, /*close=*/false);
 }
 
 void CPDF_StreamContentParser::AddPathPointAndClose(
@@ -1457,30 +1470,47 @@ void CPDF_StreamContentParser::AddPathPointAndClose(
   if (m_PathPoints.empty())
     return;
 
-  m_PathPoints.emplace_back(point, type, /*close=*/true);
+  PushPathPoint(point, type, /*close=*/true);
+}
+
+void CPDF_StreamContentParser::PushPathPoint(const CFX_PointF& point,
+                                             CFX_Path::Point::Type type,
+                                             bool close) {
+  if (m_PathPoints.size() == m_PathPoints.capacity())
+    m_pObjectHolder->CountPathPointBuffer();
+  m_PathPoints.emplace_back(point, type, close);
 }
 
 void CPDF_StreamContentParser::AddPathObject(
     CFX_FillRenderOptions::FillType fill_type,
     RenderType render_type) {
-  std::vector<CFX_Path::Point> path_points;
-  path_points.swap(m_PathPoints);
   CFX_FillRenderOptions::FillType path_clip_type = m_PathClipType;
   m_PathClipType = CFX_FillRenderOptions::FillType::kNoFill;
 
-  if (path_points.empty())
-    return;
+  if (!m_PathPoints.empty()) {
+    AddPathObjectWithPoints(m_PathPoints, fill_type, render_type,
+                            path_clip_type);
+  }
+
+  // Keep the capacity, so the next path does not have to grow the buffer.
+  m_PathPoints.clear();
+}
 
+void CPDF_StreamContentParser::AddPathObjectWithPoints(
+    pdfium::span<const CFX_Path::Point> path_points,
+    CFX_FillRenderOptions::FillType fill_type,
+    RenderType render_type,
+    CFX_FillRenderOptions::FillType path_clip_type) {
+  CPDF_Path path;
   if (path_points.size() == 1) {
     if (path_clip_type != CFX_FillRenderOptions::FillType::kNoFill) {
-      CPDF_Path path;
       path.AppendRect(0, 0, 0, 0);
       m_pCurStates->m_ClipPath.AppendPathWithAutoMerge(
           path, CFX_FillRenderOptions::FillType::kWinding);
       return;
     }
 
-    CFX_Path::Point& point = path_points.front();
+    const CFX_Path::Point& point = path_points.front();
     if (point.m_Type != CFX_Path::Point::Type::kMove || !point.m_CloseFigure ||
         m_pCurStates->m_GraphState.GetLineCap() !=
             CFX_GraphStateData::LineCap::kRound) {
@@ -1491,21 +1521,14 @@ void CPDF_StreamContentParser::AddPathObject(
     // gets closed, we can treat it as drawing a path from this point to itself
     // and closing the path. This should not apply to butt line cap or
     // projecting square line cap since they should not be rendered.
-    point.m_CloseFigure = false;
-    path_points.emplace_back(point.m_Point, CFX_Path::Point::Type::kLine,
-                             /*close=*/true);
-  }
-
-  if (path_points.back().IsTypeAndOpen(CFX_Path::Point::Type::kMove))
-    path_points.pop_back();
-
-  CPDF_Path path;
-  for (const auto& point : path_points) {
-    if (point.m_CloseFigure)
-      path.AppendPointAndClose(point.m_Point, point.m_Type);
-    else
-      path.AppendPoint(point.m_Point, point.m_Type);
+    path.AppendPoint(point.m_Point, CFX_Path::Point::Type::kMove);
+    path.AppendPointAndClose(point.m_Point, CFX_Path::Point::Type::kLine);
+  } else {
+    if (path_points.back().IsTypeAndOpen(CFX_Path::Point::Type::kMove))
+      path_points = path_points.first(path_points.size() - 1);
+    path.AppendPoints(path_points);
   }
+  m_pObjectHolder->CountPathPointBuffer();
 
   CFX_Matrix matrix = m_pCurStates->m_CTM * m_mtContentToUser;
   bool bStroke = render_type == RenderType::kStroke;
@@ -1535,14 +1558,15 @@ uint32_t CPDF_StreamContentParser::Parse(
   // Parsing will be done from within |pDataStart|.
   pdfium::span<const uint8_t> pDataStart = pData.subspan(start_offset);
   m_StartParseOffset = start_offset;
-  if (m_ParsedSet->size() > kMaxFormLevel ||
-      pdfium::Contains(*m_ParsedSet, pDataStart.data())) {
+  std::set<const uint8_t*>* pParsedSet = &m_RecursionState->parsed_set;
+  if (pParsedSet->size() > kMaxFormLevel ||
+      pdfium::Contains(*pParsedSet, pDataStart.data())) {
     return fxcrt::CollectionSize<uint32_t>(pDataStart);
   }
 
   m_StreamStartOffsets = stream_start_offsets;
 
-  ScopedSetInsertion<const uint8_t*> scopedInsert(m_ParsedSet,
+  ScopedSetInsertion<const uint8_t*> scopedInsert(pParsedSet,
                                                   pDataStart.data());
 
   uint32_t init_obj_count = m_pObjectHolder->GetPageObjectCount();
@@ -7,13 +7,16 @@
 #ifndef CORE_FPDFAPI_PAGE_CPDF_STREAMCONTENTPARSER_H_
 #define CORE_FPDFAPI_PAGE_CPDF_STREAMCONTENTPARSER_H_
 
-#include <map>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
 #include <memory>
-#include <set>
 #include <stack>
 #include <vector>
 
 #include "core/fpdfapi/page/cpdf_contentmarks.h"
+#include "core/fpdfapi/page/cpdf_form.h"
 #include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/fx_number.h"
@@ -21,6 +24,7 @@
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/cfx_fillrenderoptions.h"
 #include "core/fxge/cfx_path.h"
+#include "third_party/abseil-cpp/absl/types/variant.h"
 #include "third_party/base/span.h"
 
 class CPDF_AllStates;
@@ -49,7 +53,7 @@ class CPDF_StreamContentParser {
                            RetainPtr<CPDF_Dictionary> pResources,
                            const CFX_FloatRect& rcBBox,
                            const CPDF_AllStates* pStates,
-                           std::set<const uint8_t*>* pParsedSet);
+                           CPDF_Form::RecursionState* recursion_state);
   ~CPDF_StreamContentParser();
 
   uint32_t Parse(pdfium::span<const uint8_t> pData,
@@ -68,22 +72,40 @@ class CPDF_StreamContentParser {
  private:
   enum class RenderType : bool { kFill = false, kStroke = true };
 
+  // An operand. Numbers and short names are stored inline, so most operands
+  // never touch the heap.
   struct ContentParam {
-    enum class Type : uint8_t { kObject = 0, kNumber, kName };
+    struct Name {
+      // Long enough for resource names and marked content tags.
+      static constexpr size_t kMaxSize = 22;
+
+      ByteStringView AsStringView() const {
+        return ByteStringView(pdfium::make_span(chars, size));
+      }
+
+      uint8_t size = 0;
+      char chars[kMaxSize];
+    };
 
     ContentParam();
     ~ContentParam();
 
-    Type m_Type = Type::kObject;
-    FX_Number m_Number;
-    ByteString m_Name;
-    RetainPtr<CPDF_Object> m_pObject;
+    absl::variant<RetainPtr<CPDF_Object>, FX_Number, Name> m_Value;
   };
 
   static constexpr int kParamBufSize = 16;
 
-  using OpCodes = std::map<uint32_t, void (CPDF_StreamContentParser::*)()>;
-  static OpCodes InitializeOpCodes();
+  using OpHandler = void (CPDF_StreamContentParser::*)();
+  struct OpCode {
+    uint32_t id;
+    OpHandler handler;
+  };
+
+  // Perfect hash table of operators, indexed by OpCodeHash() of their IDs.
+  static constexpr size_t kOpCodeTableSize = 256;
+  using OpCodeTable = std::array<OpCode, kOpCodeTableSize>;
+  static constexpr OpCodeTable BuildOpCodeTable();
+  static constexpr size_t OpCodeHash(uint32_t id);
 
   void AddNameParam(ByteStringView bsName);
   void AddNumberParam(ByteStringView str);
@@ -116,9 +138,16 @@ class CPDF_StreamContentParser {
   void AddPathPoint(const CFX_PointF& point, CFX_Path::Point::Type type);
   void AddPathPointAndClose(const CFX_PointF& point,
                             CFX_Path::Point::Type type);
+  void PushPathPoint(const CFX_PointF& point,
+                     CFX_Path::Point::Type type,
+                     bool close);
   void AddPathRect(float x, float y, float w, float h);
   void AddPathObject(CFX_FillRenderOptions::FillType fill_type,
                      RenderType render_type);
+  void AddPathObjectWithPoints(pdfium::span<const CFX_Path::Point> path_points,
+                               CFX_FillRenderOptions::FillType fill_type,
+                               RenderType render_type,
+                               CFX_FillRenderOptions::FillType path_clip_type);
   CPDF_ImageObject* AddImageFromStream(RetainPtr<CPDF_Stream> pStream,
                                        const ByteString& name);
   CPDF_ImageObject* AddImageFromStreamObjNum(uint32_t stream_obj_num,
@@ -222,7 +251,7 @@ class CPDF_StreamContentParser {
   RetainPtr<CPDF_Dictionary> const m_pParentResources;
   RetainPtr<CPDF_Dictionary> const m_pResources;
   UnownedPtr<CPDF_PageObjectHolder> const m_pObjectHolder;
-  UnownedPtr<std::set<const uint8_t*>> const m_ParsedSet;
+  UnownedPtr<CPDF_Form::RecursionState> const m_RecursionState;
   CFX_Matrix m_mtContentToUser;
   const CFX_FloatRect m_BBox;
   uint32_t m_ParamStartPos = 0;
@@ -3,8 +3,40 @@
 // found in the LICENSE file.
 
 #include "core/fpdfapi/page/cpdf_streamcontentparser.h"
+
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "core/fpdfapi/page/cpdf_contentmarkitem.h"
+#include "core/fpdfapi/page/cpdf_contentmarks.h"
+#include "core/fpdfapi/page/cpdf_form.h"
+#include "core/fpdfapi/page/cpdf_formobject.h"
+#include "core/fpdfapi/page/cpdf_pageobject.h"
+#include "core/fpdfapi/page/test_with_page_module.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_reference.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_test_document.h"
+#include "core/fxcrt/data_vector.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+std::unique_ptr<CPDF_Form> ParseForm(CPDF_Document* pDoc,
+                                     ByteStringView content) {
+  auto pStream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(content.raw_span().begin(),
+                          content.raw_span().end()),
+      pdfium::MakeRetain<CPDF_Dictionary>());
+  auto pForm = std::make_unique<CPDF_Form>(pDoc, nullptr, pStream);
+  pForm->ParseContent();
+  return pForm;
+}
+
+}  // namespace
+
 TEST(cpdf_streamcontentparser, PDF_FindKeyAbbreviation) {
   EXPECT_EQ(ByteStringView("BitsPerComponent"),
             CPDF_StreamContentParser::FindKeyAbbreviationForTesting(
@@ -42,3 +74,99 @@ TEST(cpdf_streamcontentparser, PDF_FindValueAbbreviation) {
             CPDF_StreamContentParser::FindValueAbbreviationForTesting(
                 ByteStringView("II")));
 }
+
+using CPDFStreamContentParserTest = TestWithPageModule;
+
+TEST_F(CPDFStreamContentParserTest, Operands) {
+  auto pDoc = std::make_unique<CPDF_TestDocument>();
+  pDoc->CreateNewDoc();
+
+  // Short, long and escaped names, a dictionary operand, and more operands
+  // than the operator takes.
+  std::unique_ptr<CPDF_Form> pForm = ParseForm(
+      pDoc.get(),
+      "/Short BMC /AMarkedContentTagLongerThanUsual BMC /A#42 BMC "
+      "/Tag <</MCID 7>> BDC "
+      "1 2 3 4 5 6 7 8 9 10 11 12 "
+      "5.5 -6 10 20 re f EMC EMC EMC EMC");
+  ASSERT_EQ(1u, pForm->GetPageObjectCount());
+  const CPDF_PageObject* pObj = pForm->GetPageObjectByIndex(0);
+  EXPECT_EQ(CFX_FloatRect(5.5f, -6, 15.5f, 14), pObj->GetRect());
+
+  const CPDF_ContentMarks* pMarks = pObj->GetContentMarks();
+  ASSERT_EQ(4u, pMarks->CountItems());
+  EXPECT_EQ("Short", pMarks->GetItem(0)->GetName());
+  EXPECT_EQ("AMarkedContentTagLongerThanUsual", pMarks->GetItem(1)->GetName());
+  EXPECT_EQ("AB", pMarks->GetItem(2)->GetName());
+  EXPECT_EQ("Tag", pMarks->GetItem(3)->GetName());
+  EXPECT_EQ(7, pMarks->GetMarkedContentID());
+}
+
+TEST_F(CPDFStreamContentParserTest, Operators) {
+  auto pDoc = std::make_unique<CPDF_TestDocument>();
+  pDoc->CreateNewDoc();
+
+  // Unknown operators are skipped along with their operands.
+  std::unique_ptr<CPDF_Form> pForm = ParseForm(
+      pDoc.get(),
+      "1 0 0 1 100 0 cm 0 0 1 1 re f 5 foo 1 2 3 4 BX abcdefgh q "
+      "1 0 0 1 0 100 cm 0 0 1 1 re f Q 0 0 1 1 re F");
+  ASSERT_EQ(3u, pForm->GetPageObjectCount());
+  EXPECT_EQ(CFX_FloatRect(100, 0, 101, 1),
+            pForm->GetPageObjectByIndex(0)->GetRect());
+  EXPECT_EQ(CFX_FloatRect(100, 100, 101, 101),
+            pForm->GetPageObjectByIndex(1)->GetRect());
+  EXPECT_EQ(CFX_FloatRect(100, 0, 101, 1),
+            pForm->GetPageObjectByIndex(2)->GetRect());
+}
+
+TEST_F(CPDFStreamContentParserTest, FilteredForms) {
+  auto pDoc = std::make_unique<CPDF_TestDocument>();
+  pDoc->CreateNewDoc();
+
+  auto pXObjects = pdfium::MakeRetain<CPDF_Dictionary>();
+  auto add_form = [&](const char* name, ByteStringView hex_content) {
+    auto pDict = pdfium::MakeRetain<CPDF_Dictionary>();
+    pDict->SetNewFor<CPDF_Name>("Subtype", "Form");
+    pDict->SetNewFor<CPDF_Name>("Filter", "ASCIIHexDecode");
+    pDict->SetNewFor<CPDF_Dictionary>("Resources")
+        ->SetFor("XObject", pXObjects);
+    auto pStream = pDoc->NewIndirect<CPDF_Stream>(
+        DataVector<uint8_t>(hex_content.raw_span().begin(),
+                            hex_content.raw_span().end()),
+        std::move(pDict));
+    pXObjects->SetNewFor<CPDF_Reference>(name, pDoc.get(),
+                                         pStream->GetObjNum());
+  };
+  // "0 0 1 1 re f"
+  add_form("Rect", "3020302031203120726520663E");
+  // "/Self Do"
+  add_form("Self", "2F53656C6620446F3E");
+
+  auto pDict = pdfium::MakeRetain<CPDF_Dictionary>();
+  pDict->SetNewFor<CPDF_Dictionary>("Resources")->SetFor("XObject", pXObjects);
+  static constexpr char kContent[] = "/Rect Do /Rect Do /Self Do";
+  auto pStream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(std::begin(kContent), std::end(kContent) - 1),
+      std::move(pDict));
+  auto pForm = std::make_unique<CPDF_Form>(pDoc.get(), nullptr, pStream);
+  pForm->ParseContent();
+  ASSERT_EQ(3u, pForm->GetPageObjectCount());
+
+  // Both uses of /Rect get their own copy of its content.
+  for (size_t i = 0; i < 2; ++i) {
+    const CPDF_FormObject* pFormObj = pForm->GetPageObjectByIndex(i)->AsForm();
+    ASSERT_TRUE(pFormObj);
+    ASSERT_EQ(1u, pFormObj->form()->GetPageObjectCount());
+    EXPECT_EQ(CFX_FloatRect(0, 0, 1, 1),
+              pFormObj->form()->GetPageObjectByIndex(0)->GetRect());
+  }
+
+  // /Self stops drawing itself as soon as it recurses.
+  const CPDF_FormObject* pSelf = pForm->GetPageObjectByIndex(2)->AsForm();
+  ASSERT_TRUE(pSelf);
+  ASSERT_EQ(1u, pSelf->form()->GetPageObjectCount());
+  pSelf = pSelf->form()->GetPageObjectByIndex(0)->AsForm();
+  ASSERT_TRUE(pSelf);
+  EXPECT_EQ(0u, pSelf->form()->GetPageObjectCount());
+}
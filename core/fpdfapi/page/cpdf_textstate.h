@@ -35,6 +35,7 @@ class CPDF_TextState {
   ~CPDF_TextState();
 
   void Emplace();
+  bool HasRef() const { return !!m_Ref; }
 
   RetainPtr<CPDF_Font> GetFont() const;
   void SetFont(RetainPtr<CPDF_Font> pFont);
@@ -21,6 +21,7 @@
 #include "core/fxcrt/fx_extension.h"
 #include "core/fxcrt/fx_stream.h"
 #include "third_party/base/check.h"
+#include "third_party/base/check_op.h"
 #include "third_party/base/notreached.h"
 
 // Indexed by 8-bit character code, contains either:
@@ -90,26 +91,33 @@ absl::optional<FX_FILESIZE> GetHeaderOffset(
 }
 
 ByteString PDF_NameDecode(ByteStringView orig) {
-  size_t src_size = orig.GetLength();
-  size_t out_index = 0;
   ByteString result;
+  size_t out_size;
   {
     // Span's lifetime must end before ReleaseBuffer() below.
-    pdfium::span<char> pDest = result.GetBuffer(src_size);
-    for (size_t i = 0; i < src_size; i++) {
-      if (orig[i] == '#' && i + 2 < src_size) {
-        pDest[out_index++] = FXSYS_HexCharToInt(orig[i + 1]) * 16 +
-                             FXSYS_HexCharToInt(orig[i + 2]);
-        i += 2;
-      } else {
-        pDest[out_index++] = orig[i];
-      }
-    }
+    pdfium::span<char> pDest = result.GetBuffer(orig.GetLength());
+    out_size = PDF_NameDecodeToBuffer(orig, pDest);
   }
-  result.ReleaseBuffer(out_index);
+  result.ReleaseBuffer(out_size);
   return result;
 }
 
+size_t PDF_NameDecodeToBuffer(ByteStringView orig, pdfium::span<char> dest) {
+  size_t src_size = orig.GetLength();
+  CHECK_GE(dest.size(), src_size);
+  size_t out_index = 0;
+  for (size_t i = 0; i < src_size; i++) {
+    if (orig[i] == '#' && i + 2 < src_size) {
+      dest[out_index++] = FXSYS_HexCharToInt(orig[i + 1]) * 16 +
+                          FXSYS_HexCharToInt(orig[i + 2]);
+      i += 2;
+    } else {
+      dest[out_index++] = orig[i];
+    }
+  }
+  return out_index;
+}
+
 ByteString PDF_NameEncode(const ByteString& orig) {
   const uint8_t* src_buf = reinterpret_cast<const uint8_t*>(orig.c_str());
   int src_len = orig.GetLength();
@@ -7,12 +7,15 @@
 #ifndef CORE_FPDFAPI_PARSER_FPDF_PARSER_UTILITY_H_
 #define CORE_FPDFAPI_PARSER_FPDF_PARSER_UTILITY_H_
 
+#include <stddef.h>
+
 #include <iosfwd>
 #include <vector>
 
 #include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/base/span.h"
 
 class CPDF_Array;
 class CPDF_Dictionary;
@@ -46,6 +49,9 @@ absl::optional<FX_FILESIZE> GetHeaderOffset(
     const RetainPtr<IFX_SeekableReadStream>& pFile);
 
 ByteString PDF_NameDecode(ByteStringView orig);
+// Decodes |orig| into |dest|, which must be at least as long as |orig|, and
+// returns the decoded length.
+size_t PDF_NameDecodeToBuffer(ByteStringView orig, pdfium::span<char> dest);
 ByteString PDF_NameEncode(const ByteString& orig);
 
 // Return |nCount| elements from |pArray| as a vector of floats. |pArray| must
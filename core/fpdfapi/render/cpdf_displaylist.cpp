@@ -0,0 +1,573 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_displaylist.h"
+
+#include <map>
+#include <utility>
+
+#include "core/fpdfapi/font/cpdf_font.h"
+#include "core/fpdfapi/page/cpdf_clippath.h"
+#include "core/fpdfapi/page/cpdf_form.h"
+#include "core/fpdfapi/page/cpdf_formobject.h"
+#include "core/fpdfapi/page/cpdf_image.h"
+#include "core/fpdfapi/page/cpdf_imageobject.h"
+#include "core/fpdfapi/page/cpdf_pageobjectholder.h"
+#include "core/fpdfapi/page/cpdf_pathobject.h"
+#include "core/fpdfapi/page/cpdf_textobject.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/render/cpdf_render_utils.h"
+#include "core/fxcrt/cfx_serializer.h"
+#include "core/fxcrt/unowned_ptr.h"
+#include "third_party/base/notreached.h"
+
+namespace {
+
+// Matches the render recursion limit, beyond which nothing is drawn.
+constexpr int kMaxFormDepth = 64;
+
+constexpr uint8_t kMagic[] = {'P', 'D', 'D', 'L'};
+constexpr uint32_t kVersion = 2;
+
+constexpr uint8_t kCloseFigureFlag = 0x80;
+
+bool GetFillColor(const CPDF_PageObject* pObj,
+                  CPDF_DisplayList::Color* color) {
+  const CPDF_ColorState& color_state = pObj->m_ColorState;
+  if (!color_state.HasRef() || color_state.GetFillColor()->IsNull() ||
+      color_state.GetFillColor()->IsPattern()) {
+    return false;
+  }
+  color->colorref = color_state.GetFillColorRef();
+  color->alpha = pObj->m_GeneralState.GetFillAlpha();
+  return true;
+}
+
+bool GetStrokeColor(const CPDF_PageObject* pObj,
+                    CPDF_DisplayList::Color* color) {
+  const CPDF_ColorState& color_state = pObj->m_ColorState;
+  if (!color_state.HasRef() || color_state.GetStrokeColor()->IsNull() ||
+      color_state.GetStrokeColor()->IsPattern()) {
+    return false;
+  }
+  color->colorref = color_state.GetStrokeColorRef();
+  color->alpha = pObj->m_GeneralState.GetStrokeAlpha();
+  return true;
+}
+
+void WriteColor(const CPDF_DisplayList::Color& color,
+                CFX_SerialWriter* writer) {
+  writer->WriteUint32(color.colorref);
+  writer->WriteFloat(color.alpha);
+}
+
+void WritePath(const CFX_Path& path, CFX_SerialWriter* writer) {
+  const std::vector<CFX_Path::Point>& points = path.GetPoints();
+  writer->WriteUint32(static_cast<uint32_t>(points.size()));
+  for (const CFX_Path::Point& point : points) {
+    writer->WriteFloat(point.m_Point.x);
+    writer->WriteFloat(point.m_Point.y);
+    writer->WriteUint8(static_cast<uint8_t>(point.m_Type) |
+                       (point.m_CloseFigure ? kCloseFigureFlag : 0));
+  }
+}
+
+bool ReadColor(CFX_SerialReader* reader, CPDF_DisplayList::Color* color) {
+  return reader->ReadUint32(&color->colorref) &&
+         reader->ReadFloat(&color->alpha);
+}
+
+bool ReadFillType(CFX_SerialReader* reader,
+                  CFX_FillRenderOptions::FillType* fill_type) {
+  uint8_t value;
+  if (!reader->ReadUint8(&value) ||
+      value > static_cast<uint8_t>(CFX_FillRenderOptions::FillType::kWinding)) {
+    return false;
+  }
+  *fill_type = static_cast<CFX_FillRenderOptions::FillType>(value);
+  return true;
+}
+
+bool ReadPath(CFX_SerialReader* reader, CFX_Path* path) {
+  constexpr size_t kPointSize = 9;
+  uint32_t count;
+  if (!reader->ReadCount(kPointSize, &count))
+    return false;
+
+  std::vector<CFX_Path::Point>& points = path->GetPoints();
+  points.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    CFX_PointF point;
+    uint8_t flags;
+    if (!reader->ReadFloat(&point.x) || !reader->ReadFloat(&point.y) ||
+        !reader->ReadUint8(&flags)) {
+      return false;
+    }
+
+    const uint8_t type = flags & ~kCloseFigureFlag;
+    if (type > static_cast<uint8_t>(CFX_Path::Point::Type::kMove))
+      return false;
+
+    points.emplace_back(point, static_cast<CFX_Path::Point::Type>(type),
+                        !!(flags & kCloseFigureFlag));
+  }
+  return true;
+}
+
+void WriteItem(const CPDF_DisplayList::Item& item,
+               CFX_SerialWriter* writer) {
+  writer->WriteUint8(static_cast<uint8_t>(item.type));
+  writer->WriteUint32(item.clip_index);
+  writer->WriteRect(item.bbox);
+  writer->WriteMatrix(item.matrix);
+  WriteColor(item.fill_color, writer);
+  switch (item.type) {
+    case CPDF_PageObject::Type::kPath:
+      WritePath(item.path, writer);
+      writer->WriteUint8(static_cast<uint8_t>(item.graph_state.m_LineCap));
+      writer->WriteUint8(static_cast<uint8_t>(item.graph_state.m_LineJoin));
+      writer->WriteFloat(item.graph_state.m_DashPhase);
+      writer->WriteFloat(item.graph_state.m_MiterLimit);
+      writer->WriteFloat(item.graph_state.m_LineWidth);
+      writer->WriteUint32(
+          static_cast<uint32_t>(item.graph_state.m_DashArray.size()));
+      for (float dash : item.graph_state.m_DashArray)
+        writer->WriteFloat(dash);
+      WriteColor(item.stroke_color, writer);
+      writer->WriteUint8(static_cast<uint8_t>(item.fill_type));
+      writer->WriteUint8(item.stroke);
+      writer->WriteUint8(item.stroke_adjust);
+      break;
+    case CPDF_PageObject::Type::kText:
+      writer->WriteUint32(item.font_index);
+      writer->WriteFloat(item.font_size);
+      writer->WriteUint32(static_cast<uint32_t>(item.char_codes.size()));
+      for (uint32_t char_code : item.char_codes)
+        writer->WriteUint32(char_code);
+      for (float pos : item.char_pos)
+        writer->WriteFloat(pos);
+      break;
+    case CPDF_PageObject::Type::kImage:
+      writer->WriteUint32(item.image_index);
+      break;
+    default:
+      NOTREACHED();
+      break;
+  }
+}
+
+bool ReadItem(CFX_SerialReader* reader, CPDF_DisplayList::Item* item) {
+  uint8_t type;
+  if (!reader->ReadUint8(&type) || !reader->ReadUint32(&item->clip_index) ||
+      !reader->ReadRect(&item->bbox) || !reader->ReadMatrix(&item->matrix) ||
+      !ReadColor(reader, &item->fill_color)) {
+    return false;
+  }
+
+  item->type = static_cast<CPDF_PageObject::Type>(type);
+  switch (item->type) {
+    case CPDF_PageObject::Type::kPath: {
+      uint8_t cap;
+      uint8_t join;
+      uint32_t dash_count;
+      if (!ReadPath(reader, &item->path) || !reader->ReadUint8(&cap) ||
+          cap > static_cast<uint8_t>(CFX_GraphStateData::LineCap::kSquare) ||
+          !reader->ReadUint8(&join) ||
+          join > static_cast<uint8_t>(CFX_GraphStateData::LineJoin::kBevel) ||
+          !reader->ReadFloat(&item->graph_state.m_DashPhase) ||
+          !reader->ReadFloat(&item->graph_state.m_MiterLimit) ||
+          !reader->ReadFloat(&item->graph_state.m_LineWidth) ||
+          !reader->ReadCount(sizeof(float), &dash_count)) {
+        return false;
+      }
+      item->graph_state.m_LineCap =
+          static_cast<CFX_GraphStateData::LineCap>(cap);
+      item->graph_state.m_LineJoin =
+          static_cast<CFX_GraphStateData::LineJoin>(join);
+      item->graph_state.m_DashArray.resize(dash_count);
+      for (float& dash : item->graph_state.m_DashArray) {
+        if (!reader->ReadFloat(&dash))
+          return false;
+      }
+      return ReadColor(reader, &item->stroke_color) &&
+             ReadFillType(reader, &item->fill_type) &&
+             reader->ReadBool(&item->stroke) &&
+             reader->ReadBool(&item->stroke_adjust);
+    }
+    case CPDF_PageObject::Type::kText: {
+      uint32_t char_count;
+      if (!reader->ReadUint32(&item->font_index) ||
+          !reader->ReadFloat(&item->font_size) ||
+          !reader->ReadCount(sizeof(uint32_t), &char_count) ||
+          char_count == 0) {
+        return false;
+      }
+      item->char_codes.resize(char_count);
+      for (uint32_t& char_code : item->char_codes) {
+        if (!reader->ReadUint32(&char_code))
+          return false;
+      }
+      item->char_pos.resize(char_count - 1);
+      for (float& pos : item->char_pos) {
+        if (!reader->ReadFloat(&pos))
+          return false;
+      }
+      return true;
+    }
+    case CPDF_PageObject::Type::kImage:
+      return reader->ReadUint32(&item->image_index);
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+// Flattens page objects into a display list, inlining forms and collecting
+// the chain of clips each object is drawn with.
+class CPDF_DisplayList::Compiler {
+ public:
+  explicit Compiler(CPDF_DisplayList* pList) : m_pList(pList) {}
+
+  bool AddObjects(const CPDF_PageObjectHolder* pHolder,
+                  const CFX_Matrix& mtObj2Page,
+                  int depth) {
+    if (depth > kMaxFormDepth)
+      return false;
+
+    for (const auto& pObj : *pHolder) {
+      if (!pObj)
+        continue;
+
+      const bool has_clip = pObj->m_ClipPath.HasRef();
+      if (has_clip)
+        m_ClipChain.push_back({pObj->m_ClipPath, mtObj2Page});
+      const bool added = AddObject(pObj.get(), mtObj2Page, depth);
+      if (has_clip)
+        m_ClipChain.pop_back();
+      if (!added)
+        return false;
+    }
+    return true;
+  }
+
+ private:
+  // A clip and the matrix that maps it to page space.
+  struct ChainedClip {
+    bool operator==(const ChainedClip& that) const {
+      return clip == that.clip && matrix == that.matrix;
+    }
+
+    CPDF_ClipPath clip;
+    CFX_Matrix matrix;
+  };
+
+  bool AddObject(const CPDF_PageObject* pObj,
+                 const CFX_Matrix& mtObj2Page,
+                 int depth) {
+    if (!CanFlattenPageObject(pObj) || pObj->m_GeneralState.GetTR())
+      return false;
+
+    switch (pObj->GetType()) {
+      case CPDF_PageObject::Type::kPath:
+        return AddPath(pObj->AsPath(), mtObj2Page);
+      case CPDF_PageObject::Type::kText:
+        return AddText(pObj->AsText(), mtObj2Page);
+      case CPDF_PageObject::Type::kImage:
+        return AddImage(pObj->AsImage(), mtObj2Page);
+      case CPDF_PageObject::Type::kForm:
+        return AddForm(pObj->AsForm(), mtObj2Page, depth);
+      case CPDF_PageObject::Type::kShading:
+        break;
+    }
+    return false;
+  }
+
+  bool AddPath(const CPDF_PathObject* pPathObj, const CFX_Matrix& mtObj2Page) {
+    const CFX_Path* pPath = pPathObj->path().GetObject();
+    if (!pPath || (pPathObj->has_no_filltype() && !pPathObj->stroke()))
+      return true;
+
+    Item item = NewItem(pPathObj, mtObj2Page);
+    item.matrix = pPathObj->matrix() * mtObj2Page;
+    item.fill_type = pPathObj->filltype();
+    item.stroke = pPathObj->stroke();
+    item.stroke_adjust = pPathObj->m_GeneralState.GetStrokeAdjust();
+    if (!pPathObj->has_no_filltype() &&
+        !GetFillColor(pPathObj, &item.fill_color)) {
+      return false;
+    }
+    // Forced color modes may stroke paths that are only filled.
+    if (!GetStrokeColor(pPathObj, &item.stroke_color) && item.stroke)
+      return false;
+
+    const CFX_GraphStateData* pGraphState =
+        pPathObj->m_GraphState.GetObject();
+    if (pGraphState)
+      item.graph_state = *pGraphState;
+    item.path.Append(*pPath, nullptr);
+    m_pList->m_Items.push_back(std::move(item));
+    return true;
+  }
+
+  bool AddText(const CPDF_TextObject* pTextObj, const CFX_Matrix& mtObj2Page) {
+    if (pTextObj->GetCharCodes().empty())
+      return true;
+
+    RetainPtr<CPDF_Font> pFont = pTextObj->m_TextState.GetFont();
+    if (pFont->IsType3Font())
+      return false;
+
+    switch (pTextObj->m_TextState.GetTextMode()) {
+      case TextRenderingMode::MODE_FILL:
+      case TextRenderingMode::MODE_FILL_CLIP:
+        break;
+      case TextRenderingMode::MODE_STROKE:
+      case TextRenderingMode::MODE_STROKE_CLIP:
+      case TextRenderingMode::MODE_FILL_STROKE:
+      case TextRenderingMode::MODE_FILL_STROKE_CLIP:
+        // Only filled when the font has no outlines to stroke.
+        if (pFont->HasFace())
+          return false;
+        break;
+      case TextRenderingMode::MODE_INVISIBLE:
+      case TextRenderingMode::MODE_CLIP:
+        return true;
+      case TextRenderingMode::MODE_UNKNOWN:
+        return false;
+    }
+
+    const uint32_t font_objnum = pFont->GetFontDictObjNum();
+    if (!font_objnum)
+      return false;
+
+    const CFX_Matrix text_matrix = pTextObj->GetTextMatrix();
+    if (!IsAvailableMatrix(text_matrix))
+      return true;
+
+    Item item = NewItem(pTextObj, mtObj2Page);
+    if (!GetFillColor(pTextObj, &item.fill_color))
+      return false;
+
+    item.matrix = text_matrix * mtObj2Page;
+    item.font_index = GetIndex(font_objnum, &m_FontIndices,
+                               &m_pList->m_FontObjNums);
+    item.font_size = pTextObj->m_TextState.GetFontSize();
+    pdfium::span<const uint32_t> char_codes = pTextObj->GetCharCodes();
+    pdfium::span<const float> char_pos = pTextObj->GetCharPositions();
+    item.char_codes.assign(char_codes.begin(), char_codes.end());
+    item.char_pos.assign(char_pos.begin(), char_pos.end());
+    m_pList->m_Items.push_back(std::move(item));
+    return true;
+  }
+
+  bool AddImage(const CPDF_ImageObject* pImageObj,
+                const CFX_Matrix& mtObj2Page) {
+    RetainPtr<CPDF_Image> pImage = pImageObj->GetImage();
+    RetainPtr<const CPDF_Stream> pStream = pImage->GetStream();
+    if (!pStream || !pStream->GetObjNum())
+      return false;
+
+    // Overprinted images may be drawn with a darken blend.
+    if (pImageObj->m_GeneralState.HasRef() &&
+        pImageObj->m_GeneralState.GetFillOP()) {
+      return false;
+    }
+
+    Item item = NewItem(pImageObj, mtObj2Page);
+    if (!GetFillColor(pImageObj, &item.fill_color))
+      return false;
+
+    item.matrix = pImageObj->matrix() * mtObj2Page;
+    item.image_index = GetIndex(pStream->GetObjNum(), &m_ImageIndices,
+                                &m_pList->m_ImageObjNums);
+    m_pList->m_Items.push_back(std::move(item));
+    return true;
+  }
+
+  bool AddForm(const CPDF_FormObject* pFormObj,
+               const CFX_Matrix& mtObj2Page,
+               int depth) {
+    return AddObjects(pFormObj->form(), pFormObj->form_matrix() * mtObj2Page,
+                      depth + 1);
+  }
+
+  Item NewItem(const CPDF_PageObject* pObj, const CFX_Matrix& mtObj2Page) {
+    Item item;
+    item.type = pObj->GetType();
+    item.clip_index = GetClipIndex();
+    item.bbox = mtObj2Page.TransformRect(pObj->GetRect());
+    return item;
+  }
+
+  uint32_t GetClipIndex() {
+    if (m_ClipChain.empty())
+      return kNoClip;
+
+    // Consecutive objects usually share their clips.
+    if (m_ClipChain == m_LastClipChain)
+      return m_LastClipIndex;
+
+    std::vector<ClipPath> clip;
+    for (const ChainedClip& chained : m_ClipChain) {
+      for (size_t i = 0; i < chained.clip.GetPathCount(); ++i) {
+        const CFX_Path* pPath = chained.clip.GetPath(i).GetObject();
+        if (!pPath)
+          continue;
+
+        ClipPath clip_path;
+        clip_path.path.Append(*pPath, &chained.matrix);
+        clip_path.fill_type = chained.clip.GetClipType(i);
+        clip.push_back(std::move(clip_path));
+      }
+    }
+    m_LastClipChain = m_ClipChain;
+    m_LastClipIndex = static_cast<uint32_t>(m_pList->m_Clips.size());
+    m_pList->m_Clips.push_back(std::move(clip));
+    return m_LastClipIndex;
+  }
+
+  static uint32_t GetIndex(uint32_t objnum,
+                           std::map<uint32_t, uint32_t>* indices,
+                           std::vector<uint32_t>* objnums) {
+    auto it = indices->find(objnum);
+    if (it != indices->end())
+      return it->second;
+
+    const uint32_t index = static_cast<uint32_t>(objnums->size());
+    objnums->push_back(objnum);
+    (*indices)[objnum] = index;
+    return index;
+  }
+
+  UnownedPtr<CPDF_DisplayList> const m_pList;
+  // The clips of the object being added and of the forms it is nested in.
+  std::vector<ChainedClip> m_ClipChain;
+  std::vector<ChainedClip> m_LastClipChain;
+  uint32_t m_LastClipIndex = kNoClip;
+  std::map<uint32_t, uint32_t> m_FontIndices;
+  std::map<uint32_t, uint32_t> m_ImageIndices;
+};
+
+CPDF_DisplayList::Item::Item() = default;
+
+CPDF_DisplayList::Item::Item(const Item& that) = default;
+
+CPDF_DisplayList::Item::Item(Item&& that) noexcept = default;
+
+CPDF_DisplayList::Item::~Item() = default;
+
+// static
+std::unique_ptr<CPDF_DisplayList> CPDF_DisplayList::Compile(
+    const CPDF_PageObjectHolder* pHolder) {
+  auto list = std::make_unique<CPDF_DisplayList>();
+  RetainPtr<const CPDF_Dictionary> pDict = pHolder->GetDict();
+  if (pDict)
+    list->m_PageObjNum = pDict->GetObjNum();
+
+  Compiler compiler(list.get());
+  if (!compiler.AddObjects(pHolder, CFX_Matrix(), 0))
+    return nullptr;
+  return list;
+}
+
+// static
+std::unique_ptr<CPDF_DisplayList> CPDF_DisplayList::Deserialize(
+    pdfium::span<const uint8_t> data,
+    pdfium::span<const uint8_t> document_key) {
+  CFX_SerialReader reader(data);
+  if (!reader.ReadHeader(kMagic, kVersion, document_key))
+    return nullptr;
+
+  auto list = std::make_unique<CPDF_DisplayList>();
+  if (!reader.ReadUint32(&list->m_PageObjNum))
+    return nullptr;
+
+  for (std::vector<uint32_t>* objnums :
+       {&list->m_FontObjNums, &list->m_ImageObjNums}) {
+    uint32_t count;
+    if (!reader.ReadCount(sizeof(uint32_t), &count))
+      return nullptr;
+
+    objnums->resize(count);
+    for (uint32_t& objnum : *objnums) {
+      if (!reader.ReadUint32(&objnum) || !objnum)
+        return nullptr;
+    }
+  }
+
+  uint32_t clip_count;
+  if (!reader.ReadCount(sizeof(uint32_t), &clip_count))
+    return nullptr;
+
+  list->m_Clips.resize(clip_count);
+  for (std::vector<ClipPath>& clip : list->m_Clips) {
+    uint32_t path_count;
+    if (!reader.ReadCount(1 + sizeof(uint32_t), &path_count))
+      return nullptr;
+
+    clip.resize(path_count);
+    for (ClipPath& clip_path : clip) {
+      if (!ReadFillType(&reader, &clip_path.fill_type) ||
+          !ReadPath(&reader, &clip_path.path)) {
+        return nullptr;
+      }
+    }
+  }
+
+  uint32_t item_count;
+  if (!reader.ReadCount(1, &item_count))
+    return nullptr;
+
+  list->m_Items.resize(item_count);
+  for (Item& item : list->m_Items) {
+    if (!ReadItem(&reader, &item))
+      return nullptr;
+
+    if (item.clip_index != kNoClip && item.clip_index >= clip_count)
+      return nullptr;
+    if (item.type == CPDF_PageObject::Type::kText &&
+        item.font_index >= list->m_FontObjNums.size()) {
+      return nullptr;
+    }
+    if (item.type == CPDF_PageObject::Type::kImage &&
+        item.image_index >= list->m_ImageObjNums.size()) {
+      return nullptr;
+    }
+  }
+  if (!reader.IsAtEnd())
+    return nullptr;
+
+  return list;
+}
+
+CPDF_DisplayList::CPDF_DisplayList() = default;
+
+CPDF_DisplayList::~CPDF_DisplayList() = default;
+
+DataVector<uint8_t> CPDF_DisplayList::Serialize(
+    pdfium::span<const uint8_t> document_key) const {
+  CFX_SerialWriter writer;
+  writer.WriteHeader(kMagic, kVersion, document_key);
+  writer.WriteUint32(m_PageObjNum);
+  for (const std::vector<uint32_t>* objnums :
+       {&m_FontObjNums, &m_ImageObjNums}) {
+    writer.WriteUint32(static_cast<uint32_t>(objnums->size()));
+    for (uint32_t objnum : *objnums)
+      writer.WriteUint32(objnum);
+  }
+  writer.WriteUint32(static_cast<uint32_t>(m_Clips.size()));
+  for (const std::vector<ClipPath>& clip : m_Clips) {
+    writer.WriteUint32(static_cast<uint32_t>(clip.size()));
+    for (const ClipPath& clip_path : clip) {
+      writer.WriteUint8(static_cast<uint8_t>(clip_path.fill_type));
+      WritePath(clip_path.path, &writer);
+    }
+  }
+  writer.WriteUint32(static_cast<uint32_t>(m_Items.size()));
+  for (const Item& item : m_Items)
+    WriteItem(item, &writer);
+  return writer.Detach();
+}
@@ -0,0 +1,133 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_RENDER_CPDF_DISPLAYLIST_H_
+#define CORE_FPDFAPI_RENDER_CPDF_DISPLAYLIST_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_pageobject.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxge/cfx_fillrenderoptions.h"
+#include "core/fxge/cfx_graphstatedata.h"
+#include "core/fxge/cfx_path.h"
+#include "third_party/base/span.h"
+
+class CPDF_PageObjectHolder;
+
+// A page compiled down to what the renderer draws: flattened paths, runs of
+// glyphs, images and the clips between them, all in page space and with
+// nested forms inlined. CPDF_RenderStatus::RenderDisplayList() replays it
+// without parsing the page content or building page objects, and it can be
+// serialized, so a page that is rendered many times, possibly by different
+// processes, only has its content parsed once.
+//
+// Fonts and images are referenced by object number and are loaded from the
+// document again on replay, so a display list can only be replayed against
+// the page it was compiled from. Serialize() records a key identifying the
+// document, such as a hash of its file, and Deserialize() rejects data
+// recorded with any other key. The page is recorded by object number, for
+// the caller to check.
+class CPDF_DisplayList {
+ public:
+  static constexpr uint32_t kNoClip = 0xFFFFFFFF;
+
+  // Colors are kept as the renderer computes them before applying the render
+  // options, which are only known on replay.
+  struct Color {
+    // 0xFFFFFFFF when the object has no color.
+    FX_COLORREF colorref = 0xFFFFFFFF;
+    float alpha = 1.0f;
+  };
+
+  struct ClipPath {
+    CFX_Path path;
+    CFX_FillRenderOptions::FillType fill_type =
+        CFX_FillRenderOptions::FillType::kWinding;
+  };
+
+  struct Item {
+    Item();
+    Item(const Item& that);
+    Item(Item&& that) noexcept;
+    ~Item();
+
+    // kText, kPath or kImage.
+    CPDF_PageObject::Type type = CPDF_PageObject::Type::kPath;
+    // Index into GetClips(), or kNoClip.
+    uint32_t clip_index = kNoClip;
+    // Where the item draws in page space, to skip items outside the device
+    // clip.
+    CFX_FloatRect bbox;
+    // The path, text or image matrix, mapping to page space.
+    CFX_Matrix matrix;
+    Color fill_color;
+
+    // Paths.
+    CFX_Path path;
+    CFX_GraphStateData graph_state;
+    Color stroke_color;
+    CFX_FillRenderOptions::FillType fill_type =
+        CFX_FillRenderOptions::FillType::kNoFill;
+    bool stroke = false;
+    bool stroke_adjust = false;
+
+    // Text. Index into GetFontObjNums().
+    uint32_t font_index = 0;
+    float font_size = 0.0f;
+    std::vector<uint32_t> char_codes;
+    std::vector<float> char_pos;
+
+    // Images. Index into GetImageObjNums(). The fill color is only used by
+    // image masks, but its alpha applies to all images.
+    uint32_t image_index = 0;
+  };
+
+  // Returns nullptr if |pHolder| uses something a display list cannot
+  // represent, such as transparency groups, soft masks, blend modes, patterns,
+  // shadings, optional content, Type 3 or direct fonts, inline images, text
+  // clipping or stroked text. Such pages are rendered from their objects.
+  static std::unique_ptr<CPDF_DisplayList> Compile(
+      const CPDF_PageObjectHolder* pHolder);
+
+  // Returns nullptr if |data| is malformed, comes from an incompatible version
+  // or was serialized with a key other than |document_key|.
+  static std::unique_ptr<CPDF_DisplayList> Deserialize(
+      pdfium::span<const uint8_t> data,
+      pdfium::span<const uint8_t> document_key);
+
+  CPDF_DisplayList();
+  ~CPDF_DisplayList();
+
+  DataVector<uint8_t> Serialize(
+      pdfium::span<const uint8_t> document_key) const;
+
+  // The object number of the page dictionary the list was compiled from, or 0
+  // if it is a direct object.
+  uint32_t GetPageObjNum() const { return m_PageObjNum; }
+  const std::vector<Item>& GetItems() const { return m_Items; }
+  const std::vector<std::vector<ClipPath>>& GetClips() const {
+    return m_Clips;
+  }
+  const std::vector<uint32_t>& GetFontObjNums() const { return m_FontObjNums; }
+  const std::vector<uint32_t>& GetImageObjNums() const {
+    return m_ImageObjNums;
+  }
+
+ private:
+  class Compiler;
+
+  uint32_t m_PageObjNum = 0;
+  std::vector<Item> m_Items;
+  // Each clip is the intersection of its paths, in page space.
+  std::vector<std::vector<ClipPath>> m_Clips;
+  std::vector<uint32_t> m_FontObjNums;
+  std::vector<uint32_t> m_ImageObjNums;
+};
+
+#endif  // CORE_FPDFAPI_RENDER_CPDF_DISPLAYLIST_H_
@@ -0,0 +1,213 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_displaylist.h"
+
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "core/fpdfapi/page/cpdf_form.h"
+#include "core/fpdfapi/page/test_with_page_module.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_reference.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_test_document.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxge/dib/fx_dib.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr uint8_t kKey[] = {1, 2, 3, 4, 5, 6, 7, 8};
+constexpr uint8_t kOtherKey[] = {1, 2, 3, 4, 5, 6, 7, 9};
+
+RetainPtr<CPDF_Stream> MakeStream(ByteStringView content,
+                                  RetainPtr<CPDF_Dictionary> pDict) {
+  return pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(content.raw_span().begin(),
+                          content.raw_span().end()),
+      std::move(pDict));
+}
+
+}  // namespace
+
+class CPDFDisplayListTest : public TestWithPageModule {
+ public:
+  void SetUp() override {
+    TestWithPageModule::SetUp();
+    m_pDoc = std::make_unique<CPDF_TestDocument>();
+    m_pDoc->CreateNewDoc();
+  }
+
+  void TearDown() override {
+    m_pDoc.reset();
+    TestWithPageModule::TearDown();
+  }
+
+  std::unique_ptr<CPDF_Form> ParseForm(ByteStringView content,
+                                       RetainPtr<CPDF_Dictionary> pResources) {
+    auto pDict = pdfium::MakeRetain<CPDF_Dictionary>();
+    if (pResources)
+      pDict->SetFor("Resources", std::move(pResources));
+    auto pForm = std::make_unique<CPDF_Form>(
+        m_pDoc.get(), nullptr, MakeStream(content, std::move(pDict)));
+    pForm->ParseContent();
+    return pForm;
+  }
+
+  // A page with a filled and a stroked path, and a form that is drawn
+  // translated, all clipped to a triangle so the clip is not dropped as
+  // redundant.
+  std::unique_ptr<CPDF_Form> ParseClippedForm() {
+    auto pFormDict = pdfium::MakeRetain<CPDF_Dictionary>();
+    pFormDict->SetNewFor<CPDF_Name>("Subtype", "Form");
+    auto pInner = m_pDoc->NewIndirect<CPDF_Stream>(
+        DataVector<uint8_t>(std::begin(kInnerContent),
+                            std::end(kInnerContent) - 1),
+        std::move(pFormDict));
+    auto pResources = pdfium::MakeRetain<CPDF_Dictionary>();
+    pResources->SetNewFor<CPDF_Dictionary>("XObject")
+        ->SetNewFor<CPDF_Reference>("Inner", m_pDoc.get(),
+                                    pInner->GetObjNum());
+    return ParseForm(kContent, std::move(pResources));
+  }
+
+ protected:
+  static constexpr char kInnerContent[] = "0 0 5 5 re f";
+  static constexpr char kContent[] =
+      "q 0 0 m 100 0 l 0 100 l h W n "
+      "1 0 0 rg 10 10 20 20 re f "
+      "0 0 1 RG 3 w 5 5 m 50 50 l S "
+      "q 1 0 0 1 30 40 cm /Inner Do Q "
+      "Q 0 1 0 rg 1 1 2 2 re f";
+
+  std::unique_ptr<CPDF_TestDocument> m_pDoc;
+};
+
+TEST_F(CPDFDisplayListTest, CompileFlattensForms) {
+  std::unique_ptr<CPDF_Form> pForm = ParseClippedForm();
+  std::unique_ptr<CPDF_DisplayList> list =
+      CPDF_DisplayList::Compile(pForm.get());
+  ASSERT_TRUE(list);
+
+  const std::vector<CPDF_DisplayList::Item>& items = list->GetItems();
+  ASSERT_EQ(4u, items.size());
+  for (const CPDF_DisplayList::Item& item : items)
+    EXPECT_EQ(CPDF_PageObject::Type::kPath, item.type);
+
+  EXPECT_EQ(CFX_FillRenderOptions::FillType::kWinding, items[0].fill_type);
+  EXPECT_FALSE(items[0].stroke);
+  EXPECT_EQ(FXSYS_BGR(0, 0, 255), items[0].fill_color.colorref & 0xFFFFFF);
+
+  EXPECT_EQ(CFX_FillRenderOptions::FillType::kNoFill, items[1].fill_type);
+  EXPECT_TRUE(items[1].stroke);
+  EXPECT_EQ(3.0f, items[1].graph_state.m_LineWidth);
+
+  // The form's content is moved to where the form is drawn.
+  EXPECT_EQ(CFX_Matrix(1, 0, 0, 1, 30, 40), items[2].matrix);
+  EXPECT_EQ(CFX_FloatRect(30, 40, 35, 45), items[2].bbox);
+
+  // Everything inside the q/Q shares one clip, mapped to page space.
+  ASSERT_EQ(1u, list->GetClips().size());
+  ASSERT_EQ(1u, list->GetClips()[0].size());
+  EXPECT_EQ(CFX_FloatRect(0, 0, 100, 100),
+            list->GetClips()[0][0].path.GetBoundingBox());
+  EXPECT_EQ(0u, items[0].clip_index);
+  EXPECT_EQ(0u, items[1].clip_index);
+  EXPECT_EQ(0u, items[2].clip_index);
+  EXPECT_EQ(CPDF_DisplayList::kNoClip, items[3].clip_index);
+  EXPECT_EQ(FXSYS_BGR(0, 255, 0), items[3].fill_color.colorref & 0xFFFFFF);
+
+  EXPECT_TRUE(list->GetFontObjNums().empty());
+  EXPECT_TRUE(list->GetImageObjNums().empty());
+}
+
+TEST_F(CPDFDisplayListTest, SerializeRoundTrip) {
+  std::unique_ptr<CPDF_Form> pForm = ParseClippedForm();
+  std::unique_ptr<CPDF_DisplayList> list =
+      CPDF_DisplayList::Compile(pForm.get());
+  ASSERT_TRUE(list);
+
+  DataVector<uint8_t> data = list->Serialize(kKey);
+  std::unique_ptr<CPDF_DisplayList> copy =
+      CPDF_DisplayList::Deserialize(data, kKey);
+  ASSERT_TRUE(copy);
+  ASSERT_EQ(list->GetItems().size(), copy->GetItems().size());
+  for (size_t i = 0; i < list->GetItems().size(); ++i) {
+    const CPDF_DisplayList::Item& item = list->GetItems()[i];
+    const CPDF_DisplayList::Item& copied = copy->GetItems()[i];
+    EXPECT_EQ(item.type, copied.type);
+    EXPECT_EQ(item.clip_index, copied.clip_index);
+    EXPECT_EQ(item.bbox, copied.bbox);
+    EXPECT_EQ(item.matrix, copied.matrix);
+    EXPECT_EQ(item.fill_color.colorref, copied.fill_color.colorref);
+    EXPECT_EQ(item.stroke_color.colorref, copied.stroke_color.colorref);
+    EXPECT_EQ(item.fill_type, copied.fill_type);
+    EXPECT_EQ(item.stroke, copied.stroke);
+    EXPECT_EQ(item.graph_state.m_LineWidth, copied.graph_state.m_LineWidth);
+    EXPECT_EQ(item.path.GetPoints().size(), copied.path.GetPoints().size());
+    EXPECT_EQ(item.path.GetBoundingBox(), copied.path.GetBoundingBox());
+  }
+  ASSERT_EQ(1u, copy->GetClips().size());
+  EXPECT_EQ(list->GetClips()[0][0].path.GetBoundingBox(),
+            copy->GetClips()[0][0].path.GetBoundingBox());
+
+  // Serializing again gives the same bytes.
+  EXPECT_EQ(data, copy->Serialize(kKey));
+}
+
+TEST_F(CPDFDisplayListTest, DeserializeRejectsBadData) {
+  std::unique_ptr<CPDF_Form> pForm = ParseClippedForm();
+  std::unique_ptr<CPDF_DisplayList> list =
+      CPDF_DisplayList::Compile(pForm.get());
+  ASSERT_TRUE(list);
+  DataVector<uint8_t> data = list->Serialize(kKey);
+  ASSERT_TRUE(CPDF_DisplayList::Deserialize(data, kKey));
+
+  // Another document.
+  EXPECT_FALSE(CPDF_DisplayList::Deserialize(data, kOtherKey));
+
+  // Truncated anywhere.
+  pdfium::span<const uint8_t> span(data);
+  for (size_t size = 0; size < data.size(); ++size)
+    EXPECT_FALSE(CPDF_DisplayList::Deserialize(span.first(size), kKey));
+
+  // Trailing bytes.
+  DataVector<uint8_t> longer = data;
+  longer.push_back(0);
+  EXPECT_FALSE(CPDF_DisplayList::Deserialize(longer, kKey));
+
+  // Another version, right after the magic number.
+  DataVector<uint8_t> newer = data;
+  ++newer[4];
+  EXPECT_FALSE(CPDF_DisplayList::Deserialize(newer, kKey));
+
+  DataVector<uint8_t> bad_magic = data;
+  bad_magic[0] = 'X';
+  EXPECT_FALSE(CPDF_DisplayList::Deserialize(bad_magic, kKey));
+}
+
+TEST_F(CPDFDisplayListTest, CompileRejectsUnsupported) {
+  auto pBlend = pdfium::MakeRetain<CPDF_Dictionary>();
+  pBlend->SetNewFor<CPDF_Dictionary>("ExtGState")
+      ->SetNewFor<CPDF_Dictionary>("GS0")
+      ->SetNewFor<CPDF_Name>("BM", "Multiply");
+  std::unique_ptr<CPDF_Form> pForm =
+      ParseForm("/GS0 gs 0 0 10 10 re f", std::move(pBlend));
+  ASSERT_EQ(1u, pForm->GetPageObjectCount());
+  EXPECT_FALSE(CPDF_DisplayList::Compile(pForm.get()));
+
+  pForm = ParseForm("/OC /MC0 BDC 0 0 10 10 re f EMC", nullptr);
+  ASSERT_EQ(1u, pForm->GetPageObjectCount());
+  EXPECT_FALSE(CPDF_DisplayList::Compile(pForm.get()));
+
+  // Paths that are neither filled nor stroked are dropped.
+  pForm = ParseForm("0 0 10 10 re n", nullptr);
+  std::unique_ptr<CPDF_DisplayList> list =
+      CPDF_DisplayList::Compile(pForm.get());
+  ASSERT_TRUE(list);
+  EXPECT_TRUE(list->GetItems().empty());
+}
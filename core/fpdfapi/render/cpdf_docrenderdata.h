@@ -12,6 +12,8 @@
 
 #include "build/build_config.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdfapi/render/cpdf_formrendercache.h"
+#include "core/fpdfapi/render/cpdf_tilingcellcache.h"
 #include "core/fxcrt/observed_ptr.h"
 #include "core/fxcrt/retain_ptr.h"
 
@@ -42,6 +44,8 @@ class CPDF_DocRenderData : public CPDF_Document::RenderDataIface {
   RetainPtr<CPDF_Type3Cache> GetCachedType3(CPDF_Type3Font* pFont);
   RetainPtr<CPDF_TransferFunc> GetTransferFunc(
       RetainPtr<const CPDF_Object> pObj);
+  CPDF_TilingCellCache* GetTilingCellCache() { return &m_TilingCellCache; }
+  CPDF_FormRenderCache* GetFormRenderCache() { return &m_FormRenderCache; }
 
 #if BUILDFLAG(IS_WIN)
   CFX_PSFontTracker* GetPSFontTracker();
@@ -59,6 +63,8 @@ class CPDF_DocRenderData : public CPDF_Document::RenderDataIface {
            ObservedPtr<CPDF_TransferFunc>,
            std::less<>>
       m_TransferFuncMap;
+  CPDF_TilingCellCache m_TilingCellCache;
+  CPDF_FormRenderCache m_FormRenderCache;
 
 #if BUILDFLAG(IS_WIN)
   std::unique_ptr<CFX_PSFontTracker> m_PSFontTracker;
@@ -0,0 +1,156 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_formrendercache.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "core/fpdfapi/font/cpdf_font.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/fx_system.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+
+namespace {
+
+int Quantize(float value) {
+  return FXSYS_roundf(value * 10000);
+}
+
+bool SamePlacement(const CFX_Matrix& m1, const CFX_Matrix& m2) {
+  return Quantize(m1.a) == Quantize(m2.a) && Quantize(m1.b) == Quantize(m2.b) &&
+         Quantize(m1.c) == Quantize(m2.c) && Quantize(m1.d) == Quantize(m2.d) &&
+         Quantize(m1.e - floorf(m1.e)) == Quantize(m2.e - floorf(m2.e)) &&
+         Quantize(m1.f - floorf(m1.f)) == Quantize(m2.f - floorf(m2.f));
+}
+
+bool SameGraphState(const CFX_GraphState& state1,
+                    const CFX_GraphState& state2) {
+  return state1.GetLineWidth() == state2.GetLineWidth() &&
+         state1.GetLineCap() == state2.GetLineCap() &&
+         state1.GetLineJoin() == state2.GetLineJoin() &&
+         state1.GetMiterLimit() == state2.GetMiterLimit() &&
+         state1.GetLineDashPhase() == state2.GetLineDashPhase() &&
+         state1.GetLineDashArray() == state2.GetLineDashArray();
+}
+
+// Only the resolved colors are compared. Forms using patterns are not cached.
+bool SameColorState(const CPDF_ColorState& state1,
+                    const CPDF_ColorState& state2) {
+  if (!state1.HasRef() || !state2.HasRef())
+    return state1.HasRef() == state2.HasRef();
+
+  return state1.GetFillColorRef() == state2.GetFillColorRef() &&
+         state1.GetStrokeColorRef() == state2.GetStrokeColorRef();
+}
+
+bool SameTextState(const CPDF_TextState& state1, const CPDF_TextState& state2) {
+  if (!state1.HasRef() || !state2.HasRef())
+    return state1.HasRef() == state2.HasRef();
+
+  pdfium::span<const float> matrix1 = state1.GetMatrix();
+  pdfium::span<const float> ctm1 = state1.GetCTM();
+  return state1.GetFont() == state2.GetFont() &&
+         state1.GetFontSize() == state2.GetFontSize() &&
+         state1.GetCharSpace() == state2.GetCharSpace() &&
+         state1.GetWordSpace() == state2.GetWordSpace() &&
+         state1.GetTextMode() == state2.GetTextMode() &&
+         std::equal(matrix1.begin(), matrix1.end(),
+                    state2.GetMatrix().begin()) &&
+         std::equal(ctm1.begin(), ctm1.end(), state2.GetCTM().begin());
+}
+
+}  // namespace
+
+CPDF_FormRenderCache::Key::Key() = default;
+
+CPDF_FormRenderCache::Key::Key(const Key& that) = default;
+
+CPDF_FormRenderCache::Key& CPDF_FormRenderCache::Key::operator=(
+    const Key& that) = default;
+
+CPDF_FormRenderCache::Key::~Key() = default;
+
+bool CPDF_FormRenderCache::Key::operator==(const Key& that) const {
+  return form == that.form && resources == that.resources &&
+         SamePlacement(form_to_device, that.form_to_device) &&
+         options == that.options &&
+         SameGraphState(graph_state, that.graph_state) &&
+         SameColorState(color_state, that.color_state) &&
+         SameTextState(text_state, that.text_state) &&
+         general_state == that.general_state;
+}
+
+CPDF_FormRenderCache::Rendering::Rendering() = default;
+
+CPDF_FormRenderCache::Rendering::Rendering(const Rendering& that) = default;
+
+CPDF_FormRenderCache::Rendering& CPDF_FormRenderCache::Rendering::operator=(
+    const Rendering& that) = default;
+
+CPDF_FormRenderCache::Rendering::~Rendering() = default;
+
+CPDF_FormRenderCache::Entry::Entry(const Key& key,
+                                   const Rendering& rendering)
+    : key(key),
+      rendering(rendering),
+      size_in_bytes(static_cast<size_t>(rendering.bitmap->GetPitch()) *
+                    rendering.bitmap->GetHeight()) {}
+
+CPDF_FormRenderCache::Entry::~Entry() = default;
+
+CPDF_FormRenderCache::CPDF_FormRenderCache()
+    : CPDF_FormRenderCache(kDefaultByteBudget) {}
+
+CPDF_FormRenderCache::CPDF_FormRenderCache(size_t byte_budget)
+    : m_ByteBudget(byte_budget) {}
+
+CPDF_FormRenderCache::~CPDF_FormRenderCache() = default;
+
+CPDF_FormRenderCache::Rendering CPDF_FormRenderCache::Find(const Key& key) {
+  auto it = m_Renderings.find(key.form);
+  if (it == m_Renderings.end())
+    return Rendering();
+
+  for (LruList::iterator entry : it->second) {
+    if (entry->key == key) {
+      m_LruList.splice(m_LruList.begin(), m_LruList, entry);
+      return entry->rendering;
+    }
+  }
+  return Rendering();
+}
+
+void CPDF_FormRenderCache::Add(const Key& key, const Rendering& rendering) {
+  if (!key.form || !rendering.bitmap)
+    return;
+
+  m_LruList.emplace_front(key, rendering);
+  const size_t size_in_bytes = m_LruList.front().size_in_bytes;
+  if (size_in_bytes > m_ByteBudget) {
+    m_LruList.pop_front();
+    return;
+  }
+
+  m_SizeInBytes += size_in_bytes;
+  m_Renderings[key.form].push_back(m_LruList.begin());
+  while (m_SizeInBytes > m_ByteBudget)
+    EvictLeastRecentlyUsed();
+}
+
+void CPDF_FormRenderCache::EvictLeastRecentlyUsed() {
+  LruList::iterator oldest = std::prev(m_LruList.end());
+  auto renderings_it = m_Renderings.find(oldest->key.form);
+  std::vector<LruList::iterator>& renderings = renderings_it->second;
+  renderings.erase(std::find(renderings.begin(), renderings.end(), oldest));
+  if (renderings.empty())
+    m_Renderings.erase(renderings_it);
+
+  m_SizeInBytes -= oldest->size_in_bytes;
+  m_LruList.erase(oldest);
+}
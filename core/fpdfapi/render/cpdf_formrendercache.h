@@ -0,0 +1,109 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_RENDER_CPDF_FORMRENDERCACHE_H_
+#define CORE_FPDFAPI_RENDER_CPDF_FORMRENDERCACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_colorstate.h"
+#include "core/fpdfapi/page/cpdf_generalstate.h"
+#include "core/fpdfapi/page/cpdf_textstate.h"
+#include "core/fpdfapi/render/cpdf_renderoptions.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/cfx_graphstate.h"
+
+class CFX_DIBitmap;
+class CPDF_Dictionary;
+class CPDF_Stream;
+
+// Keeps rasterized Form XObjects, so a form drawn the same way on many pages,
+// such as a logo, header or watermark, is only rendered once. Renderings are
+// evicted least recently used first once the cache exceeds its byte budget.
+// The caller decides which forms are safe to draw from a cached rendering.
+class CPDF_FormRenderCache {
+ public:
+  // Everything a rendered form depends on. Each form object parses its own
+  // copy of the form content, starting from the form object's graphic states,
+  // so those states are compared by value. The linear part of
+  // |form_to_device| and the fractional part of its translation are compared
+  // at 1/10000 precision. The integer part of the translation only moves the
+  // rendering and is ignored.
+  struct Key {
+    Key();
+    Key(const Key& that);
+    Key& operator=(const Key& that);
+    ~Key();
+
+    bool operator==(const Key& that) const;
+
+    RetainPtr<const CPDF_Stream> form;
+    RetainPtr<const CPDF_Dictionary> resources;
+    CFX_Matrix form_to_device;
+    CFX_GraphState graph_state;
+    CPDF_ColorState color_state;
+    CPDF_TextState text_state;
+    CPDF_GeneralState general_state;
+    CPDF_RenderOptions::Options options;
+  };
+
+  // A rendered form. |origin| is where the top left corner of |bitmap| goes,
+  // relative to the integer part of the form-to-device translation.
+  struct Rendering {
+    Rendering();
+    Rendering(const Rendering& that);
+    Rendering& operator=(const Rendering& that);
+    ~Rendering();
+
+    RetainPtr<CFX_DIBitmap> bitmap;
+    CFX_Point origin;
+  };
+
+  static constexpr size_t kDefaultByteBudget = 64 * 1024 * 1024;
+
+  CPDF_FormRenderCache();
+  explicit CPDF_FormRenderCache(size_t byte_budget);
+  ~CPDF_FormRenderCache();
+
+  // Returns a rendering with a null bitmap when there is no match. The
+  // returned bitmap is shared with the cache and must not be modified.
+  Rendering Find(const Key& key);
+
+  // Renderings larger than the whole budget are not kept.
+  void Add(const Key& key, const Rendering& rendering);
+
+  size_t GetSizeInBytes() const { return m_SizeInBytes; }
+  size_t GetRenderingCount() const { return m_LruList.size(); }
+
+ private:
+  struct Entry {
+    Entry(const Key& key, const Rendering& rendering);
+    ~Entry();
+
+    Key key;
+    Rendering rendering;
+    size_t size_in_bytes;
+  };
+  using LruList = std::list<Entry>;
+
+  void EvictLeastRecentlyUsed();
+
+  const size_t m_ByteBudget;
+  size_t m_SizeInBytes = 0;
+  // Most recently used first.
+  LruList m_LruList;
+  std::map<RetainPtr<const CPDF_Stream>,
+           std::vector<LruList::iterator>,
+           std::less<>>
+      m_Renderings;
+};
+
+#endif  // CORE_FPDFAPI_RENDER_CPDF_FORMRENDERCACHE_H_
@@ -0,0 +1,147 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_formrendercache.h"
+
+#include <utility>
+
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+CPDF_FormRenderCache::Rendering MakeRendering(int width, int height) {
+  CPDF_FormRenderCache::Rendering rendering;
+  rendering.bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  EXPECT_TRUE(rendering.bitmap->Create(width, height, FXDIB_Format::kArgb));
+  rendering.origin = CFX_Point(-1, -2);
+  return rendering;
+}
+
+CPDF_FormRenderCache::Key MakeKey(RetainPtr<const CPDF_Stream> form) {
+  CPDF_FormRenderCache::Key key;
+  key.form = std::move(form);
+  key.form_to_device = CFX_Matrix(2, 0, 0, -2, 10.25f, 800.5f);
+  return key;
+}
+
+}  // namespace
+
+TEST(CPDF_FormRenderCache, FindAdded) {
+  auto form = pdfium::MakeRetain<CPDF_Stream>();
+  CPDF_FormRenderCache cache;
+  CPDF_FormRenderCache::Key key = MakeKey(form);
+  EXPECT_FALSE(cache.Find(key).bitmap);
+
+  CPDF_FormRenderCache::Rendering rendering = MakeRendering(8, 8);
+  cache.Add(key, rendering);
+  CPDF_FormRenderCache::Rendering found = cache.Find(key);
+  EXPECT_EQ(rendering.bitmap, found.bitmap);
+  EXPECT_EQ(rendering.origin, found.origin);
+  EXPECT_EQ(1u, cache.GetRenderingCount());
+  EXPECT_EQ(8u * 8u * 4u, cache.GetSizeInBytes());
+
+  // Moving the form by whole pixels reuses the rendering.
+  CPDF_FormRenderCache::Key moved = key;
+  moved.form_to_device.e = 310.25f;
+  moved.form_to_device.f = -11.5f;
+  EXPECT_EQ(rendering.bitmap, cache.Find(moved).bitmap);
+
+  // A different subpixel offset does not.
+  CPDF_FormRenderCache::Key shifted = key;
+  shifted.form_to_device.e = 10.5f;
+  EXPECT_FALSE(cache.Find(shifted).bitmap);
+
+  CPDF_FormRenderCache::Key scaled = key;
+  scaled.form_to_device.a = 2.01f;
+  EXPECT_FALSE(cache.Find(scaled).bitmap);
+
+  CPDF_FormRenderCache::Key other_options = key;
+  other_options.options.bNoTextSmooth = true;
+  EXPECT_FALSE(cache.Find(other_options).bitmap);
+
+  CPDF_FormRenderCache::Key other_resources = key;
+  other_resources.resources = pdfium::MakeRetain<CPDF_Dictionary>();
+  EXPECT_FALSE(cache.Find(other_resources).bitmap);
+
+  auto other_form = pdfium::MakeRetain<CPDF_Stream>();
+  EXPECT_FALSE(cache.Find(MakeKey(other_form)).bitmap);
+}
+
+TEST(CPDF_FormRenderCache, StatesComparedByValue) {
+  auto form = pdfium::MakeRetain<CPDF_Stream>();
+  CPDF_FormRenderCache cache;
+  CPDF_FormRenderCache::Key key = MakeKey(form);
+  key.graph_state.SetLineWidth(2.0f);
+  key.text_state.SetFontSize(12.0f);
+  key.general_state.Emplace();
+  key.general_state.SetFillAlpha(0.5f);
+  CPDF_FormRenderCache::Rendering rendering = MakeRendering(4, 4);
+  cache.Add(key, rendering);
+
+  // Separately built states with the same values share the rendering.
+  CPDF_FormRenderCache::Key same = MakeKey(form);
+  same.graph_state.SetLineWidth(2.0f);
+  same.text_state.SetFontSize(12.0f);
+  same.general_state.Emplace();
+  same.general_state.SetFillAlpha(0.5f);
+  EXPECT_EQ(rendering.bitmap, cache.Find(same).bitmap);
+
+  CPDF_FormRenderCache::Key wider = same;
+  wider.graph_state.SetLineWidth(3.0f);
+  EXPECT_FALSE(cache.Find(wider).bitmap);
+
+  CPDF_FormRenderCache::Key bigger_text = same;
+  bigger_text.text_state = CPDF_TextState();
+  bigger_text.text_state.Emplace();
+  bigger_text.text_state.SetFontSize(14.0f);
+  EXPECT_FALSE(cache.Find(bigger_text).bitmap);
+
+  CPDF_FormRenderCache::Key more_opaque = same;
+  more_opaque.general_state = CPDF_GeneralState();
+  more_opaque.general_state.Emplace();
+  more_opaque.general_state.SetFillAlpha(1.0f);
+  EXPECT_FALSE(cache.Find(more_opaque).bitmap);
+
+  CPDF_FormRenderCache::Key colored = same;
+  colored.color_state.Emplace();
+  EXPECT_FALSE(cache.Find(colored).bitmap);
+}
+
+TEST(CPDF_FormRenderCache, EvictLeastRecentlyUsed) {
+  auto form = pdfium::MakeRetain<CPDF_Stream>();
+  constexpr size_t kRenderingBytes = 16 * 16 * 4;
+  CPDF_FormRenderCache cache(3 * kRenderingBytes);
+  CPDF_FormRenderCache::Key key1 = MakeKey(form);
+  CPDF_FormRenderCache::Key key2 = key1;
+  key2.form_to_device.a = 3;
+  CPDF_FormRenderCache::Key key3 = key1;
+  key3.form_to_device.a = 4;
+  CPDF_FormRenderCache::Key key4 = key1;
+  key4.form_to_device.a = 5;
+
+  cache.Add(key1, MakeRendering(16, 16));
+  cache.Add(key2, MakeRendering(16, 16));
+  cache.Add(key3, MakeRendering(16, 16));
+  EXPECT_EQ(3u, cache.GetRenderingCount());
+
+  // Touching |key1| makes |key2| the oldest.
+  EXPECT_TRUE(cache.Find(key1).bitmap);
+  cache.Add(key4, MakeRendering(16, 16));
+  EXPECT_EQ(3u, cache.GetRenderingCount());
+  EXPECT_EQ(3 * kRenderingBytes, cache.GetSizeInBytes());
+  EXPECT_TRUE(cache.Find(key1).bitmap);
+  EXPECT_FALSE(cache.Find(key2).bitmap);
+  EXPECT_TRUE(cache.Find(key3).bitmap);
+  EXPECT_TRUE(cache.Find(key4).bitmap);
+
+  // A rendering larger than the whole budget is not kept.
+  CPDF_FormRenderCache::Key huge = key1;
+  huge.form_to_device.a = 6;
+  cache.Add(huge, MakeRendering(64, 64));
+  EXPECT_FALSE(cache.Find(huge).bitmap);
+  EXPECT_EQ(3u, cache.GetRenderingCount());
+}
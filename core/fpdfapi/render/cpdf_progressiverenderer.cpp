@@ -6,6 +6,8 @@
 
 #include "core/fpdfapi/render/cpdf_progressiverenderer.h"
 
+#include <algorithm>
+
 #include "core/fpdfapi/page/cpdf_image.h"
 #include "core/fpdfapi/page/cpdf_imageobject.h"
 #include "core/fpdfapi/page/cpdf_pageimagecache.h"
@@ -57,6 +59,9 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
       m_pDevice->SaveState();
       m_ClipRect = m_pCurrentLayer->GetMatrix().GetInverse().TransformRect(
           CFX_FloatRect(m_pDevice->GetClipBox()));
+      m_VisibleObjects =
+          m_pCurrentLayer->GetObjectHolder()->FindPageObjectsInRect(
+              m_ClipRect);
     }
     CPDF_PageObjectHolder::const_iterator iter;
     CPDF_PageObjectHolder::const_iterator iterEnd =
@@ -67,6 +72,7 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
     } else {
       iter = m_pCurrentLayer->GetObjectHolder()->begin();
     }
+    iter = SkipToVisibleObject(iter);
     int nObjsToGo = kStepLimit;
     bool is_mask = false;
     while (iter != iterEnd) {
@@ -106,7 +112,7 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
           return;
         nObjsToGo = kStepLimit;
       }
-      ++iter;
+      iter = SkipToVisibleObject(++iter);
       if (is_mask && iter != iterEnd)
         return;
     }
@@ -129,3 +135,20 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
     }
   }
 }
+
+CPDF_PageObjectHolder::const_iterator
+CPDF_ProgressiveRenderer::SkipToVisibleObject(
+    CPDF_PageObjectHolder::const_iterator iter) const {
+  if (!m_VisibleObjects.has_value())
+    return iter;
+
+  const CPDF_PageObjectHolder* pHolder = m_pCurrentLayer->GetObjectHolder();
+  if (iter == pHolder->end())
+    return iter;
+
+  const std::vector<uint32_t>& visible_objects = m_VisibleObjects.value();
+  auto it = std::lower_bound(visible_objects.begin(), visible_objects.end(),
+                             static_cast<uint32_t>(iter - pHolder->begin()));
+  return it != visible_objects.end() ? pHolder->begin() + *it
+                                     : pHolder->end();
+}
@@ -10,11 +10,13 @@
 #include <stdint.h>
 
 #include <memory>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_pageobjectholder.h"
 #include "core/fpdfapi/render/cpdf_rendercontext.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/unowned_ptr.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 class CPDF_RenderOptions;
 class CPDF_RenderStatus;
@@ -46,6 +48,11 @@ class CPDF_ProgressiveRenderer {
   // Maximum page objects to render before checking for pause.
   static constexpr int kStepLimit = 100;
 
+  // Returns the first object at or after |iter| that may intersect
+  // |m_ClipRect|.
+  CPDF_PageObjectHolder::const_iterator SkipToVisibleObject(
+      CPDF_PageObjectHolder::const_iterator iter) const;
+
   Status m_Status = kReady;
   UnownedPtr<CPDF_RenderContext> const m_pContext;
   UnownedPtr<CFX_RenderDevice> const m_pDevice;
@@ -55,6 +62,10 @@ class CPDF_ProgressiveRenderer {
   uint32_t m_LayerIndex = 0;
   CPDF_RenderContext::Layer* m_pCurrentLayer = nullptr;
   CPDF_PageObjectHolder::const_iterator m_LastObjectRendered;
+
+  // Indexes of the current layer's objects that may intersect |m_ClipRect|,
+  // if its object holder has a spatial index.
+  absl::optional<std::vector<uint32_t>> m_VisibleObjects;
 };
 
 #endif  // CORE_FPDFAPI_RENDER_CPDF_PROGRESSIVERENDERER_H_
@@ -0,0 +1,63 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_render_utils.h"
+
+#include "core/fpdfapi/page/cpdf_colorstate.h"
+#include "core/fpdfapi/page/cpdf_contentmarkitem.h"
+#include "core/fpdfapi/page/cpdf_contentmarks.h"
+#include "core/fpdfapi/page/cpdf_form.h"
+#include "core/fpdfapi/page/cpdf_formobject.h"
+#include "core/fpdfapi/page/cpdf_image.h"
+#include "core/fpdfapi/page/cpdf_imageobject.h"
+#include "core/fpdfapi/page/cpdf_pageobject.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fxcrt/fx_coordinates.h"
+
+bool IsAvailableMatrix(const CFX_Matrix& matrix) {
+  if (matrix.a == 0 || matrix.d == 0)
+    return matrix.b != 0 && matrix.c != 0;
+
+  if (matrix.b == 0 || matrix.c == 0)
+    return matrix.a != 0 && matrix.d != 0;
+
+  return true;
+}
+
+bool HasOptionalContentMark(const CPDF_PageObject* pObj) {
+  const CPDF_ContentMarks* pMarks = pObj->GetContentMarks();
+  for (size_t i = 0; i < pMarks->CountItems(); ++i) {
+    if (pMarks->GetItem(i)->GetName() == "OC")
+      return true;
+  }
+  return false;
+}
+
+bool UsesPattern(const CPDF_ColorState& color_state) {
+  return color_state.HasRef() && (color_state.GetFillColor()->IsPattern() ||
+                                  color_state.GetStrokeColor()->IsPattern());
+}
+
+bool CanFlattenPageObject(const CPDF_PageObject* pObj) {
+  if (pObj->m_GeneralState.GetBlendType() != BlendMode::kNormal ||
+      pObj->m_GeneralState.GetSoftMask() || UsesPattern(pObj->m_ColorState) ||
+      HasOptionalContentMark(pObj)) {
+    return false;
+  }
+  if (pObj->m_ClipPath.HasRef() && pObj->m_ClipPath.GetTextCount() > 0)
+    return false;
+
+  if (pObj->IsImage() && pObj->AsImage()->GetImage()->GetOC())
+    return false;
+
+  const CPDF_FormObject* pFormObj = pObj->AsForm();
+  if (!pFormObj)
+    return true;
+
+  // Translucent forms and transparency groups are composited as a whole.
+  const CPDF_Form* pForm = pFormObj->form();
+  return pFormObj->m_GeneralState.GetFillAlpha() == 1.0f &&
+         !pForm->GetTransparency().IsGroup() &&
+         !pForm->GetDict()->KeyExist("OC");
+}
@@ -0,0 +1,29 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_RENDER_CPDF_RENDER_UTILS_H_
+#define CORE_FPDFAPI_RENDER_CPDF_RENDER_UTILS_H_
+
+class CFX_Matrix;
+class CPDF_ColorState;
+class CPDF_PageObject;
+
+// Returns false for matrices that collapse what they map to nothing, which
+// the renderer does not draw.
+bool IsAvailableMatrix(const CFX_Matrix& matrix);
+
+bool HasOptionalContentMark(const CPDF_PageObject* pObj);
+bool UsesPattern(const CPDF_ColorState& color_state);
+
+// Returns whether |pObj| can be drawn ahead of time, apart from the page,
+// and give the same result as drawing it in place. That rules out anything
+// that reads the backdrop, such as blend modes, soft masks and forms that are
+// composited as a whole, as well as patterns, optional content and text
+// clips, whose results depend on state outside the object. Objects inside
+// forms are not checked.
+//
+// The form render cache and display lists only hold such objects.
+bool CanFlattenPageObject(const CPDF_PageObject* pObj);
+
+#endif  // CORE_FPDFAPI_RENDER_CPDF_RENDER_UTILS_H_
@@ -75,6 +75,22 @@ void CPDF_RenderContext::Render(CFX_RenderDevice* pDevice,
   }
 }
 
+void CPDF_RenderContext::RenderDisplayList(CFX_RenderDevice* pDevice,
+                                           const CPDF_DisplayList& list,
+                                           const CPDF_RenderOptions* pOptions,
+                                           const CFX_Matrix& mtPage2Device) {
+  CFX_RenderDevice::StateRestorer restorer(pDevice);
+  CPDF_RenderStatus status(this, pDevice);
+  if (pOptions)
+    status.SetOptions(*pOptions);
+  status.Initialize(nullptr, nullptr);
+  status.RenderDisplayList(list, mtPage2Device);
+  if (status.GetRenderOptions().GetOptions().bLimitedImageCache) {
+    m_pPageCache->CacheOptimization(
+        status.GetRenderOptions().GetCacheSizeLimit());
+  }
+}
+
 CPDF_RenderContext::Layer::Layer(CPDF_PageObjectHolder* pHolder,
                                  const CFX_Matrix& matrix)
     : m_pObjectHolder(pHolder), m_Matrix(matrix) {}
@@ -9,6 +9,7 @@
 
 #include <vector>
 
+#include "core/fpdfapi/render/cpdf_scratchbitmappool.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/unowned_ptr.h"
@@ -17,6 +18,7 @@ class CFX_DIBitmap;
 class CFX_Matrix;
 class CFX_RenderDevice;
 class CPDF_Dictionary;
+class CPDF_DisplayList;
 class CPDF_Document;
 class CPDF_PageImageCache;
 class CPDF_PageObject;
@@ -52,6 +54,12 @@ class CPDF_RenderContext {
               const CPDF_RenderOptions* pOptions,
               const CFX_Matrix* pLastMatrix);
 
+  // Draws a display list compiled from the page instead of the layers.
+  void RenderDisplayList(CFX_RenderDevice* pDevice,
+                         const CPDF_DisplayList& list,
+                         const CPDF_RenderOptions* pOptions,
+                         const CFX_Matrix& mtPage2Device);
+
   void GetBackground(RetainPtr<CFX_DIBitmap> pBuffer,
                      const CPDF_PageObject* pObj,
                      const CPDF_RenderOptions* pOptions,
@@ -68,12 +76,16 @@ class CPDF_RenderContext {
     return m_pPageResources;
   }
   CPDF_PageImageCache* GetPageCache() const { return m_pPageCache; }
+  CPDF_ScratchBitmapPool* GetScratchBitmapPool() {
+    return &m_ScratchBitmapPool;
+  }
 
  private:
   UnownedPtr<CPDF_Document> const m_pDocument;
   RetainPtr<CPDF_Dictionary> const m_pPageResources;
   UnownedPtr<CPDF_PageImageCache> const m_pPageCache;
   std::vector<Layer> m_Layers;
+  CPDF_ScratchBitmapPool m_ScratchBitmapPool;
 };
 
 #endif  // CORE_FPDFAPI_RENDER_CPDF_RENDERCONTEXT_H_
@@ -20,6 +20,20 @@ CPDF_RenderOptions::Options::Options(const CPDF_RenderOptions::Options& rhs) =
 CPDF_RenderOptions::Options& CPDF_RenderOptions::Options::operator=(
     const CPDF_RenderOptions::Options& rhs) = default;
 
+bool CPDF_RenderOptions::Options::operator==(
+    const CPDF_RenderOptions::Options& rhs) const {
+  return bClearType == rhs.bClearType && bNoNativeText == rhs.bNoNativeText &&
+         bForceHalftone == rhs.bForceHalftone && bRectAA == rhs.bRectAA &&
+         bBreakForMasks == rhs.bBreakForMasks &&
+         bNoTextSmooth == rhs.bNoTextSmooth &&
+         bNoPathSmooth == rhs.bNoPathSmooth &&
+         bNoImageSmooth == rhs.bNoImageSmooth &&
+         bLimitedImageCache == rhs.bLimitedImageCache &&
+         bConvertFillToStroke == rhs.bConvertFillToStroke &&
+         bCacheForms == rhs.bCacheForms && bLowDetail == rhs.bLowDetail &&
+         fLowDetailThreshold == rhs.fLowDetailThreshold;
+}
+
 CPDF_RenderOptions::CPDF_RenderOptions() {
   // TODO(thestig): Make constexpr to initialize |m_Options| once C++14 is
   // available.
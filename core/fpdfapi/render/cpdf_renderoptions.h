@@ -27,6 +27,9 @@ class CPDF_RenderOptions {
     Options(const Options& rhs);
     Options& operator=(const Options& rhs);
 
+    bool operator==(const Options& rhs) const;
+    bool operator!=(const Options& rhs) const { return !(*this == rhs); }
+
     bool bClearType = false;
     bool bNoNativeText = false;
     bool bForceHalftone = false;
@@ -37,6 +40,11 @@ class CPDF_RenderOptions {
     bool bNoImageSmooth = false;
     bool bLimitedImageCache = false;
     bool bConvertFillToStroke = false;
+    bool bCacheForms = false;
+    bool bLowDetail = false;
+    // With |bLowDetail|, paths narrower or shorter than this many device
+    // pixels and text with glyphs smaller than it are drawn as approximations.
+    float fLowDetailThreshold = 1.0f;
   };
 
   struct ColorScheme {
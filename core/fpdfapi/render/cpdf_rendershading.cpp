@@ -24,6 +24,7 @@
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fpdfapi/render/cpdf_devicebuffer.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
+#include "core/fxcrt/fx_2d_size.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_system.h"
 #include "core/fxcrt/span_util.h"
@@ -58,6 +59,62 @@ uint32_t GetValidatedOutputsCount(
   return funcs_outputs ? std::max(funcs_outputs, pCS->CountComponents()) : 0;
 }
 
+// Evaluates |funcs| on every |nInputs| values in |inputs| and converts the
+// concatenated results through |pCS|, writing an RGB triple per set of inputs
+// to |rgbs|. If a function fails on any set of inputs, falls back to calling
+// each function and then GetRGB() one set at a time.
+void GetShadingRGBs(pdfium::span<const float> inputs,
+                    uint32_t nInputs,
+                    const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
+                    const RetainPtr<CPDF_ColorSpace>& pCS,
+                    size_t results_count,
+                    pdfium::span<float> rgbs) {
+  const size_t count = inputs.size() / nInputs;
+  DCHECK_EQ(rgbs.size(), count * 3);
+  std::vector<float> result_array(Fx2DSizeOrDie(count, results_count));
+  std::vector<float> func_results;
+  size_t offset = 0;
+  bool batched = true;
+  for (const auto& func : funcs) {
+    // Call() fails every time for a function with the wrong number of
+    // inputs, so it contributes no results.
+    if (!func || func->CountInputs() != nInputs)
+      continue;
+
+    const uint32_t nOutputs = func->CountOutputs();
+    func_results.resize(Fx2DSizeOrDie(count, nOutputs));
+    if (!func->CallBatch(inputs, func_results).has_value()) {
+      batched = false;
+      break;
+    }
+    for (size_t n = 0; n < count; ++n) {
+      fxcrt::spancpy(
+          pdfium::make_span(result_array)
+              .subspan(n * results_count + offset, nOutputs),
+          pdfium::make_span(func_results).subspan(n * nOutputs, nOutputs));
+    }
+    offset += nOutputs;
+  }
+  if (batched) {
+    pCS->GetRGBs(result_array, results_count, rgbs);
+    return;
+  }
+
+  result_array.assign(results_count, 0.0f);
+  for (size_t n = 0; n < count; ++n) {
+    pdfium::span<const float> input = inputs.subspan(n * nInputs, nInputs);
+    pdfium::span<float> result_span = pdfium::make_span(result_array);
+    for (const auto& func : funcs) {
+      if (!func)
+        continue;
+      absl::optional<uint32_t> nresults = func->Call(input, result_span);
+      if (nresults.has_value())
+        result_span = result_span.subspan(nresults.value());
+    }
+    pCS->GetRGBs(result_array, results_count, rgbs.subspan(n * 3, 3));
+  }
+}
+
 std::array<FX_ARGB, kShadingSteps> GetShadingSteps(
     float t_min,
     float t_max,
@@ -67,26 +124,20 @@ std::array<FX_ARGB, kShadingSteps> GetShadingSteps(
     size_t results_count) {
   DCHECK(results_count >= CountOutputsFromFunctions(funcs));
   DCHECK(results_count >= pCS->CountComponents());
-  std::array<FX_ARGB, kShadingSteps> shading_steps;
-  std::vector<float> result_array(results_count);
+  std::array<float, kShadingSteps> inputs;
   float diff = t_max - t_min;
+  for (int i = 0; i < kShadingSteps; ++i)
+    inputs[i] = diff * i / kShadingSteps + t_min;
+
+  std::array<float, kShadingSteps * 3> rgbs;
+  GetShadingRGBs(pdfium::make_span(inputs), /*nInputs=*/1, funcs, pCS,
+                 results_count, pdfium::make_span(rgbs));
+
+  std::array<FX_ARGB, kShadingSteps> shading_steps;
   for (int i = 0; i < kShadingSteps; ++i) {
-    float input = diff * i / kShadingSteps + t_min;
-    pdfium::span<float> result_span = pdfium::make_span(result_array);
-    for (const auto& func : funcs) {
-      if (!func)
-        continue;
-      absl::optional<uint32_t> nresults =
-          func->Call(pdfium::make_span(&input, 1), result_span);
-      if (nresults.has_value())
-        result_span = result_span.subspan(nresults.value());
-    }
-    float R = 0.0f;
-    float G = 0.0f;
-    float B = 0.0f;
-    pCS->GetRGB(result_array, &R, &G, &B);
-    shading_steps[i] = ArgbEncode(alpha, FXSYS_roundf(R * 255),
-                                  FXSYS_roundf(G * 255), FXSYS_roundf(B * 255));
+    shading_steps[i] = ArgbEncode(alpha, FXSYS_roundf(rgbs[i * 3] * 255),
+                                  FXSYS_roundf(rgbs[i * 3 + 1] * 255),
+                                  FXSYS_roundf(rgbs[i * 3 + 2] * 255));
   }
   return shading_steps;
 }
@@ -285,32 +336,35 @@ void DrawFuncShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
 
   DCHECK(total_results >= CountOutputsFromFunctions(funcs));
   DCHECK(total_results >= pCS->CountComponents());
-  std::vector<float> result_array(total_results);
+  std::vector<int> columns;
+  std::vector<float> inputs;
+  std::vector<float> rgbs;
   for (int row = 0; row < height; ++row) {
-    uint32_t* dib_buf =
-        reinterpret_cast<uint32_t*>(pBitmap->GetWritableScanline(row).data());
+    // Evaluate the whole row at once.
+    columns.clear();
+    inputs.clear();
     for (int column = 0; column < width; column++) {
       CFX_PointF pos = matrix.Transform(
           CFX_PointF(static_cast<float>(column), static_cast<float>(row)));
       if (pos.x < xmin || pos.x > xmax || pos.y < ymin || pos.y > ymax)
         continue;
 
-      float input[2] = {pos.x, pos.y};
-      pdfium::span<float> result_span = pdfium::make_span(result_array);
-      for (const auto& func : funcs) {
-        if (!func)
-          continue;
-        absl::optional<uint32_t> nresults = func->Call(input, result_span);
-        if (nresults.has_value())
-          result_span = result_span.subspan(nresults.value());
-      }
-      float R = 0.0f;
-      float G = 0.0f;
-      float B = 0.0f;
-      pCS->GetRGB(result_array, &R, &G, &B);
-      dib_buf[column] = ArgbEncode(alpha, static_cast<int32_t>(R * 255),
-                                   static_cast<int32_t>(G * 255),
-                                   static_cast<int32_t>(B * 255));
+      columns.push_back(column);
+      inputs.push_back(pos.x);
+      inputs.push_back(pos.y);
+    }
+    if (columns.empty())
+      continue;
+
+    rgbs.resize(columns.size() * 3);
+    GetShadingRGBs(inputs, /*nInputs=*/2, funcs, pCS, total_results, rgbs);
+    uint32_t* dib_buf =
+        reinterpret_cast<uint32_t*>(pBitmap->GetWritableScanline(row).data());
+    for (size_t i = 0; i < columns.size(); ++i) {
+      dib_buf[columns[i]] =
+          ArgbEncode(alpha, static_cast<int32_t>(rgbs[i * 3] * 255),
+                     static_cast<int32_t>(rgbs[i * 3 + 1] * 255),
+                     static_cast<int32_t>(rgbs[i * 3 + 2] * 255));
     }
   }
 }
@@ -332,87 +386,150 @@ bool GetScanlineIntersect(int y,
   return true;
 }
 
-void DrawGouraud(const RetainPtr<CFX_DIBitmap>& pBitmap,
-                 int alpha,
-                 CPDF_MeshVertex triangle[3]) {
-  float min_y = triangle[0].position.y;
-  float max_y = triangle[0].position.y;
-  for (int i = 1; i < 3; i++) {
-    min_y = std::min(min_y, triangle[i].position.y);
-    max_y = std::max(max_y, triangle[i].position.y);
+void DrawGouraudRow(const RetainPtr<CFX_DIBitmap>& pBitmap,
+                    int alpha,
+                    const CPDF_MeshVertex triangle[3],
+                    int y) {
+  int nIntersects = 0;
+  float inter_x[3];
+  float r[3];
+  float g[3];
+  float b[3];
+  for (int i = 0; i < 3; i++) {
+    const CPDF_MeshVertex& vertex1 = triangle[i];
+    const CPDF_MeshVertex& vertex2 = triangle[(i + 1) % 3];
+    const CFX_PointF& position1 = vertex1.position;
+    const CFX_PointF& position2 = vertex2.position;
+    bool bIntersect =
+        GetScanlineIntersect(y, position1, position2, &inter_x[nIntersects]);
+    if (!bIntersect)
+      continue;
+
+    float y_dist = (y - position1.y) / (position2.y - position1.y);
+    r[nIntersects] = vertex1.r + ((vertex2.r - vertex1.r) * y_dist);
+    g[nIntersects] = vertex1.g + ((vertex2.g - vertex1.g) * y_dist);
+    b[nIntersects] = vertex1.b + ((vertex2.b - vertex1.b) * y_dist);
+    nIntersects++;
   }
-  if (min_y == max_y)
+  if (nIntersects != 2)
     return;
 
-  int min_yi = std::max(static_cast<int>(floorf(min_y)), 0);
-  int max_yi = static_cast<int>(ceilf(max_y));
-  if (max_yi >= pBitmap->GetHeight())
-    max_yi = pBitmap->GetHeight() - 1;
-
-  for (int y = min_yi; y <= max_yi; y++) {
-    int nIntersects = 0;
-    float inter_x[3];
-    float r[3];
-    float g[3];
-    float b[3];
-    for (int i = 0; i < 3; i++) {
-      CPDF_MeshVertex& vertex1 = triangle[i];
-      CPDF_MeshVertex& vertex2 = triangle[(i + 1) % 3];
-      CFX_PointF& position1 = vertex1.position;
-      CFX_PointF& position2 = vertex2.position;
-      bool bIntersect =
-          GetScanlineIntersect(y, position1, position2, &inter_x[nIntersects]);
-      if (!bIntersect)
-        continue;
+  int min_x;
+  int max_x;
+  int start_index;
+  int end_index;
+  if (inter_x[0] < inter_x[1]) {
+    min_x = static_cast<int>(floorf(inter_x[0]));
+    max_x = static_cast<int>(ceilf(inter_x[1]));
+    start_index = 0;
+    end_index = 1;
+  } else {
+    min_x = static_cast<int>(floorf(inter_x[1]));
+    max_x = static_cast<int>(ceilf(inter_x[0]));
+    start_index = 1;
+    end_index = 0;
+  }
 
-      float y_dist = (y - position1.y) / (position2.y - position1.y);
-      r[nIntersects] = vertex1.r + ((vertex2.r - vertex1.r) * y_dist);
-      g[nIntersects] = vertex1.g + ((vertex2.g - vertex1.g) * y_dist);
-      b[nIntersects] = vertex1.b + ((vertex2.b - vertex1.b) * y_dist);
-      nIntersects++;
-    }
-    if (nIntersects != 2)
-      continue;
+  int start_x = pdfium::clamp(min_x, 0, pBitmap->GetWidth());
+  int end_x = pdfium::clamp(max_x, 0, pBitmap->GetWidth());
+  float r_unit = (r[end_index] - r[start_index]) / (max_x - min_x);
+  float g_unit = (g[end_index] - g[start_index]) / (max_x - min_x);
+  float b_unit = (b[end_index] - b[start_index]) / (max_x - min_x);
+  float r_result = r[start_index] + (start_x - min_x) * r_unit;
+  float g_result = g[start_index] + (start_x - min_x) * g_unit;
+  float b_result = b[start_index] + (start_x - min_x) * b_unit;
+  pdfium::span<uint8_t> dib_span =
+      pBitmap->GetWritableScanline(y).subspan(start_x * 4);
+
+  for (int x = start_x; x < end_x; x++) {
+    uint8_t* dib_buf = dib_span.data();
+    r_result += r_unit;
+    g_result += g_unit;
+    b_result += b_unit;
+    FXARGB_SETDIB(dib_buf, ArgbEncode(alpha, static_cast<int>(r_result * 255),
+                                      static_cast<int>(g_result * 255),
+                                      static_cast<int>(b_result * 255)));
+    dib_span = dib_span.subspan(4);
+  }
+}
 
-    int min_x;
-    int max_x;
-    int start_index;
-    int end_index;
-    if (inter_x[0] < inter_x[1]) {
-      min_x = static_cast<int>(floorf(inter_x[0]));
-      max_x = static_cast<int>(ceilf(inter_x[1]));
-      start_index = 0;
-      end_index = 1;
-    } else {
-      min_x = static_cast<int>(floorf(inter_x[1]));
-      max_x = static_cast<int>(ceilf(inter_x[0]));
-      start_index = 1;
-      end_index = 0;
+// Gouraud-shaded triangles of a mesh, collected before drawing so they can be
+// drawn band by band. Every triangle that touches a band is drawn while the
+// band's scanlines are still in cache. Triangles keep their stream order
+// within a band, so each pixel gets the same value as when the triangles are
+// drawn one after another. The buffer is drawn and emptied whenever it fills
+// up, so large meshes do not take more memory.
+class GouraudTriangleBuffer {
+ public:
+  GouraudTriangleBuffer(RetainPtr<CFX_DIBitmap> pBitmap, int alpha)
+      : m_pBitmap(std::move(pBitmap)), m_Alpha(alpha) {}
+
+  void Add(const CPDF_MeshVertex triangle[3]) {
+    float min_y = triangle[0].position.y;
+    float max_y = triangle[0].position.y;
+    for (int i = 1; i < 3; i++) {
+      min_y = std::min(min_y, triangle[i].position.y);
+      max_y = std::max(max_y, triangle[i].position.y);
     }
+    if (min_y == max_y)
+      return;
+
+    int min_yi = std::max(static_cast<int>(floorf(min_y)), 0);
+    int max_yi = static_cast<int>(ceilf(max_y));
+    if (max_yi >= m_pBitmap->GetHeight())
+      max_yi = m_pBitmap->GetHeight() - 1;
+    if (min_yi > max_yi)
+      return;
+
+    m_Triangles.push_back({{triangle[0], triangle[1], triangle[2]},
+                           min_yi,
+                           max_yi});
+    if (m_Triangles.size() >= kMaxTriangles)
+      Flush();
+  }
+
+  // Draws the buffered triangles and empties the buffer.
+  void Flush() {
+    if (m_Triangles.empty())
+      return;
 
-    int start_x = pdfium::clamp(min_x, 0, pBitmap->GetWidth());
-    int end_x = pdfium::clamp(max_x, 0, pBitmap->GetWidth());
-    float r_unit = (r[end_index] - r[start_index]) / (max_x - min_x);
-    float g_unit = (g[end_index] - g[start_index]) / (max_x - min_x);
-    float b_unit = (b[end_index] - b[start_index]) / (max_x - min_x);
-    float r_result = r[start_index] + (start_x - min_x) * r_unit;
-    float g_result = g[start_index] + (start_x - min_x) * g_unit;
-    float b_result = b[start_index] + (start_x - min_x) * b_unit;
-    pdfium::span<uint8_t> dib_span =
-        pBitmap->GetWritableScanline(y).subspan(start_x * 4);
-
-    for (int x = start_x; x < end_x; x++) {
-      uint8_t* dib_buf = dib_span.data();
-      r_result += r_unit;
-      g_result += g_unit;
-      b_result += b_unit;
-      FXARGB_SETDIB(dib_buf, ArgbEncode(alpha, static_cast<int>(r_result * 255),
-                                        static_cast<int>(g_result * 255),
-                                        static_cast<int>(b_result * 255)));
-      dib_span = dib_span.subspan(4);
+    const int height = m_pBitmap->GetHeight();
+    std::vector<std::vector<uint32_t>> bands((height + kBandRows - 1) /
+                                             kBandRows);
+    for (size_t i = 0; i < m_Triangles.size(); i++) {
+      const Triangle& triangle = m_Triangles[i];
+      for (int band = triangle.min_y / kBandRows;
+           band <= triangle.max_y / kBandRows; band++) {
+        bands[band].push_back(static_cast<uint32_t>(i));
+      }
+    }
+    for (size_t band = 0; band < bands.size(); band++) {
+      const int top = static_cast<int>(band) * kBandRows;
+      const int bottom = std::min(top + kBandRows, height) - 1;
+      for (uint32_t index : bands[band]) {
+        const Triangle& triangle = m_Triangles[index];
+        const int last_y = std::min(triangle.max_y, bottom);
+        for (int y = std::max(triangle.min_y, top); y <= last_y; y++)
+          DrawGouraudRow(m_pBitmap, m_Alpha, triangle.vertices, y);
+      }
     }
+    m_Triangles.clear();
   }
-}
+
+ private:
+  static constexpr int kBandRows = 32;
+  static constexpr size_t kMaxTriangles = 4096;
+
+  struct Triangle {
+    CPDF_MeshVertex vertices[3];
+    int min_y;  // First bitmap row to draw.
+    int max_y;  // Last bitmap row to draw.
+  };
+
+  const RetainPtr<CFX_DIBitmap> m_pBitmap;
+  const int m_Alpha;
+  std::vector<Triangle> m_Triangles;
+};
 
 void DrawFreeGouraudShading(
     const RetainPtr<CFX_DIBitmap>& pBitmap,
@@ -428,20 +545,26 @@ void DrawFreeGouraudShading(
   if (!stream.Load())
     return;
 
+  GouraudTriangleBuffer triangles(pBitmap, alpha);
   CPDF_MeshVertex triangle[3];
   while (!stream.IsEOF()) {
     CPDF_MeshVertex vertex;
     uint32_t flag;
     if (!stream.ReadVertex(mtObject2Bitmap, &vertex, &flag))
-      return;
+      break;
 
     if (flag == 0) {
       triangle[0] = vertex;
+      bool bComplete = true;
       for (int i = 1; i < 3; ++i) {
         uint32_t dummy_flag;
-        if (!stream.ReadVertex(mtObject2Bitmap, &triangle[i], &dummy_flag))
-          return;
+        if (!stream.ReadVertex(mtObject2Bitmap, &triangle[i], &dummy_flag)) {
+          bComplete = false;
+          break;
+        }
       }
+      if (!bComplete)
+        break;
     } else {
       if (flag == 1)
         triangle[0] = triangle[1];
@@ -449,8 +572,9 @@ void DrawFreeGouraudShading(
       triangle[1] = triangle[2];
       triangle[2] = vertex;
     }
-    DrawGouraud(pBitmap, alpha, triangle);
+    triangles.Add(triangle);
   }
+  triangles.Flush();
 }
 
 void DrawLatticeGouraudShading(
@@ -476,23 +600,25 @@ void DrawLatticeGouraudShading(
   if (vertices[0].empty())
     return;
 
+  GouraudTriangleBuffer triangles(pBitmap, alpha);
   int last_index = 0;
   while (true) {
     vertices[1 - last_index] = stream.ReadVertexRow(mtObject2Bitmap, row_verts);
     if (vertices[1 - last_index].empty())
-      return;
+      break;
 
     CPDF_MeshVertex triangle[3];
     for (int i = 1; i < row_verts; ++i) {
       triangle[0] = vertices[last_index][i];
       triangle[1] = vertices[1 - last_index][i - 1];
       triangle[2] = vertices[last_index][i - 1];
-      DrawGouraud(pBitmap, alpha, triangle);
+      triangles.Add(triangle);
       triangle[2] = vertices[1 - last_index][i];
-      DrawGouraud(pBitmap, alpha, triangle);
+      triangles.Add(triangle);
     }
     last_index = 1 - last_index;
   }
+  triangles.Flush();
 }
 
 struct CoonBezierCoeff {
@@ -710,16 +836,14 @@ struct PatchDrawer {
       D2.GetPoints(points.subspan(3, 4));
       C2.GetPointsReverse(points.subspan(6, 4));
       D1.GetPointsReverse(points.subspan(9, 4));
-      CFX_FillRenderOptions fill_options(
-          CFX_FillRenderOptions::WindingOptions());
-      fill_options.full_cover = true;
-      if (bNoPathSmooth)
-        fill_options.aliased_path = true;
-      pDevice->DrawPath(
-          path, nullptr, nullptr,
+      SubPatch& sub_patch = sub_patches.emplace_back();
+      for (size_t i = 0; i < kSubPatchPoints; ++i)
+        sub_patch.points[i] = points[i].m_Point;
+      sub_patch.color =
           ArgbEncode(alpha, div_colors[0].comp[0], div_colors[0].comp[1],
-                     div_colors[0].comp[2]),
-          0, fill_options);
+                     div_colors[0].comp[2]);
+      if (sub_patches.size() >= kMaxSubPatches)
+        FlushSubPatches();
     } else {
       if (d_bottom < kCoonColorThreshold && d_top < kCoonColorThreshold) {
         CoonBezier m1;
@@ -765,12 +889,50 @@ struct PatchDrawer {
     }
   }
 
+  // Draws the sub-patches collected by Draw() in order, skipping the ones
+  // that lie outside the device, and clears them. Draw() flushes on its own
+  // when a patch is subdivided into more than kMaxSubPatches pieces.
+  void FlushSubPatches() {
+    const int width = pDevice->GetWidth();
+    const int height = pDevice->GetHeight();
+    CFX_FillRenderOptions fill_options(CFX_FillRenderOptions::WindingOptions());
+    fill_options.full_cover = true;
+    if (bNoPathSmooth)
+      fill_options.aliased_path = true;
+
+    pdfium::span<CFX_Path::Point> points = path.GetPoints();
+    for (const SubPatch& sub_patch : sub_patches) {
+      CFX_FloatRect bbox =
+          CFX_FloatRect::GetBBox(pdfium::make_span(sub_patch.points));
+      if (bbox.right <= 0 || bbox.left >= width || bbox.top <= 0 ||
+          bbox.bottom >= height) {
+        continue;
+      }
+      for (size_t i = 0; i < kSubPatchPoints; ++i)
+        points[i].m_Point = sub_patch.points[i];
+      pDevice->DrawPath(path, nullptr, nullptr, sub_patch.color, 0,
+                        fill_options);
+    }
+    sub_patches.clear();
+  }
+
+  static constexpr size_t kSubPatchPoints = 13;
+  static constexpr size_t kMaxSubPatches = 4096;
+
+  // A piece of a patch small or uniform enough to fill with one color. The
+  // points form a path of four Bezier curves.
+  struct SubPatch {
+    CFX_PointF points[kSubPatchPoints];
+    FX_ARGB color;
+  };
+
   int max_delta;
   CFX_Path path;
   CFX_RenderDevice* pDevice;
   int bNoPathSmooth;
   int alpha;
   CoonColor patch_colors[4];
+  std::vector<SubPatch> sub_patches;
 };
 
 void DrawCoonPatchMeshes(
@@ -799,7 +961,7 @@ void DrawCoonPatchMeshes(
   patch.pDevice = &device;
   patch.bNoPathSmooth = bNoPathSmooth;
 
-  for (int i = 0; i < 13; i++) {
+  for (size_t i = 0; i < PatchDrawer::kSubPatchPoints; i++) {
     patch.path.AppendPoint(CFX_PointF(), i == 0
                                              ? CFX_Path::Point::Type::kMove
                                              : CFX_Path::Point::Type::kBezier);
@@ -866,6 +1028,7 @@ void DrawCoonPatchMeshes(
     D2.InitFromPoints(coords[9].x, coords[9].y, coords[8].x, coords[8].y,
                       coords[7].x, coords[7].y, coords[6].x, coords[6].y);
     patch.Draw(1, 1, 0, 0, C1, C2, D1, D2);
+    patch.FlushSubPatches();
   }
 }
 
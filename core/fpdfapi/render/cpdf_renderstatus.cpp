@@ -6,6 +6,7 @@
 
 #include "core/fpdfapi/render/cpdf_renderstatus.h"
 
+#include <math.h>
 #include <stdint.h>
 
 #include <algorithm>
@@ -43,12 +44,15 @@
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fpdfapi/render/charposlist.h"
 #include "core/fpdfapi/render/cpdf_docrenderdata.h"
+#include "core/fpdfapi/render/cpdf_formrendercache.h"
 #include "core/fpdfapi/render/cpdf_imagerenderer.h"
+#include "core/fpdfapi/render/cpdf_render_utils.h"
 #include "core/fpdfapi/render/cpdf_rendercontext.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 #include "core/fpdfapi/render/cpdf_rendershading.h"
 #include "core/fpdfapi/render/cpdf_rendertiling.h"
 #include "core/fpdfapi/render/cpdf_scaledrenderbuffer.h"
+#include "core/fpdfapi/render/cpdf_scratchbitmappool.h"
 #include "core/fpdfapi/render/cpdf_textrenderer.h"
 #include "core/fpdfapi/render/cpdf_type3cache.h"
 #include "core/fxcrt/autorestorer.h"
@@ -56,7 +60,6 @@
 #include "core/fxcrt/fx_2d_size.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_system.h"
-#include "core/fxcrt/span_util.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 #include "core/fxge/cfx_fillrenderoptions.h"
@@ -81,9 +84,12 @@ namespace {
 constexpr int kRenderMaxRecursionDepth = 64;
 int g_CurrentRecursionDepth = 0;
 
+// Larger forms are always drawn directly.
+constexpr int64_t kMaxCachedFormPixels = 2048 * 2048;
+
 CFX_FillRenderOptions GetFillOptionsForDrawPathWithBlend(
     const CPDF_RenderOptions::Options& options,
-    const CPDF_PathObject* path_obj,
+    bool stroke_adjust,
     CFX_FillRenderOptions::FillType fill_type,
     bool is_stroke,
     bool is_type3_char) {
@@ -92,7 +98,7 @@ CFX_FillRenderOptions GetFillOptionsForDrawPathWithBlend(
     fill_options.rect_aa = true;
   if (options.bNoPathSmooth)
     fill_options.aliased_path = true;
-  if (path_obj->m_GeneralState.GetStrokeAdjust())
+  if (stroke_adjust)
     fill_options.adjust_stroke = true;
   if (is_stroke)
     fill_options.stroke = true;
@@ -132,16 +138,6 @@ FXDIB_Format GetFormatForLuminosity(bool is_luminosity) {
 #endif
 }
 
-bool IsAvailableMatrix(const CFX_Matrix& matrix) {
-  if (matrix.a == 0 || matrix.d == 0)
-    return matrix.b != 0 && matrix.c != 0;
-
-  if (matrix.b == 0 || matrix.c == 0)
-    return matrix.a != 0 && matrix.d != 0;
-
-  return true;
-}
-
 bool MissingFillColor(const CPDF_ColorState* pColorState) {
   return !pColorState->HasRef() || pColorState->GetFillColor()->IsNull();
 }
@@ -160,6 +156,44 @@ bool Type3CharMissingStrokeColor(const CPDF_Type3Char* pChar,
   return pChar && (!pChar->colored() || MissingStrokeColor(pColorState));
 }
 
+// Returns whether drawing a rendering of |pHolder| made on a transparent
+// bitmap gives the same result as drawing its objects directly.
+bool IsCacheableFormContent(const CPDF_PageObjectHolder* pHolder, int depth) {
+  if (depth > kRenderMaxRecursionDepth)
+    return false;
+
+  for (const auto& pObj : *pHolder) {
+    if (!CanFlattenPageObject(pObj.get()))
+      return false;
+
+    const CPDF_FormObject* pFormObj = pObj->AsForm();
+    if (pFormObj && !IsCacheableFormContent(pFormObj->form(), depth + 1))
+      return false;
+  }
+  return true;
+}
+
+// Roughly how much of its bounding box a line of text covers with ink.
+constexpr int kGreekedTextAlphaDivisor = 3;
+
+FX_ARGB GetDisplayListArgb(const CPDF_RenderOptions& options,
+                           const CPDF_DisplayList::Color& color,
+                           CPDF_PageObject::Type object_type,
+                           CPDF_RenderOptions::RenderType render_type) {
+  if (color.colorref == 0xFFFFFFFF)
+    return 0;
+
+  int32_t alpha = static_cast<int32_t>(color.alpha * 255);
+  return options.TranslateObjectColor(
+      AlphaAndColorRefToArgb(alpha, color.colorref), object_type, render_type);
+}
+
+bool IsOutsideClipRect(const CFX_FloatRect& rect,
+                       const CFX_FloatRect& clip_rect) {
+  return rect.left > clip_rect.right || rect.right < clip_rect.left ||
+         rect.bottom > clip_rect.top || rect.top < clip_rect.bottom;
+}
+
 }  // namespace
 
 CPDF_RenderStatus::CPDF_RenderStatus(CPDF_RenderContext* pContext,
@@ -198,6 +232,25 @@ void CPDF_RenderStatus::RenderObjectList(
     const CFX_Matrix& mtObj2Device) {
   CFX_FloatRect clip_rect = mtObj2Device.GetInverse().TransformRect(
       CFX_FloatRect(m_pDevice->GetClipBox()));
+
+  // Rendering ends at |m_pStopObj| even when it is outside the clip, so only
+  // skip to the objects in the clip without one.
+  absl::optional<std::vector<uint32_t>> visible_objects;
+  if (!m_pStopObj)
+    visible_objects = pObjectHolder->FindPageObjectsInRect(clip_rect);
+  if (visible_objects.has_value()) {
+    for (uint32_t index : visible_objects.value()) {
+      CPDF_PageObject* pCurObj = pObjectHolder->GetPageObjectByIndex(index);
+      if (!pCurObj || IsOutsideClipRect(pCurObj->GetRect(), clip_rect))
+        continue;
+
+      RenderSingleObject(pCurObj, mtObj2Device);
+      if (m_bStopped)
+        return;
+    }
+    return;
+  }
+
   for (const auto& pCurObj : *pObjectHolder) {
     if (pCurObj.get() == m_pStopObj) {
       m_bStopped = true;
@@ -206,18 +259,84 @@ void CPDF_RenderStatus::RenderObjectList(
     if (!pCurObj)
       continue;
 
-    if (pCurObj->GetRect().left > clip_rect.right ||
-        pCurObj->GetRect().right < clip_rect.left ||
-        pCurObj->GetRect().bottom > clip_rect.top ||
-        pCurObj->GetRect().top < clip_rect.bottom) {
+    if (IsOutsideClipRect(pCurObj->GetRect(), clip_rect))
       continue;
-    }
+
     RenderSingleObject(pCurObj.get(), mtObj2Device);
     if (m_bStopped)
       return;
   }
 }
 
+void CPDF_RenderStatus::RenderDisplayList(const CPDF_DisplayList& list,
+                                          const CFX_Matrix& mtPage2Device) {
+  CPDF_Document* pDoc = m_pContext->GetDocument();
+  auto* pPageData = CPDF_DocPageData::FromDocument(pDoc);
+  std::vector<RetainPtr<CPDF_Font>> fonts;
+  for (uint32_t objnum : list.GetFontObjNums()) {
+    RetainPtr<CPDF_Dictionary> pFontDict =
+        ToDictionary(pDoc->GetMutableIndirectObject(objnum));
+    RetainPtr<CPDF_Font> pFont =
+        pFontDict ? pPageData->GetFont(std::move(pFontDict)) : nullptr;
+    if (pFont && pFont->IsType3Font())
+      pFont.Reset();
+    fonts.push_back(std::move(pFont));
+  }
+  // Holding on to the images also keeps them in the document's cache for as
+  // long as the list is drawn.
+  std::vector<RetainPtr<CPDF_Image>> images;
+  for (uint32_t objnum : list.GetImageObjNums()) {
+    RetainPtr<const CPDF_Stream> pStream =
+        ToStream(pDoc->GetIndirectObject(objnum));
+    images.push_back(pStream &&
+                             pStream->GetDict()->GetNameFor("Subtype") ==
+                                 "Image"
+                         ? pPageData->GetImage(objnum)
+                         : nullptr);
+  }
+
+  CFX_FloatRect clip_rect = mtPage2Device.GetInverse().TransformRect(
+      CFX_FloatRect(m_pDevice->GetClipBox()));
+  uint32_t clip_index = CPDF_DisplayList::kNoClip;
+  for (const CPDF_DisplayList::Item& item : list.GetItems()) {
+    if (IsOutsideClipRect(item.bbox, clip_rect))
+      continue;
+
+    if (item.clip_index != clip_index) {
+      clip_index = item.clip_index;
+      ProcessDisplayListClip(clip_index != CPDF_DisplayList::kNoClip
+                                 ? &list.GetClips()[clip_index]
+                                 : nullptr,
+                             mtPage2Device);
+    }
+    switch (item.type) {
+      case CPDF_PageObject::Type::kPath:
+        ProcessDisplayListPath(item, mtPage2Device);
+        break;
+      case CPDF_PageObject::Type::kText:
+        if (fonts[item.font_index]) {
+          CPDF_TextRenderer::DrawNormalText(
+              m_pDevice, item.char_codes, item.char_pos,
+              fonts[item.font_index].Get(), item.font_size,
+              item.matrix * mtPage2Device,
+              GetDisplayListArgb(m_Options, item.fill_color, item.type,
+                                 CPDF_RenderOptions::RenderType::kFill),
+              m_Options);
+        }
+        break;
+      case CPDF_PageObject::Type::kImage:
+        if (images[item.image_index]) {
+          ProcessDisplayListImage(item, images[item.image_index],
+                                  mtPage2Device);
+        }
+        break;
+      default:
+        NOTREACHED();
+        break;
+    }
+  }
+}
+
 void CPDF_RenderStatus::RenderSingleObject(CPDF_PageObject* pObj,
                                            const CFX_Matrix& mtObj2Device) {
   AutoRestorer<int> restorer(&g_CurrentRecursionDepth);
@@ -282,6 +401,9 @@ FX_RECT CPDF_RenderStatus::GetObjectClippedRect(
 
 void CPDF_RenderStatus::ProcessObjectNoClip(CPDF_PageObject* pObj,
                                             const CFX_Matrix& mtObj2Device) {
+  if (m_Options.GetOptions().bLowDetail && ProcessLowDetail(pObj, mtObj2Device))
+    return;
+
   bool bRet = false;
   switch (pObj->GetType()) {
     case CPDF_PageObject::Type::kText:
@@ -318,6 +440,101 @@ bool CPDF_RenderStatus::DrawObjWithBlend(CPDF_PageObject* pObj,
   }
 }
 
+bool CPDF_RenderStatus::ProcessLowDetail(CPDF_PageObject* pObj,
+                                         const CFX_Matrix& mtObj2Device) {
+  // Type 3 glyph procedures render into cached glyph bitmaps, which the
+  // text object using them is already approximated in place of.
+  if (m_pType3Char)
+    return false;
+
+  switch (pObj->GetType()) {
+    case CPDF_PageObject::Type::kText:
+      return ProcessLowDetailText(pObj->AsText(), mtObj2Device);
+    case CPDF_PageObject::Type::kPath:
+      return ProcessLowDetailPath(pObj->AsPath(), mtObj2Device);
+    default:
+      return false;
+  }
+}
+
+bool CPDF_RenderStatus::ProcessLowDetailPath(CPDF_PathObject* path_obj,
+                                             const CFX_Matrix& mtObj2Device) {
+  const float threshold = m_Options.GetOptions().fLowDetailThreshold;
+  CFX_FloatRect device_rect = mtObj2Device.TransformRect(path_obj->GetRect());
+  const bool thin_x = device_rect.Width() < threshold;
+  const bool thin_y = device_rect.Height() < threshold;
+  if (!thin_x && !thin_y)
+    return false;
+
+  if (UsesPattern(path_obj->m_ColorState))
+    return false;
+
+  // Fill the bounding box instead, so anti-aliasing gives the path about the
+  // weight its area would have had. A path that is only thin one way, like a
+  // rule or a table border, becomes a bar along its long side.
+  FX_ARGB argb;
+  if (path_obj->filltype() != CFX_FillRenderOptions::FillType::kNoFill) {
+    argb = GetFillArgb(path_obj);
+  } else if (path_obj->stroke()) {
+    argb = GetStrokeArgb(path_obj);
+    // Strokes are never drawn thinner than a hairline.
+    device_rect.Inflate(std::max(0.0f, (1.0f - device_rect.Width()) / 2),
+                        std::max(0.0f, (1.0f - device_rect.Height()) / 2));
+  } else {
+    return true;
+  }
+
+  CFX_Path path;
+  path.AppendFloatRect(device_rect);
+  CFX_FillRenderOptions fill_options(CFX_FillRenderOptions::WindingOptions());
+  fill_options.aliased_path = m_Options.GetOptions().bNoPathSmooth;
+  m_pDevice->DrawPathWithBlend(path, nullptr, nullptr, argb, 0, fill_options,
+                               m_curBlend);
+  return true;
+}
+
+bool CPDF_RenderStatus::ProcessLowDetailText(CPDF_TextObject* textobj,
+                                             const CFX_Matrix& mtObj2Device) {
+  if (textobj->GetCharCodes().empty())
+    return false;
+
+  CFX_Matrix glyph_matrix = textobj->GetTextMatrix() * mtObj2Device;
+  float glyph_size =
+      textobj->m_TextState.GetFontSize() * glyph_matrix.GetYUnit();
+  if (!(glyph_size < m_Options.GetOptions().fLowDetailThreshold))
+    return false;
+
+  if (UsesPattern(textobj->m_ColorState))
+    return false;
+
+  // Greek the text: draw its bounding box as a bar in a lighter shade of the
+  // text color, without loading or rasterizing any glyphs.
+  FX_ARGB argb;
+  switch (textobj->m_TextState.GetTextMode()) {
+    case TextRenderingMode::MODE_FILL:
+    case TextRenderingMode::MODE_FILL_CLIP:
+    case TextRenderingMode::MODE_FILL_STROKE:
+    case TextRenderingMode::MODE_FILL_STROKE_CLIP:
+      argb = GetFillArgb(textobj);
+      break;
+    case TextRenderingMode::MODE_STROKE:
+    case TextRenderingMode::MODE_STROKE_CLIP:
+      argb = GetStrokeArgb(textobj);
+      break;
+    default:
+      return false;
+  }
+  argb = FXARGB_MUL_ALPHA(argb, 255 / kGreekedTextAlphaDivisor);
+
+  CFX_Path path;
+  path.AppendFloatRect(textobj->GetRect());
+  CFX_FillRenderOptions fill_options(CFX_FillRenderOptions::WindingOptions());
+  fill_options.aliased_path = m_Options.GetOptions().bNoPathSmooth;
+  m_pDevice->DrawPathWithBlend(path, &mtObj2Device, nullptr, argb, 0,
+                               fill_options, m_curBlend);
+  return true;
+}
+
 void CPDF_RenderStatus::DrawObjWithBackground(CPDF_PageObject* pObj,
                                               const CFX_Matrix& mtObj2Device) {
   FX_RECT rect = GetObjectClippedRect(pObj, mtObj2Device);
@@ -353,6 +570,9 @@ bool CPDF_RenderStatus::ProcessForm(const CPDF_FormObject* pFormObj,
     return true;
 
   CFX_Matrix matrix = pFormObj->form_matrix() * mtObj2Device;
+  if (m_Options.GetOptions().bCacheForms && ProcessCachedForm(pFormObj, matrix))
+    return true;
+
   RetainPtr<const CPDF_Dictionary> pResources =
       pFormObj->form()->GetDict()->GetDictFor("Resources");
   CPDF_RenderStatus status(m_pContext, m_pDevice);
@@ -371,6 +591,101 @@ bool CPDF_RenderStatus::ProcessForm(const CPDF_FormObject* pFormObj,
   return true;
 }
 
+bool CPDF_RenderStatus::ProcessCachedForm(const CPDF_FormObject* pFormObj,
+                                          const CFX_Matrix& mtForm2Device) {
+  if (m_bPrint || m_bDropObjects || m_bLoadMask || m_pStopObj ||
+      m_pType3Char || m_curBlend != BlendMode::kNormal ||
+      !m_Options.ColorModeIs(CPDF_RenderOptions::kNormal) ||
+      m_Options.GetOptions().bClearType ||
+      CFX_DefaultRenderDevice::SkiaIsDefaultRenderer() ||
+      !m_pDevice->GetBitmap() || m_pDevice->GetBackDrop()) {
+    return false;
+  }
+
+  CPDF_DocRenderData* pRenderData =
+      CPDF_DocRenderData::FromDocument(m_pContext->GetDocument());
+  if (!pRenderData)
+    return false;
+
+  // Renderings are shared by every form object drawing the same stream, so
+  // they are only valid while the objects still match that stream.
+  const CPDF_Form* pForm = pFormObj->form();
+  if (pForm->IsContentModified())
+    return false;
+
+  RetainPtr<const CPDF_Dictionary> pFormDict = pForm->GetDict();
+  if (pForm->GetTransparency().IsGroup() || !pFormDict->KeyExist("BBox"))
+    return false;
+
+  const float origin_x = floorf(mtForm2Device.e);
+  const float origin_y = floorf(mtForm2Device.f);
+  if (!pdfium::base::IsValueInRangeForNumericType<int>(origin_x) ||
+      !pdfium::base::IsValueInRangeForNumericType<int>(origin_y)) {
+    return false;
+  }
+
+  CPDF_FormRenderCache::Key key;
+  key.form = pForm->GetStream();
+  key.resources = pForm->GetResources();
+  key.form_to_device = mtForm2Device;
+  key.graph_state = pFormObj->m_GraphState;
+  key.color_state = pFormObj->m_ColorState;
+  key.text_state = pFormObj->m_TextState;
+  key.general_state = pFormObj->m_GeneralState;
+  key.options = m_Options.GetOptions();
+  CPDF_FormRenderCache* pCache = pRenderData->GetFormRenderCache();
+  CPDF_FormRenderCache::Rendering rendering = pCache->Find(key);
+  if (!rendering.bitmap) {
+    if (!IsCacheableFormContent(pForm, 0))
+      return false;
+
+    // Every object in the form is clipped to its BBox. Leave a pixel of slack
+    // on each side for rounding differences in the clip.
+    CFX_Matrix form_matrix = pFormDict->GetMatrixFor("Matrix") * mtForm2Device;
+    CFX_FloatRect bbox =
+        form_matrix.TransformRect(pFormDict->GetRectFor("BBox"));
+    bbox.Inflate(1.0f, 1.0f);
+    FX_RECT rect = bbox.GetOuterRect();
+    if (rect.IsEmpty() ||
+        static_cast<int64_t>(rect.Width()) * rect.Height() >
+            kMaxCachedFormPixels) {
+      return false;
+    }
+
+    auto pBitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+    if (!pBitmap->Create(rect.Width(), rect.Height(), FXDIB_Format::kArgb))
+      return false;
+
+    CFX_DefaultRenderDevice bitmap_device;
+    bitmap_device.Attach(pBitmap);
+    CFX_Matrix bitmap_matrix = mtForm2Device;
+    bitmap_matrix.Translate(-rect.left, -rect.top);
+    // Nested forms are part of this rendering, so do not cache them again.
+    CPDF_RenderOptions options = m_Options;
+    options.GetOptions().bCacheForms = false;
+    CPDF_RenderStatus status(m_pContext, &bitmap_device);
+    status.SetOptions(options);
+    status.SetFormResource(pFormDict->GetDictFor("Resources"));
+    status.Initialize(this, pFormObj);
+    status.RenderObjectList(pForm, bitmap_matrix);
+
+    rendering.bitmap = std::move(pBitmap);
+    rendering.origin = CFX_Point(rect.left - static_cast<int>(origin_x),
+                                 rect.top - static_cast<int>(origin_y));
+    pCache->Add(key, rendering);
+  }
+
+  FX_SAFE_INT32 left = static_cast<int>(origin_x);
+  left += rendering.origin.x;
+  FX_SAFE_INT32 top = static_cast<int>(origin_y);
+  top += rendering.origin.y;
+  if (!left.IsValid() || !top.IsValid())
+    return false;
+
+  m_pDevice->SetDIBits(rendering.bitmap, left.ValueOrDie(), top.ValueOrDie());
+  return true;
+}
+
 bool CPDF_RenderStatus::ProcessPath(CPDF_PathObject* path_obj,
                                     const CFX_Matrix& mtObj2Device) {
   CFX_FillRenderOptions::FillType fill_type = path_obj->filltype();
@@ -400,8 +715,9 @@ bool CPDF_RenderStatus::ProcessPath(CPDF_PathObject* path_obj,
   return m_pDevice->DrawPathWithBlend(
       *path_obj->path().GetObject(), &path_matrix,
       path_obj->m_GraphState.GetObject(), fill_argb, stroke_argb,
-      GetFillOptionsForDrawPathWithBlend(options, path_obj, fill_type, stroke,
-                                         m_pType3Char),
+      GetFillOptionsForDrawPathWithBlend(
+          options, path_obj->m_GeneralState.GetStrokeAdjust(), fill_type,
+          stroke, m_pType3Char),
       m_curBlend);
 }
 
@@ -615,25 +931,30 @@ bool CPDF_RenderStatus::ProcessTransparency(CPDF_PageObject* pPageObj,
 
   int width = rect.Width();
   int height = rect.Height();
+  CPDF_ScratchBitmapPool* pPool = m_pContext->GetScratchBitmapPool();
   CFX_DefaultRenderDevice bitmap_device;
   RetainPtr<CFX_DIBitmap> backdrop;
   if (!transparency.IsIsolated() &&
       (m_pDevice->GetRenderCaps() & FXRC_GET_BITS)) {
-    backdrop = pdfium::MakeRetain<CFX_DIBitmap>();
-    if (!m_pDevice->CreateCompatibleBitmap(backdrop, width, height))
+    backdrop = pPool->Acquire(width, height,
+                              m_pDevice->GetCompatibleBitmapFormat());
+    if (!backdrop)
       return true;
     m_pDevice->GetDIBits(backdrop, rect.left, rect.top);
   }
-  if (!bitmap_device.Create(width, height, FXDIB_Format::kArgb, backdrop))
+  if (!bitmap_device.AttachWithBackdropAndGroupKnockout(
+          pPool->Acquire(width, height, FXDIB_Format::kArgb), backdrop,
+          /*bGroupKnockout=*/false)) {
     return true;
+  }
 
   CFX_Matrix new_matrix = mtObj2Device;
   new_matrix.Translate(-rect.left, -rect.top);
 
   RetainPtr<CFX_DIBitmap> pTextMask;
   if (bTextClip) {
-    pTextMask = pdfium::MakeRetain<CFX_DIBitmap>();
-    if (!pTextMask->Create(width, height, FXDIB_Format::k8bppMask))
+    pTextMask = pPool->Acquire(width, height, FXDIB_Format::k8bppMask);
+    if (!pTextMask)
       return true;
 
     CFX_DefaultRenderDevice text_device;
@@ -702,15 +1023,13 @@ RetainPtr<CFX_DIBitmap> CPDF_RenderStatus::GetBackdrop(
     const CPDF_PageObject* pObj,
     const FX_RECT& bbox,
     bool bBackAlphaRequired) {
-  int width = bbox.Width();
-  int height = bbox.Height();
-  auto pBackdrop = pdfium::MakeRetain<CFX_DIBitmap>();
-  if (bBackAlphaRequired && !m_bDropObjects)
-    pBackdrop->Create(width, height, FXDIB_Format::kArgb);
-  else
-    m_pDevice->CreateCompatibleBitmap(pBackdrop, width, height);
-
-  if (pBackdrop->GetBuffer().empty())
+  FXDIB_Format format = bBackAlphaRequired && !m_bDropObjects
+                            ? FXDIB_Format::kArgb
+                            : m_pDevice->GetCompatibleBitmapFormat();
+  RetainPtr<CFX_DIBitmap> pBackdrop =
+      m_pContext->GetScratchBitmapPool()->Acquire(bbox.Width(), bbox.Height(),
+                                                  format);
+  if (!pBackdrop)
     return nullptr;
 
   bool bNeedDraw;
@@ -1189,6 +1508,82 @@ bool CPDF_RenderStatus::ProcessImage(CPDF_ImageObject* pImageObj,
   return render.GetResult();
 }
 
+void CPDF_RenderStatus::ProcessDisplayListClip(
+    const std::vector<CPDF_DisplayList::ClipPath>* pClip,
+    const CFX_Matrix& mtPage2Device) {
+  m_pDevice->RestoreState(true);
+  if (!pClip)
+    return;
+
+  for (const CPDF_DisplayList::ClipPath& clip_path : *pClip) {
+    if (clip_path.path.GetPoints().empty()) {
+      CFX_Path empty_path;
+      empty_path.AppendRect(-1, -1, 0, 0);
+      m_pDevice->SetClip_PathFill(empty_path, nullptr,
+                                  CFX_FillRenderOptions::WindingOptions());
+    } else {
+      m_pDevice->SetClip_PathFill(clip_path.path, &mtPage2Device,
+                                  CFX_FillRenderOptions(clip_path.fill_type));
+    }
+  }
+}
+
+void CPDF_RenderStatus::ProcessDisplayListPath(
+    const CPDF_DisplayList::Item& item,
+    const CFX_Matrix& mtPage2Device) {
+  CFX_FillRenderOptions::FillType fill_type = item.fill_type;
+  bool stroke = item.stroke;
+  CPDF_RenderOptions::Options& options = m_Options.GetOptions();
+  if (m_Options.ColorModeIs(CPDF_RenderOptions::Type::kForcedColor) &&
+      options.bConvertFillToStroke &&
+      fill_type != CFX_FillRenderOptions::FillType::kNoFill) {
+    stroke = true;
+    fill_type = CFX_FillRenderOptions::FillType::kNoFill;
+  }
+
+  uint32_t fill_argb =
+      fill_type != CFX_FillRenderOptions::FillType::kNoFill
+          ? GetDisplayListArgb(m_Options, item.fill_color, item.type,
+                               CPDF_RenderOptions::RenderType::kFill)
+          : 0;
+  uint32_t stroke_argb =
+      stroke ? GetDisplayListArgb(m_Options, item.stroke_color, item.type,
+                                  CPDF_RenderOptions::RenderType::kStroke)
+             : 0;
+  CFX_Matrix path_matrix = item.matrix * mtPage2Device;
+  if (!IsAvailableMatrix(path_matrix))
+    return;
+
+  m_pDevice->DrawPathWithBlend(
+      item.path, &path_matrix, &item.graph_state, fill_argb, stroke_argb,
+      GetFillOptionsForDrawPathWithBlend(options, item.stroke_adjust,
+                                         fill_type, stroke, false),
+      m_curBlend);
+}
+
+void CPDF_RenderStatus::ProcessDisplayListImage(
+    const CPDF_DisplayList::Item& item,
+    RetainPtr<CPDF_Image> pImage,
+    const CFX_Matrix& mtPage2Device) {
+  CPDF_ImageObject image_obj;
+  image_obj.SetImage(std::move(pImage));
+  image_obj.SetImageMatrix(item.matrix);
+  if (item.fill_color.alpha != 1.0f)
+    image_obj.m_GeneralState.SetFillAlpha(item.fill_color.alpha);
+  if (item.fill_color.colorref != 0xFFFFFFFF) {
+    // Image masks are drawn in the fill color.
+    const FX_COLORREF colorref = item.fill_color.colorref;
+    image_obj.m_ColorState.Emplace();
+    image_obj.m_ColorState.SetFillColor(
+        CPDF_ColorSpace::GetStockCS(CPDF_ColorSpace::Family::kDeviceRGB),
+        {FXSYS_GetRValue(colorref) / 255.0f,
+         FXSYS_GetGValue(colorref) / 255.0f,
+         FXSYS_GetBValue(colorref) / 255.0f});
+    image_obj.m_ColorState.SetFillColorRef(colorref);
+  }
+  ProcessImage(&image_obj, mtPage2Device);
+}
+
 void CPDF_RenderStatus::CompositeDIBitmap(
     const RetainPtr<CFX_DIBitmap>& pDIBitmap,
     int left,
@@ -1300,9 +1695,12 @@ void CPDF_RenderStatus::CompositeDIBitmap(
                                pDIBitmap, 0, 0, blend_mode, nullptr, false);
   }
 
-  auto pBackdrop1 = pdfium::MakeRetain<CFX_DIBitmap>();
-  pBackdrop1->Create(pBackdrop->GetWidth(), pBackdrop->GetHeight(),
-                     FXDIB_Format::kRgb32);
+  RetainPtr<CFX_DIBitmap> pBackdrop1 =
+      m_pContext->GetScratchBitmapPool()->Acquire(
+          pBackdrop->GetWidth(), pBackdrop->GetHeight(), FXDIB_Format::kRgb32);
+  if (!pBackdrop1)
+    return;
+
   pBackdrop1->Clear((uint32_t)-1);
   pBackdrop1->CompositeBitmap(0, 0, pBackdrop->GetWidth(),
                               pBackdrop->GetHeight(), pBackdrop, 0, 0,
@@ -1343,10 +1741,11 @@ RetainPtr<CFX_DIBitmap> CPDF_RenderStatus::LoadSMask(
   int width = pClipRect->right - pClipRect->left;
   int height = pClipRect->bottom - pClipRect->top;
   FXDIB_Format format = GetFormatForLuminosity(bLuminosity);
-  if (!bitmap_device.Create(width, height, format, nullptr))
+  CPDF_ScratchBitmapPool* pPool = m_pContext->GetScratchBitmapPool();
+  RetainPtr<CFX_DIBitmap> bitmap = pPool->Acquire(width, height, format);
+  if (!bitmap || !bitmap_device.Attach(bitmap))
     return nullptr;
 
-  RetainPtr<CFX_DIBitmap> bitmap = bitmap_device.GetBitmap();
   CPDF_ColorSpace::Family nCSFamily = CPDF_ColorSpace::Family::kUnknown;
   if (bLuminosity) {
     FX_ARGB back_color =
@@ -1371,8 +1770,13 @@ RetainPtr<CFX_DIBitmap> CPDF_RenderStatus::LoadSMask(
   status.Initialize(nullptr, nullptr);
   status.RenderObjectList(&form, matrix);
 
-  auto pMask = pdfium::MakeRetain<CFX_DIBitmap>();
-  if (!pMask->Create(width, height, FXDIB_Format::k8bppMask))
+  // An alpha mask is already rendered as a mask.
+  if (!bLuminosity && !pFunc)
+    return bitmap;
+
+  RetainPtr<CFX_DIBitmap> pMask =
+      pPool->Acquire(width, height, FXDIB_Format::k8bppMask);
+  if (!pMask)
     return nullptr;
 
   pdfium::span<uint8_t> dest_buf = pMask->GetBuffer();
@@ -1403,13 +1807,11 @@ RetainPtr<CFX_DIBitmap> CPDF_RenderStatus::LoadSMask(
         src_pos += Bpp;
       }
     }
-  } else if (pFunc) {
+  } else {
     int size = dest_pitch * height;
     for (int i = 0; i < size; i++) {
       dest_buf[i] = transfers[src_buf[i]];
     }
-  } else {
-    fxcrt::spancpy(dest_buf, src_buf.first(dest_pitch * height));
   }
   return pMask;
 }
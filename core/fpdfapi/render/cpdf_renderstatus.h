@@ -16,6 +16,7 @@
 #include "core/fpdfapi/page/cpdf_graphicstates.h"
 #include "core/fpdfapi/page/cpdf_transparency.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/render/cpdf_displaylist.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/unowned_ptr.h"
@@ -27,6 +28,7 @@ class CFX_RenderDevice;
 class CPDF_Color;
 class CPDF_Font;
 class CPDF_FormObject;
+class CPDF_Image;
 class CPDF_ImageObject;
 class CPDF_ImageRenderer;
 class CPDF_Object;
@@ -71,6 +73,10 @@ class CPDF_RenderStatus {
 
   void RenderObjectList(const CPDF_PageObjectHolder* pObjectHolder,
                         const CFX_Matrix& mtObj2Device);
+  // Draws |list| the way RenderObjectList() draws the page it was compiled
+  // from.
+  void RenderDisplayList(const CPDF_DisplayList& list,
+                         const CFX_Matrix& mtPage2Device);
   void RenderSingleObject(CPDF_PageObject* pObj,
                           const CFX_Matrix& mtObj2Device);
   bool ContinueSingleObject(CPDF_PageObject* pObj,
@@ -132,6 +138,13 @@ class CPDF_RenderStatus {
   void DrawObjWithBackground(CPDF_PageObject* pObj,
                              const CFX_Matrix& mtObj2Device);
   bool DrawObjWithBlend(CPDF_PageObject* pObj, const CFX_Matrix& mtObj2Device);
+  // Draws a cheap approximation of |pObj| if it is too small to show detail.
+  // Returns false if |pObj| has to be drawn normally.
+  bool ProcessLowDetail(CPDF_PageObject* pObj, const CFX_Matrix& mtObj2Device);
+  bool ProcessLowDetailPath(CPDF_PathObject* path_obj,
+                            const CFX_Matrix& mtObj2Device);
+  bool ProcessLowDetailText(CPDF_TextObject* textobj,
+                            const CFX_Matrix& mtObj2Device);
   bool ProcessPath(CPDF_PathObject* path_obj, const CFX_Matrix& mtObj2Device);
   void ProcessPathPattern(CPDF_PathObject* path_obj,
                           const CFX_Matrix& mtObj2Device,
@@ -165,6 +178,19 @@ class CPDF_RenderStatus {
                                bool stroke);
   bool ProcessForm(const CPDF_FormObject* pFormObj,
                    const CFX_Matrix& mtObj2Device);
+  // Replaces the clip with |pClip|, or with none if it is null.
+  void ProcessDisplayListClip(
+      const std::vector<CPDF_DisplayList::ClipPath>* pClip,
+      const CFX_Matrix& mtPage2Device);
+  void ProcessDisplayListPath(const CPDF_DisplayList::Item& item,
+                              const CFX_Matrix& mtPage2Device);
+  void ProcessDisplayListImage(const CPDF_DisplayList::Item& item,
+                               RetainPtr<CPDF_Image> pImage,
+                               const CFX_Matrix& mtPage2Device);
+  // Draws the form from CPDF_FormRenderCache, rendering and caching it first
+  // if needed. Returns false if the form has to be drawn directly instead.
+  bool ProcessCachedForm(const CPDF_FormObject* pFormObj,
+                         const CFX_Matrix& mtForm2Device);
   FX_RECT GetClippedBBox(const FX_RECT& rect) const;
   RetainPtr<CFX_DIBitmap> GetBackdrop(const CPDF_PageObject* pObj,
                                       const FX_RECT& bbox,
@@ -6,6 +6,9 @@
 
 #include "core/fpdfapi/render/cpdf_rendertiling.h"
 
+#include <stdint.h>
+
+#include <algorithm>
 #include <limits>
 #include <memory>
 
@@ -13,10 +16,14 @@
 #include "core/fpdfapi/page/cpdf_pageimagecache.h"
 #include "core/fpdfapi/page/cpdf_tilingpattern.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/render/cpdf_docrenderdata.h"
 #include "core/fpdfapi/render/cpdf_rendercontext.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 #include "core/fpdfapi/render/cpdf_renderstatus.h"
+#include "core/fpdfapi/render/cpdf_tilingcellcache.h"
 #include "core/fxcrt/fx_safe_types.h"
+#include "core/fxcrt/span_util.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 
 namespace {
@@ -53,6 +60,8 @@ RetainPtr<CFX_DIBitmap> DrawPatternBitmap(
 
   options.GetOptions() = draw_options;
   options.GetOptions().bForceHalftone = true;
+  // The cell is drawn with group knockout, which cached forms do not honor.
+  options.GetOptions().bCacheForms = false;
 
   CPDF_RenderContext context(pDoc, nullptr, pCache);
   context.AppendLayer(pPatternForm, mtPattern2Bitmap);
@@ -65,6 +74,120 @@ RetainPtr<CFX_DIBitmap> DrawPatternBitmap(
   return pBitmap;
 }
 
+RetainPtr<CFX_DIBitmap> GetPatternBitmap(CPDF_RenderContext* pContext,
+                                         CPDF_TilingPattern* pPattern,
+                                         CPDF_Form* pPatternForm,
+                                         const CFX_Matrix& mtObj2Device,
+                                         int width,
+                                         int height,
+                                         const CPDF_RenderOptions& options) {
+  CPDF_DocRenderData* pRenderData =
+      CPDF_DocRenderData::FromDocument(pContext->GetDocument());
+  CPDF_TilingCellCache* pCellCache =
+      pRenderData ? pRenderData->GetTilingCellCache() : nullptr;
+  CPDF_TilingCellCache::Key key;
+  if (pCellCache) {
+    key.pattern = pPatternForm->GetStream();
+    key.pattern_to_form = pPattern->pattern_to_form();
+    key.object_to_device = mtObj2Device;
+    key.width = width;
+    key.height = height;
+    key.options = options.GetOptions();
+    key.gray = options.ColorModeIs(CPDF_RenderOptions::kGray);
+    RetainPtr<CFX_DIBitmap> pCached = pCellCache->Find(key);
+    if (pCached)
+      return pCached;
+  }
+
+  RetainPtr<CFX_DIBitmap> pPatternBitmap;
+  if (width * height < 16) {
+    RetainPtr<CFX_DIBitmap> pEnlargedBitmap = DrawPatternBitmap(
+        pContext->GetDocument(), pContext->GetPageCache(), pPattern,
+        pPatternForm, mtObj2Device, 8, 8, options.GetOptions());
+    pPatternBitmap = pEnlargedBitmap->StretchTo(
+        width, height, FXDIB_ResampleOptions(), nullptr);
+  } else {
+    pPatternBitmap = DrawPatternBitmap(
+        pContext->GetDocument(), pContext->GetPageCache(), pPattern,
+        pPatternForm, mtObj2Device, width, height, options.GetOptions());
+  }
+  if (!pPatternBitmap)
+    return nullptr;
+
+  if (options.ColorModeIs(CPDF_RenderOptions::kGray))
+    pPatternBitmap->ConvertColorScale(0, 0xffffff);
+
+  if (pCellCache)
+    pCellCache->Add(key, pPatternBitmap);
+  return pPatternBitmap;
+}
+
+// Builds the ARGB tile that compositing the uncoloured pattern cell |pMask|
+// with |fill_argb| onto a transparent bitmap would produce.
+RetainPtr<CFX_DIBitmap> ColorizeMaskTile(const RetainPtr<CFX_DIBitmap>& pMask,
+                                         FX_ARGB fill_argb) {
+  const int width = pMask->GetWidth();
+  const int height = pMask->GetHeight();
+  auto pTile = pdfium::MakeRetain<CFX_DIBitmap>();
+  if (!pTile->Create(width, height, FXDIB_Format::kArgb))
+    return nullptr;
+
+  // CompositeMask() leaves the bitmap untouched for a transparent colour,
+  // while single pixel cells are written directly with the fill colour.
+  const int fill_alpha = FXARGB_A(fill_argb);
+  const bool single_pixel = width == 1 && height == 1;
+  if (fill_alpha == 0 && !single_pixel)
+    return pTile;
+
+  for (int row = 0; row < height; ++row) {
+    pdfium::span<const uint8_t> src_scan = pMask->GetScanline(row);
+    uint8_t* dest_scan = pTile->GetWritableScanline(row).data();
+    for (int col = 0; col < width; ++col) {
+      FX_ARGB argb =
+          single_pixel
+              ? (src_scan[col] << 24) | (fill_argb & 0xffffff)
+              : ArgbEncode(fill_alpha * src_scan[col] / 255,
+                           FXARGB_R(fill_argb), FXARGB_G(fill_argb),
+                           FXARGB_B(fill_argb));
+      FXARGB_SETDIB(dest_scan, argb);
+      dest_scan += 4;
+    }
+  }
+  return pTile;
+}
+
+int WrapOffset(int64_t offset, int period) {
+  return static_cast<int>((offset % period + period) % period);
+}
+
+// Fills all of |pScreen| with copies of the ARGB |pTile| laid edge to edge,
+// with one of them having its top left corner at (|origin_x|, |origin_y|).
+// This is what compositing the tile at each of those positions onto a
+// transparent bitmap produces, but copies each row in runs.
+void FillWithTile(const RetainPtr<CFX_DIBitmap>& pScreen,
+                  const RetainPtr<CFX_DIBitmap>& pTile,
+                  int origin_x,
+                  int origin_y) {
+  const int tile_width = pTile->GetWidth();
+  const int tile_height = pTile->GetHeight();
+  const int screen_width = pScreen->GetWidth();
+  const int first_col = WrapOffset(-static_cast<int64_t>(origin_x), tile_width);
+  for (int row = 0; row < pScreen->GetHeight(); ++row) {
+    pdfium::span<const uint8_t> src_scan = pTile->GetScanline(
+        WrapOffset(static_cast<int64_t>(row) - origin_y, tile_height));
+    pdfium::span<uint8_t> dest_scan = pScreen->GetWritableScanline(row);
+    int col = 0;
+    int tile_col = first_col;
+    while (col < screen_width) {
+      int count = std::min(tile_width - tile_col, screen_width - col);
+      fxcrt::spancpy(dest_scan.subspan(col * 4, count * 4),
+                     src_scan.subspan(tile_col * 4, count * 4));
+      col += count;
+      tile_col = 0;
+    }
+  }
+}
+
 }  // namespace
 
 // static
@@ -169,24 +292,13 @@ RetainPtr<CFX_DIBitmap> CPDF_RenderTiling::Draw(
   }
   float left_offset = cell_bbox.left - mtPattern2Device.e;
   float top_offset = cell_bbox.bottom - mtPattern2Device.f;
-  RetainPtr<CFX_DIBitmap> pPatternBitmap;
-  if (width * height < 16) {
-    RetainPtr<CFX_DIBitmap> pEnlargedBitmap = DrawPatternBitmap(
-        pContext->GetDocument(), pContext->GetPageCache(), pPattern,
-        pPatternForm, mtObj2Device, 8, 8, options.GetOptions());
-    pPatternBitmap = pEnlargedBitmap->StretchTo(
-        width, height, FXDIB_ResampleOptions(), nullptr);
-  } else {
-    pPatternBitmap = DrawPatternBitmap(
-        pContext->GetDocument(), pContext->GetPageCache(), pPattern,
-        pPatternForm, mtObj2Device, width, height, options.GetOptions());
-  }
+  // Cached cells are shared, so |pPatternBitmap| must not be modified.
+  RetainPtr<CFX_DIBitmap> pPatternBitmap =
+      GetPatternBitmap(pContext, pPattern, pPatternForm, mtObj2Device, width,
+                       height, options);
   if (!pPatternBitmap)
     return nullptr;
 
-  if (options.ColorModeIs(CPDF_RenderOptions::kGray))
-    pPatternBitmap->ConvertColorScale(0, 0xffffff);
-
   FX_ARGB fill_argb = pRenderStatus->GetFillArgb(pPageObj);
   int clip_width = clip_box.right - clip_box.left;
   int clip_height = clip_box.bottom - clip_box.top;
@@ -194,6 +306,24 @@ RetainPtr<CFX_DIBitmap> CPDF_RenderTiling::Draw(
   if (!pScreen->Create(clip_width, clip_height, FXDIB_Format::kArgb))
     return nullptr;
 
+  // Aligned cells abut without overlapping, so the tiles can be laid down
+  // with a wrapping copy instead of compositing them one at a time.
+  if (bAligned) {
+    RetainPtr<CFX_DIBitmap> pTile;
+    if (pPattern->colored()) {
+      if (pPatternBitmap->GetFormat() == FXDIB_Format::kArgb)
+        pTile = pPatternBitmap;
+    } else if (pPatternBitmap->GetFormat() == FXDIB_Format::k8bppMask) {
+      pTile = ColorizeMaskTile(pPatternBitmap, fill_argb);
+    }
+    if (pTile) {
+      FillWithTile(pScreen, pTile,
+                   FXSYS_roundf(mtPattern2Device.e) - clip_box.left,
+                   FXSYS_roundf(mtPattern2Device.f) - clip_box.top);
+      return pScreen;
+    }
+  }
+
   pdfium::span<const uint8_t> src_buf = pPatternBitmap->GetBuffer();
   for (int col = min_col; col <= max_col; col++) {
     for (int row = min_row; row <= max_row; row++) {
@@ -0,0 +1,108 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_scratchbitmappool.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "core/fxcrt/fx_safe_types.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "third_party/base/check.h"
+
+CPDF_ScratchBitmapPool::Buffer::Buffer() = default;
+
+CPDF_ScratchBitmapPool::Buffer::Buffer(Buffer&& that) = default;
+
+CPDF_ScratchBitmapPool::Buffer& CPDF_ScratchBitmapPool::Buffer::operator=(
+    Buffer&& that) = default;
+
+CPDF_ScratchBitmapPool::Buffer::~Buffer() = default;
+
+bool CPDF_ScratchBitmapPool::Buffer::IsFree() const {
+  return !bitmap || bitmap->HasOneRef();
+}
+
+CPDF_ScratchBitmapPool::CPDF_ScratchBitmapPool()
+    : CPDF_ScratchBitmapPool(kDefaultByteBudget) {}
+
+CPDF_ScratchBitmapPool::CPDF_ScratchBitmapPool(size_t byte_budget)
+    : m_ByteBudget(byte_budget) {}
+
+CPDF_ScratchBitmapPool::~CPDF_ScratchBitmapPool() {
+  // Pooled bitmaps do not own their pixels.
+  for (const Buffer& buffer : m_Buffers)
+    CHECK(buffer.IsFree());
+}
+
+RetainPtr<CFX_DIBitmap> CPDF_ScratchBitmapPool::Acquire(int width,
+                                                        int height,
+                                                        FXDIB_Format format) {
+  absl::optional<CFX_DIBitmap::PitchAndSize> pitch_size =
+      CFX_DIBitmap::CalculatePitchAndSize(width, height, format, 0);
+  if (!pitch_size.has_value())
+    return nullptr;
+
+  // Match the slack that CFX_DIBitmap::Create() allocates.
+  FX_SAFE_SIZE_T safe_size = pitch_size.value().size;
+  safe_size += 4;
+  if (!safe_size.IsValid())
+    return nullptr;
+
+  auto pBitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  const size_t size = safe_size.ValueOrDie();
+  Buffer* buffer = FindBuffer(size);
+  if (!buffer) {
+    if (!pBitmap->Create(width, height, format))
+      return nullptr;
+    return pBitmap;
+  }
+
+  memset(buffer->data.get(), 0, size);
+  if (!pBitmap->Create(width, height, format, buffer->data.get(),
+                       pitch_size.value().pitch)) {
+    return nullptr;
+  }
+  buffer->bitmap = pBitmap;
+  return pBitmap;
+}
+
+CPDF_ScratchBitmapPool::Buffer* CPDF_ScratchBitmapPool::FindBuffer(
+    size_t size) {
+  Buffer* best_fit = nullptr;
+  Buffer* largest_free = nullptr;
+  for (Buffer& buffer : m_Buffers) {
+    if (!buffer.IsFree())
+      continue;
+    if (buffer.size >= size && (!best_fit || buffer.size < best_fit->size))
+      best_fit = &buffer;
+    if (!largest_free || buffer.size > largest_free->size)
+      largest_free = &buffer;
+  }
+  if (best_fit) {
+    best_fit->bitmap.Reset();
+    return best_fit;
+  }
+
+  // Grow the largest free buffer rather than adding another one.
+  size_t reclaimed = largest_free ? largest_free->size : 0;
+  if (size > m_ByteBudget || m_SizeInBytes - reclaimed > m_ByteBudget - size)
+    return nullptr;
+
+  std::unique_ptr<uint8_t, FxFreeDeleter> data(FX_TryAlloc(uint8_t, size));
+  if (!data)
+    return nullptr;
+
+  Buffer* buffer = largest_free;
+  if (!buffer) {
+    m_Buffers.emplace_back();
+    buffer = &m_Buffers.back();
+  }
+  m_SizeInBytes = m_SizeInBytes - reclaimed + size;
+  buffer->data = std::move(data);
+  buffer->size = size;
+  buffer->bitmap.Reset();
+  return buffer;
+}
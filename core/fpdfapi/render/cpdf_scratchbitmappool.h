@@ -0,0 +1,62 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_RENDER_CPDF_SCRATCHBITMAPPOOL_H_
+#define CORE_FPDFAPI_RENDER_CPDF_SCRATCHBITMAPPOOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/fxcrt/fx_memory_wrappers.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/dib/fx_dib.h"
+
+class CFX_DIBitmap;
+
+// Recycles the pixel buffers of short-lived bitmaps within one render pass,
+// such as transparency group surfaces, backdrops and soft masks, so a page
+// with many small transparent objects does not allocate and free a buffer for
+// each of them.
+class CPDF_ScratchBitmapPool {
+ public:
+  static constexpr size_t kDefaultByteBudget = 64 * 1024 * 1024;
+
+  CPDF_ScratchBitmapPool();
+  explicit CPDF_ScratchBitmapPool(size_t byte_budget);
+  ~CPDF_ScratchBitmapPool();
+
+  // Returns a zero-filled bitmap, or nullptr on failure. Its buffer goes back
+  // to the pool once the last reference to the bitmap is dropped, so callers
+  // must not keep the bitmap beyond the render pass. Requests that do not fit
+  // in the byte budget get a bitmap with its own buffer.
+  RetainPtr<CFX_DIBitmap> Acquire(int width, int height, FXDIB_Format format);
+
+  size_t GetBufferCount() const { return m_Buffers.size(); }
+  size_t GetSizeInBytes() const { return m_SizeInBytes; }
+
+ private:
+  struct Buffer {
+    Buffer();
+    Buffer(Buffer&& that);
+    Buffer& operator=(Buffer&& that);
+    ~Buffer();
+
+    bool IsFree() const;
+
+    std::unique_ptr<uint8_t, FxFreeDeleter> data;
+    size_t size = 0;
+    RetainPtr<CFX_DIBitmap> bitmap;
+  };
+
+  Buffer* FindBuffer(size_t size);
+
+  const size_t m_ByteBudget;
+  size_t m_SizeInBytes = 0;
+  std::vector<Buffer> m_Buffers;
+};
+
+#endif  // CORE_FPDFAPI_RENDER_CPDF_SCRATCHBITMAPPOOL_H_
@@ -0,0 +1,82 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_scratchbitmappool.h"
+
+#include <algorithm>
+
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+bool IsZeroed(const RetainPtr<CFX_DIBitmap>& bitmap) {
+  pdfium::span<const uint8_t> buffer = bitmap->GetBuffer();
+  return std::all_of(buffer.begin(), buffer.end(),
+                     [](uint8_t value) { return value == 0; });
+}
+
+}  // namespace
+
+TEST(CPDF_ScratchBitmapPool, ReuseReleasedBuffer) {
+  CPDF_ScratchBitmapPool pool;
+  RetainPtr<CFX_DIBitmap> bitmap = pool.Acquire(16, 8, FXDIB_Format::kArgb);
+  ASSERT_TRUE(bitmap);
+  EXPECT_EQ(16, bitmap->GetWidth());
+  EXPECT_EQ(8, bitmap->GetHeight());
+  EXPECT_EQ(FXDIB_Format::kArgb, bitmap->GetFormat());
+  EXPECT_TRUE(IsZeroed(bitmap));
+  const uint8_t* pixels = bitmap->GetBuffer().data();
+  bitmap->Clear(0xff336699);
+
+  // A buffer in use is not handed out again.
+  RetainPtr<CFX_DIBitmap> other = pool.Acquire(16, 8, FXDIB_Format::kArgb);
+  ASSERT_TRUE(other);
+  EXPECT_NE(pixels, other->GetBuffer().data());
+  EXPECT_EQ(2u, pool.GetBufferCount());
+  other.Reset();
+
+  // Once released, the buffer comes back zeroed, possibly in a smaller
+  // bitmap of another format.
+  bitmap.Reset();
+  RetainPtr<CFX_DIBitmap> mask = pool.Acquire(20, 4, FXDIB_Format::k8bppMask);
+  ASSERT_TRUE(mask);
+  EXPECT_EQ(2u, pool.GetBufferCount());
+  EXPECT_EQ(20, mask->GetWidth());
+  EXPECT_EQ(FXDIB_Format::k8bppMask, mask->GetFormat());
+  EXPECT_TRUE(IsZeroed(mask));
+}
+
+TEST(CPDF_ScratchBitmapPool, GrowReleasedBuffer) {
+  CPDF_ScratchBitmapPool pool;
+  RetainPtr<CFX_DIBitmap> bitmap = pool.Acquire(4, 4, FXDIB_Format::kArgb);
+  ASSERT_TRUE(bitmap);
+  const size_t small_size = pool.GetSizeInBytes();
+  bitmap.Reset();
+
+  bitmap = pool.Acquire(64, 64, FXDIB_Format::kArgb);
+  ASSERT_TRUE(bitmap);
+  EXPECT_EQ(1u, pool.GetBufferCount());
+  EXPECT_GT(pool.GetSizeInBytes(), small_size);
+  EXPECT_TRUE(IsZeroed(bitmap));
+}
+
+TEST(CPDF_ScratchBitmapPool, OverBudget) {
+  constexpr size_t kBudget = 64 * 64 * 4 + 4;
+  CPDF_ScratchBitmapPool pool(kBudget);
+  RetainPtr<CFX_DIBitmap> bitmap = pool.Acquire(64, 64, FXDIB_Format::kArgb);
+  ASSERT_TRUE(bitmap);
+  EXPECT_EQ(kBudget, pool.GetSizeInBytes());
+
+  // Requests past the budget still succeed, outside the pool.
+  RetainPtr<CFX_DIBitmap> extra = pool.Acquire(8, 8, FXDIB_Format::kArgb);
+  ASSERT_TRUE(extra);
+  EXPECT_TRUE(IsZeroed(extra));
+  EXPECT_EQ(1u, pool.GetBufferCount());
+  EXPECT_EQ(kBudget, pool.GetSizeInBytes());
+
+  RetainPtr<CFX_DIBitmap> huge = pool.Acquire(128, 128, FXDIB_Format::kArgb);
+  ASSERT_TRUE(huge);
+  EXPECT_EQ(1u, pool.GetBufferCount());
+}
@@ -0,0 +1,101 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_tilingcellcache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "core/fpdfapi/parser/cpdf_object.h"
+#include "core/fxcrt/fx_system.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+
+namespace {
+
+bool SameLinearPart(const CFX_Matrix& m1, const CFX_Matrix& m2) {
+  return FXSYS_roundf(m1.a * 10000) == FXSYS_roundf(m2.a * 10000) &&
+         FXSYS_roundf(m1.b * 10000) == FXSYS_roundf(m2.b * 10000) &&
+         FXSYS_roundf(m1.c * 10000) == FXSYS_roundf(m2.c * 10000) &&
+         FXSYS_roundf(m1.d * 10000) == FXSYS_roundf(m2.d * 10000);
+}
+
+}  // namespace
+
+CPDF_TilingCellCache::Key::Key() = default;
+
+CPDF_TilingCellCache::Key::Key(const Key& that) = default;
+
+CPDF_TilingCellCache::Key& CPDF_TilingCellCache::Key::operator=(
+    const Key& that) = default;
+
+CPDF_TilingCellCache::Key::~Key() = default;
+
+bool CPDF_TilingCellCache::Key::operator==(const Key& that) const {
+  return pattern == that.pattern && pattern_to_form == that.pattern_to_form &&
+         SameLinearPart(object_to_device, that.object_to_device) &&
+         width == that.width && height == that.height &&
+         options == that.options && gray == that.gray;
+}
+
+CPDF_TilingCellCache::Entry::Entry(const Key& key,
+                                   RetainPtr<CFX_DIBitmap> bitmap)
+    : key(key),
+      bitmap(std::move(bitmap)),
+      size_in_bytes(static_cast<size_t>(this->bitmap->GetPitch()) *
+                    this->bitmap->GetHeight()) {}
+
+CPDF_TilingCellCache::Entry::~Entry() = default;
+
+CPDF_TilingCellCache::CPDF_TilingCellCache()
+    : CPDF_TilingCellCache(kDefaultByteBudget) {}
+
+CPDF_TilingCellCache::CPDF_TilingCellCache(size_t byte_budget)
+    : m_ByteBudget(byte_budget) {}
+
+CPDF_TilingCellCache::~CPDF_TilingCellCache() = default;
+
+RetainPtr<CFX_DIBitmap> CPDF_TilingCellCache::Find(const Key& key) {
+  auto it = m_Cells.find(key.pattern);
+  if (it == m_Cells.end())
+    return nullptr;
+
+  for (LruList::iterator entry : it->second) {
+    if (entry->key == key) {
+      m_LruList.splice(m_LruList.begin(), m_LruList, entry);
+      return entry->bitmap;
+    }
+  }
+  return nullptr;
+}
+
+void CPDF_TilingCellCache::Add(const Key& key,
+                               RetainPtr<CFX_DIBitmap> pBitmap) {
+  if (!key.pattern || !pBitmap)
+    return;
+
+  m_LruList.emplace_front(key, std::move(pBitmap));
+  const size_t size_in_bytes = m_LruList.front().size_in_bytes;
+  if (size_in_bytes > m_ByteBudget) {
+    m_LruList.pop_front();
+    return;
+  }
+
+  m_SizeInBytes += size_in_bytes;
+  m_Cells[key.pattern].push_back(m_LruList.begin());
+  while (m_SizeInBytes > m_ByteBudget)
+    EvictLeastRecentlyUsed();
+}
+
+void CPDF_TilingCellCache::EvictLeastRecentlyUsed() {
+  LruList::iterator oldest = std::prev(m_LruList.end());
+  auto cells_it = m_Cells.find(oldest->key.pattern);
+  std::vector<LruList::iterator>& cells = cells_it->second;
+  cells.erase(std::find(cells.begin(), cells.end(), oldest));
+  if (cells.empty())
+    m_Cells.erase(cells_it);
+
+  m_SizeInBytes -= oldest->size_in_bytes;
+  m_LruList.erase(oldest);
+}
@@ -0,0 +1,88 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_RENDER_CPDF_TILINGCELLCACHE_H_
+#define CORE_FPDFAPI_RENDER_CPDF_TILINGCELLCACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "core/fpdfapi/render/cpdf_renderoptions.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
+
+class CFX_DIBitmap;
+class CPDF_Object;
+
+// Keeps rendered tiling pattern cells, so a pattern that fills many objects,
+// possibly on many pages, is only rasterized once per device scale. Cells are
+// evicted least recently used first once the cache exceeds its byte budget.
+class CPDF_TilingCellCache {
+ public:
+  // The inputs DrawPatternBitmap() renders a cell from. Like CPDF_Type3Cache,
+  // the linear part of |object_to_device| is compared at 1/10000 precision.
+  // Its translation does not affect the cell and is ignored. The fill colour
+  // of uncoloured patterns is not part of the key, since their cells are
+  // masks that get coloured when filling.
+  struct Key {
+    Key();
+    Key(const Key& that);
+    Key& operator=(const Key& that);
+    ~Key();
+
+    bool operator==(const Key& that) const;
+
+    RetainPtr<const CPDF_Object> pattern;
+    CFX_Matrix pattern_to_form;
+    CFX_Matrix object_to_device;
+    int width = 0;
+    int height = 0;
+    CPDF_RenderOptions::Options options;
+    bool gray = false;
+  };
+
+  static constexpr size_t kDefaultByteBudget = 32 * 1024 * 1024;
+
+  CPDF_TilingCellCache();
+  explicit CPDF_TilingCellCache(size_t byte_budget);
+  ~CPDF_TilingCellCache();
+
+  // The returned bitmap is shared with the cache and must not be modified.
+  RetainPtr<CFX_DIBitmap> Find(const Key& key);
+
+  // Cells larger than the whole budget are not kept.
+  void Add(const Key& key, RetainPtr<CFX_DIBitmap> pBitmap);
+
+  size_t GetSizeInBytes() const { return m_SizeInBytes; }
+  size_t GetCellCount() const { return m_LruList.size(); }
+
+ private:
+  struct Entry {
+    Entry(const Key& key, RetainPtr<CFX_DIBitmap> bitmap);
+    ~Entry();
+
+    Key key;
+    RetainPtr<CFX_DIBitmap> bitmap;
+    size_t size_in_bytes;
+  };
+  using LruList = std::list<Entry>;
+
+  void EvictLeastRecentlyUsed();
+
+  const size_t m_ByteBudget;
+  size_t m_SizeInBytes = 0;
+  // Most recently used first.
+  LruList m_LruList;
+  std::map<RetainPtr<const CPDF_Object>,
+           std::vector<LruList::iterator>,
+           std::less<>>
+      m_Cells;
+};
+
+#endif  // CORE_FPDFAPI_RENDER_CPDF_TILINGCELLCACHE_H_
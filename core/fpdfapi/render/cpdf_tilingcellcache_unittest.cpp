@@ -0,0 +1,135 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_tilingcellcache.h"
+
+#include <utility>
+
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+RetainPtr<CFX_DIBitmap> MakeCell(int width, int height) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  EXPECT_TRUE(bitmap->Create(width, height, FXDIB_Format::kArgb));
+  return bitmap;
+}
+
+CPDF_TilingCellCache::Key MakeKey(RetainPtr<const CPDF_Object> pattern,
+                                  int width,
+                                  int height) {
+  CPDF_TilingCellCache::Key key;
+  key.pattern = std::move(pattern);
+  key.object_to_device = CFX_Matrix(2, 0, 0, -2, 10, 800);
+  key.width = width;
+  key.height = height;
+  return key;
+}
+
+}  // namespace
+
+TEST(CPDF_TilingCellCache, FindAdded) {
+  auto pattern = pdfium::MakeRetain<CPDF_Dictionary>();
+  CPDF_TilingCellCache cache;
+  CPDF_TilingCellCache::Key key = MakeKey(pattern, 8, 8);
+  EXPECT_FALSE(cache.Find(key));
+
+  RetainPtr<CFX_DIBitmap> cell = MakeCell(8, 8);
+  cache.Add(key, cell);
+  EXPECT_EQ(cell, cache.Find(key));
+  EXPECT_EQ(1u, cache.GetCellCount());
+  EXPECT_EQ(8u * 8u * 4u, cache.GetSizeInBytes());
+
+  // The translation does not matter, and tiny scale differences are ignored.
+  CPDF_TilingCellCache::Key moved = key;
+  moved.object_to_device.e = 300;
+  moved.object_to_device.f = 12;
+  moved.object_to_device.a += 0.00001f;
+  EXPECT_EQ(cell, cache.Find(moved));
+
+  CPDF_TilingCellCache::Key scaled = key;
+  scaled.object_to_device.a = 2.01f;
+  EXPECT_FALSE(cache.Find(scaled));
+
+  CPDF_TilingCellCache::Key resized = key;
+  resized.width = 9;
+  EXPECT_FALSE(cache.Find(resized));
+
+  CPDF_TilingCellCache::Key gray = key;
+  gray.gray = true;
+  EXPECT_FALSE(cache.Find(gray));
+
+  CPDF_TilingCellCache::Key other_options = key;
+  other_options.options.bNoPathSmooth = true;
+  EXPECT_FALSE(cache.Find(other_options));
+
+  auto other_pattern = pdfium::MakeRetain<CPDF_Dictionary>();
+  EXPECT_FALSE(cache.Find(MakeKey(other_pattern, 8, 8)));
+}
+
+TEST(CPDF_TilingCellCache, EvictLeastRecentlyUsed) {
+  auto pattern = pdfium::MakeRetain<CPDF_Dictionary>();
+  constexpr size_t kCellBytes = 16 * 16 * 4;
+  CPDF_TilingCellCache cache(3 * kCellBytes);
+  CPDF_TilingCellCache::Key key1 = MakeKey(pattern, 16, 16);
+  CPDF_TilingCellCache::Key key2 = key1;
+  key2.object_to_device.a = 3;
+  CPDF_TilingCellCache::Key key3 = key1;
+  key3.object_to_device.a = 4;
+  CPDF_TilingCellCache::Key key4 = key1;
+  key4.object_to_device.a = 5;
+
+  cache.Add(key1, MakeCell(16, 16));
+  cache.Add(key2, MakeCell(16, 16));
+  cache.Add(key3, MakeCell(16, 16));
+  EXPECT_EQ(3u, cache.GetCellCount());
+
+  // Touching |key1| makes |key2| the oldest.
+  EXPECT_TRUE(cache.Find(key1));
+  cache.Add(key4, MakeCell(16, 16));
+  EXPECT_EQ(3u, cache.GetCellCount());
+  EXPECT_EQ(3 * kCellBytes, cache.GetSizeInBytes());
+  EXPECT_TRUE(cache.Find(key1));
+  EXPECT_FALSE(cache.Find(key2));
+  EXPECT_TRUE(cache.Find(key3));
+  EXPECT_TRUE(cache.Find(key4));
+
+  // A cell larger than the whole budget is not kept.
+  CPDF_TilingCellCache::Key huge = MakeKey(pattern, 64, 64);
+  cache.Add(huge, MakeCell(64, 64));
+  EXPECT_FALSE(cache.Find(huge));
+  EXPECT_EQ(3u, cache.GetCellCount());
+}
+
+TEST(CPDF_TilingCellCache, EvictAcrossPatterns) {
+  auto pattern1 = pdfium::MakeRetain<CPDF_Dictionary>();
+  auto pattern2 = pdfium::MakeRetain<CPDF_Dictionary>();
+  constexpr size_t kCellBytes = 8 * 8 * 4;
+  CPDF_TilingCellCache cache(2 * kCellBytes);
+  CPDF_TilingCellCache::Key key1 = MakeKey(pattern1, 8, 8);
+  CPDF_TilingCellCache::Key key2 = MakeKey(pattern2, 8, 8);
+  CPDF_TilingCellCache::Key key3 = key1;
+  key3.object_to_device.a = 3;
+
+  cache.Add(key1, MakeCell(8, 8));
+  cache.Add(key2, MakeCell(8, 8));
+  EXPECT_TRUE(cache.Find(key1));
+
+  // |key2| is the oldest, and was the only cell for |pattern2|.
+  cache.Add(key3, MakeCell(8, 8));
+  EXPECT_EQ(2u, cache.GetCellCount());
+  EXPECT_TRUE(cache.Find(key1));
+  EXPECT_FALSE(cache.Find(key2));
+  EXPECT_TRUE(cache.Find(key3));
+
+  // Re-adding |key2| evicts |key1|, now the oldest cell of |pattern1|.
+  cache.Add(key2, MakeCell(8, 8));
+  EXPECT_EQ(2u, cache.GetCellCount());
+  EXPECT_EQ(2 * kCellBytes, cache.GetSizeInBytes());
+  EXPECT_FALSE(cache.Find(key1));
+  EXPECT_TRUE(cache.Find(key2));
+  EXPECT_TRUE(cache.Find(key3));
+}
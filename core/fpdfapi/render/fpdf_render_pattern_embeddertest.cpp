@@ -2,12 +2,23 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "core/fxge/cfx_defaultrenderdevice.h"
 #include "public/cpp/fpdf_scopers.h"
 #include "testing/embedder_test.h"
 #include "testing/embedder_test_constants.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
-class FPDFRenderPatternEmbedderTest : public EmbedderTest {};
+class FPDFRenderPatternEmbedderTest : public EmbedderTest {
+ protected:
+  void RenderMeshShadingPage(int page_index, const char* checksum) {
+    ASSERT_TRUE(OpenDocument("mesh_shadings.pdf"));
+    FPDF_PAGE page = LoadPage(page_index);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page);
+    CompareBitmap(bitmap.get(), 255, 255, checksum);
+    UnloadPage(page);
+  }
+};
 
 TEST_F(FPDFRenderPatternEmbedderTest, LoadError_547706) {
   // Test shading where object is a dictionary instead of a stream.
@@ -18,3 +29,38 @@ TEST_F(FPDFRenderPatternEmbedderTest, LoadError_547706) {
   CompareBitmap(bitmap.get(), 612, 792, pdfium::kBlankPage612By792Checksum);
   UnloadPage(page);
 }
+
+// The mesh shading tests pin the AGG output of CPDF_RenderShading. Skia draws
+// Coons patch meshes itself and composites the other meshes differently.
+
+TEST_F(FPDFRenderPatternEmbedderTest, FreeFormGouraudShading) {
+  if (CFX_DefaultRenderDevice::SkiaIsDefaultRenderer())
+    return;
+
+  // Overlapping triangles, followed by a strip continued through edge flags.
+  RenderMeshShadingPage(0, "f8dd5e61f7eaad43e364712f701a74ca");
+}
+
+TEST_F(FPDFRenderPatternEmbedderTest, LatticeGouraudShading) {
+  if (CFX_DefaultRenderDevice::SkiaIsDefaultRenderer())
+    return;
+
+  RenderMeshShadingPage(1, "ced595c2015f459c60faed0006ab58e3");
+}
+
+TEST_F(FPDFRenderPatternEmbedderTest, CoonsPatchMeshShading) {
+  if (CFX_DefaultRenderDevice::SkiaIsDefaultRenderer())
+    return;
+
+  // The second patch continues from the right edge of the first and reaches
+  // past the right side of the page.
+  RenderMeshShadingPage(2, "d166e6bf0e60e94154e0ff4ca7a0c2a3");
+}
+
+TEST_F(FPDFRenderPatternEmbedderTest, TensorPatchMeshShadingClipped) {
+  if (CFX_DefaultRenderDevice::SkiaIsDefaultRenderer())
+    return;
+
+  // Both patches reach outside the clip rectangle.
+  RenderMeshShadingPage(3, "c481c40f71934a984445b00ceace5ad7");
+}
@@ -6,6 +6,7 @@
 
 #include "core/fpdftext/cpdf_linkextract.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "core/fpdftext/cpdf_textpage.h"
@@ -103,6 +104,128 @@ size_t TrimExternalBracketsFromWebLink(const WideString& str,
   return end;
 }
 
+// States of a DFA that finds "http", "www." or '@' in a word, ignoring case.
+// CheckWebLink() and CheckMailLink() only accept words that contain one of
+// them.
+enum class LinkMarkerState : uint8_t {
+  kNone,
+  kH,
+  kHt,
+  kHtt,
+  kW,
+  kWw,
+  kWww,
+  kFound,
+};
+
+LinkMarkerState NextLinkMarkerState(LinkMarkerState state, wchar_t ch) {
+  // Line breaks after a hyphen are removed from words before checking them.
+  if (ch == L'\n' || ch == L'\r')
+    return state;
+
+  if (FXSYS_IsUpperASCII(ch))
+    ch += L'a' - L'A';
+  else if (ch >= 0x80)
+    ch = static_cast<wchar_t>(FXSYS_towlower(ch));
+
+  switch (state) {
+    case LinkMarkerState::kFound:
+      return LinkMarkerState::kFound;
+    case LinkMarkerState::kH:
+      if (ch == L't')
+        return LinkMarkerState::kHt;
+      break;
+    case LinkMarkerState::kHt:
+      if (ch == L't')
+        return LinkMarkerState::kHtt;
+      break;
+    case LinkMarkerState::kHtt:
+      if (ch == L'p')
+        return LinkMarkerState::kFound;
+      break;
+    case LinkMarkerState::kW:
+      if (ch == L'w')
+        return LinkMarkerState::kWw;
+      break;
+    case LinkMarkerState::kWw:
+      if (ch == L'w')
+        return LinkMarkerState::kWww;
+      break;
+    case LinkMarkerState::kWww:
+      if (ch == L'.')
+        return LinkMarkerState::kFound;
+      if (ch == L'w')
+        return LinkMarkerState::kWww;
+      break;
+    case LinkMarkerState::kNone:
+      break;
+  }
+  if (ch == L'@')
+    return LinkMarkerState::kFound;
+  if (ch == L'h')
+    return LinkMarkerState::kH;
+  if (ch == L'w')
+    return LinkMarkerState::kW;
+  return LinkMarkerState::kNone;
+}
+
+// Returns the index in |page_text| at which the first link marker from
+// |start| on ends, if one ends before |end|.
+absl::optional<size_t> FindLinkMarker(const WideString& page_text,
+                                      size_t start,
+                                      size_t end) {
+  LinkMarkerState state = LinkMarkerState::kNone;
+  for (size_t i = start; i < end; ++i) {
+    state = NextLinkMarkerState(state, page_text[i]);
+    if (state == LinkMarkerState::kFound)
+      return i;
+  }
+  return absl::nullopt;
+}
+
+bool IsWordBreak(const CPDF_LinkExtract::ScanChar& scan_char) {
+  return scan_char.m_CharType == CPDF_TextPage::CharType::kGenerated ||
+         scan_char.m_Unicode == L' ';
+}
+
+bool IsHyphen(const CPDF_LinkExtract::ScanChar& scan_char) {
+  return scan_char.m_CharType == CPDF_TextPage::CharType::kHyphen ||
+         (scan_char.m_CharType == CPDF_TextPage::CharType::kNormal &&
+          scan_char.m_Unicode == L'-');
+}
+
+bool IsLineBreak(const CPDF_LinkExtract::ScanChar& scan_char) {
+  return scan_char.m_Unicode == L'\n' || scan_char.m_Unicode == L'\r';
+}
+
+// Returns where the word that holds the character at |index| starts, as
+// CPDF_LinkExtract::ExtractLinksFromChars() splits words: at word breaks,
+// except for line breaks after a hyphen. Sets |after_hyphen| to whether the
+// last character before the word that is not a break is a hyphen.
+size_t FindWordStart(size_t index,
+                     const CPDF_LinkExtract::GetScanCharCallback& get_char,
+                     bool* after_hyphen) {
+  size_t pos = index;
+  while (pos > 0) {
+    if (!IsWordBreak(get_char(pos - 1))) {
+      --pos;
+      continue;
+    }
+
+    size_t breaks_start = pos - 1;
+    while (breaks_start > 0 && IsWordBreak(get_char(breaks_start - 1)))
+      --breaks_start;
+    *after_hyphen = breaks_start > 0 && IsHyphen(get_char(breaks_start - 1));
+    for (size_t i = pos; i > breaks_start; --i) {
+      if (!*after_hyphen || !IsLineBreak(get_char(i - 1)))
+        return i;
+    }
+    pos = breaks_start;
+  }
+  *after_hyphen = false;
+  return 0;
+}
+
 }  // namespace
 
 CPDF_LinkExtract::CPDF_LinkExtract(const CPDF_TextPage* pTextPage)
@@ -111,21 +234,48 @@ CPDF_LinkExtract::CPDF_LinkExtract(const CPDF_TextPage* pTextPage)
 CPDF_LinkExtract::~CPDF_LinkExtract() = default;
 
 void CPDF_LinkExtract::ExtractLinks() {
+  ExtractLinksFromChars(
+      m_pTextPage->CountChars(), m_pTextPage->GetAllPageText(),
+      [this](size_t index) {
+        const CPDF_TextPage::CharInfo& char_info =
+            m_pTextPage->GetCharInfo(index);
+        return ScanChar{char_info.m_Unicode, char_info.m_CharType};
+      });
+}
+
+void CPDF_LinkExtract::ExtractLinksFromChars(
+    size_t char_count,
+    const WideString& page_text,
+    const GetScanCharCallback& get_char) {
   m_LinkArray.clear();
   size_t start = 0;
   size_t pos = 0;
   bool bAfterHyphen = false;
   bool bLineBreak = false;
-  const size_t nTotalChar = m_pTextPage->CountChars();
-  const WideString page_text = m_pTextPage->GetAllPageText();
+  LinkMarkerState marker_state = LinkMarkerState::kNone;
+  const size_t nTotalChar = char_count;
+  const size_t nTextLength = std::min(page_text.GetLength(), nTotalChar);
+  // Words up to the one that holds |marker_end| have to be scanned. Those
+  // after it are skipped until the next link marker.
+  size_t marker_end = 0;
   while (pos < nTotalChar) {
-    const CPDF_TextPage::CharInfo& char_info = m_pTextPage->GetCharInfo(pos);
-    if (char_info.m_CharType != CPDF_TextPage::CharType::kGenerated &&
-        char_info.m_Unicode != L' ' && pos != nTotalChar - 1) {
-      bAfterHyphen =
-          (char_info.m_CharType == CPDF_TextPage::CharType::kHyphen ||
-           (char_info.m_CharType == CPDF_TextPage::CharType::kNormal &&
-            char_info.m_Unicode == L'-'));
+    if (pos == start && pos >= marker_end) {
+      absl::optional<size_t> marker =
+          FindLinkMarker(page_text, pos, nTextLength);
+      if (!marker.has_value())
+        break;
+
+      marker_end = marker.value() + 1;
+      start = FindWordStart(marker.value(), get_char, &bAfterHyphen);
+      pos = start;
+    }
+
+    const ScanChar scan_char = get_char(pos);
+    // Words are checked as they appear in |page_text|.
+    if (pos < nTextLength)
+      marker_state = NextLinkMarkerState(marker_state, page_text[pos]);
+    if (!IsWordBreak(scan_char) && pos != nTotalChar - 1) {
+      bAfterHyphen = IsHyphen(scan_char);
       ++pos;
       continue;
     }
@@ -133,14 +283,22 @@ void CPDF_LinkExtract::ExtractLinks() {
     size_t nCount = pos - start;
     if (pos == nTotalChar - 1) {
       ++nCount;
-    } else if (bAfterHyphen &&
-               (char_info.m_Unicode == L'\n' || char_info.m_Unicode == L'\r')) {
+    } else if (bAfterHyphen && IsLineBreak(scan_char)) {
       // Handle text breaks with a hyphen to the next line.
       bLineBreak = true;
       ++pos;
       continue;
     }
 
+    // The marker may have started before the word, and short words cannot be
+    // links.
+    if (marker_state != LinkMarkerState::kFound || nCount <= 5) {
+      bLineBreak = false;
+      marker_state = LinkMarkerState::kNone;
+      start = ++pos;
+      continue;
+    }
+
     WideString strBeCheck = page_text.Substr(start, nCount);
     if (bLineBreak) {
       strBeCheck.Remove(L'\n');
@@ -172,6 +330,7 @@ void CPDF_LinkExtract::ExtractLinks() {
         }
       }
     }
+    marker_state = LinkMarkerState::kNone;
     start = ++pos;
   }
 }
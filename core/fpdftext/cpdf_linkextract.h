@@ -10,15 +10,15 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <functional>
 #include <vector>
 
+#include "core/fpdftext/cpdf_textpage.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxcrt/widestring.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
-class CPDF_TextPage;
-
 class CPDF_LinkExtract {
  public:
   struct Range {
@@ -26,6 +26,13 @@ class CPDF_LinkExtract {
     size_t m_Count;
   };
 
+  // What ExtractLinks() needs to know about each character of the page.
+  struct ScanChar {
+    wchar_t m_Unicode;
+    CPDF_TextPage::CharType m_CharType;
+  };
+  using GetScanCharCallback = std::function<ScanChar(size_t)>;
+
   explicit CPDF_LinkExtract(const CPDF_TextPage* pTextPage);
   ~CPDF_LinkExtract();
 
@@ -40,6 +47,14 @@ class CPDF_LinkExtract {
     WideString m_strUrl;
   };
 
+  // Finds the links among |char_count| characters, whose text is |page_text|.
+  // Only words that contain "http", "www." or '@' can be links. These are
+  // found with a single pass over |page_text|, and only their characters are
+  // passed to |get_char|, copied and checked with CheckWebLink() and
+  // CheckMailLink().
+  void ExtractLinksFromChars(size_t char_count,
+                             const WideString& page_text,
+                             const GetScanCharCallback& get_char);
   absl::optional<Link> CheckWebLink(const WideString& str);
   bool CheckMailLink(WideString* str);
 
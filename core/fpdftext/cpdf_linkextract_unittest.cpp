@@ -4,6 +4,11 @@
 
 #include "core/fpdftext/cpdf_linkextract.h"
 
+#include <stdint.h>
+
+#include <iterator>
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
 // Class to help test functions in CPDF_LinkExtract class.
@@ -16,6 +21,112 @@ class CPDF_TestLinkExtract final : public CPDF_LinkExtract {
   // Access CheckMailLink and CheckWebLink.
   FRIEND_TEST(CPDF_LinkExtractTest, CheckMailLink);
   FRIEND_TEST(CPDF_LinkExtractTest, CheckWebLink);
+  FRIEND_TEST(CPDF_LinkExtractTest, ExtractLinksFromChars);
+  FRIEND_TEST(CPDF_LinkExtractTest, ExtractLinksMatchesWordByWord);
+
+  // Describes |text| with one character per unicode. Spaces in |generated| are
+  // generated characters, as are line breaks.
+  static std::vector<ScanChar> MakeChars(const WideString& text,
+                                         const WideString& generated) {
+    std::vector<ScanChar> chars;
+    for (size_t i = 0; i < text.GetLength(); ++i) {
+      CPDF_TextPage::CharType type = CPDF_TextPage::CharType::kNormal;
+      if (text[i] == L'\r' || text[i] == L'\n' ||
+          (i < generated.GetLength() && generated[i] == L' ')) {
+        type = CPDF_TextPage::CharType::kGenerated;
+      } else if (text[i] == 0xfffe) {
+        type = CPDF_TextPage::CharType::kHyphen;
+      }
+      chars.push_back({text[i], type});
+    }
+    return chars;
+  }
+
+  // Calls ExtractLinksFromChars() and returns how many characters it read.
+  size_t ExtractTestLinks(const std::vector<ScanChar>& chars,
+                          const WideString& page_text) {
+    size_t chars_read = 0;
+    ExtractLinksFromChars(chars.size(), page_text,
+                          [&chars, &chars_read](size_t index) {
+                            ++chars_read;
+                            return chars[index];
+                          });
+    return chars_read;
+  }
+
+  // Finds links the way ExtractLinksFromChars() did before it skipped words
+  // without link markers: by copying and checking every word.
+  std::vector<Link> ExtractLinksWordByWord(const std::vector<ScanChar>& chars,
+                                           const WideString& page_text) {
+    std::vector<Link> links;
+    size_t start = 0;
+    size_t pos = 0;
+    bool bAfterHyphen = false;
+    bool bLineBreak = false;
+    const size_t nTotalChar = chars.size();
+    while (pos < nTotalChar) {
+      const ScanChar& scan_char = chars[pos];
+      if (scan_char.m_CharType != CPDF_TextPage::CharType::kGenerated &&
+          scan_char.m_Unicode != L' ' && pos != nTotalChar - 1) {
+        bAfterHyphen =
+            (scan_char.m_CharType == CPDF_TextPage::CharType::kHyphen ||
+             (scan_char.m_CharType == CPDF_TextPage::CharType::kNormal &&
+              scan_char.m_Unicode == L'-'));
+        ++pos;
+        continue;
+      }
+
+      size_t nCount = pos - start;
+      if (pos == nTotalChar - 1) {
+        ++nCount;
+      } else if (bAfterHyphen && (scan_char.m_Unicode == L'\n' ||
+                                  scan_char.m_Unicode == L'\r')) {
+        bLineBreak = true;
+        ++pos;
+        continue;
+      }
+
+      WideString strBeCheck = page_text.Substr(start, nCount);
+      if (bLineBreak) {
+        strBeCheck.Remove(L'\n');
+        strBeCheck.Remove(L'\r');
+        bLineBreak = false;
+      }
+      strBeCheck.Replace(L"\xfffe", L"-");
+
+      if (strBeCheck.GetLength() > 5) {
+        while (strBeCheck.GetLength() > 0) {
+          wchar_t ch = strBeCheck.Back();
+          if (ch != L')' && ch != L',' && ch != L'>' && ch != L'.')
+            break;
+
+          strBeCheck = strBeCheck.First(strBeCheck.GetLength() - 1);
+          nCount--;
+        }
+
+        if (nCount > 5) {
+          auto maybe_link = CheckWebLink(strBeCheck);
+          if (maybe_link.has_value()) {
+            maybe_link.value().m_Start += start;
+            links.push_back(maybe_link.value());
+          } else if (CheckMailLink(&strBeCheck)) {
+            links.push_back(Link{{start, nCount}, strBeCheck});
+          }
+        }
+      }
+      start = ++pos;
+    }
+    return links;
+  }
+
+  void ExpectLinks(const std::vector<Link>& expected) const {
+    ASSERT_EQ(expected.size(), m_LinkArray.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_EQ(expected[i].m_Start, m_LinkArray[i].m_Start);
+      EXPECT_EQ(expected[i].m_Count, m_LinkArray[i].m_Count);
+      EXPECT_EQ(expected[i].m_strUrl, m_LinkArray[i].m_strUrl);
+    }
+  }
 };
 
 TEST(CPDF_LinkExtractTest, CheckMailLink) {
@@ -175,3 +286,76 @@ TEST(CPDF_LinkExtractTest, CheckWebLink) {
     EXPECT_EQ(it.count, maybe_link.value().m_Count) << it.input_string;
   }
 }
+
+TEST(CPDF_LinkExtractTest, ExtractLinksFromChars) {
+  CPDF_TestLinkExtract extractor;
+  const WideString text(
+      L"See http://www.example.com, (www.abc.com) or write to\r\n"
+      L"Abc.Def@xyz.org. Short a@b.c and no links here.\r\n"
+      L"Broken www.exam-\r\nple.com\r\nHTTPS://CAPS.COM");
+  extractor.ExtractTestLinks(
+      CPDF_TestLinkExtract::MakeChars(text, WideString()), text);
+  ASSERT_EQ(5u, extractor.CountLinks());
+  EXPECT_EQ(L"http://www.example.com", extractor.GetURL(0));
+  EXPECT_EQ(4u, extractor.m_LinkArray[0].m_Start);
+  EXPECT_EQ(22u, extractor.m_LinkArray[0].m_Count);
+  EXPECT_EQ(L"http://www.abc.com", extractor.GetURL(1));
+  EXPECT_EQ(L"mailto:Abc.Def@xyz.org", extractor.GetURL(2));
+  EXPECT_EQ(L"http://www.exam-ple.com", extractor.GetURL(3));
+  EXPECT_EQ(L"HTTPS://CAPS.COM", extractor.GetURL(4));
+  EXPECT_EQ(text.GetLength() - 16, extractor.m_LinkArray[4].m_Start);
+  EXPECT_EQ(16u, extractor.m_LinkArray[4].m_Count);
+
+  const WideString no_links(L"Nothing to see here, http:// or www. alone");
+  extractor.ExtractTestLinks(
+      CPDF_TestLinkExtract::MakeChars(no_links, WideString()), no_links);
+  EXPECT_EQ(0u, extractor.CountLinks());
+
+  // Words without "http", "www." or '@' are not even looked at.
+  const WideString no_markers(L"Nothing to see here, just words.");
+  EXPECT_EQ(0u, extractor.ExtractTestLinks(
+                    CPDF_TestLinkExtract::MakeChars(no_markers, WideString()),
+                    no_markers));
+  EXPECT_EQ(0u, extractor.CountLinks());
+
+  extractor.ExtractTestLinks({}, WideString());
+  EXPECT_EQ(0u, extractor.CountLinks());
+}
+
+TEST(CPDF_LinkExtractTest, ExtractLinksMatchesWordByWord) {
+  static const wchar_t* const kPieces[] = {
+      L"http://", L"HTTPS://", L"hTtP:/", L"www.", L"WwW", L"@", L"example",
+      L".com", L"(", L")", L",", L".", L">", L"[", L"]:80", L"/path", L"a",
+      L"-", L"\r\n", L" ", L"  ", L"mail", L"x_y", L"\x6d4b", L"\xfffe", L"h",
+      L"t", L"p", L"w", L"\"", L"\x0130", L"\x212a", L"..", L"\n", L"q@r.st",
+      L"\r"};
+
+  CPDF_TestLinkExtract extractor;
+  uint32_t seed = 1;
+  auto next_random = [&seed](uint32_t range) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % range;
+  };
+  for (int iteration = 0; iteration < 2000; ++iteration) {
+    WideString text;
+    WideString generated;
+    const uint32_t piece_count = 1 + next_random(40);
+    for (uint32_t i = 0; i < piece_count; ++i) {
+      const wchar_t* piece = kPieces[next_random(std::size(kPieces))];
+      text += piece;
+      const wchar_t mark = next_random(2) ? L' ' : L'x';
+      for (size_t j = 0; piece[j]; ++j)
+        generated += mark;
+    }
+    auto chars = CPDF_TestLinkExtract::MakeChars(text, generated);
+
+    // The page text does not always line up with the characters.
+    WideString page_text = text;
+    if (iteration % 4 == 3 && !page_text.IsEmpty())
+      page_text.Delete(next_random(page_text.GetLength()), 1 + next_random(3));
+
+    extractor.ExtractTestLinks(chars, page_text);
+    SCOPED_TRACE(testing::Message() << "iteration " << iteration);
+    extractor.ExpectLinks(extractor.ExtractLinksWordByWord(chars, page_text));
+  }
+}
@@ -0,0 +1,245 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdftext/cpdf_textindex.h"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <utility>
+
+#include "core/fpdftext/cpdf_textpage.h"
+#include "core/fxcrt/fx_extension.h"
+
+namespace {
+
+constexpr size_t kGramSize = 3;
+constexpr float kSizeEpsilon = 0.01f;
+
+bool IsSpace(wchar_t c) {
+  return c == L' ' || c == L'\r' || c == L'\n' || c == L'\t' || c == 160;
+}
+
+bool IsWordChar(wchar_t c) {
+  return FXSYS_iswalnum(c) || c == L'_';
+}
+
+// Collapses runs of whitespace in |term| to a single space and trims it.
+WideString CollapseSpaces(const WideString& term) {
+  WideString result;
+  bool pending_space = false;
+  for (wchar_t c : term) {
+    if (IsSpace(c)) {
+      pending_space = !result.IsEmpty();
+      continue;
+    }
+    if (pending_space) {
+      result += L' ';
+      pending_space = false;
+    }
+    result += c;
+  }
+  return result;
+}
+
+// Compares the first |key.GetLength()| characters of |text| at |pos| with
+// |key|, where running off the end of |text| sorts first.
+int CompareAt(WideStringView text, size_t pos, WideStringView key) {
+  for (size_t i = 0; i < key.GetLength(); ++i) {
+    if (pos + i >= text.GetLength())
+      return -1;
+    auto c = text[pos + i];
+    if (c != key[i])
+      return c < key[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+struct CPDF_TextIndex::Page {
+  // Case folded text, with one entry in |chars| per character.
+  WideString folded;
+  std::vector<Char> chars;
+  // Positions in |folded| that do not start with a space, ordered by the
+  // trigram that starts there, then by position.
+  std::vector<uint32_t> grams;
+};
+
+CPDF_TextIndex::CPDF_TextIndex() = default;
+
+CPDF_TextIndex::~CPDF_TextIndex() = default;
+
+void CPDF_TextIndex::AddPage(int page_index, const CPDF_TextPage* pTextPage) {
+  const WideString text = pTextPage->GetAllPageText();
+  std::vector<Char> chars;
+  chars.reserve(text.GetLength());
+  const CPDF_TextObject* last_text_obj = nullptr;
+  uint32_t run = 0;
+  for (size_t i = 0; i < text.GetLength(); ++i) {
+    int char_index = pTextPage->CharIndexFromTextIndex(static_cast<int>(i));
+    if (char_index < 0)
+      break;
+
+    const CPDF_TextPage::CharInfo& info = pTextPage->GetCharInfo(char_index);
+    CFX_FloatRect box;
+    if (info.m_CharType != CPDF_TextPage::CharType::kGenerated) {
+      if (last_text_obj != info.m_pTextObj) {
+        last_text_obj = info.m_pTextObj;
+        ++run;
+      }
+      box = info.m_CharBox;
+    }
+    chars.push_back({text[i], char_index, run, box});
+  }
+  AddPageChars(page_index, chars);
+}
+
+void CPDF_TextIndex::AddPageChars(int page_index,
+                                  const std::vector<Char>& chars) {
+  auto page = std::make_unique<Page>();
+  page->chars.reserve(chars.size());
+  {
+    // Each run of whitespace keeps its first character.
+    auto folded = page->folded.GetBuffer(chars.size());
+    size_t length = 0;
+    for (const Char& ch : chars) {
+      bool space = IsSpace(ch.unicode);
+      if (space && length > 0 && folded[length - 1] == L' ')
+        continue;
+
+      folded[length++] =
+          space ? L' ' : static_cast<wchar_t>(FXSYS_towlower(ch.unicode));
+      page->chars.push_back(ch);
+    }
+    page->folded.ReleaseBuffer(length);
+  }
+
+  const WideStringView folded = page->folded.AsStringView();
+  page->grams.resize(folded.GetLength());
+  std::iota(page->grams.begin(), page->grams.end(), 0);
+  page->grams.erase(std::remove_if(page->grams.begin(), page->grams.end(),
+                                   [folded](uint32_t pos) {
+                                     return folded[pos] == L' ';
+                                   }),
+                    page->grams.end());
+  std::stable_sort(page->grams.begin(), page->grams.end(),
+                   [folded](uint32_t a, uint32_t b) {
+                     size_t len = std::min(kGramSize, folded.GetLength() - b);
+                     return CompareAt(folded, a, folded.Substr(b, len)) < 0;
+                   });
+  page->grams.shrink_to_fit();
+  m_Pages[page_index] = std::move(page);
+}
+
+void CPDF_TextIndex::RemovePage(int page_index) {
+  m_Pages.erase(page_index);
+}
+
+bool CPDF_TextIndex::HasPage(int page_index) const {
+  return m_Pages.count(page_index) > 0;
+}
+
+std::vector<CPDF_TextIndex::Hit> CPDF_TextIndex::Search(
+    const std::vector<WideString>& terms,
+    const Options& options) const {
+  std::vector<WideString> exact_terms;
+  std::vector<WideString> folded_terms;
+  for (const WideString& term : terms) {
+    exact_terms.push_back(CollapseSpaces(term));
+    folded_terms.push_back(exact_terms.back());
+    folded_terms.back().MakeLower();
+  }
+
+  std::vector<Hit> hits;
+  std::vector<uint32_t> candidates;
+  for (const auto& it : m_Pages) {
+    const Page& page = *it.second;
+    const WideStringView folded = page.folded.AsStringView();
+    const size_t first_hit = hits.size();
+    for (size_t t = 0; t < folded_terms.size(); ++t) {
+      const WideStringView term = folded_terms[t].AsStringView();
+      if (term.IsEmpty())
+        continue;
+
+      const WideStringView key =
+          term.First(std::min(kGramSize, term.GetLength()));
+      auto lower = std::partition_point(
+          page.grams.begin(), page.grams.end(), [folded, key](uint32_t pos) {
+            return CompareAt(folded, pos, key) < 0;
+          });
+      auto upper = std::partition_point(
+          lower, page.grams.end(), [folded, key](uint32_t pos) {
+            return CompareAt(folded, pos, key) == 0;
+          });
+      candidates.assign(lower, upper);
+      if (term.GetLength() < kGramSize)
+        std::sort(candidates.begin(), candidates.end());
+
+      size_t next_start = 0;
+      for (uint32_t pos : candidates) {
+        size_t end = pos + term.GetLength();
+        if (pos < next_start || end > folded.GetLength() ||
+            folded.Substr(pos, term.GetLength()) != term) {
+          continue;
+        }
+        if (options.bMatchCase) {
+          const WideString& exact = exact_terms[t];
+          bool same = true;
+          for (size_t i = 0; i < exact.GetLength() && same; ++i) {
+            wchar_t c = page.chars[pos + i].unicode;
+            same = IsSpace(c) ? exact[i] == L' ' : c == exact[i];
+          }
+          if (!same)
+            continue;
+        }
+        if (options.bMatchWholeWord &&
+            ((pos > 0 && IsWordChar(folded[pos - 1])) ||
+             (end < folded.GetLength() && IsWordChar(folded[end])))) {
+          continue;
+        }
+        int char_index = page.chars[pos].char_index;
+        hits.push_back({it.first, t, char_index,
+                        page.chars[end - 1].char_index - char_index + 1});
+        next_start = options.bConsecutive ? pos + 1 : end;
+      }
+    }
+    std::sort(hits.begin() + first_hit, hits.end(),
+              [](const Hit& a, const Hit& b) {
+                return std::tie(a.char_index, a.term_index) <
+                       std::tie(b.char_index, b.term_index);
+              });
+  }
+  return hits;
+}
+
+std::vector<CFX_FloatRect> CPDF_TextIndex::GetHitRects(const Hit& hit) const {
+  std::vector<CFX_FloatRect> rects;
+  auto it = m_Pages.find(hit.page_index);
+  if (it == m_Pages.end() || hit.char_count <= 0)
+    return rects;
+
+  const std::vector<Char>& chars = it->second->chars;
+  auto first = std::lower_bound(chars.begin(), chars.end(), hit.char_index,
+                                [](const Char& ch, int char_index) {
+                                  return ch.char_index < char_index;
+                                });
+  uint32_t run = 0;
+  for (auto ch = first; ch != chars.end() &&
+                        ch->char_index < hit.char_index + hit.char_count;
+       ++ch) {
+    if (ch->box.Width() < kSizeEpsilon || ch->box.Height() < kSizeEpsilon)
+      continue;
+
+    CFX_FloatRect box = ch->box;
+    box.Normalize();
+    if (rects.empty() || ch->run != run) {
+      rects.push_back(box);
+      run = ch->run;
+      continue;
+    }
+    rects.back().Union(box);
+  }
+  return rects;
+}
@@ -0,0 +1,82 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFTEXT_CPDF_TEXTINDEX_H_
+#define CORE_FPDFTEXT_CPDF_TEXTINDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/widestring.h"
+
+class CPDF_TextPage;
+
+// Search index over the text of the pages of a document. Pages are added one
+// at a time from their CPDF_TextPage, after which any number of terms can be
+// looked up on all of them without loading the pages again.
+//
+// The text of each page is case folded once, with runs of whitespace
+// collapsed to a single space, and the positions in it are sorted by the
+// trigram that starts there. A search then only verifies the positions that
+// share the first trigram of a term, instead of scanning the whole text.
+class CPDF_TextIndex {
+ public:
+  struct Options {
+    bool bMatchCase = false;
+    bool bMatchWholeWord = false;
+    bool bConsecutive = false;
+  };
+
+  struct Hit {
+    int page_index;
+    size_t term_index;
+    int char_index;
+    int char_count;
+  };
+
+  // One character of the page text, as passed to AddPageChars().
+  struct Char {
+    wchar_t unicode;
+    // Index of the character in the CPDF_TextPage.
+    int char_index;
+    // Characters from the same text object share a run, as in
+    // CPDF_TextPage::GetRectArray().
+    uint32_t run;
+    // Empty for generated characters.
+    CFX_FloatRect box;
+  };
+
+  CPDF_TextIndex();
+  ~CPDF_TextIndex();
+
+  // Indexes the text of |pTextPage| as page |page_index|, replacing anything
+  // indexed for that page before.
+  void AddPage(int page_index, const CPDF_TextPage* pTextPage);
+  void AddPageChars(int page_index, const std::vector<Char>& chars);
+  void RemovePage(int page_index);
+  bool HasPage(int page_index) const;
+  size_t GetPageCount() const { return m_Pages.size(); }
+
+  // Returns the matches of all |terms| on all indexed pages, ordered by page,
+  // then by position. Whitespace in a term matches any run of whitespace in
+  // the text. Unless |options.bConsecutive| is set, matches of the same term
+  // do not overlap.
+  std::vector<Hit> Search(const std::vector<WideString>& terms,
+                          const Options& options) const;
+
+  // Returns the boxes covering |hit|, one per text object it spans.
+  std::vector<CFX_FloatRect> GetHitRects(const Hit& hit) const;
+
+ private:
+  struct Page;
+
+  std::map<int, std::unique_ptr<Page>> m_Pages;
+};
+
+#endif  // CORE_FPDFTEXT_CPDF_TEXTINDEX_H_
@@ -0,0 +1,144 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdftext/cpdf_textindex.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Lays |text| out on one line, one unit per character. Each line of |text|
+// is its own run.
+std::vector<CPDF_TextIndex::Char> MakeChars(const wchar_t* text) {
+  std::vector<CPDF_TextIndex::Char> chars;
+  uint32_t run = 0;
+  for (int i = 0; text[i]; ++i) {
+    CFX_FloatRect box;
+    if (text[i] == L'\n')
+      ++run;
+    else
+      box = CFX_FloatRect(i, 0, i + 1, 1);
+    chars.push_back({text[i], i, run, box});
+  }
+  return chars;
+}
+
+std::vector<CPDF_TextIndex::Hit> Search(
+    const CPDF_TextIndex& index,
+    const std::vector<WideString>& terms,
+    const CPDF_TextIndex::Options& options = CPDF_TextIndex::Options()) {
+  return index.Search(terms, options);
+}
+
+void ExpectHit(const CPDF_TextIndex::Hit& hit,
+               int page_index,
+               size_t term_index,
+               int char_index,
+               int char_count) {
+  EXPECT_EQ(page_index, hit.page_index);
+  EXPECT_EQ(term_index, hit.term_index);
+  EXPECT_EQ(char_index, hit.char_index);
+  EXPECT_EQ(char_count, hit.char_count);
+}
+
+}  // namespace
+
+TEST(CPDFTextIndexTest, FindsTermsOnAllPages) {
+  CPDF_TextIndex index;
+  index.AddPageChars(2, MakeChars(L"Nothing else."));
+  index.AddPageChars(0, MakeChars(L"Hello world, hello PDF."));
+  index.AddPageChars(1, MakeChars(L"Say HELLO"));
+  EXPECT_EQ(3u, index.GetPageCount());
+
+  std::vector<CPDF_TextIndex::Hit> hits = Search(index, {L"hello", L"pdf"});
+  ASSERT_EQ(4u, hits.size());
+  ExpectHit(hits[0], 0, 0, 0, 5);
+  ExpectHit(hits[1], 0, 0, 13, 5);
+  ExpectHit(hits[2], 0, 1, 19, 3);
+  ExpectHit(hits[3], 1, 0, 4, 5);
+
+  // Terms shorter than a trigram, and terms that are not there.
+  hits = Search(index, {L"e", L"missing"});
+  ASSERT_EQ(5u, hits.size());
+  ExpectHit(hits[0], 0, 0, 1, 1);
+  ExpectHit(hits[1], 0, 0, 14, 1);
+  ExpectHit(hits[2], 1, 0, 5, 1);
+  ExpectHit(hits[3], 2, 0, 8, 1);
+  ExpectHit(hits[4], 2, 0, 11, 1);
+
+  EXPECT_TRUE(Search(index, {L"", L"   "}).empty());
+  EXPECT_TRUE(Search(index, {}).empty());
+}
+
+TEST(CPDFTextIndexTest, Options) {
+  CPDF_TextIndex index;
+  index.AddPageChars(0, MakeChars(L"Cat cat concatenate catcat"));
+
+  std::vector<CPDF_TextIndex::Hit> hits = Search(index, {L"cat"});
+  ASSERT_EQ(5u, hits.size());
+  ExpectHit(hits[0], 0, 0, 0, 3);
+  ExpectHit(hits[1], 0, 0, 4, 3);
+  ExpectHit(hits[2], 0, 0, 11, 3);
+  ExpectHit(hits[3], 0, 0, 20, 3);
+  ExpectHit(hits[4], 0, 0, 23, 3);
+
+  CPDF_TextIndex::Options options;
+  options.bMatchCase = true;
+  hits = Search(index, {L"Cat"}, options);
+  ASSERT_EQ(1u, hits.size());
+  ExpectHit(hits[0], 0, 0, 0, 3);
+
+  options = CPDF_TextIndex::Options();
+  options.bMatchWholeWord = true;
+  hits = Search(index, {L"cat"}, options);
+  ASSERT_EQ(2u, hits.size());
+  ExpectHit(hits[0], 0, 0, 0, 3);
+  ExpectHit(hits[1], 0, 0, 4, 3);
+
+  index.AddPageChars(0, MakeChars(L"aaaa"));
+  EXPECT_EQ(2u, Search(index, {L"aa"}).size());
+  options = CPDF_TextIndex::Options();
+  options.bConsecutive = true;
+  EXPECT_EQ(3u, Search(index, {L"aa"}, options).size());
+}
+
+TEST(CPDFTextIndexTest, WhitespaceMatchesAnyRun) {
+  CPDF_TextIndex index;
+  index.AddPageChars(0, MakeChars(L"one two\r\n  three"));
+
+  std::vector<CPDF_TextIndex::Hit> hits =
+      Search(index, {L"two three", L" one  two "});
+  ASSERT_EQ(2u, hits.size());
+  ExpectHit(hits[0], 0, 1, 0, 7);
+  ExpectHit(hits[1], 0, 0, 4, 12);
+
+  // The match spans two lines, so it gets a box on each.
+  std::vector<CFX_FloatRect> rects = index.GetHitRects(hits[1]);
+  ASSERT_EQ(2u, rects.size());
+  EXPECT_EQ(CFX_FloatRect(4, 0, 8, 1), rects[0]);
+  EXPECT_EQ(CFX_FloatRect(11, 0, 16, 1), rects[1]);
+
+  rects = index.GetHitRects(hits[0]);
+  ASSERT_EQ(1u, rects.size());
+  EXPECT_EQ(CFX_FloatRect(0, 0, 7, 1), rects[0]);
+}
+
+TEST(CPDFTextIndexTest, ReplaceAndRemovePages) {
+  CPDF_TextIndex index;
+  index.AddPageChars(0, MakeChars(L"first"));
+  index.AddPageChars(1, MakeChars(L"second"));
+  EXPECT_EQ(1u, Search(index, {L"first"}).size());
+
+  index.AddPageChars(0, MakeChars(L"changed"));
+  EXPECT_TRUE(Search(index, {L"first"}).empty());
+  EXPECT_EQ(1u, Search(index, {L"changed"}).size());
+
+  EXPECT_TRUE(index.HasPage(1));
+  index.RemovePage(1);
+  EXPECT_FALSE(index.HasPage(1));
+  EXPECT_TRUE(Search(index, {L"second"}).empty());
+  EXPECT_TRUE(index.GetHitRects({1, 0, 0, 6}).empty());
+}
@@ -10,6 +10,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <map>
 #include <utility>
 #include <vector>
 
@@ -23,6 +24,7 @@
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_string.h"
 #include "core/fpdftext/unicodenormalizationdata.h"
+#include "core/fxcrt/cfx_serializer.h"
 #include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_bidi.h"
 #include "core/fxcrt/fx_extension.h"
@@ -31,12 +33,20 @@
 #include "third_party/base/check.h"
 #include "third_party/base/check_op.h"
 #include "third_party/base/cxx17_backports.h"
+#include "third_party/base/ptr_util.h"
 
 namespace {
 
 constexpr float kDefaultFontSize = 1.0f;
 constexpr float kSizeEpsilon = 0.01f;
 
+constexpr uint8_t kSnapshotMagic[] = {'P', 'D', 'T', 'P'};
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr uint32_t kSnapshotNoTextObject = 0xFFFFFFFF;
+constexpr uint8_t kSnapshotNewMatrixFlag = 0x80;
+// Flags, text object, index, char code, unicode, origin and box.
+constexpr size_t kSnapshotCharSize = 1 + 4 * 4 + 2 * 4 + 4 * 4;
+
 const uint16_t* const kUnicodeDataNormalizationMaps[] = {
     kUnicodeDataNormalizationMap2, kUnicodeDataNormalizationMap3,
     kUnicodeDataNormalizationMap4};
@@ -108,6 +118,18 @@ float MaskPercentFilled(const std::vector<bool>& mask,
   return count / (end - start);
 }
 
+// Lists the text objects of |pHolder| and of the forms in it, depth first, so
+// snapshots can refer to them by position.
+void CollectTextObjects(const CPDF_PageObjectHolder* pHolder,
+                        std::vector<const CPDF_TextObject*>* objects) {
+  for (const auto& pObj : *pHolder) {
+    if (pObj->IsText())
+      objects->push_back(pObj->AsText());
+    else if (pObj->IsForm())
+      CollectTextObjects(pObj->AsForm()->form(), objects);
+  }
+}
+
 bool IsControlChar(const CPDF_TextPage::CharInfo& char_info) {
   switch (char_info.m_Unicode) {
     case 0x2:
@@ -282,17 +304,130 @@ CPDF_TextPage::CharInfo::CharInfo(const CharInfo&) = default;
 
 CPDF_TextPage::CharInfo::~CharInfo() = default;
 
+// static
+bool CPDF_TextPage::StreamPageText(const CPDF_Page* pPage,
+                                   bool rtl,
+                                   TextSink* pSink) {
+  CPDF_TextPage text_page(pPage, rtl, pSink);
+  text_page.ProcessObject();
+  text_page.FlushToSink();
+  return !text_page.m_bSinkStopped;
+}
+
 CPDF_TextPage::CPDF_TextPage(const CPDF_Page* pPage, bool rtl)
-    : m_pPage(pPage), m_rtl(rtl), m_DisplayMatrix(GetPageMatrix(pPage)) {
+    : CPDF_TextPage(pPage, rtl, nullptr) {
   Init();
 }
 
+CPDF_TextPage::CPDF_TextPage(const CPDF_Page* pPage,
+                             bool rtl,
+                             TextSink* pSink)
+    : m_pPage(pPage),
+      m_rtl(rtl),
+      m_DisplayMatrix(GetPageMatrix(pPage)),
+      m_pSink(pSink) {}
+
 CPDF_TextPage::~CPDF_TextPage() = default;
 
+// static
+std::unique_ptr<CPDF_TextPage> CPDF_TextPage::Deserialize(
+    const CPDF_Page* pPage,
+    pdfium::span<const uint8_t> data,
+    pdfium::span<const uint8_t> document_key) {
+  CFX_SerialReader reader(data);
+  bool rtl;
+  uint32_t object_count;
+  if (!reader.ReadHeader(kSnapshotMagic, kSnapshotVersion, document_key) ||
+      !reader.ReadBool(&rtl) || !reader.ReadUint32(&object_count)) {
+    return nullptr;
+  }
+
+  std::vector<const CPDF_TextObject*> objects;
+  CollectTextObjects(pPage, &objects);
+  if (objects.size() != object_count)
+    return nullptr;
+
+  uint32_t char_count;
+  if (!reader.ReadCount(kSnapshotCharSize, &char_count))
+    return nullptr;
+
+  auto text_page = pdfium::WrapUnique(new CPDF_TextPage(pPage, rtl, nullptr));
+  CFX_Matrix matrix;
+  for (uint32_t i = 0; i < char_count; ++i) {
+    CharInfo& info = text_page->m_CharList.emplace_back();
+    uint8_t flags;
+    uint32_t object_index;
+    uint32_t index;
+    uint32_t unicode;
+    if (!reader.ReadUint8(&flags) || !reader.ReadUint32(&object_index) ||
+        !reader.ReadUint32(&index) || !reader.ReadUint32(&info.m_CharCode) ||
+        !reader.ReadUint32(&unicode) || !reader.ReadFloat(&info.m_Origin.x) ||
+        !reader.ReadFloat(&info.m_Origin.y) ||
+        !reader.ReadRect(&info.m_CharBox)) {
+      return nullptr;
+    }
+
+    const uint8_t type = flags & ~kSnapshotNewMatrixFlag;
+    if (type > static_cast<uint8_t>(CharType::kPiece))
+      return nullptr;
+
+    // The first character always has its matrix.
+    if (flags & kSnapshotNewMatrixFlag) {
+      if (!reader.ReadMatrix(&matrix))
+        return nullptr;
+    } else if (i == 0) {
+      return nullptr;
+    }
+    if (object_index != kSnapshotNoTextObject) {
+      if (object_index >= objects.size())
+        return nullptr;
+      info.m_pTextObj = objects[object_index];
+    }
+    info.m_Index = static_cast<int>(index);
+    info.m_Unicode = static_cast<wchar_t>(unicode);
+    info.m_CharType = static_cast<CharType>(type);
+    info.m_Matrix = matrix;
+  }
+
+  uint32_t text_length;
+  if (!reader.ReadCount(sizeof(uint32_t), &text_length))
+    return nullptr;
+
+  WideString text;
+  {
+    pdfium::span<wchar_t> buffer = text.GetBuffer(text_length).first(text_length);
+    for (wchar_t& unicode : buffer) {
+      uint32_t value;
+      if (!reader.ReadUint32(&value))
+        return nullptr;
+      unicode = static_cast<wchar_t>(value);
+    }
+    text.ReleaseBuffer(text_length);
+  }
+  if (!reader.IsAtEnd())
+    return nullptr;
+
+  text_page->m_TextBuf << text;
+
+  text_page->IndexChars();
+
+  // Every text index must be within the text.
+  size_t indexed_length = 0;
+  for (const TextPageCharSegment& segment : text_page->m_CharIndices)
+    indexed_length += segment.count;
+  if (indexed_length > text_length)
+    return nullptr;
+
+  return text_page;
+}
+
 void CPDF_TextPage::Init() {
   m_TextBuf.SetAllocStep(10240);
   ProcessObject();
+  IndexChars();
+}
 
+void CPDF_TextPage::IndexChars() {
   const int nCount = CountChars();
   if (nCount)
     m_CharIndices.push_back({0, 0});
@@ -316,10 +451,92 @@ void CPDF_TextPage::Init() {
   }
 }
 
+void CPDF_TextPage::FlushToSink() {
+  if (!m_pSink || m_bSinkStopped)
+    return;
+
+  WideStringView text = m_TextBuf.AsStringView().Substr(m_SinkTextStart);
+  if (!text.IsEmpty()) {
+    absl::optional<CFX_FloatRect> bounds;
+    for (size_t i = m_SinkCharStart; i < m_CharList.size(); ++i) {
+      const CharInfo& charinfo = m_CharList[i];
+      if (charinfo.m_CharType == CPDF_TextPage::CharType::kGenerated)
+        continue;
+
+      CFX_FloatRect char_box = charinfo.m_CharBox;
+      char_box.Normalize();
+      if (bounds.has_value())
+        bounds->Union(char_box);
+      else
+        bounds = char_box;
+    }
+    if (!m_pSink->OnText(text, bounds)) {
+      m_bSinkStopped = true;
+      return;
+    }
+  }
+
+  // GetPrevCharInfo() and IsSameTextObject() look back at the last two
+  // characters, IsHyphen() at the last two in |m_TextBuf| that are not
+  // trailing spaces.
+  if (m_CharList.size() > 2)
+    m_CharList.erase(m_CharList.begin(), m_CharList.end() - 2);
+  m_SinkCharStart = m_CharList.size();
+
+  WideStringView buf = m_TextBuf.AsStringView();
+  size_t keep_from = buf.GetLength();
+  while (keep_from > 0 && buf[keep_from - 1] == L' ')
+    --keep_from;
+  keep_from = keep_from > 1 ? keep_from - 2 : 0;
+  m_TextBuf.Delete(0, keep_from);
+  m_SinkTextStart = m_TextBuf.GetLength();
+}
+
 int CPDF_TextPage::CountChars() const {
   return fxcrt::CollectionSize<int>(m_CharList);
 }
 
+DataVector<uint8_t> CPDF_TextPage::Serialize(
+    pdfium::span<const uint8_t> document_key) const {
+  std::vector<const CPDF_TextObject*> objects;
+  CollectTextObjects(m_pPage, &objects);
+  std::map<const CPDF_TextObject*, uint32_t> object_indices;
+  for (size_t i = 0; i < objects.size(); ++i)
+    object_indices[objects[i]] = static_cast<uint32_t>(i);
+
+  CFX_SerialWriter writer;
+  writer.WriteHeader(kSnapshotMagic, kSnapshotVersion, document_key);
+  writer.WriteUint8(m_rtl);
+  writer.WriteUint32(static_cast<uint32_t>(objects.size()));
+  writer.WriteUint32(static_cast<uint32_t>(m_CharList.size()));
+  const CFX_Matrix* prev_matrix = nullptr;
+  for (const CharInfo& info : m_CharList) {
+    // Characters of the same text object mostly share their matrix, so it is
+    // only written when it changes.
+    const bool new_matrix = !prev_matrix || *prev_matrix != info.m_Matrix;
+    prev_matrix = &info.m_Matrix;
+    auto it = object_indices.find(info.m_pTextObj.get());
+    writer.WriteUint8(static_cast<uint8_t>(info.m_CharType) |
+                      (new_matrix ? kSnapshotNewMatrixFlag : 0));
+    writer.WriteUint32(it != object_indices.end() ? it->second
+                                                  : kSnapshotNoTextObject);
+    writer.WriteUint32(static_cast<uint32_t>(info.m_Index));
+    writer.WriteUint32(info.m_CharCode);
+    writer.WriteUint32(static_cast<uint32_t>(info.m_Unicode));
+    writer.WriteFloat(info.m_Origin.x);
+    writer.WriteFloat(info.m_Origin.y);
+    writer.WriteRect(info.m_CharBox);
+    if (new_matrix)
+      writer.WriteMatrix(info.m_Matrix);
+  }
+
+  WideStringView text = m_TextBuf.AsStringView();
+  writer.WriteUint32(static_cast<uint32_t>(text.GetLength()));
+  for (wchar_t unicode : text)
+    writer.WriteUint32(static_cast<uint32_t>(unicode));
+  return writer.Detach();
+}
+
 int CPDF_TextPage::CharIndexFromTextIndex(int text_index) const {
   int count = 0;
   for (const auto& info : m_CharIndices) {
@@ -622,6 +839,9 @@ void CPDF_TextPage::ProcessObject() {
 
   m_TextlineDir = FindTextlineFlowOrientation();
   for (auto it = m_pPage->begin(); it != m_pPage->end(); ++it) {
+    if (m_bSinkStopped)
+      return;
+
     CPDF_PageObject* pObj = it->get();
     if (!pObj)
       continue;
@@ -940,7 +1160,7 @@ void CPDF_TextPage::SwapTempTextBuf(size_t iCharListStartAppend,
 
 void CPDF_TextPage::ProcessTextObject(const TransformedTextObject& obj) {
   const CPDF_TextObject* pTextObj = obj.m_pTextObj;
-  if (fabs(pTextObj->GetRect().Width()) < kSizeEpsilon)
+  if (m_bSinkStopped || fabs(pTextObj->GetRect().Width()) < kSizeEpsilon)
     return;
 
   CFX_Matrix form_matrix = obj.m_formMatrix;
@@ -979,6 +1199,7 @@ void CPDF_TextPage::ProcessTextObject(const TransformedTextObject& obj) {
           AppendGeneratedCharacter(L'\r', form_matrix);
           AppendGeneratedCharacter(L'\n', form_matrix);
         }
+        FlushToSink();
         break;
       case GenerateCharacter::kHyphen:
         if (pTextObj->CountChars() == 1) {
@@ -11,6 +11,7 @@
 
 #include <deque>
 #include <functional>
+#include <memory>
 #include <vector>
 
 #include "core/fpdfapi/page/cpdf_pageobjectholder.h"
@@ -21,6 +22,7 @@
 #include "core/fxcrt/widestring.h"
 #include "core/fxcrt/widetext_buffer.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/base/span.h"
 
 class CPDF_FormObject;
 class CPDF_Page;
@@ -59,9 +61,45 @@ class CPDF_TextPage {
     CFX_Matrix m_Matrix;
   };
 
+  // Receives the text of a page from StreamPageText().
+  class TextSink {
+   public:
+    virtual ~TextSink() = default;
+
+    // |text| is the next piece of the page text, usually a line and the line
+    // break that ends it. |bounds| covers its characters in page space, and is
+    // not set when it only has generated characters. Returns false to stop.
+    virtual bool OnText(WideStringView text,
+                        const absl::optional<CFX_FloatRect>& bounds) = 0;
+  };
+
+  // Extracts the same text as CPDF_TextPage(pPage, rtl).GetAllPageText(), but
+  // hands it to |pSink| as each line is completed and only keeps the
+  // characters of the current line. Returns false if |pSink| stopped early.
+  static bool StreamPageText(const CPDF_Page* pPage,
+                             bool rtl,
+                             TextSink* pSink);
+
+  // Rebuilds a text page for |pPage| from what Serialize() wrote, without
+  // analyzing the page layout again. Returns nullptr if |data| is malformed,
+  // comes from an incompatible version, was serialized with a key other than
+  // |document_key|, or does not match the text objects of |pPage|.
+  static std::unique_ptr<CPDF_TextPage> Deserialize(
+      const CPDF_Page* pPage,
+      pdfium::span<const uint8_t> data,
+      pdfium::span<const uint8_t> document_key);
+
   CPDF_TextPage(const CPDF_Page* pPage, bool rtl);
   ~CPDF_TextPage();
 
+  // Returns a snapshot of the characters, their boxes and the page text, so a
+  // viewer can cache it and reload the page's text with Deserialize() when it
+  // loads the page again. |document_key| identifies the document, such as a
+  // hash of its file. Text objects are referred to by their position on the
+  // page, so the snapshot only fits the same page of the same document.
+  DataVector<uint8_t> Serialize(
+      pdfium::span<const uint8_t> document_key) const;
+
   int CharIndexFromTextIndex(int text_index) const;
   int TextIndexFromCharIndex(int char_index) const;
   size_t size() const { return m_CharList.size(); }
@@ -111,7 +149,11 @@ class CPDF_TextPage {
     CFX_Matrix m_formMatrix;
   };
 
+  CPDF_TextPage(const CPDF_Page* pPage, bool rtl, TextSink* pSink);
+
   void Init();
+  void IndexChars();
+  void FlushToSink();
   bool IsHyphen(wchar_t curChar) const;
   void ProcessObject();
   void ProcessFormObject(CPDF_FormObject* pFormObj,
@@ -158,6 +200,13 @@ class CPDF_TextPage {
   std::vector<TransformedTextObject> mTextObjects;
   TextOrientation m_TextlineDir = TextOrientation::kUnknown;
   CFX_FloatRect m_CurlineRect;
+  // Only set by StreamPageText(). Completed lines are then flushed from
+  // |m_CharList| and |m_TextBuf|, except for the few entries the extraction
+  // looks back at.
+  UnownedPtr<TextSink> const m_pSink;
+  size_t m_SinkCharStart = 0;
+  size_t m_SinkTextStart = 0;
+  bool m_bSinkStopped = false;
 };
 
 #endif  // CORE_FPDFTEXT_CPDF_TEXTPAGE_H_
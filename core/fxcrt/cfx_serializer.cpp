@@ -0,0 +1,92 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/cfx_serializer.h"
+
+#include <string.h>
+
+CFX_SerialWriter::CFX_SerialWriter() = default;
+
+CFX_SerialWriter::~CFX_SerialWriter() = default;
+
+void CFX_SerialWriter::WriteHeader(pdfium::span<const uint8_t> magic,
+                                   uint32_t version,
+                                   pdfium::span<const uint8_t> key) {
+  WriteBytes(magic);
+  WriteUint32(version);
+  WriteUint32(static_cast<uint32_t>(key.size()));
+  WriteBytes(key);
+}
+
+void CFX_SerialWriter::WriteBytes(pdfium::span<const uint8_t> bytes) {
+  m_Data.insert(m_Data.end(), bytes.begin(), bytes.end());
+}
+
+void CFX_SerialWriter::WriteRect(const CFX_FloatRect& rect) {
+  WriteFloat(rect.left);
+  WriteFloat(rect.bottom);
+  WriteFloat(rect.right);
+  WriteFloat(rect.top);
+}
+
+void CFX_SerialWriter::WriteMatrix(const CFX_Matrix& matrix) {
+  WriteFloat(matrix.a);
+  WriteFloat(matrix.b);
+  WriteFloat(matrix.c);
+  WriteFloat(matrix.d);
+  WriteFloat(matrix.e);
+  WriteFloat(matrix.f);
+}
+
+CFX_SerialReader::CFX_SerialReader(pdfium::span<const uint8_t> data)
+    : m_Data(data) {}
+
+CFX_SerialReader::~CFX_SerialReader() = default;
+
+bool CFX_SerialReader::ReadHeader(pdfium::span<const uint8_t> magic,
+                                  uint32_t version,
+                                  pdfium::span<const uint8_t> key) {
+  pdfium::span<const uint8_t> read_magic;
+  uint32_t read_version;
+  uint32_t key_size;
+  pdfium::span<const uint8_t> read_key;
+  return ReadBytes(magic.size(), &read_magic) &&
+         memcmp(read_magic.data(), magic.data(), magic.size()) == 0 &&
+         ReadUint32(&read_version) && read_version == version &&
+         ReadUint32(&key_size) && key_size == key.size() &&
+         ReadBytes(key_size, &read_key) &&
+         (key.empty() || memcmp(read_key.data(), key.data(), key.size()) == 0);
+}
+
+bool CFX_SerialReader::ReadBool(bool* value) {
+  uint8_t byte;
+  if (!ReadUint8(&byte) || byte > 1)
+    return false;
+  *value = !!byte;
+  return true;
+}
+
+bool CFX_SerialReader::ReadBytes(size_t size,
+                                 pdfium::span<const uint8_t>* bytes) {
+  if (m_Data.size() - m_Pos < size)
+    return false;
+  *bytes = m_Data.subspan(m_Pos, size);
+  m_Pos += size;
+  return true;
+}
+
+bool CFX_SerialReader::ReadRect(CFX_FloatRect* rect) {
+  return ReadFloat(&rect->left) && ReadFloat(&rect->bottom) &&
+         ReadFloat(&rect->right) && ReadFloat(&rect->top);
+}
+
+bool CFX_SerialReader::ReadMatrix(CFX_Matrix* matrix) {
+  return ReadFloat(&matrix->a) && ReadFloat(&matrix->b) &&
+         ReadFloat(&matrix->c) && ReadFloat(&matrix->d) &&
+         ReadFloat(&matrix->e) && ReadFloat(&matrix->f);
+}
+
+bool CFX_SerialReader::ReadCount(size_t min_size, uint32_t* count) {
+  return ReadUint32(count) && *count <= (m_Data.size() - m_Pos) / min_size;
+}
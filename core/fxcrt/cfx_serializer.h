@@ -0,0 +1,107 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCRT_CFX_SERIALIZER_H_
+#define CORE_FXCRT_CFX_SERIALIZER_H_
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <utility>
+
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/fx_system.h"
+#include "third_party/base/span.h"
+
+// Writes integers and floats little-endian, so that serialized page data can
+// be shared between machines.
+class CFX_SerialWriter {
+ public:
+  CFX_SerialWriter();
+  ~CFX_SerialWriter();
+
+  // Writes |magic|, |version| and |key|, as checked by
+  // CFX_SerialReader::ReadHeader().
+  void WriteHeader(pdfium::span<const uint8_t> magic,
+                   uint32_t version,
+                   pdfium::span<const uint8_t> key);
+
+  void WriteUint8(uint8_t value) { m_Data.push_back(value); }
+
+  void WriteUint32(uint32_t value) {
+    for (int i = 0; i < 4; ++i)
+      m_Data.push_back(static_cast<uint8_t>(value >> (i * 8)));
+  }
+
+  void WriteFloat(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteUint32(bits);
+  }
+
+  void WriteBytes(pdfium::span<const uint8_t> bytes);
+  void WriteRect(const CFX_FloatRect& rect);
+  void WriteMatrix(const CFX_Matrix& matrix);
+
+  DataVector<uint8_t> Detach() { return std::move(m_Data); }
+
+ private:
+  DataVector<uint8_t> m_Data;
+};
+
+// Reads what CFX_SerialWriter writes. Every read fails once the data runs out
+// or holds a value no writer would have written.
+class CFX_SerialReader {
+ public:
+  explicit CFX_SerialReader(pdfium::span<const uint8_t> data);
+  ~CFX_SerialReader();
+
+  // Fails unless the data starts with exactly |magic|, |version| and |key|.
+  bool ReadHeader(pdfium::span<const uint8_t> magic,
+                  uint32_t version,
+                  pdfium::span<const uint8_t> key);
+
+  bool IsAtEnd() const { return m_Pos == m_Data.size(); }
+
+  bool ReadUint8(uint8_t* value) {
+    if (m_Data.size() - m_Pos < 1)
+      return false;
+    *value = m_Data[m_Pos++];
+    return true;
+  }
+
+  bool ReadUint32(uint32_t* value) {
+    if (m_Data.size() - m_Pos < 4)
+      return false;
+    *value = FXSYS_UINT32_GET_LSBFIRST(&m_Data[m_Pos]);
+    m_Pos += 4;
+    return true;
+  }
+
+  bool ReadFloat(float* value) {
+    uint32_t bits;
+    if (!ReadUint32(&bits))
+      return false;
+    memcpy(value, &bits, sizeof(bits));
+    return isfinite(*value);
+  }
+
+  bool ReadBool(bool* value);
+  bool ReadBytes(size_t size, pdfium::span<const uint8_t>* bytes);
+  bool ReadRect(CFX_FloatRect* rect);
+  bool ReadMatrix(CFX_Matrix* matrix);
+
+  // Reads the size of an array whose elements take at least |min_size| bytes
+  // each, so a corrupt size fails here rather than when allocating.
+  bool ReadCount(size_t min_size, uint32_t* count);
+
+ private:
+  pdfium::span<const uint8_t> const m_Data;
+  size_t m_Pos = 0;
+};
+
+#endif  // CORE_FXCRT_CFX_SERIALIZER_H_
@@ -0,0 +1,95 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/cfx_serializer.h"
+
+#include <math.h>
+
+#include <limits>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr uint8_t kMagic[] = {'T', 'E', 'S', 'T'};
+constexpr uint8_t kKey[] = {1, 2, 3};
+
+}  // namespace
+
+TEST(CFXSerializerTest, RoundTrip) {
+  CFX_SerialWriter writer;
+  writer.WriteHeader(kMagic, 7, kKey);
+  writer.WriteUint8(1);
+  writer.WriteUint32(0x12345678);
+  writer.WriteFloat(-2.5f);
+  writer.WriteRect(CFX_FloatRect(1, 2, 3, 4));
+  writer.WriteMatrix(CFX_Matrix(1, 2, 3, 4, 5, 6));
+  DataVector<uint8_t> data = writer.Detach();
+
+  // Little-endian, whatever the machine.
+  ASSERT_EQ(4u + 4u + 4u + 3u + 1u + 4u + 4u + 16u + 24u, data.size());
+  EXPECT_EQ(0x78, data[16]);
+  EXPECT_EQ(0x12, data[19]);
+
+  CFX_SerialReader reader(data);
+  ASSERT_TRUE(reader.ReadHeader(kMagic, 7, kKey));
+  bool flag = false;
+  EXPECT_TRUE(reader.ReadBool(&flag));
+  EXPECT_TRUE(flag);
+  uint32_t value = 0;
+  EXPECT_TRUE(reader.ReadUint32(&value));
+  EXPECT_EQ(0x12345678u, value);
+  float number = 0;
+  EXPECT_TRUE(reader.ReadFloat(&number));
+  EXPECT_EQ(-2.5f, number);
+  CFX_FloatRect rect;
+  EXPECT_TRUE(reader.ReadRect(&rect));
+  EXPECT_EQ(CFX_FloatRect(1, 2, 3, 4), rect);
+  CFX_Matrix matrix;
+  EXPECT_TRUE(reader.ReadMatrix(&matrix));
+  EXPECT_EQ(CFX_Matrix(1, 2, 3, 4, 5, 6), matrix);
+  EXPECT_TRUE(reader.IsAtEnd());
+  EXPECT_FALSE(reader.ReadUint8(nullptr));
+}
+
+TEST(CFXSerializerTest, RejectsBadHeaders) {
+  CFX_SerialWriter writer;
+  writer.WriteHeader(kMagic, 7, kKey);
+  DataVector<uint8_t> data = writer.Detach();
+
+  constexpr uint8_t kOtherMagic[] = {'T', 'E', 'S', 'X'};
+  constexpr uint8_t kOtherKey[] = {1, 2, 4};
+  EXPECT_FALSE(CFX_SerialReader(data).ReadHeader(kOtherMagic, 7, kKey));
+  EXPECT_FALSE(CFX_SerialReader(data).ReadHeader(kMagic, 8, kKey));
+  EXPECT_FALSE(CFX_SerialReader(data).ReadHeader(kMagic, 7, kOtherKey));
+  EXPECT_FALSE(CFX_SerialReader(data).ReadHeader(
+      kMagic, 7, pdfium::make_span(kKey).first(2)));
+  EXPECT_FALSE(CFX_SerialReader(pdfium::make_span(data).first(data.size() - 1))
+                   .ReadHeader(kMagic, 7, kKey));
+  EXPECT_TRUE(CFX_SerialReader(data).ReadHeader(kMagic, 7, kKey));
+}
+
+TEST(CFXSerializerTest, RejectsBadValues) {
+  CFX_SerialWriter writer;
+  writer.WriteUint8(2);
+  writer.WriteFloat(std::numeric_limits<float>::infinity());
+  writer.WriteFloat(NAN);
+  writer.WriteUint32(3);
+  writer.WriteUint32(0);
+  DataVector<uint8_t> data = writer.Detach();
+
+  CFX_SerialReader reader(data);
+  bool flag;
+  EXPECT_FALSE(reader.ReadBool(&flag));
+  float number;
+  EXPECT_FALSE(reader.ReadFloat(&number));
+  EXPECT_FALSE(reader.ReadFloat(&number));
+
+  // Three 4-byte elements do not fit in the 4 bytes left.
+  uint32_t count;
+  EXPECT_FALSE(reader.ReadCount(4, &count));
+  CFX_SerialReader four_bytes_left(pdfium::make_span(data).last(8));
+  EXPECT_TRUE(four_bytes_left.ReadCount(1, &count));
+  EXPECT_EQ(3u, count);
+}
@@ -95,7 +95,8 @@ inline int FXSYS_WideHexCharToInt(wchar_t c) {
 }
 
 inline bool FXSYS_IsDecimalDigit(char c) {
-  return !((c & 0x80) || !isdigit(c));
+  // Same as isdigit() for ASCII, without the per-call locale lookup.
+  return c >= '0' && c <= '9';
 }
 
 inline bool FXSYS_IsDecimalDigit(wchar_t c) {
@@ -6,8 +6,6 @@
 
 #include "core/fxcrt/fx_number.h"
 
-#include <ctype.h>
-
 #include <limits>
 
 #include "core/fxcrt/fx_extension.h"
@@ -28,13 +26,6 @@ FX_Number::FX_Number(ByteStringView strc)
   if (strc.IsEmpty())
     return;
 
-  if (strc.Contains('.')) {
-    m_bIsInteger = false;
-    m_bIsSigned = true;
-    m_FloatValue = StringToFloat(strc);
-    return;
-  }
-
   // Note, numbers in PDF are typically of the form 123, -123, etc. But,
   // for things like the Permissions on the encryption hash the number is
   // actually an unsigned value. We use a uint32_t so we can deal with the
@@ -52,11 +43,22 @@ FX_Number::FX_Number(ByteStringView strc)
     cc++;
   }
 
-  for (; cc < strc.GetLength() && isdigit(strc[cc]); ++cc) {
+  // Parse the integer in the same pass that looks for a '.', since most
+  // numbers are short integers and this runs once per content stream operand.
+  const char* str = strc.unterminated_c_str();
+  const size_t len = strc.GetLength();
+  for (; cc < len && FXSYS_IsDecimalDigit(str[cc]); ++cc) {
     // Deliberately not using FXSYS_DecimalCharToInt() in a tight loop to avoid
-    // a duplicate isdigit() call. Note that the order of operation is
-    // important to avoid unintentional overflows.
-    unsigned_val = unsigned_val * 10 + (strc[cc] - '0');
+    // a duplicate FXSYS_IsDecimalDigit() call. Note that the order of
+    // operation is important to avoid unintentional overflows.
+    unsigned_val = unsigned_val * 10 + (str[cc] - '0');
+  }
+
+  if (cc < len && strc.Substr(cc).Contains('.')) {
+    m_bIsInteger = false;
+    m_bIsSigned = true;
+    m_FloatValue = StringToFloat(strc);
+    return;
   }
 
   uint32_t uValue = unsigned_val.ValueOrDefault(0);
@@ -141,3 +141,22 @@ TEST(fxnumber, FromStringFloat) {
   FX_Number number("3.24");
   EXPECT_FLOAT_EQ(3.24f, number.GetFloat());
 }
+
+TEST(fxnumber, FromStringFloatAfterOtherCharacters) {
+  {
+    FX_Number number("-.5");
+    EXPECT_FALSE(number.IsInteger());
+    EXPECT_FLOAT_EQ(-0.5f, number.GetFloat());
+  }
+  {
+    // A '.' anywhere makes the number a float, even after non-digits.
+    FX_Number number("12x.5");
+    EXPECT_FALSE(number.IsInteger());
+    EXPECT_FLOAT_EQ(120.5f, number.GetFloat());
+  }
+  {
+    FX_Number number("12x5");
+    EXPECT_TRUE(number.IsInteger());
+    EXPECT_EQ(12, number.GetSigned());
+  }
+}
@@ -8,14 +8,17 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "build/build_config.h"
 #include "core/fxcrt/fx_2d_size.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxge/cfx_cliprgn.h"
+#include "core/fxge/cfx_clipruns.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 #include "core/fxge/cfx_graphstatedata.h"
 #include "core/fxge/cfx_path.h"
@@ -38,7 +41,6 @@
 #include "third_party/agg23/agg_conv_stroke.h"
 #include "third_party/agg23/agg_curves.h"
 #include "third_party/agg23/agg_path_storage.h"
-#include "third_party/agg23/agg_pixfmt_gray.h"
 #include "third_party/agg23/agg_rasterizer_scanline_aa.h"
 #include "third_party/agg23/agg_renderer_scanline.h"
 #include "third_party/agg23/agg_scanline_u.h"
@@ -238,7 +240,8 @@ void RgbByteOrderTransferBitmap(const RetainPtr<CFX_DIBitmap>& pBitmap,
   }
 }
 
-void RasterizeStroke(agg::rasterizer_scanline_aa* rasterizer,
+template <class Rasterizer>
+void RasterizeStroke(Rasterizer* rasterizer,
                      agg::path_storage* path_data,
                      const CFX_Matrix* pObject2Device,
                      const CFX_GraphStateData* pGraphState,
@@ -313,8 +316,17 @@ agg::filling_rule_e GetAlternateOrWindingFillType(
              : agg::fill_even_odd;
 }
 
-RetainPtr<CFX_DIBitmap> GetClipMaskFromRegion(const CFX_ClipRgn* r) {
-  return (r && r->GetType() == CFX_ClipRgn::kMaskF) ? r->GetMask() : nullptr;
+// Compositing onto a backdrop also writes pixels outside the clip, so that
+// path reads the clip coverage from the mask instead.
+const CFX_ClipRuns* GetClipRunsFromRegion(const CFX_ClipRgn* r,
+                                          bool bHasBackdrop) {
+  return (r && !bHasBackdrop) ? r->GetRuns() : nullptr;
+}
+
+RetainPtr<CFX_DIBitmap> GetClipMaskFromRegion(const CFX_ClipRgn* r,
+                                              const CFX_ClipRuns* runs) {
+  return (r && !runs && r->GetType() == CFX_ClipRgn::kMaskF) ? r->GetMask()
+                                                              : nullptr;
 }
 
 FX_RECT GetClipBoxFromRegion(const RetainPtr<CFX_DIBitmap>& device,
@@ -324,6 +336,15 @@ FX_RECT GetClipBoxFromRegion(const RetainPtr<CFX_DIBitmap>& device,
   return FX_RECT(0, 0, device->GetWidth(), device->GetHeight());
 }
 
+// Returns the number of consecutive fully covered pixels in |cover_scan|,
+// starting at |col| and stopping before |col_end|.
+int GetFullCoverRunLength(const uint8_t* cover_scan, int col, int col_end) {
+  int end = col;
+  while (end < col_end && cover_scan[end] == 255)
+    ++end;
+  return end - col;
+}
+
 class CFX_Renderer {
  public:
   CFX_Renderer(const RetainPtr<CFX_DIBitmap>& pDevice,
@@ -390,6 +411,15 @@ class CFX_Renderer {
                         int clip_right,
                         uint8_t* clip_scan);
 
+  // Composites only the parts of a span inside the clip runs of row |y|.
+  // Fully covered runs take the unclipped fast paths.
+  void CompositeSpanWithClipRuns(uint8_t* dest_scan,
+                                 int Bpp,
+                                 int y,
+                                 int span_left,
+                                 int span_len,
+                                 uint8_t* cover_scan);
+
   void CompositeSpan1bppHelper(uint8_t* dest_scan,
                                int col_start,
                                int col_end,
@@ -397,6 +427,10 @@ class CFX_Renderer {
                                const uint8_t* clip_scan,
                                int span_left);
 
+  // Writes the opaque source colour to |count| consecutive pixels. The bulk
+  // stores compile to vector code, unlike the per-pixel blending loops.
+  void FillSolidRun(uint8_t* dest_scan, int Bpp, int count) const;
+
   static CompositeSpanFunc GetCompositeSpanFunc(
       const RetainPtr<CFX_DIBitmap>& device) {
     if (device->GetBPP() == 1)
@@ -419,6 +453,20 @@ class CFX_Renderer {
                      : m_Alpha * cover_scan[col] / 255;
   }
 
+  // Returns how many pixels starting at |col| get the opaque source colour
+  // as is, which is the interior of every opaque fill. When |bFullCover| is
+  // set, coverage is ignored as in the callers' per-pixel loops.
+  inline int GetSolidRunLength(const uint8_t* cover_scan,
+                               const uint8_t* clip_scan,
+                               int col,
+                               int col_end,
+                               bool bFullCover) const {
+    if (m_Alpha != 255 || clip_scan)
+      return 0;
+    return bFullCover ? col_end - col
+                      : GetFullCoverRunLength(cover_scan, col, col_end);
+  }
+
   inline int GetColStart(int span_left, int clip_left) const {
     return span_left < clip_left ? clip_left - span_left : 0;
   }
@@ -438,10 +486,12 @@ class CFX_Renderer {
   const bool m_bRgbByteOrder;
   const FX_RECT m_ClipBox;
   RetainPtr<CFX_DIBitmap> const m_pBackdropDevice;
+  UnownedPtr<const CFX_ClipRuns> const m_pClipRuns;
   RetainPtr<CFX_DIBitmap> const m_pClipMask;
   RetainPtr<CFX_DIBitmap> const m_pDevice;
   UnownedPtr<const CFX_ClipRgn> m_pClipRgn;
   const CompositeSpanFunc m_CompositeSpanFunc;
+  std::vector<uint8_t> m_ClipScan;
 };
 
 void CFX_Renderer::CompositeSpan(uint8_t* dest_scan,
@@ -617,6 +667,14 @@ void CFX_Renderer::CompositeSpanGray(uint8_t* dest_scan,
   int col_end = GetColEnd(span_left, span_len, clip_right);
   dest_scan += col_start;
   for (int col = col_start; col < col_end; col++) {
+    int run = GetSolidRunLength(cover_scan, clip_scan, col, col_end,
+                                /*bFullCover=*/false);
+    if (run > 0) {
+      FillSolidRun(dest_scan, /*Bpp=*/1, run);
+      dest_scan += run;
+      col += run - 1;
+      continue;
+    }
     int src_alpha = GetSourceAlpha(cover_scan, clip_scan, col);
     if (src_alpha) {
       if (src_alpha == 255)
@@ -641,6 +699,14 @@ void CFX_Renderer::CompositeSpanARGB(uint8_t* dest_scan,
   dest_scan += col_start * Bpp;
   if (m_bRgbByteOrder) {
     for (int col = col_start; col < col_end; col++) {
+      int run =
+          GetSolidRunLength(cover_scan, clip_scan, col, col_end, m_bFullCover);
+      if (run > 0) {
+        FillSolidRun(dest_scan, Bpp, run);
+        dest_scan += run * Bpp;
+        col += run - 1;
+        continue;
+      }
       int src_alpha = m_bFullCover ? GetSrcAlpha(clip_scan, col)
                                    : GetSourceAlpha(cover_scan, clip_scan, col);
       if (src_alpha) {
@@ -665,6 +731,14 @@ void CFX_Renderer::CompositeSpanARGB(uint8_t* dest_scan,
     return;
   }
   for (int col = col_start; col < col_end; col++) {
+    int run =
+        GetSolidRunLength(cover_scan, clip_scan, col, col_end, m_bFullCover);
+    if (run > 0) {
+      FillSolidRun(dest_scan, Bpp, run);
+      dest_scan += run * Bpp;
+      col += run - 1;
+      continue;
+    }
     int src_alpha = m_bFullCover ? GetSrcAlpha(clip_scan, col)
                                  : GetSourceAlpha(cover_scan, clip_scan, col);
     if (src_alpha) {
@@ -709,6 +783,14 @@ void CFX_Renderer::CompositeSpanRGB(uint8_t* dest_scan,
   dest_scan += col_start * Bpp;
   if (m_bRgbByteOrder) {
     for (int col = col_start; col < col_end; col++) {
+      int run = GetSolidRunLength(cover_scan, clip_scan, col, col_end,
+                                  /*bFullCover=*/false);
+      if (run > 0) {
+        FillSolidRun(dest_scan, Bpp, run);
+        dest_scan += run * Bpp;
+        col += run - 1;
+        continue;
+      }
       int src_alpha = GetSourceAlpha(cover_scan, clip_scan, col);
       if (src_alpha) {
         if (src_alpha == 255) {
@@ -735,6 +817,14 @@ void CFX_Renderer::CompositeSpanRGB(uint8_t* dest_scan,
     return;
   }
   for (int col = col_start; col < col_end; col++) {
+    int run =
+        GetSolidRunLength(cover_scan, clip_scan, col, col_end, m_bFullCover);
+    if (run > 0) {
+      FillSolidRun(dest_scan, Bpp, run);
+      dest_scan += run * Bpp;
+      col += run - 1;
+      continue;
+    }
     int src_alpha = m_bFullCover ? GetSrcAlpha(clip_scan, col)
                                  : GetSourceAlpha(cover_scan, clip_scan, col);
     if (src_alpha) {
@@ -773,7 +863,8 @@ CFX_Renderer::CFX_Renderer(const RetainPtr<CFX_DIBitmap>& pDevice,
       m_bRgbByteOrder(bRgbByteOrder),
       m_ClipBox(GetClipBoxFromRegion(pDevice, pClipRgn)),
       m_pBackdropDevice(pBackdropDevice),
-      m_pClipMask(GetClipMaskFromRegion(pClipRgn)),
+      m_pClipRuns(GetClipRunsFromRegion(pClipRgn, !!pBackdropDevice)),
+      m_pClipMask(GetClipMaskFromRegion(pClipRgn, m_pClipRuns.get())),
       m_pDevice(pDevice),
       m_pClipRgn(pClipRgn),
       m_CompositeSpanFunc(GetCompositeSpanFunc(m_pDevice)) {
@@ -812,6 +903,15 @@ void CFX_Renderer::render(const Scanline& sl) {
       break;
 
     int x = span->x;
+    if (m_pClipRuns) {
+      CompositeSpanWithClipRuns(dest_scan, Bpp, y, x, span->len,
+                                span->covers);
+      if (--num_spans == 0)
+        break;
+
+      ++span;
+      continue;
+    }
     uint8_t* dest_pos = nullptr;
     uint8_t* backdrop_pos = nullptr;
     if (Bpp) {
@@ -842,6 +942,52 @@ void CFX_Renderer::render(const Scanline& sl) {
   }
 }
 
+void CFX_Renderer::CompositeSpanWithClipRuns(uint8_t* dest_scan,
+                                             int Bpp,
+                                             int y,
+                                             int span_left,
+                                             int span_len,
+                                             uint8_t* cover_scan) {
+  const int span_right = span_left + span_len;
+  for (const CFX_ClipRuns::Run& run : m_pClipRuns->GetRow(y)) {
+    if (run.right <= span_left)
+      continue;
+    if (run.left >= span_right)
+      break;
+
+    const int left = std::max(run.left, span_left);
+    const int len = std::min(run.right, span_right) - left;
+    uint8_t* clip_scan = nullptr;
+    if (run.coverage != 255) {
+      m_ClipScan.assign(len, run.coverage);
+      clip_scan = m_ClipScan.data();
+    }
+    uint8_t* dest_pos = Bpp ? dest_scan + left * Bpp : dest_scan + left / 8;
+    (this->*m_CompositeSpanFunc)(dest_pos, Bpp, left, len,
+                                 cover_scan + (left - span_left),
+                                 m_ClipBox.left, m_ClipBox.right, clip_scan);
+  }
+}
+
+void CFX_Renderer::FillSolidRun(uint8_t* dest_scan, int Bpp, int count) const {
+  if (Bpp == 1) {
+    memset(dest_scan, m_Gray, count);
+    return;
+  }
+  if (Bpp == 4) {
+    std::fill_n(reinterpret_cast<uint32_t*>(dest_scan), count, m_Color);
+    return;
+  }
+  DCHECK_EQ(Bpp, 3);
+  const uint8_t first = m_bRgbByteOrder ? m_Red : m_Blue;
+  const uint8_t last = m_bRgbByteOrder ? m_Blue : m_Red;
+  for (int i = 0; i < count; ++i) {
+    *dest_scan++ = first;
+    *dest_scan++ = m_Green;
+    *dest_scan++ = last;
+  }
+}
+
 void CFX_Renderer::CompositeSpan1bppHelper(uint8_t* dest_scan,
                                            int col_start,
                                            int col_end,
@@ -870,29 +1016,40 @@ void CFX_Renderer::CompositeSpan1bppHelper(uint8_t* dest_scan,
   }
 }
 
-template <class BaseRenderer>
-class RendererScanLineAaOffset {
+// Collects rasterized clip path scanlines as clip runs. The coverage values
+// match what blending the scanlines onto a zeroed 8-bit mask would give.
+class ClipRunsCollector {
  public:
-  typedef BaseRenderer base_ren_type;
-  typedef typename base_ren_type::color_type color_type;
-  RendererScanLineAaOffset(base_ren_type& ren, unsigned left, unsigned top)
-      : m_ren(&ren), m_left(left), m_top(top) {}
-  void color(const color_type& c) { m_color = c; }
-  const color_type& color() const { return m_color; }
+  explicit ClipRunsCollector(CFX_ClipRuns* runs) : m_pRuns(runs) {}
+
+  // Needed for agg caller
   void prepare(unsigned) {}
+
   template <class Scanline>
   void render(const Scanline& sl) {
+    const FX_RECT& box = m_pRuns->GetBox();
     int y = sl.y();
+    if (y < box.top || y >= box.bottom)
+      return;
+
     unsigned num_spans = sl.num_spans();
     typename Scanline::const_iterator span = sl.begin();
     while (true) {
       int x = span->x;
-      if (span->len > 0) {
-        m_ren->blend_solid_hspan(x - m_left, y - m_top, (unsigned)span->len,
-                                 m_color, span->covers);
-      } else {
-        m_ren->blend_hline(x - m_left, y - m_top, (unsigned)(x - span->len - 1),
-                           m_color, *(span->covers));
+      int left = std::max(x, box.left);
+      int right = std::min(x + span->len, box.right);
+      const uint8_t* covers = span->covers + (left - x);
+      int run_left = left;
+      while (run_left < right) {
+        uint8_t coverage = GetMaskValue(*covers);
+        int run_right = run_left + 1;
+        ++covers;
+        while (run_right < right && GetMaskValue(*covers) == coverage) {
+          ++run_right;
+          ++covers;
+        }
+        m_pRuns->AppendRun(y, run_left, run_right, coverage);
+        run_left = run_right;
       }
       if (--num_spans == 0)
         break;
@@ -902,10 +1059,14 @@ class RendererScanLineAaOffset {
   }
 
  private:
-  base_ren_type* m_ren;
-  color_type m_color;
-  unsigned m_left;
-  unsigned m_top;
+  // Same as agg::pixfmt_gray8::blend_solid_hspan() with an opaque white
+  // colour onto a zero pixel.
+  static uint8_t GetMaskValue(uint8_t cover) {
+    unsigned alpha = (255 * (cover + 1)) >> 8;
+    return alpha == 255 ? 255 : (255 * alpha) >> 8;
+  }
+
+  UnownedPtr<CFX_ClipRuns> const m_pRuns;
 };
 
 agg::path_storage BuildAggPath(const CFX_Path& path,
@@ -956,6 +1117,240 @@ agg::path_storage BuildAggPath(const CFX_Path& path,
 
 }  // namespace
 
+// Records the device-space vertices that would be added to an AGG rasterizer.
+// When every edge is horizontal or vertical and no vertex needs clipping, the
+// outline is swept here instead: vertical edges turn straight into per-row
+// cells, and the sweep mirrors agg::rasterizer_scanline_aa::sweep_scanline(),
+// so the coverage is the same as the rasterizer's without building, sorting
+// and walking its cell blocks. This is what table borders, form grids and
+// hatching mostly look like, filled or stroked.
+class CFX_AggOutline {
+ public:
+  CFX_AggOutline() = default;
+  ~CFX_AggOutline() = default;
+
+  // Same interface as agg::rasterizer_scanline_aa, so RasterizeStroke() can
+  // record into it.
+  template <class VertexSource>
+  void add_path(VertexSource& vs) {
+    add_path_transformed(vs, nullptr);
+  }
+
+  template <class VertexSource>
+  void add_path_transformed(VertexSource& vs, const CFX_Matrix* pMatrix) {
+    float x;
+    float y;
+    unsigned cmd;
+    vs.rewind(0);
+    while (!agg::is_stop(cmd = vs.vertex(&x, &y))) {
+      if (pMatrix) {
+        CFX_PointF ret = pMatrix->Transform(CFX_PointF(x, y));
+        x = ret.x;
+        y = ret.y;
+      }
+      m_Vertices.push_back({x, y, cmd});
+    }
+  }
+
+  void AddTo(agg::rasterizer_scanline_aa* rasterizer) const {
+    for (const Vertex& vertex : m_Vertices)
+      rasterizer->add_vertex(vertex.x, vertex.y, vertex.cmd);
+  }
+
+  // Returns false, without rendering anything, if the outline is not
+  // axis-aligned or leaves the |width| x |height| clip box. |rasterizer| only
+  // supplies the filling rule and alpha calculation.
+  template <class Renderer>
+  bool RenderAxisAligned(const agg::rasterizer_scanline_aa& rasterizer,
+                         int width,
+                         int height,
+                         bool no_smooth,
+                         Renderer& render) const;
+
+ private:
+  struct Vertex {
+    float x;
+    float y;
+    unsigned cmd;
+  };
+
+  // A vertical edge in poly coordinates, with |top| < |bottom|. |dir| is the
+  // sign of the cover it adds, i.e. +1 when the edge runs downwards.
+  struct VerticalEdge {
+    int x;
+    int top;
+    int bottom;
+    int dir;
+  };
+
+  struct Cell {
+    int x;
+    int cover;
+    int area;
+  };
+
+  bool GetVerticalEdges(int max_x,
+                        int max_y,
+                        std::vector<VerticalEdge>* edges) const;
+
+  std::vector<Vertex> m_Vertices;
+};
+
+bool CFX_AggOutline::GetVerticalEdges(int max_x,
+                                      int max_y,
+                                      std::vector<VerticalEdge>* edges) const {
+  // Follows the rasterizer's move_to / line_to / close_polygon state machine
+  // for an outline that is entirely inside the clip box.
+  bool started = false;
+  bool open = false;
+  int start_x = 0;
+  int start_y = 0;
+  int cur_x = 0;
+  int cur_y = 0;
+  auto line_to = [&](int x, int y) {
+    if (x == cur_x) {
+      if (y != cur_y)
+        edges->push_back({x, std::min(y, cur_y), std::max(y, cur_y),
+                          y > cur_y ? 1 : -1});
+    } else if (y != cur_y) {
+      return false;
+    }
+    cur_x = x;
+    cur_y = y;
+    return true;
+  };
+  for (const Vertex& vertex : m_Vertices) {
+    if (agg::is_close(vertex.cmd)) {
+      if (open) {
+        if (!line_to(start_x, start_y))
+          return false;
+        open = false;
+      }
+      continue;
+    }
+    if (!agg::is_vertex(vertex.cmd))
+      continue;
+
+    int x = agg::poly_coord(vertex.x);
+    int y = agg::poly_coord(vertex.y);
+    if (x < 0 || x > max_x || y < 0 || y > max_y)
+      return false;
+
+    if (agg::is_move_to(vertex.cmd)) {
+      if (open && !line_to(start_x, start_y))
+        return false;
+      start_x = cur_x = x;
+      start_y = cur_y = y;
+      started = true;
+      open = true;
+      continue;
+    }
+    if (!started || !line_to(x, y))
+      return false;
+    open = true;
+  }
+  return !open || line_to(start_x, start_y);
+}
+
+template <class Renderer>
+bool CFX_AggOutline::RenderAxisAligned(
+    const agg::rasterizer_scanline_aa& rasterizer,
+    int width,
+    int height,
+    bool no_smooth,
+    Renderer& render) const {
+  std::vector<VerticalEdge> edges;
+  if (!GetVerticalEdges(width << agg::poly_base_shift,
+                        height << agg::poly_base_shift, &edges)) {
+    return false;
+  }
+  if (edges.empty())
+    return true;
+
+  std::sort(edges.begin(), edges.end(),
+            [](const VerticalEdge& a, const VerticalEdge& b) {
+              return a.top < b.top;
+            });
+  int min_x = edges.front().x >> agg::poly_base_shift;
+  int max_x = min_x;
+  for (const VerticalEdge& edge : edges) {
+    min_x = std::min(min_x, edge.x >> agg::poly_base_shift);
+    max_x = std::max(max_x, edge.x >> agg::poly_base_shift);
+  }
+
+  agg::scanline_u8 scanline;
+  scanline.reset(min_x, max_x);
+  render.prepare(static_cast<unsigned>(max_x - min_x + 2));
+
+  std::vector<VerticalEdge> active;
+  std::vector<Cell> cells;
+  size_t next_edge = 0;
+  int y = 0;
+  while (next_edge < edges.size() || !active.empty()) {
+    if (active.empty())
+      y = std::max(y, edges[next_edge].top >> agg::poly_base_shift);
+    while (next_edge < edges.size() &&
+           (edges[next_edge].top >> agg::poly_base_shift) <= y) {
+      active.push_back(edges[next_edge++]);
+    }
+
+    const int row_top = y << agg::poly_base_shift;
+    const int row_bottom = row_top + agg::poly_base_size;
+    cells.clear();
+    for (const VerticalEdge& edge : active) {
+      int delta =
+          std::min(edge.bottom, row_bottom) - std::max(edge.top, row_top);
+      if (delta <= 0)
+        continue;
+
+      int cover = delta * edge.dir;
+      int fx = edge.x & agg::poly_base_mask;
+      cells.push_back({edge.x >> agg::poly_base_shift, cover, 2 * fx * cover});
+    }
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [row_bottom](const VerticalEdge& edge) {
+                                  return edge.bottom <= row_bottom;
+                                }),
+                 active.end());
+    std::sort(cells.begin(), cells.end(),
+              [](const Cell& a, const Cell& b) { return a.x < b.x; });
+
+    scanline.reset_spans();
+    int cover = 0;
+    size_t i = 0;
+    while (i < cells.size()) {
+      int x = cells[i].x;
+      int area = cells[i].area;
+      cover += cells[i].cover;
+      while (++i < cells.size() && cells[i].x == x) {
+        area += cells[i].area;
+        cover += cells[i].cover;
+      }
+      // Same as rasterizer_scanline_aa::calculate_area().
+      int cover_area = static_cast<int>(static_cast<unsigned>(cover)
+                                        << (agg::poly_base_shift + 1));
+      if (area) {
+        unsigned alpha =
+            rasterizer.calculate_alpha(cover_area - area, no_smooth);
+        if (alpha)
+          scanline.add_cell(x, alpha);
+        x++;
+      }
+      if (i < cells.size() && cells[i].x > x) {
+        unsigned alpha = rasterizer.calculate_alpha(cover_area, no_smooth);
+        if (alpha)
+          scanline.add_span(x, cells[i].x - x, alpha);
+      }
+    }
+    if (scanline.num_spans()) {
+      scanline.finalize(y);
+      render.render(scanline);
+    }
+    ++y;
+  }
+  return true;
+}
+
 CFX_AggDeviceDriver::CFX_AggDeviceDriver(
     RetainPtr<CFX_DIBitmap> pBitmap,
     bool bRgbByteOrder,
@@ -1051,22 +1446,16 @@ void CFX_AggDeviceDriver::SetClipMask(agg::rasterizer_scanline_aa& rasterizer) {
   FX_RECT path_rect(rasterizer.min_x(), rasterizer.min_y(),
                     rasterizer.max_x() + 1, rasterizer.max_y() + 1);
   path_rect.Intersect(m_pClipRgn->GetBox());
-  auto pThisLayer = pdfium::MakeRetain<CFX_DIBitmap>();
-  pThisLayer->Create(path_rect.Width(), path_rect.Height(),
-                     FXDIB_Format::k8bppMask);
-  agg::rendering_buffer raw_buf(pThisLayer->GetBuffer().data(),
-                                pThisLayer->GetWidth(), pThisLayer->GetHeight(),
-                                pThisLayer->GetPitch());
-  agg::pixfmt_gray8 pixel_buf(raw_buf);
-  agg::renderer_base<agg::pixfmt_gray8> base_buf(pixel_buf);
-  RendererScanLineAaOffset<agg::renderer_base<agg::pixfmt_gray8>> final_render(
-      base_buf, path_rect.left, path_rect.top);
-  final_render.color(agg::gray8(255));
+  if (path_rect.Width() <= 0 || path_rect.Height() <= 0) {
+    path_rect = FX_RECT(path_rect.left, path_rect.top, path_rect.left,
+                        path_rect.top);
+  }
+  auto pThisLayer = pdfium::MakeRetain<CFX_ClipRuns>(path_rect);
+  ClipRunsCollector collector(pThisLayer.Get());
   agg::scanline_u8 scanline;
-  agg::render_scanlines(rasterizer, scanline, final_render,
+  agg::render_scanlines(rasterizer, scanline, collector,
                         m_FillOptions.aliased_path);
-  m_pClipRgn->IntersectMaskF(path_rect.left, path_rect.top,
-                             std::move(pThisLayer));
+  m_pClipRgn->IntersectRuns(std::move(pThisLayer));
 }
 
 bool CFX_AggDeviceDriver::SetClip_PathFill(
@@ -1134,7 +1523,8 @@ bool CFX_AggDeviceDriver::MultiplyAlpha(const RetainPtr<CFX_DIBBase>& mask) {
   return m_pBitmap->MultiplyAlpha(mask);
 }
 
-void CFX_AggDeviceDriver::RenderRasterizer(
+void CFX_AggDeviceDriver::RenderOutline(
+    const CFX_AggOutline& outline,
     agg::rasterizer_scanline_aa& rasterizer,
     uint32_t color,
     bool bFullCover,
@@ -1142,6 +1532,13 @@ void CFX_AggDeviceDriver::RenderRasterizer(
   RetainPtr<CFX_DIBitmap> pt = bGroupKnockout ? m_pBackdropBitmap : nullptr;
   CFX_Renderer render(m_pBitmap, pt, m_pClipRgn.get(), color, bFullCover,
                       m_bRgbByteOrder);
+  if (outline.RenderAxisAligned(rasterizer, GetDeviceCaps(FXDC_PIXEL_WIDTH),
+                                GetDeviceCaps(FXDC_PIXEL_HEIGHT),
+                                m_FillOptions.aliased_path, render)) {
+    ++m_AxisAlignedOutlineCount;
+    return;
+  }
+  outline.AddTo(&rasterizer);
   agg::scanline_u8 scanline;
   agg::render_scanlines(rasterizer, scanline, render,
                         m_FillOptions.aliased_path);
@@ -1164,14 +1561,15 @@ bool CFX_AggDeviceDriver::DrawPath(const CFX_Path& path,
   if (fill_options.fill_type != CFX_FillRenderOptions::FillType::kNoFill &&
       fill_color) {
     agg::path_storage path_data = BuildAggPath(path, pObject2Device);
+    CFX_AggOutline outline;
+    outline.add_path(path_data);
     agg::rasterizer_scanline_aa rasterizer;
     rasterizer.clip_box(0.0f, 0.0f,
                         static_cast<float>(GetDeviceCaps(FXDC_PIXEL_WIDTH)),
                         static_cast<float>(GetDeviceCaps(FXDC_PIXEL_HEIGHT)));
-    rasterizer.add_path(path_data);
     rasterizer.filling_rule(GetAlternateOrWindingFillType(fill_options));
-    RenderRasterizer(rasterizer, fill_color, fill_options.full_cover,
-                     /*bGroupKnockout=*/false);
+    RenderOutline(outline, rasterizer, fill_color, fill_options.full_cover,
+                  /*bGroupKnockout=*/false);
   }
   int stroke_alpha = FXARGB_A(stroke_color);
   if (!pGraphState || !stroke_alpha)
@@ -1179,14 +1577,15 @@ bool CFX_AggDeviceDriver::DrawPath(const CFX_Path& path,
 
   if (fill_options.zero_area) {
     agg::path_storage path_data = BuildAggPath(path, pObject2Device);
+    CFX_AggOutline outline;
+    RasterizeStroke(&outline, &path_data, nullptr, pGraphState, 1,
+                    fill_options.stroke_text_mode);
     agg::rasterizer_scanline_aa rasterizer;
     rasterizer.clip_box(0.0f, 0.0f,
                         static_cast<float>(GetDeviceCaps(FXDC_PIXEL_WIDTH)),
                         static_cast<float>(GetDeviceCaps(FXDC_PIXEL_HEIGHT)));
-    RasterizeStroke(&rasterizer, &path_data, nullptr, pGraphState, 1,
-                    fill_options.stroke_text_mode);
-    RenderRasterizer(rasterizer, stroke_color, fill_options.full_cover,
-                     m_bGroupKnockout);
+    RenderOutline(outline, rasterizer, stroke_color, fill_options.full_cover,
+                  m_bGroupKnockout);
     return true;
   }
   CFX_Matrix matrix1;
@@ -1202,14 +1601,15 @@ bool CFX_AggDeviceDriver::DrawPath(const CFX_Path& path,
   }
 
   agg::path_storage path_data = BuildAggPath(path, &matrix1);
+  CFX_AggOutline outline;
+  RasterizeStroke(&outline, &path_data, &matrix2, pGraphState, matrix1.a,
+                  fill_options.stroke_text_mode);
   agg::rasterizer_scanline_aa rasterizer;
   rasterizer.clip_box(0.0f, 0.0f,
                       static_cast<float>(GetDeviceCaps(FXDC_PIXEL_WIDTH)),
                       static_cast<float>(GetDeviceCaps(FXDC_PIXEL_HEIGHT)));
-  RasterizeStroke(&rasterizer, &path_data, &matrix2, pGraphState, matrix1.a,
-                  fill_options.stroke_text_mode);
-  RenderRasterizer(rasterizer, stroke_color, fill_options.full_cover,
-                   m_bGroupKnockout);
+  RenderOutline(outline, rasterizer, stroke_color, fill_options.full_cover,
+                m_bGroupKnockout);
   return true;
 }
 
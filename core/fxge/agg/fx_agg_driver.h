@@ -7,6 +7,8 @@
 #ifndef CORE_FXGE_AGG_FX_AGG_DRIVER_H_
 #define CORE_FXGE_AGG_FX_AGG_DRIVER_H_
 
+#include <stddef.h>
+
 #include <memory>
 #include <vector>
 
@@ -26,6 +28,8 @@ namespace agg {
 class rasterizer_scanline_aa;
 }  // namespace agg
 
+class CFX_AggOutline;
+
 class CFX_AggDeviceDriver final : public RenderDeviceDriverIface {
  public:
   CFX_AggDeviceDriver(RetainPtr<CFX_DIBitmap> pBitmap,
@@ -97,11 +101,20 @@ class CFX_AggDeviceDriver final : public RenderDeviceDriverIface {
   bool MultiplyAlpha(float alpha) override;
   bool MultiplyAlpha(const RetainPtr<CFX_DIBBase>& mask) override;
 
+  // Number of outlines rendered without going through the AGG rasterizer.
+  size_t GetAxisAlignedOutlineCountForTesting() const {
+    return m_AxisAlignedOutlineCount;
+  }
+
  private:
-  void RenderRasterizer(pdfium::agg::rasterizer_scanline_aa& rasterizer,
-                        uint32_t color,
-                        bool bFullCover,
-                        bool bGroupKnockout);
+  // Renders |outline| with the coverage |rasterizer| would produce for it.
+  // Axis-aligned outlines are swept directly; everything else is added to
+  // |rasterizer| and rendered from its scanlines.
+  void RenderOutline(const CFX_AggOutline& outline,
+                     pdfium::agg::rasterizer_scanline_aa& rasterizer,
+                     uint32_t color,
+                     bool bFullCover,
+                     bool bGroupKnockout);
 
   void SetClipMask(pdfium::agg::rasterizer_scanline_aa& rasterizer);
 
@@ -115,6 +128,7 @@ class CFX_AggDeviceDriver final : public RenderDeviceDriverIface {
   const bool m_bRgbByteOrder;
   const bool m_bGroupKnockout;
   RetainPtr<CFX_DIBitmap> m_pBackdropBitmap;
+  size_t m_AxisAlignedOutlineCount = 0;
 };
 
 }  // namespace pdfium
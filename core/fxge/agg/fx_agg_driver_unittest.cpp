@@ -0,0 +1,92 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/agg/fx_agg_driver.h"
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/cfx_fillrenderoptions.h"
+#include "core/fxge/cfx_graphstatedata.h"
+#include "core/fxge/cfx_path.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "core/fxge/dib/fx_dib.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace pdfium {
+
+namespace {
+
+RetainPtr<CFX_DIBitmap> CreateMaskBitmap() {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  if (!bitmap->Create(16, 16, FXDIB_Format::k8bppMask))
+    return nullptr;
+
+  bitmap->Clear(0);
+  return bitmap;
+}
+
+CFX_FillRenderOptions WindingFillOptions() {
+  return CFX_FillRenderOptions(CFX_FillRenderOptions::FillType::kWinding);
+}
+
+}  // namespace
+
+TEST(CFX_AggDeviceDriverTest, AxisAlignedFillSkipsRasterizer) {
+  RetainPtr<CFX_DIBitmap> bitmap = CreateMaskBitmap();
+  ASSERT_TRUE(bitmap);
+  CFX_AggDeviceDriver driver(bitmap, /*bRgbByteOrder=*/false,
+                             /*pBackdropBitmap=*/nullptr,
+                             /*bGroupKnockout=*/false);
+
+  CFX_Path path;
+  path.AppendRect(2.5f, 4, 10, 8.25f);
+  ASSERT_TRUE(driver.DrawPath(path, /*pObject2Device=*/nullptr,
+                              /*pGraphState=*/nullptr, 0xff000000,
+                              /*stroke_color=*/0, WindingFillOptions(),
+                              BlendMode::kNormal));
+  EXPECT_EQ(1u, driver.GetAxisAlignedOutlineCountForTesting());
+  EXPECT_EQ(128, bitmap->GetScanline(5)[2]);
+  EXPECT_EQ(255, bitmap->GetScanline(5)[5]);
+}
+
+TEST(CFX_AggDeviceDriverTest, AxisAlignedStrokeSkipsRasterizer) {
+  RetainPtr<CFX_DIBitmap> bitmap = CreateMaskBitmap();
+  ASSERT_TRUE(bitmap);
+  CFX_AggDeviceDriver driver(bitmap, /*bRgbByteOrder=*/false,
+                             /*pBackdropBitmap=*/nullptr,
+                             /*bGroupKnockout=*/false);
+
+  // Default line width is 1.
+  const CFX_GraphStateData graph_state;
+  CFX_Path path;
+  path.AppendPoint(CFX_PointF(1, 12.5f), CFX_Path::Point::Type::kMove);
+  path.AppendPoint(CFX_PointF(15, 12.5f), CFX_Path::Point::Type::kLine);
+  ASSERT_TRUE(driver.DrawPath(path, /*pObject2Device=*/nullptr, &graph_state,
+                              /*fill_color=*/0, 0xff000000,
+                              CFX_FillRenderOptions(), BlendMode::kNormal));
+  EXPECT_EQ(1u, driver.GetAxisAlignedOutlineCountForTesting());
+  EXPECT_EQ(255, bitmap->GetScanline(12)[5]);
+}
+
+TEST(CFX_AggDeviceDriverTest, DiagonalFillUsesRasterizer) {
+  RetainPtr<CFX_DIBitmap> bitmap = CreateMaskBitmap();
+  ASSERT_TRUE(bitmap);
+  CFX_AggDeviceDriver driver(bitmap, /*bRgbByteOrder=*/false,
+                             /*pBackdropBitmap=*/nullptr,
+                             /*bGroupKnockout=*/false);
+
+  CFX_Path path;
+  path.AppendPoint(CFX_PointF(2, 2), CFX_Path::Point::Type::kMove);
+  path.AppendPoint(CFX_PointF(14, 2), CFX_Path::Point::Type::kLine);
+  path.AppendPoint(CFX_PointF(2, 14), CFX_Path::Point::Type::kLine);
+  path.ClosePath();
+  ASSERT_TRUE(driver.DrawPath(path, /*pObject2Device=*/nullptr,
+                              /*pGraphState=*/nullptr, 0xff000000,
+                              /*stroke_color=*/0, WindingFillOptions(),
+                              BlendMode::kNormal));
+  EXPECT_EQ(0u, driver.GetAxisAlignedOutlineCountForTesting());
+  EXPECT_EQ(255, bitmap->GetScanline(4)[4]);
+}
+
+}  // namespace pdfium
@@ -8,6 +8,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <utility>
 
 #include "core/fxcrt/span_util.h"
@@ -15,18 +16,45 @@
 #include "third_party/base/check_op.h"
 #include "third_party/base/notreached.h"
 
+namespace {
+
+constexpr size_t kMinPixelsPerRun = 4;
+
+}  // namespace
+
 CFX_ClipRgn::CFX_ClipRgn(int width, int height) : m_Box(0, 0, width, height) {}
 
 CFX_ClipRgn::CFX_ClipRgn(const CFX_ClipRgn& src) = default;
 
 CFX_ClipRgn::~CFX_ClipRgn() = default;
 
+RetainPtr<CFX_DIBitmap> CFX_ClipRgn::GetMask() const {
+  return m_Runs ? m_Runs->GetMask() : m_Mask;
+}
+
 void CFX_ClipRgn::IntersectRect(const FX_RECT& rect) {
   if (m_Type == kRectI) {
     m_Box.Intersect(rect);
     return;
   }
-  IntersectMaskRect(rect, m_Box, m_Mask);
+  if (!m_Runs) {
+    IntersectMaskRect(rect, m_Box, m_Mask);
+    return;
+  }
+
+  FX_RECT new_box = rect;
+  new_box.Intersect(m_Box);
+  if (new_box.IsEmpty()) {
+    m_Type = kRectI;
+    m_Runs = nullptr;
+    m_Box = new_box;
+    return;
+  }
+  if (new_box == m_Box)
+    return;
+
+  m_Box = new_box;
+  SetRuns(m_Runs->Crop(new_box));
 }
 
 void CFX_ClipRgn::IntersectMaskRect(FX_RECT rect,
@@ -59,6 +87,10 @@ void CFX_ClipRgn::IntersectMaskF(int left,
                                  int top,
                                  RetainPtr<CFX_DIBitmap> pMask) {
   DCHECK_EQ(pMask->GetFormat(), FXDIB_Format::k8bppMask);
+  if (m_Runs) {
+    m_Mask = m_Runs->GetMask();
+    m_Runs = nullptr;
+  }
   FX_RECT mask_box(left, top, left + pMask->GetWidth(),
                    top + pMask->GetHeight());
   if (m_Type == kRectI) {
@@ -88,3 +120,60 @@ void CFX_ClipRgn::IntersectMaskF(int left,
   m_Box = new_box;
   m_Mask = std::move(new_dib);
 }
+
+void CFX_ClipRgn::IntersectRuns(RetainPtr<CFX_ClipRuns> runs) {
+  const FX_RECT& mask_box = runs->GetBox();
+  FX_RECT new_box = m_Box;
+  new_box.Intersect(mask_box);
+  if (new_box.IsEmpty()) {
+    m_Type = kRectI;
+    m_Mask = nullptr;
+    m_Runs = nullptr;
+    m_Box = new_box;
+    return;
+  }
+
+  if (m_Type == kRectI) {
+    m_Type = kMaskF;
+    m_Box = new_box;
+    SetRuns(new_box == mask_box ? std::move(runs) : runs->Crop(new_box));
+    return;
+  }
+  if (m_Runs) {
+    m_Box = new_box;
+    SetRuns(CFX_ClipRuns::Intersect(*m_Runs, *runs, new_box));
+    return;
+  }
+
+  // Pixels outside the runs are not covered and stay zero.
+  auto new_dib = pdfium::MakeRetain<CFX_DIBitmap>();
+  new_dib->Create(new_box.Width(), new_box.Height(), FXDIB_Format::k8bppMask);
+  for (int row = new_box.top; row < new_box.bottom; row++) {
+    pdfium::span<const uint8_t> old_scan = m_Mask->GetScanline(row - m_Box.top);
+    uint8_t* new_scan = new_dib->GetWritableScanline(row - new_box.top).data();
+    for (const CFX_ClipRuns::Run& run : runs->GetRow(row)) {
+      int left = std::max(run.left, new_box.left);
+      int right = std::min(run.right, new_box.right);
+      for (int col = left; col < right; col++) {
+        new_scan[col - new_box.left] =
+            old_scan[col - m_Box.left] * run.coverage / 255;
+      }
+    }
+  }
+  m_Box = new_box;
+  m_Mask = std::move(new_dib);
+}
+
+void CFX_ClipRgn::SetRuns(RetainPtr<CFX_ClipRuns> runs) {
+  // Ragged coverage, such as many thin shapes, averages only a few pixels per
+  // run and is faster to intersect and composite as a mask.
+  size_t mask_size =
+      static_cast<size_t>(m_Box.Width()) * static_cast<size_t>(m_Box.Height());
+  if (runs->GetRunCount() > mask_size / kMinPixelsPerRun) {
+    m_Mask = runs->GetMask();
+    m_Runs = nullptr;
+    return;
+  }
+  m_Mask = nullptr;
+  m_Runs = std::move(runs);
+}
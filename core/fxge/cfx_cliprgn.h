@@ -9,6 +9,7 @@
 
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/cfx_clipruns.h"
 
 class CFX_DIBitmap;
 
@@ -22,19 +23,29 @@ class CFX_ClipRgn {
 
   ClipType GetType() const { return m_Type; }
   const FX_RECT& GetBox() const { return m_Box; }
-  RetainPtr<CFX_DIBitmap> GetMask() const { return m_Mask; }
+
+  // For kMaskF regions, returns the coverage as an 8-bit mask the size of
+  // GetBox(). Regions kept as runs build the mask on first use.
+  RetainPtr<CFX_DIBitmap> GetMask() const;
+
+  // Returns the coverage runs of a kMaskF region, or nullptr if the region
+  // only has a mask.
+  const CFX_ClipRuns* GetRuns() const { return m_Runs.Get(); }
 
   void IntersectRect(const FX_RECT& rect);
   void IntersectMaskF(int left, int top, RetainPtr<CFX_DIBitmap> Mask);
+  void IntersectRuns(RetainPtr<CFX_ClipRuns> runs);
 
  private:
   void IntersectMaskRect(FX_RECT rect,
                          FX_RECT mask_rect,
                          RetainPtr<CFX_DIBitmap> pOldMask);
+  void SetRuns(RetainPtr<CFX_ClipRuns> runs);
 
   ClipType m_Type = kRectI;
   FX_RECT m_Box;
   RetainPtr<CFX_DIBitmap> m_Mask;
+  RetainPtr<CFX_ClipRuns> m_Runs;
 };
 
 #endif  // CORE_FXGE_CFX_CLIPRGN_H_
@@ -0,0 +1,117 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_cliprgn.h"
+
+#include <stdint.h>
+
+#include "core/fxge/cfx_clipruns.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// A ring with anti-aliased looking edges, so the runs mix full and partial
+// coverage.
+RetainPtr<CFX_ClipRuns> MakeRing(const FX_RECT& box) {
+  auto runs = pdfium::MakeRetain<CFX_ClipRuns>(box);
+  for (int y = box.top; y < box.bottom; ++y) {
+    int inset = (y - box.top) % 5;
+    int left = box.left + inset;
+    int right = box.right - inset;
+    if (right - left < 6)
+      continue;
+    runs->AppendRun(y, left, left + 1, 90);
+    runs->AppendRun(y, left + 1, left + 3, 255);
+    runs->AppendRun(y, right - 3, right - 1, 255);
+    runs->AppendRun(y, right - 1, right, 170);
+  }
+  return runs;
+}
+
+void ExpectSameRegion(const CFX_ClipRgn& expected, const CFX_ClipRgn& actual) {
+  ASSERT_EQ(expected.GetType(), actual.GetType());
+  ASSERT_EQ(expected.GetBox(), actual.GetBox());
+  if (expected.GetType() == CFX_ClipRgn::kRectI)
+    return;
+
+  RetainPtr<CFX_DIBitmap> expected_mask = expected.GetMask();
+  RetainPtr<CFX_DIBitmap> actual_mask = actual.GetMask();
+  ASSERT_EQ(expected_mask->GetWidth(), actual_mask->GetWidth());
+  ASSERT_EQ(expected_mask->GetHeight(), actual_mask->GetHeight());
+  for (int row = 0; row < expected_mask->GetHeight(); ++row) {
+    pdfium::span<const uint8_t> expected_scan =
+        expected_mask->GetScanline(row);
+    pdfium::span<const uint8_t> actual_scan = actual_mask->GetScanline(row);
+    for (int col = 0; col < expected_mask->GetWidth(); ++col)
+      EXPECT_EQ(expected_scan[col], actual_scan[col]) << row << "," << col;
+  }
+}
+
+}  // namespace
+
+TEST(CFX_ClipRgn, RunsMatchMasks) {
+  const FX_RECT kRing1(5, 10, 250, 150);
+  const FX_RECT kRing2(100, 0, 290, 120);
+  CFX_ClipRgn by_mask(300, 300);
+  by_mask.IntersectRect(FX_RECT(2, 3, 270, 290));
+  by_mask.IntersectMaskF(kRing1.left, kRing1.top, MakeRing(kRing1)->GetMask());
+  by_mask.IntersectMaskF(kRing2.left, kRing2.top, MakeRing(kRing2)->GetMask());
+  by_mask.IntersectRect(FX_RECT(0, 0, 240, 110));
+
+  CFX_ClipRgn by_runs(300, 300);
+  by_runs.IntersectRect(FX_RECT(2, 3, 270, 290));
+  by_runs.IntersectRuns(MakeRing(kRing1));
+  ASSERT_TRUE(by_runs.GetRuns());
+  by_runs.IntersectRuns(MakeRing(kRing2));
+  ASSERT_TRUE(by_runs.GetRuns());
+  by_runs.IntersectRect(FX_RECT(0, 0, 240, 110));
+  ASSERT_TRUE(by_runs.GetRuns());
+  ExpectSameRegion(by_mask, by_runs);
+
+  // Runs intersected with a region that only has a mask.
+  CFX_ClipRgn mixed(300, 300);
+  mixed.IntersectRect(FX_RECT(2, 3, 270, 290));
+  mixed.IntersectMaskF(kRing1.left, kRing1.top, MakeRing(kRing1)->GetMask());
+  mixed.IntersectRuns(MakeRing(kRing2));
+  EXPECT_FALSE(mixed.GetRuns());
+  mixed.IntersectRect(FX_RECT(0, 0, 240, 110));
+  ExpectSameRegion(by_mask, mixed);
+
+  // A mask intersected with a region kept as runs.
+  CFX_ClipRgn mixed2(300, 300);
+  mixed2.IntersectRect(FX_RECT(2, 3, 270, 290));
+  mixed2.IntersectRuns(MakeRing(kRing1));
+  mixed2.IntersectMaskF(kRing2.left, kRing2.top, MakeRing(kRing2)->GetMask());
+  EXPECT_FALSE(mixed2.GetRuns());
+  mixed2.IntersectRect(FX_RECT(0, 0, 240, 110));
+  ExpectSameRegion(by_mask, mixed2);
+}
+
+TEST(CFX_ClipRgn, RunsOutsideRegion) {
+  CFX_ClipRgn region(100, 100);
+  region.IntersectRect(FX_RECT(0, 0, 10, 10));
+  auto runs = pdfium::MakeRetain<CFX_ClipRuns>(FX_RECT(20, 20, 30, 30));
+  runs->AppendRun(25, 20, 30, 255);
+  region.IntersectRuns(runs);
+  EXPECT_EQ(CFX_ClipRgn::kRectI, region.GetType());
+  EXPECT_TRUE(region.GetBox().IsEmpty());
+  EXPECT_FALSE(region.GetRuns());
+}
+
+TEST(CFX_ClipRgn, RaggedRunsBecomeMask) {
+  auto runs = pdfium::MakeRetain<CFX_ClipRuns>(FX_RECT(0, 0, 16, 16));
+  for (int y = 0; y < 16; ++y) {
+    for (int x = 0; x < 16; x += 2)
+      runs->AppendRun(y, x, x + 1, 255);
+  }
+  CFX_ClipRgn region(100, 100);
+  region.IntersectRuns(runs);
+  EXPECT_EQ(CFX_ClipRgn::kMaskF, region.GetType());
+  EXPECT_FALSE(region.GetRuns());
+  RetainPtr<CFX_DIBitmap> mask = region.GetMask();
+  ASSERT_TRUE(mask);
+  EXPECT_EQ(255, mask->GetScanline(3)[4]);
+  EXPECT_EQ(0, mask->GetScanline(3)[5]);
+}
@@ -0,0 +1,113 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_clipruns.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "third_party/base/check.h"
+#include "third_party/base/check_op.h"
+
+// static
+RetainPtr<CFX_ClipRuns> CFX_ClipRuns::Intersect(const CFX_ClipRuns& runs1,
+                                                const CFX_ClipRuns& runs2,
+                                                const FX_RECT& box) {
+  auto result = pdfium::MakeRetain<CFX_ClipRuns>(box);
+  for (int y = box.top; y < box.bottom; ++y) {
+    pdfium::span<const Run> row1 = runs1.GetRow(y);
+    pdfium::span<const Run> row2 = runs2.GetRow(y);
+    size_t i1 = 0;
+    size_t i2 = 0;
+    while (i1 < row1.size() && i2 < row2.size()) {
+      const Run& run1 = row1[i1];
+      const Run& run2 = row2[i2];
+      int left = std::max({run1.left, run2.left, box.left});
+      int right = std::min({run1.right, run2.right, box.right});
+      if (left < right) {
+        result->AppendRun(y, left, right,
+                          run1.coverage * run2.coverage / 255);
+      }
+      if (run1.right < run2.right)
+        ++i1;
+      else
+        ++i2;
+    }
+  }
+  return result;
+}
+
+CFX_ClipRuns::CFX_ClipRuns(const FX_RECT& box)
+    : m_Box(box), m_LastRow(box.top - 1) {}
+
+CFX_ClipRuns::~CFX_ClipRuns() = default;
+
+void CFX_ClipRuns::AppendRun(int y, int left, int right, uint8_t coverage) {
+  DCHECK(!m_Mask);
+  DCHECK_GE(y, m_LastRow);
+  DCHECK_LT(y, m_Box.bottom);
+  DCHECK_GE(left, m_Box.left);
+  DCHECK_LE(right, m_Box.right);
+  if (left >= right || coverage == 0)
+    return;
+
+  while (m_LastRow < y) {
+    ++m_LastRow;
+    m_RowStarts.push_back(m_Runs.size());
+  }
+  if (m_Runs.size() > m_RowStarts.back()) {
+    Run& last = m_Runs.back();
+    DCHECK_LE(last.right, left);
+    if (last.right == left && last.coverage == coverage) {
+      last.right = right;
+      return;
+    }
+  }
+  m_Runs.push_back({left, right, coverage});
+}
+
+RetainPtr<CFX_ClipRuns> CFX_ClipRuns::Crop(const FX_RECT& box) const {
+  auto result = pdfium::MakeRetain<CFX_ClipRuns>(box);
+  for (int y = box.top; y < box.bottom; ++y) {
+    for (const Run& run : GetRow(y)) {
+      result->AppendRun(y, std::max(run.left, box.left),
+                        std::min(run.right, box.right), run.coverage);
+    }
+  }
+  return result;
+}
+
+pdfium::span<const CFX_ClipRuns::Run> CFX_ClipRuns::GetRow(int y) const {
+  if (y < m_Box.top || y >= m_Box.bottom)
+    return {};
+
+  size_t start = GetRowStart(y);
+  return pdfium::make_span(m_Runs).subspan(start, GetRowStart(y + 1) - start);
+}
+
+RetainPtr<CFX_DIBitmap> CFX_ClipRuns::GetMask() const {
+  if (m_Mask)
+    return m_Mask;
+
+  auto mask = pdfium::MakeRetain<CFX_DIBitmap>();
+  if (!mask->Create(m_Box.Width(), m_Box.Height(), FXDIB_Format::k8bppMask))
+    return mask;
+
+  for (int y = m_Box.top; y <= m_LastRow; ++y) {
+    pdfium::span<uint8_t> scan = mask->GetWritableScanline(y - m_Box.top);
+    for (const Run& run : GetRow(y)) {
+      memset(scan.subspan(run.left - m_Box.left).data(), run.coverage,
+             run.right - run.left);
+    }
+  }
+  m_Mask = std::move(mask);
+  return m_Mask;
+}
+
+size_t CFX_ClipRuns::GetRowStart(int y) const {
+  return y <= m_LastRow ? m_RowStarts[y - m_Box.top] : m_Runs.size();
+}
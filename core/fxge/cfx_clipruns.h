@@ -0,0 +1,68 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_CFX_CLIPRUNS_H_
+#define CORE_FXGE_CFX_CLIPRUNS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "third_party/base/span.h"
+
+class CFX_DIBitmap;
+
+// Clip coverage stored as runs of equal coverage per row, which is much
+// smaller than an 8-bit mask for the mostly fully covered or uncovered rows
+// of a clip path. Pixels outside the runs are not covered. Once built, the
+// runs do not change, so clip regions can share them.
+class CFX_ClipRuns final : public Retainable {
+ public:
+  CONSTRUCT_VIA_MAKE_RETAIN;
+
+  struct Run {
+    int left;
+    int right;
+    uint8_t coverage;
+  };
+
+  // Returns the runs covering |box| in both |runs1| and |runs2|, with the
+  // coverage of each pixel multiplied as for 8-bit masks. |box| must be
+  // inside the boxes of both.
+  static RetainPtr<CFX_ClipRuns> Intersect(const CFX_ClipRuns& runs1,
+                                           const CFX_ClipRuns& runs2,
+                                           const FX_RECT& box);
+
+  // Appends a run to row |y|. Rows must be added from top to bottom and the
+  // runs of a row from left to right, inside the box.
+  void AppendRun(int y, int left, int right, uint8_t coverage);
+
+  // Returns the runs cropped to |box|, which must be inside GetBox().
+  RetainPtr<CFX_ClipRuns> Crop(const FX_RECT& box) const;
+
+  const FX_RECT& GetBox() const { return m_Box; }
+  size_t GetRunCount() const { return m_Runs.size(); }
+  pdfium::span<const Run> GetRow(int y) const;
+
+  // Returns the coverage as an 8-bit mask the size of GetBox(). The mask is
+  // built on first use and shared, so callers must not modify it.
+  RetainPtr<CFX_DIBitmap> GetMask() const;
+
+ private:
+  explicit CFX_ClipRuns(const FX_RECT& box);
+  ~CFX_ClipRuns() override;
+
+  size_t GetRowStart(int y) const;
+
+  const FX_RECT m_Box;
+  int m_LastRow;
+  std::vector<Run> m_Runs;
+  std::vector<size_t> m_RowStarts;
+  mutable RetainPtr<CFX_DIBitmap> m_Mask;
+};
+
+#endif  // CORE_FXGE_CFX_CLIPRUNS_H_
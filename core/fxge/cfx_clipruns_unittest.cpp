@@ -0,0 +1,85 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_clipruns.h"
+
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+TEST(CFX_ClipRuns, AppendRun) {
+  auto runs = pdfium::MakeRetain<CFX_ClipRuns>(FX_RECT(10, 20, 30, 25));
+  runs->AppendRun(21, 10, 12, 255);
+  runs->AppendRun(21, 12, 15, 255);
+  runs->AppendRun(21, 15, 16, 128);
+  runs->AppendRun(21, 16, 17, 0);
+  runs->AppendRun(23, 20, 30, 255);
+  EXPECT_EQ(3u, runs->GetRunCount());
+
+  EXPECT_TRUE(runs->GetRow(20).empty());
+  ASSERT_EQ(2u, runs->GetRow(21).size());
+  EXPECT_EQ(10, runs->GetRow(21)[0].left);
+  EXPECT_EQ(15, runs->GetRow(21)[0].right);
+  EXPECT_EQ(255, runs->GetRow(21)[0].coverage);
+  EXPECT_EQ(15, runs->GetRow(21)[1].left);
+  EXPECT_EQ(16, runs->GetRow(21)[1].right);
+  EXPECT_EQ(128, runs->GetRow(21)[1].coverage);
+  EXPECT_TRUE(runs->GetRow(22).empty());
+  ASSERT_EQ(1u, runs->GetRow(23).size());
+  EXPECT_TRUE(runs->GetRow(24).empty());
+  EXPECT_TRUE(runs->GetRow(25).empty());
+
+  RetainPtr<CFX_DIBitmap> mask = runs->GetMask();
+  ASSERT_TRUE(mask);
+  EXPECT_EQ(20, mask->GetWidth());
+  EXPECT_EQ(5, mask->GetHeight());
+  EXPECT_EQ(0, mask->GetScanline(0)[0]);
+  EXPECT_EQ(255, mask->GetScanline(1)[4]);
+  EXPECT_EQ(128, mask->GetScanline(1)[5]);
+  EXPECT_EQ(0, mask->GetScanline(1)[6]);
+  EXPECT_EQ(0, mask->GetScanline(3)[9]);
+  EXPECT_EQ(255, mask->GetScanline(3)[10]);
+  EXPECT_EQ(255, mask->GetScanline(3)[19]);
+  EXPECT_EQ(mask, runs->GetMask());
+}
+
+TEST(CFX_ClipRuns, Intersect) {
+  auto runs1 = pdfium::MakeRetain<CFX_ClipRuns>(FX_RECT(0, 0, 10, 2));
+  runs1->AppendRun(0, 0, 6, 255);
+  runs1->AppendRun(0, 6, 7, 100);
+  runs1->AppendRun(1, 2, 4, 255);
+  auto runs2 = pdfium::MakeRetain<CFX_ClipRuns>(FX_RECT(3, 0, 12, 2));
+  runs2->AppendRun(0, 3, 7, 200);
+  runs2->AppendRun(1, 4, 12, 255);
+
+  RetainPtr<CFX_ClipRuns> result =
+      CFX_ClipRuns::Intersect(*runs1, *runs2, FX_RECT(3, 0, 10, 2));
+  EXPECT_EQ(FX_RECT(3, 0, 10, 2), result->GetBox());
+  ASSERT_EQ(2u, result->GetRow(0).size());
+  EXPECT_EQ(3, result->GetRow(0)[0].left);
+  EXPECT_EQ(6, result->GetRow(0)[0].right);
+  EXPECT_EQ(200, result->GetRow(0)[0].coverage);
+  EXPECT_EQ(6, result->GetRow(0)[1].left);
+  EXPECT_EQ(7, result->GetRow(0)[1].right);
+  EXPECT_EQ(100 * 200 / 255, result->GetRow(0)[1].coverage);
+  EXPECT_TRUE(result->GetRow(1).empty());
+}
+
+TEST(CFX_ClipRuns, Crop) {
+  auto runs = pdfium::MakeRetain<CFX_ClipRuns>(FX_RECT(0, 0, 10, 3));
+  runs->AppendRun(0, 0, 10, 255);
+  runs->AppendRun(1, 0, 2, 255);
+  runs->AppendRun(1, 8, 10, 50);
+  runs->AppendRun(2, 4, 5, 255);
+
+  RetainPtr<CFX_ClipRuns> result = runs->Crop(FX_RECT(1, 1, 9, 3));
+  EXPECT_EQ(FX_RECT(1, 1, 9, 3), result->GetBox());
+  EXPECT_TRUE(result->GetRow(0).empty());
+  ASSERT_EQ(2u, result->GetRow(1).size());
+  EXPECT_EQ(1, result->GetRow(1)[0].left);
+  EXPECT_EQ(2, result->GetRow(1)[0].right);
+  EXPECT_EQ(8, result->GetRow(1)[1].left);
+  EXPECT_EQ(9, result->GetRow(1)[1].right);
+  ASSERT_EQ(1u, result->GetRow(2).size());
+  EXPECT_EQ(4, result->GetRow(2)[0].left);
+}
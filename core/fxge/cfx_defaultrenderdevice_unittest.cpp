@@ -78,3 +78,114 @@ TEST(CFX_DefaultRenderDeviceTest, GetClipBox_Empty) {
 
   EXPECT_TRUE(device.GetClipBox().IsEmpty());
 }
+
+TEST(CFX_DefaultRenderDeviceTest, DrawPath_OpaqueFill) {
+  const CFX_FillRenderOptions fill_options(
+      CFX_FillRenderOptions::FillType::kWinding);
+
+  // A triangle, so the fill goes through the rasterizer rather than the
+  // rectangle fast path.
+  CFX_Path path;
+  path.AppendPoint(CFX_PointF(0, 0), CFX_Path::Point::Type::kMove);
+  path.AppendPoint(CFX_PointF(16, 0), CFX_Path::Point::Type::kLine);
+  path.AppendPointAndClose(CFX_PointF(0, 16), CFX_Path::Point::Type::kLine);
+
+  for (FXDIB_Format format : {FXDIB_Format::kArgb, FXDIB_Format::kRgb32,
+                              FXDIB_Format::kRgb, FXDIB_Format::k8bppMask}) {
+    CFX_DefaultRenderDevice device;
+    ASSERT_TRUE(device.Create(/*width=*/16, /*height=*/16, format,
+                              /*pBackdropBitmap=*/nullptr));
+    RetainPtr<CFX_DIBitmap> bitmap = device.GetBitmap();
+    bitmap->Clear(0);
+    ASSERT_TRUE(device.DrawPath(path, /*pObject2Device=*/nullptr,
+                                /*pGraphState=*/nullptr, 0xff336699,
+                                /*stroke_color=*/0, fill_options));
+
+    const int Bpp = bitmap->GetBPP() / 8;
+    // Fully covered pixels, including a whole run in the top row.
+    for (int x = 0; x < 14; ++x) {
+      pdfium::span<const uint8_t> pixel =
+          bitmap->GetScanline(1).subspan(x * Bpp, Bpp);
+      if (format == FXDIB_Format::k8bppMask) {
+        EXPECT_EQ(0xff, pixel[0]);
+        continue;
+      }
+      EXPECT_EQ(0x99, pixel[0]);
+      EXPECT_EQ(0x66, pixel[1]);
+      EXPECT_EQ(0x33, pixel[2]);
+      if (format == FXDIB_Format::kArgb) {
+        EXPECT_EQ(0xff, pixel[3]);
+      }
+    }
+    // Outside of the triangle.
+    EXPECT_EQ(0, bitmap->GetScanline(15)[15 * Bpp]);
+  }
+}
+
+TEST(CFX_DefaultRenderDeviceTest, DrawPath_AxisAlignedFillCoverage) {
+  CFX_FillRenderOptions fill_options(
+      CFX_FillRenderOptions::FillType::kWinding);
+  // Anti-aliased, so the fill reaches the driver rather than FillRect().
+  fill_options.rect_aa = true;
+
+  CFX_Path path;
+  path.AppendRect(2.5f, 4, 10, 8.25f);
+
+  CFX_DefaultRenderDevice device;
+  ASSERT_TRUE(device.Create(/*width=*/16, /*height=*/16,
+                            FXDIB_Format::k8bppMask,
+                            /*pBackdropBitmap=*/nullptr));
+  RetainPtr<CFX_DIBitmap> bitmap = device.GetBitmap();
+  bitmap->Clear(0);
+  ASSERT_TRUE(device.DrawPath(path, /*pObject2Device=*/nullptr,
+                              /*pGraphState=*/nullptr, 0xff000000,
+                              /*stroke_color=*/0, fill_options));
+
+  for (int row = 4; row < 8; ++row) {
+    pdfium::span<const uint8_t> scanline = bitmap->GetScanline(row);
+    EXPECT_EQ(0, scanline[1]);
+    EXPECT_EQ(128, scanline[2]);
+    for (int col = 3; col < 10; ++col)
+      EXPECT_EQ(255, scanline[col]);
+    EXPECT_EQ(0, scanline[10]);
+  }
+  // The bottom row is a quarter covered.
+  pdfium::span<const uint8_t> scanline = bitmap->GetScanline(8);
+  EXPECT_EQ(32, scanline[2]);
+  for (int col = 3; col < 10; ++col)
+    EXPECT_EQ(64, scanline[col]);
+  EXPECT_EQ(0, scanline[10]);
+  EXPECT_EQ(0, bitmap->GetScanline(3)[5]);
+  EXPECT_EQ(0, bitmap->GetScanline(9)[5]);
+}
+
+TEST(CFX_DefaultRenderDeviceTest, DrawPath_HairlineStroke) {
+  const CFX_FillRenderOptions fill_options;
+
+  // Default line width is 1.
+  const CFX_GraphStateData graphics_state;
+
+  CFX_Path path;
+  path.AppendPoint(CFX_PointF(1, 12.5f), CFX_Path::Point::Type::kMove);
+  path.AppendPoint(CFX_PointF(15, 12.5f), CFX_Path::Point::Type::kLine);
+
+  CFX_DefaultRenderDevice device;
+  ASSERT_TRUE(device.Create(/*width=*/16, /*height=*/16,
+                            FXDIB_Format::k8bppMask,
+                            /*pBackdropBitmap=*/nullptr));
+  RetainPtr<CFX_DIBitmap> bitmap = device.GetBitmap();
+  bitmap->Clear(0);
+  ASSERT_TRUE(device.DrawPath(path, /*pObject2Device=*/nullptr,
+                              &graphics_state, /*fill_color=*/0, 0xff000000,
+                              fill_options));
+
+  pdfium::span<const uint8_t> scanline = bitmap->GetScanline(12);
+  EXPECT_EQ(0, scanline[0]);
+  for (int col = 1; col < 15; ++col)
+    EXPECT_EQ(255, scanline[col]);
+  EXPECT_EQ(0, scanline[15]);
+  for (int col = 0; col < 16; ++col) {
+    EXPECT_EQ(0, bitmap->GetScanline(11)[col]);
+    EXPECT_EQ(0, bitmap->GetScanline(13)[col]);
+  }
+}
@@ -14,9 +14,10 @@
 #include <utility>
 
 #include "build/build_config.h"
-#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fixed_uninit_data_vector.h"
 #include "core/fxcrt/fx_codepage.h"
 #include "core/fxcrt/fx_stream.h"
+#include "core/fxcrt/span_util.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/cfx_fontcache.h"
 #include "core/fxge/cfx_fontmapper.h"
@@ -373,6 +374,7 @@ bool CFX_Font::LoadFile(RetainPtr<IFX_SeekableReadStream> pFile,
 void CFX_Font::SetFace(RetainPtr<CFX_Face> face) {
   ClearGlyphCache();
   m_ObjectTag = 0;
+  m_EmbeddedDigest.clear();
   m_Face = face;
 }
 
@@ -444,16 +446,34 @@ int CFX_Font::GetGlyphWidthImpl(uint32_t glyph_index,
 }
 
 bool CFX_Font::LoadEmbedded(pdfium::span<const uint8_t> src_span,
+                            const ByteString& digest,
                             bool force_vertical,
                             uint64_t object_tag) {
   m_bVertical = force_vertical;
   m_ObjectTag = object_tag;
-  m_FontDataAllocation = DataVector<uint8_t>(src_span.begin(), src_span.end());
-  m_Face = CFX_GEModule::Get()->GetFontMgr()->NewFixedFace(
-      nullptr, m_FontDataAllocation, 0);
+  m_EmbeddedDigest = digest;
   m_bEmbedded = true;
-  m_FontData = m_FontDataAllocation;
-  return !!m_Face;
+
+  CFX_FontMgr* pFontMgr = CFX_GEModule::Get()->GetFontMgr();
+  RetainPtr<CFX_FontMgr::FontDesc> pFontDesc =
+      pFontMgr->GetCachedEmbeddedFontDesc(digest);
+  if (!pFontDesc) {
+    FixedUninitDataVector<uint8_t> font_data(src_span.size());
+    fxcrt::spancpy(font_data.writable_span(), src_span);
+    pFontDesc =
+        pFontMgr->AddCachedEmbeddedFontDesc(digest, std::move(font_data));
+  }
+  // The font program is shared, and CFX_FontCache shares the glyph cache by
+  // |digest|. Each font gets its own face, since the PDF font classes select
+  // a charmap on the face based on their own encoding, and two fonts
+  // embedding the same program need not agree.
+  m_Face = pFontMgr->NewFixedFace(pFontDesc, pFontDesc->FontData(), 0);
+  if (!m_Face)
+    return false;
+
+  m_FontData = {FXFT_Get_Face_Stream_Base(m_Face->GetRec()),
+                FXFT_Get_Face_Stream_Size(m_Face->GetRec())};
+  return true;
 }
 
 bool CFX_Font::IsTTFont() const {
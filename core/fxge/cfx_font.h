@@ -13,7 +13,6 @@
 
 #include "build/build_config.h"
 #include "core/fxcrt/bytestring.h"
-#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_codepage_forward.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/fx_memory_wrappers.h"
@@ -78,7 +77,11 @@ class CFX_Font {
                  FX_CodePage code_page,
                  bool bVertical);
 
+  // |digest| identifies the contents of |src_span|. Fonts loaded with the
+  // same digest share a single copy of the font data and a glyph cache, but
+  // not a face.
   bool LoadEmbedded(pdfium::span<const uint8_t> src_span,
+                    const ByteString& digest,
                     bool force_vertical,
                     uint64_t object_tag);
   RetainPtr<CFX_Face> GetFace() const { return m_Face; }
@@ -133,6 +136,7 @@ class CFX_Font {
   FontType GetFontType() const { return m_FontType; }
   void SetFontType(FontType type) { m_FontType = type; }
   uint64_t GetObjectTag() const { return m_ObjectTag; }
+  const ByteString& GetEmbeddedDigest() const { return m_EmbeddedDigest; }
   pdfium::span<uint8_t> GetFontSpan() const { return m_FontData; }
   void AdjustMMParams(int glyph_index, int dest_width, int weight) const;
   std::unique_ptr<CFX_Path> LoadGlyphPathImpl(uint32_t glyph_index,
@@ -167,10 +171,10 @@ class CFX_Font {
   mutable RetainPtr<CFX_GlyphCache> m_GlyphCache;
   std::unique_ptr<CFX_SubstFont> m_pSubstFont;
   std::unique_ptr<uint8_t, FxFreeDeleter> m_pSubData;
-  DataVector<uint8_t> m_FontDataAllocation;
   pdfium::span<uint8_t> m_FontData;
   FontType m_FontType = FontType::kUnknown;
   uint64_t m_ObjectTag = 0;
+  ByteString m_EmbeddedDigest;
   bool m_bEmbedded = false;
   bool m_bVertical = false;
 #if BUILDFLAG(IS_APPLE)
@@ -17,6 +17,22 @@ CFX_FontCache::~CFX_FontCache() = default;
 
 RetainPtr<CFX_GlyphCache> CFX_FontCache::GetGlyphCache(const CFX_Font* pFont) {
   RetainPtr<CFX_Face> face = pFont->GetFace();
+  const ByteString& digest = pFont->GetEmbeddedDigest();
+  if (face && !digest.IsEmpty() && !pFont->GetSubstFont()) {
+    // Fonts embedding the same program have separate faces, so that each can
+    // select its own charmap. Glyphs are rendered by glyph index, which does
+    // not depend on the charmap, and embedded faces are always opened with
+    // face index 0 at the same pixel size. So any of the faces can render
+    // glyphs for all of them.
+    auto it = m_EmbeddedGlyphCacheMap.find(digest);
+    if (it != m_EmbeddedGlyphCacheMap.end() && it->second)
+      return pdfium::WrapRetain(it->second.Get());
+
+    auto new_cache = pdfium::MakeRetain<CFX_GlyphCache>(face);
+    m_EmbeddedGlyphCacheMap[digest].Reset(new_cache.Get());
+    return new_cache;
+  }
+
   const bool bExternal = !face;
   auto& map = bExternal ? m_ExtGlyphCacheMap : m_GlyphCacheMap;
   auto it = map.find(face.Get());
@@ -9,6 +9,7 @@
 
 #include <map>
 
+#include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/fx_system.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxge/cfx_glyphcache.h"
@@ -29,6 +30,8 @@ class CFX_FontCache {
  private:
   std::map<CFX_Face*, ObservedPtr<CFX_GlyphCache>> m_GlyphCacheMap;
   std::map<CFX_Face*, ObservedPtr<CFX_GlyphCache>> m_ExtGlyphCacheMap;
+  // Keyed by CFX_Font::GetEmbeddedDigest().
+  std::map<ByteString, ObservedPtr<CFX_GlyphCache>> m_EmbeddedGlyphCacheMap;
 };
 
 #endif  // CORE_FXGE_CFX_FONTCACHE_H_
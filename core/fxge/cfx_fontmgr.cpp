@@ -113,6 +113,21 @@ RetainPtr<CFX_FontMgr::FontDesc> CFX_FontMgr::AddCachedTTCFontDesc(
   return pNewDesc;
 }
 
+RetainPtr<CFX_FontMgr::FontDesc> CFX_FontMgr::GetCachedEmbeddedFontDesc(
+    const ByteString& digest) {
+  auto it = m_EmbeddedFaceMap.find(digest);
+  return it != m_EmbeddedFaceMap.end() ? pdfium::WrapRetain(it->second.Get())
+                                       : nullptr;
+}
+
+RetainPtr<CFX_FontMgr::FontDesc> CFX_FontMgr::AddCachedEmbeddedFontDesc(
+    const ByteString& digest,
+    FixedUninitDataVector<uint8_t> data) {
+  auto pNewDesc = pdfium::MakeRetain<FontDesc>(std::move(data));
+  m_EmbeddedFaceMap[digest].Reset(pNewDesc.Get());
+  return pNewDesc;
+}
+
 RetainPtr<CFX_Face> CFX_FontMgr::NewFixedFace(RetainPtr<FontDesc> pDesc,
                                               pdfium::span<const uint8_t> span,
                                               size_t face_index) {
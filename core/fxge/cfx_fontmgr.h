@@ -63,6 +63,14 @@ class CFX_FontMgr {
                                            uint32_t checksum,
                                            FixedUninitDataVector<uint8_t> data);
 
+  // Embedded font programs are keyed by a digest of their contents, so that
+  // identical fonts embedded in different documents share one copy of the
+  // font data.
+  RetainPtr<FontDesc> GetCachedEmbeddedFontDesc(const ByteString& digest);
+  RetainPtr<FontDesc> AddCachedEmbeddedFontDesc(
+      const ByteString& digest,
+      FixedUninitDataVector<uint8_t> data);
+
   RetainPtr<CFX_Face> NewFixedFace(RetainPtr<FontDesc> pDesc,
                                    pdfium::span<const uint8_t> span,
                                    size_t face_index);
@@ -82,6 +90,7 @@ class CFX_FontMgr {
   std::unique_ptr<CFX_FontMapper> m_pBuiltinMapper;
   std::map<std::tuple<ByteString, int, bool>, ObservedPtr<FontDesc>> m_FaceMap;
   std::map<std::tuple<size_t, uint32_t>, ObservedPtr<FontDesc>> m_TTCFaceMap;
+  std::map<ByteString, ObservedPtr<FontDesc>> m_EmbeddedFaceMap;
   const bool m_FTLibrarySupportsHinting;
 };
 
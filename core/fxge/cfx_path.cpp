@@ -295,6 +295,10 @@ void CFX_Path::AppendPointAndClose(const CFX_PointF& point, Point::Type type) {
   m_Points.push_back(Point(point, type, /*close=*/true));
 }
 
+void CFX_Path::AppendPoints(pdfium::span<const Point> points) {
+  m_Points.insert(m_Points.end(), points.begin(), points.end());
+}
+
 void CFX_Path::AppendLine(const CFX_PointF& pt1, const CFX_PointF& pt2) {
   if (m_Points.empty() || fabs(m_Points.back().m_Point.x - pt1.x) > 0.001 ||
       fabs(m_Points.back().m_Point.y - pt1.y) > 0.001) {
@@ -14,6 +14,7 @@
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/base/span.h"
 
 class CFX_Path {
  public:
@@ -64,6 +65,7 @@ class CFX_Path {
   void AppendLine(const CFX_PointF& pt1, const CFX_PointF& pt2);
   void AppendPoint(const CFX_PointF& point, Point::Type type);
   void AppendPointAndClose(const CFX_PointF& point, Point::Type type);
+  void AppendPoints(pdfium::span<const Point> points);
   void ClosePath();
 
  private:
@@ -545,8 +545,11 @@ bool CFX_RenderDevice::CreateCompatibleBitmap(
     const RetainPtr<CFX_DIBitmap>& pDIB,
     int width,
     int height) const {
-  return pDIB->Create(width, height,
-                      GetCreateCompatibleBitmapFormat(m_RenderCaps));
+  return pDIB->Create(width, height, GetCompatibleBitmapFormat());
+}
+
+FXDIB_Format CFX_RenderDevice::GetCompatibleBitmapFormat() const {
+  return GetCreateCompatibleBitmapFormat(m_RenderCaps);
 }
 
 void CFX_RenderDevice::SetBaseClip(const FX_RECT& rect) {
@@ -67,6 +67,8 @@ class CFX_RenderDevice {
   bool CreateCompatibleBitmap(const RetainPtr<CFX_DIBitmap>& pDIB,
                               int width,
                               int height) const;
+  // The format CreateCompatibleBitmap() uses.
+  FXDIB_Format GetCompatibleBitmapFormat() const;
   const FX_RECT& GetClipBox() const { return m_ClipBox; }
   void SetBaseClip(const FX_RECT& rect);
   bool SetClip_PathFill(const CFX_Path& path,
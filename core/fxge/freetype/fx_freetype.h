@@ -11,6 +11,7 @@
 
 #include <memory>
 
+#include FT_ADVANCES_H
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 #include FT_LCD_FILTER_H
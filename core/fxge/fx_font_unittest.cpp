@@ -5,8 +5,12 @@
 #include <string>
 
 #include "core/fxge/cfx_folderfontinfo.h"
+#include "core/fxge/cfx_font.h"
 #include "core/fxge/cfx_fontmapper.h"
+#include "core/fxge/cfx_fontmgr.h"
 #include "core/fxge/cfx_gemodule.h"
+#include "core/fxge/cfx_glyphbitmap.h"
+#include "core/fxge/cfx_textrenderoptions.h"
 #include "core/fxge/fx_font.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/utils/path_service.h"
@@ -54,3 +58,43 @@ TEST(FXFontTest, ReadFontNameFromMicrosoftEntries) {
   ASSERT_EQ(1u, font_mapper.GetFaceSize());
   ASSERT_EQ("Test", font_mapper.GetFaceName(0));
 }
+
+TEST(FXFontTest, LoadEmbeddedSharesFontDataByDigest) {
+  pdfium::span<const uint8_t> font_data = CFX_FontMgr::GetStandardFont(0);
+  const ByteString kDigest1 = "digest1";
+  const ByteString kDigest2 = "digest2";
+
+  CFX_Font font1;
+  ASSERT_TRUE(font1.LoadEmbedded(font_data, kDigest1, false, 1));
+  CFX_Font font2;
+  ASSERT_TRUE(font2.LoadEmbedded(font_data, kDigest1, false, 2));
+  EXPECT_EQ(font1.GetFontSpan().data(), font2.GetFontSpan().data());
+
+  // Faces carry the selected charmap, so they are never shared.
+  ASSERT_NE(font1.GetFace(), font2.GetFace());
+  FXFT_FaceRec* face1 = font1.GetFaceRec();
+  FXFT_FaceRec* face2 = font2.GetFaceRec();
+  ASSERT_GT(face2->num_charmaps, 1);
+  FT_CharMap charmap1 = face1->charmap;
+  ASSERT_EQ(0, FT_Set_Charmap(face2, face2->charmaps[1]));
+  EXPECT_EQ(charmap1, face1->charmap);
+
+  // Glyphs do not depend on the charmap, so the glyph cache is shared.
+  const CFX_Matrix matrix(20, 0, 0, 20, 0, 0);
+  CFX_TextRenderOptions options;
+  const CFX_GlyphBitmap* bitmap1 =
+      font1.LoadGlyphBitmap(36, false, matrix, 0, FT_RENDER_MODE_NORMAL,
+                            &options);
+  ASSERT_TRUE(bitmap1);
+  EXPECT_EQ(bitmap1, font2.LoadGlyphBitmap(36, false, matrix, 0,
+                                           FT_RENDER_MODE_NORMAL, &options));
+
+  CFX_Font font3;
+  ASSERT_TRUE(font3.LoadEmbedded(font_data, kDigest2, false, 3));
+  EXPECT_NE(font1.GetFontSpan().data(), font3.GetFontSpan().data());
+  const CFX_GlyphBitmap* bitmap3 =
+      font3.LoadGlyphBitmap(36, false, matrix, 0, FT_RENDER_MODE_NORMAL,
+                            &options);
+  ASSERT_TRUE(bitmap3);
+  EXPECT_NE(bitmap1, bitmap3);
+}
@@ -12,6 +12,7 @@
 #include "core/fpdfapi/page/cpdf_pageimagecache.h"
 #include "core/fpdfapi/render/cpdf_pagerendercontext.h"
 #include "core/fpdfapi/render/cpdf_progressiverenderer.h"
+#include "core/fpdfapi/render/cpdf_rendercontext.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 #include "core/fpdfdoc/cpdf_annotlist.h"
 #include "core/fxge/cfx_renderdevice.h"
@@ -20,18 +21,11 @@
 
 namespace {
 
-void RenderPageImpl(CPDF_PageRenderContext* pContext,
-                    CPDF_Page* pPage,
-                    const CFX_Matrix& matrix,
-                    const FX_RECT& clipping_rect,
-                    int flags,
-                    const FPDF_COLORSCHEME* color_scheme,
-                    bool need_to_restore,
-                    CPDFSDK_PauseAdapter* pause) {
-  if (!pContext->m_pOptions)
-    pContext->m_pOptions = std::make_unique<CPDF_RenderOptions>();
-
-  auto& options = pContext->m_pOptions->GetOptions();
+void SetRenderOptions(CPDF_RenderOptions* pOptions,
+                      CPDF_Page* pPage,
+                      int flags,
+                      const FPDF_COLORSCHEME* color_scheme) {
+  auto& options = pOptions->GetOptions();
   options.bClearType = !!(flags & FPDF_LCD_TEXT);
   options.bNoNativeText = !!(flags & FPDF_NO_NATIVETEXT);
   options.bLimitedImageCache = !!(flags & FPDF_RENDER_LIMITEDIMAGECACHE);
@@ -39,21 +33,37 @@ void RenderPageImpl(CPDF_PageRenderContext* pContext,
   options.bNoTextSmooth = !!(flags & FPDF_RENDER_NO_SMOOTHTEXT);
   options.bNoImageSmooth = !!(flags & FPDF_RENDER_NO_SMOOTHIMAGE);
   options.bNoPathSmooth = !!(flags & FPDF_RENDER_NO_SMOOTHPATH);
+  options.bCacheForms = !!(flags & FPDF_RENDER_CACHE_FORMS);
+  options.bLowDetail = !!(flags & FPDF_RENDER_LOW_DETAIL);
 
   // Grayscale output
   if (flags & FPDF_GRAYSCALE)
-    pContext->m_pOptions->SetColorMode(CPDF_RenderOptions::kGray);
+    pOptions->SetColorMode(CPDF_RenderOptions::kGray);
 
   if (color_scheme) {
-    pContext->m_pOptions->SetColorMode(CPDF_RenderOptions::kForcedColor);
-    SetColorFromScheme(color_scheme, pContext->m_pOptions.get());
+    pOptions->SetColorMode(CPDF_RenderOptions::kForcedColor);
+    SetColorFromScheme(color_scheme, pOptions);
     options.bConvertFillToStroke = !!(flags & FPDF_CONVERT_FILL_TO_STROKE);
   }
 
   const CPDF_OCContext::UsageType usage =
       (flags & FPDF_PRINTING) ? CPDF_OCContext::kPrint : CPDF_OCContext::kView;
-  pContext->m_pOptions->SetOCContext(
+  pOptions->SetOCContext(
       pdfium::MakeRetain<CPDF_OCContext>(pPage->GetDocument(), usage));
+}
+
+void RenderPageImpl(CPDF_PageRenderContext* pContext,
+                    CPDF_Page* pPage,
+                    const CFX_Matrix& matrix,
+                    const FX_RECT& clipping_rect,
+                    int flags,
+                    const FPDF_COLORSCHEME* color_scheme,
+                    bool need_to_restore,
+                    CPDFSDK_PauseAdapter* pause) {
+  if (!pContext->m_pOptions)
+    pContext->m_pOptions = std::make_unique<CPDF_RenderOptions>();
+
+  SetRenderOptions(pContext->m_pOptions.get(), pPage, flags, color_scheme);
 
   pContext->m_pDevice->SaveState();
   pContext->m_pDevice->SetBaseClip(clipping_rect);
@@ -113,3 +123,26 @@ void CPDFSDK_RenderPageWithContext(CPDF_PageRenderContext* pContext,
   RenderPageImpl(pContext, pPage, pPage->GetDisplayMatrix(rect, rotate), rect,
                  flags, color_scheme, need_to_restore, pause);
 }
+
+void CPDFSDK_RenderDisplayList(CFX_RenderDevice* pDevice,
+                               CPDF_Page* pPage,
+                               const CPDF_DisplayList& list,
+                               int start_x,
+                               int start_y,
+                               int size_x,
+                               int size_y,
+                               int rotate,
+                               int flags) {
+  CPDF_RenderOptions options;
+  SetRenderOptions(&options, pPage, flags, /*color_scheme=*/nullptr);
+
+  const FX_RECT rect(start_x, start_y, start_x + size_x, start_y + size_y);
+  CFX_RenderDevice::StateRestorer restorer(pDevice);
+  pDevice->SetBaseClip(rect);
+  pDevice->SetClip_Rect(rect);
+  CPDF_RenderContext context(pPage->GetDocument(),
+                             pPage->GetMutablePageResources(),
+                             pPage->GetPageImageCache());
+  context.RenderDisplayList(pDevice, list, &options,
+                            pPage->GetDisplayMatrix(rect, rotate));
+}
@@ -10,7 +10,9 @@
 #include "public/fpdfview.h"
 
 class CFX_Matrix;
+class CFX_RenderDevice;
 class CPDFSDK_PauseAdapter;
+class CPDF_DisplayList;
 class CPDF_Page;
 class CPDF_PageRenderContext;
 struct FX_RECT;
@@ -36,4 +38,17 @@ void CPDFSDK_RenderPageWithContext(CPDF_PageRenderContext* pContext,
                                    bool need_to_restore,
                                    CPDFSDK_PauseAdapter* pause);
 
+// Draws |list|, compiled from |pPage|, with the same placement and options
+// CPDFSDK_RenderPageWithContext() would use for |pPage|. Annotations are not
+// drawn.
+void CPDFSDK_RenderDisplayList(CFX_RenderDevice* pDevice,
+                               CPDF_Page* pPage,
+                               const CPDF_DisplayList& list,
+                               int start_x,
+                               int start_y,
+                               int size_x,
+                               int size_y,
+                               int rotate,
+                               int flags);
+
 #endif  // FPDFSDK_CPDFSDK_RENDERPAGE_H_
@@ -17,6 +17,8 @@
 #include "core/fpdfapi/parser/cpdf_number.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/cpdf_stream_acc.h"
+#include "core/fpdfapi/render/cpdf_docrenderdata.h"
+#include "core/fpdfapi/render/cpdf_formrendercache.h"
 #include "core/fxcrt/fx_codepage.h"
 #include "core/fxcrt/fx_system.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
@@ -2926,6 +2928,56 @@ TEST_F(FPDFEditEmbedderTest, ModifyFormObject) {
   UnloadPage(page);
 }
 
+TEST_F(FPDFEditEmbedderTest, ModifyCachedFormObject) {
+  ASSERT_TRUE(OpenDocument("form_object.pdf"));
+  FPDF_PAGE page = LoadPage(0);
+  ASSERT_TRUE(page);
+
+  CPDF_FormRenderCache* form_cache =
+      CPDF_DocRenderData::FromDocument(CPDFDocumentFromFPDFDocument(document()))
+          ->GetFormRenderCache();
+  std::string cached_checksum;
+  {
+    ScopedFPDFBitmap bitmap =
+        RenderLoadedPageWithFlags(page, FPDF_RENDER_CACHE_FORMS);
+    cached_checksum = HashBitmap(bitmap.get());
+  }
+  ASSERT_EQ(1u, form_cache->GetRenderingCount());
+
+  // Recolor an object inside the form. The cached rendering must not be used
+  // any more.
+  FPDF_PAGEOBJECT form = FPDFPage_GetObject(page, 0);
+  ASSERT_EQ(FPDF_PAGEOBJ_FORM, FPDFPageObj_GetType(form));
+  FPDF_PAGEOBJECT text = FPDFFormObj_GetObject(form, 0);
+  ASSERT_TRUE(text);
+  ASSERT_TRUE(FPDFPageObj_SetFillColor(text, 255, 0, 0, 255));
+  std::string recolored_checksum;
+  {
+    ScopedFPDFBitmap bitmap =
+        RenderLoadedPageWithFlags(page, FPDF_RENDER_CACHE_FORMS);
+    recolored_checksum = HashBitmap(bitmap.get());
+  }
+  EXPECT_NE(cached_checksum, recolored_checksum);
+  {
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page);
+    EXPECT_EQ(recolored_checksum, HashBitmap(bitmap.get()));
+  }
+
+  // Moving an object inside the form is picked up as well.
+  FPDFPageObj_Transform(text, 1, 0, 0, 1, 0, -20);
+  {
+    ScopedFPDFBitmap bitmap =
+        RenderLoadedPageWithFlags(page, FPDF_RENDER_CACHE_FORMS);
+    std::string moved_checksum = HashBitmap(bitmap.get());
+    EXPECT_NE(recolored_checksum, moved_checksum);
+    ScopedFPDFBitmap uncached_bitmap = RenderLoadedPage(page);
+    EXPECT_EQ(moved_checksum, HashBitmap(uncached_bitmap.get()));
+  }
+  EXPECT_EQ(1u, form_cache->GetRenderingCount());
+
+  UnloadPage(page);
+}
+
 // Tests adding text from standard font using FPDFText_LoadStandardFont.
 TEST_F(FPDFEditEmbedderTest, AddStandardFontText2) {
   // Start with a blank page
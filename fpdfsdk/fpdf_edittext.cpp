@@ -8,6 +8,7 @@
 #include <utility>
 #include <vector>
 
+#include "core/fdrm/fx_crypt.h"
 #include "core/fpdfapi/font/cpdf_cidfont.h"
 #include "core/fpdfapi/font/cpdf_font.h"
 #include "core/fpdfapi/page/cpdf_docpagedata.h"
@@ -539,8 +540,12 @@ FPDF_EXPORT FPDF_FONT FPDF_CALLCONV FPDFText_LoadFont(FPDF_DOCUMENT document,
   // TODO(npm): Maybe use FT_Get_X11_Font_Format to check format? Otherwise, we
   // are allowing giving any font that can be loaded on freetype and setting it
   // as any font type.
-  if (!pFont->LoadEmbedded(span, /*force_vertical=*/false, /*object_tag=*/0))
+  uint8_t digest[20];
+  CRYPT_SHA1Generate(data, size, digest);
+  if (!pFont->LoadEmbedded(span, ByteString(digest, sizeof(digest)),
+                           /*force_vertical=*/false, /*object_tag=*/0)) {
     return nullptr;
+  }
 
   // Caller takes ownership.
   return FPDFFontFromCPDFFont(
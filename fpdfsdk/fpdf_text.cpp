@@ -8,17 +8,22 @@
 
 #include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "build/build_config.h"
 #include "core/fpdfapi/font/cpdf_font.h"
 #include "core/fpdfapi/page/cpdf_page.h"
 #include "core/fpdfapi/page/cpdf_textobject.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fpdfdoc/cpdf_viewerpreferences.h"
 #include "core/fpdftext/cpdf_linkextract.h"
+#include "core/fpdftext/cpdf_textindex.h"
 #include "core/fpdftext/cpdf_textpage.h"
 #include "core/fpdftext/cpdf_textpagefind.h"
 #include "core/fxcrt/stl_util.h"
+#include "core/fxcrt/unowned_ptr.h"
 #include "fpdfsdk/cpdfsdk_helpers.h"
 #include "third_party/base/check_op.h"
 #include "third_party/base/numerics/safe_conversions.h"
@@ -35,6 +40,32 @@ CPDF_TextPage* GetTextPageForValidIndex(FPDF_TEXTPAGE text_page, int index) {
   return static_cast<size_t>(index) < textpage->size() ? textpage : nullptr;
 }
 
+bool IsValidTextSink(const FPDF_TEXT_SINK* sink) {
+  return sink && (sink->version == 1 || sink->version == 2) && sink->WriteText;
+}
+
+class TextSinkAdapter final : public CPDF_TextPage::TextSink {
+ public:
+  explicit TextSinkAdapter(FPDF_TEXT_SINK* sink) : m_pSink(sink) {}
+
+  bool OnText(WideStringView text,
+              const absl::optional<CFX_FloatRect>& bounds) override {
+    ByteString utf16 = WideString(text).ToUTF16LE();
+    // Do not pass on the NUL terminator.
+    int count = pdfium::base::checked_cast<int>(
+        utf16.GetLength() / kBytesPerCharacter - 1);
+    FS_RECTF rect;
+    if (bounds.has_value())
+      rect = FSRectFFromCFXFloatRect(bounds.value());
+    return !!m_pSink->WriteText(
+        m_pSink, reinterpret_cast<FPDF_WIDESTRING>(utf16.c_str()), count,
+        bounds.has_value() ? &rect : nullptr);
+  }
+
+ private:
+  UnownedPtr<FPDF_TEXT_SINK> const m_pSink;
+};
+
 }  // namespace
 
 FPDF_EXPORT FPDF_TEXTPAGE FPDF_CALLCONV FPDFText_LoadPage(FPDF_PAGE page) {
@@ -56,6 +87,44 @@ FPDF_EXPORT void FPDF_CALLCONV FPDFText_ClosePage(FPDF_TEXTPAGE text_page) {
       CPDFTextPageFromFPDFTextPage(text_page));
 }
 
+FPDF_EXPORT unsigned long FPDF_CALLCONV
+FPDFText_SaveSnapshot(FPDF_TEXTPAGE text_page,
+                      const unsigned char* key,
+                      unsigned long key_len,
+                      void* buffer,
+                      unsigned long buflen) {
+  CPDF_TextPage* textpage = CPDFTextPageFromFPDFTextPage(text_page);
+  if (!textpage || (!key && key_len))
+    return 0;
+
+  DataVector<uint8_t> snapshot =
+      textpage->Serialize(pdfium::make_span(key, key_len));
+  const unsigned long snapshot_len =
+      pdfium::base::checked_cast<unsigned long>(snapshot.size());
+  if (buffer && buflen >= snapshot_len)
+    memcpy(buffer, snapshot.data(), snapshot_len);
+
+  return snapshot_len;
+}
+
+FPDF_EXPORT FPDF_TEXTPAGE FPDF_CALLCONV
+FPDFText_LoadPageFromSnapshot(FPDF_PAGE page,
+                              const void* data,
+                              unsigned long size,
+                              const unsigned char* key,
+                              unsigned long key_len) {
+  CPDF_Page* pPDFPage = CPDFPageFromFPDFPage(page);
+  if (!pPDFPage || !data || (!key && key_len))
+    return nullptr;
+
+  std::unique_ptr<CPDF_TextPage> textpage = CPDF_TextPage::Deserialize(
+      pPDFPage, pdfium::make_span(static_cast<const uint8_t*>(data), size),
+      pdfium::make_span(key, key_len));
+
+  // Caller takes ownership.
+  return FPDFTextPageFromCPDFTextPage(textpage.release());
+}
+
 FPDF_EXPORT int FPDF_CALLCONV FPDFText_CountChars(FPDF_TEXTPAGE text_page) {
   CPDF_TextPage* textpage = CPDFTextPageFromFPDFTextPage(text_page);
   return textpage ? textpage->CountChars() : -1;
@@ -340,6 +409,47 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFText_GetText(FPDF_TEXTPAGE page,
   return pdfium::base::checked_cast<int>(ret_count);
 }
 
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_StreamPageText(FPDF_PAGE page, FPDF_TEXT_SINK* sink) {
+  CPDF_Page* pPDFPage = CPDFPageFromFPDFPage(page);
+  if (!pPDFPage || !IsValidTextSink(sink))
+    return false;
+
+  CPDF_ViewerPreferences viewRef(pPDFPage->GetDocument());
+  TextSinkAdapter adapter(sink);
+  return CPDF_TextPage::StreamPageText(pPDFPage, viewRef.IsDirectionR2L(),
+                                       &adapter);
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_StreamDocumentText(FPDF_DOCUMENT document,
+                            int start_index,
+                            int page_count,
+                            FPDF_TEXT_SINK* sink) {
+  CPDF_Document* pDoc = CPDFDocumentFromFPDFDocument(document);
+  if (!pDoc || !IsValidTextSink(sink) || start_index < 0 || page_count < 0 ||
+      page_count > pDoc->GetPageCount() - start_index) {
+    return false;
+  }
+
+  CPDF_ViewerPreferences viewRef(pDoc);
+  const bool rtl = viewRef.IsDirectionR2L();
+  TextSinkAdapter adapter(sink);
+  for (int i = start_index; i < start_index + page_count; ++i) {
+    RetainPtr<CPDF_Dictionary> pDict = pDoc->GetMutablePageDictionary(i);
+    if (pDict) {
+      // Only the page objects are needed, and they go away with the page.
+      auto pPage = pdfium::MakeRetain<CPDF_Page>(pDoc, std::move(pDict));
+      pPage->ParseContent();
+      if (!CPDF_TextPage::StreamPageText(pPage.Get(), rtl, &adapter))
+        return false;
+    }
+    if (sink->version >= 2 && sink->EndPage && !sink->EndPage(sink, i))
+      return false;
+  }
+  return true;
+}
+
 FPDF_EXPORT int FPDF_CALLCONV FPDFText_CountRects(FPDF_TEXTPAGE text_page,
                                                   int start,
                                                   int count) {
@@ -456,6 +566,80 @@ FPDF_EXPORT void FPDF_CALLCONV FPDFText_FindClose(FPDF_SCHHANDLE handle) {
       CPDFTextPageFindFromFPDFSchHandle(handle));
 }
 
+FPDF_EXPORT FPDF_TEXTINDEX FPDF_CALLCONV FPDFText_CreateIndex() {
+  // Caller takes ownership.
+  return FPDFTextIndexFromCPDFTextIndex(new CPDF_TextIndex());
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_AddPageToIndex(FPDF_TEXTINDEX index,
+                        FPDF_TEXTPAGE text_page,
+                        int page_index) {
+  CPDF_TextIndex* text_index = CPDFTextIndexFromFPDFTextIndex(index);
+  CPDF_TextPage* textpage = CPDFTextPageFromFPDFTextPage(text_page);
+  if (!text_index || !textpage || page_index < 0)
+    return false;
+
+  text_index->AddPage(page_index, textpage);
+  return true;
+}
+
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFText_SearchIndex(FPDF_TEXTINDEX index,
+                     const FPDF_WIDESTRING* terms,
+                     int term_count,
+                     unsigned long flags,
+                     FPDF_TEXT_INDEX_HIT* hits,
+                     int max_hits) {
+  CPDF_TextIndex* text_index = CPDFTextIndexFromFPDFTextIndex(index);
+  if (!text_index || term_count < 0 || (term_count > 0 && !terms) ||
+      max_hits < 0 || (max_hits > 0 && !hits)) {
+    return -1;
+  }
+
+  std::vector<WideString> search_terms;
+  for (int i = 0; i < term_count; ++i)
+    search_terms.push_back(WideStringFromFPDFWideString(terms[i]));
+
+  CPDF_TextIndex::Options options;
+  options.bMatchCase = !!(flags & FPDF_MATCHCASE);
+  options.bMatchWholeWord = !!(flags & FPDF_MATCHWHOLEWORD);
+  options.bConsecutive = !!(flags & FPDF_CONSECUTIVE);
+  std::vector<CPDF_TextIndex::Hit> results =
+      text_index->Search(search_terms, options);
+  size_t count = std::min(results.size(), static_cast<size_t>(max_hits));
+  for (size_t i = 0; i < count; ++i) {
+    hits[i].page_index = results[i].page_index;
+    hits[i].term_index = static_cast<int>(results[i].term_index);
+    hits[i].char_index = results[i].char_index;
+    hits[i].char_count = results[i].char_count;
+  }
+  return pdfium::base::checked_cast<int>(results.size());
+}
+
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFText_GetIndexHitRects(FPDF_TEXTINDEX index,
+                          const FPDF_TEXT_INDEX_HIT* hit,
+                          FS_RECTF* rects,
+                          int max_rects) {
+  CPDF_TextIndex* text_index = CPDFTextIndexFromFPDFTextIndex(index);
+  if (!text_index || !hit || max_rects < 0 || (max_rects > 0 && !rects))
+    return -1;
+
+  std::vector<CFX_FloatRect> boxes = text_index->GetHitRects(
+      {hit->page_index, static_cast<size_t>(std::max(hit->term_index, 0)),
+       hit->char_index, hit->char_count});
+  size_t count = std::min(boxes.size(), static_cast<size_t>(max_rects));
+  for (size_t i = 0; i < count; ++i)
+    rects[i] = FSRectFFromCFXFloatRect(boxes[i]);
+  return pdfium::base::checked_cast<int>(boxes.size());
+}
+
+FPDF_EXPORT void FPDF_CALLCONV FPDFText_CloseIndex(FPDF_TEXTINDEX index) {
+  // Take ownership back from caller and destroy.
+  delete CPDFTextIndexFromFPDFTextIndex(index);
+}
+
 // web link
 FPDF_EXPORT FPDF_PAGELINK FPDF_CALLCONV
 FPDFLink_LoadWebLinks(FPDF_TEXTPAGE text_page) {
@@ -2,11 +2,15 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <utility>
 #include <vector>
 
 #include "build/build_config.h"
+#include "core/fpdfapi/font/cpdf_fontglobals.h"
+#include "core/fxcrt/widestring.h"
 #include "core/fxge/fx_font.h"
 #include "public/cpp/fpdf_scopers.h"
 #include "public/fpdf_doc.h"
@@ -35,6 +39,48 @@ bool check_unsigned_shorts(const char* expected,
   return true;
 }
 
+// Records what FPDFText_StreamPageText() and FPDFText_StreamDocumentText()
+// pass to it, and stops after |max_pieces| pieces.
+class TextSinkRecorder final : public FPDF_TEXT_SINK {
+ public:
+  explicit TextSinkRecorder(size_t max_pieces) : max_pieces_(max_pieces) {
+    version = 2;
+    WriteText = WriteTextTrampoline;
+    EndPage = EndPageTrampoline;
+  }
+  TextSinkRecorder() : TextSinkRecorder(SIZE_MAX) {}
+
+  const std::vector<WideString>& pieces() const { return pieces_; }
+  const std::vector<FS_RECTF>& bounds() const { return bounds_; }
+
+  // The index of each page that ended, and how many pieces came before.
+  const std::vector<std::pair<int, size_t>>& page_ends() const {
+    return page_ends_;
+  }
+
+ private:
+  static int EndPageTrampoline(FPDF_TEXT_SINK* pThis, int page_index) {
+    auto* recorder = static_cast<TextSinkRecorder*>(pThis);
+    recorder->page_ends_.emplace_back(page_index, recorder->pieces_.size());
+    return true;
+  }
+
+  static int WriteTextTrampoline(FPDF_TEXT_SINK* pThis,
+                                 FPDF_WIDESTRING text,
+                                 int count,
+                                 const FS_RECTF* bounds) {
+    auto* recorder = static_cast<TextSinkRecorder*>(pThis);
+    recorder->pieces_.push_back(WideString::FromUTF16LE(text, count));
+    recorder->bounds_.push_back(bounds ? *bounds : FS_RECTF{0, 0, 0, 0});
+    return recorder->pieces_.size() < recorder->max_pieces_;
+  }
+
+  const size_t max_pieces_;
+  std::vector<WideString> pieces_;
+  std::vector<FS_RECTF> bounds_;
+  std::vector<std::pair<int, size_t>> page_ends_;
+};
+
 }  // namespace
 
 class FPDFTextEmbedderTest : public EmbedderTest {};
@@ -292,6 +338,117 @@ TEST_F(FPDFTextEmbedderTest, TextHebrewMirrored) {
   UnloadPage(page);
 }
 
+TEST_F(FPDFTextEmbedderTest, StreamPageText) {
+  ASSERT_TRUE(OpenDocument("hello_world.pdf"));
+  FPDF_PAGE page = LoadPage(0);
+  ASSERT_TRUE(page);
+
+  TextSinkRecorder sink;
+  EXPECT_FALSE(FPDFText_StreamPageText(nullptr, &sink));
+  EXPECT_FALSE(FPDFText_StreamPageText(page, nullptr));
+  TextSinkRecorder bad_version;
+  bad_version.version = 3;
+  EXPECT_FALSE(FPDFText_StreamPageText(page, &bad_version));
+  EXPECT_TRUE(bad_version.pieces().empty());
+
+  // The text comes a line at a time, with the line break ending it.
+  ASSERT_TRUE(FPDFText_StreamPageText(page, &sink));
+  ASSERT_EQ(2u, sink.pieces().size());
+  EXPECT_EQ(L"Hello, world!\r\n", sink.pieces()[0]);
+  EXPECT_EQ(L"Goodbye, world!", sink.pieces()[1]);
+  EXPECT_EQ(WideString::FromASCII(kHelloGoodbyeText),
+            sink.pieces()[0] + sink.pieces()[1]);
+
+  // The first line's bounds cover the box of its fifth character.
+  const FS_RECTF& hello_bounds = sink.bounds()[0];
+  EXPECT_LE(hello_bounds.left, 41.120f);
+  EXPECT_GE(hello_bounds.right, 46.208f);
+  EXPECT_LE(hello_bounds.bottom, 49.892f);
+  EXPECT_GE(hello_bounds.top, 55.652f);
+
+  // The sink can stop the extraction.
+  TextSinkRecorder first_line(1);
+  EXPECT_FALSE(FPDFText_StreamPageText(page, &first_line));
+  ASSERT_EQ(1u, first_line.pieces().size());
+  EXPECT_EQ(L"Hello, world!\r\n", first_line.pieces()[0]);
+
+  UnloadPage(page);
+}
+
+TEST_F(FPDFTextEmbedderTest, StreamDocumentText) {
+  ASSERT_TRUE(OpenDocument("hello_world_2_pages.pdf"));
+
+  TextSinkRecorder sink;
+  EXPECT_FALSE(FPDFText_StreamDocumentText(nullptr, 0, 2, &sink));
+  EXPECT_FALSE(FPDFText_StreamDocumentText(document(), 0, 2, nullptr));
+  EXPECT_FALSE(FPDFText_StreamDocumentText(document(), -1, 2, &sink));
+  EXPECT_FALSE(FPDFText_StreamDocumentText(document(), 0, -1, &sink));
+  EXPECT_FALSE(FPDFText_StreamDocumentText(document(), 0, 3, &sink));
+  EXPECT_FALSE(FPDFText_StreamDocumentText(document(), 2, 1, &sink));
+  EXPECT_TRUE(sink.pieces().empty());
+  EXPECT_TRUE(sink.page_ends().empty());
+
+  // Both pages, in order, each followed by EndPage().
+  ASSERT_TRUE(FPDFText_StreamDocumentText(document(), 0, 2, &sink));
+  ASSERT_EQ(4u, sink.pieces().size());
+  for (size_t i = 0; i < 4; i += 2) {
+    EXPECT_EQ(L"Hello, world!\r\n", sink.pieces()[i]);
+    EXPECT_EQ(L"Goodbye, world!", sink.pieces()[i + 1]);
+  }
+  const std::vector<std::pair<int, size_t>> kBothPageEnds = {{0, 2}, {1, 4}};
+  EXPECT_EQ(kBothPageEnds, sink.page_ends());
+
+  // A range of pages.
+  TextSinkRecorder second_page;
+  ASSERT_TRUE(FPDFText_StreamDocumentText(document(), 1, 1, &second_page));
+  EXPECT_EQ(2u, second_page.pieces().size());
+  const std::vector<std::pair<int, size_t>> kSecondPageEnd = {{1, 2}};
+  EXPECT_EQ(kSecondPageEnd, second_page.page_ends());
+
+  TextSinkRecorder no_pages;
+  EXPECT_TRUE(FPDFText_StreamDocumentText(document(), 2, 0, &no_pages));
+  EXPECT_TRUE(no_pages.pieces().empty());
+  EXPECT_TRUE(no_pages.page_ends().empty());
+
+  // Version 1 sinks get the text without the page ends.
+  TextSinkRecorder version_1;
+  version_1.version = 1;
+  ASSERT_TRUE(FPDFText_StreamDocumentText(document(), 0, 2, &version_1));
+  EXPECT_EQ(4u, version_1.pieces().size());
+  EXPECT_TRUE(version_1.page_ends().empty());
+
+  // Stopping on the first page skips the second one.
+  TextSinkRecorder first_line(1);
+  EXPECT_FALSE(FPDFText_StreamDocumentText(document(), 0, 2, &first_line));
+  EXPECT_EQ(1u, first_line.pieces().size());
+  EXPECT_TRUE(first_line.page_ends().empty());
+}
+
+TEST_F(FPDFTextEmbedderTest, StreamPageTextMirrored) {
+  ASSERT_TRUE(OpenDocument("hebrew_mirrored.pdf"));
+  FPDF_PAGE page = LoadPage(0);
+  ASSERT_TRUE(page);
+
+  WideString text;
+  {
+    ScopedFPDFTextPage textpage(FPDFText_LoadPage(page));
+    ASSERT_TRUE(textpage);
+    const int char_count = FPDFText_CountChars(textpage.get());
+    std::vector<unsigned short> buffer(char_count + 1);
+    int written =
+        FPDFText_GetText(textpage.get(), 0, char_count, buffer.data());
+    ASSERT_GT(written, 0);
+    text = WideString::FromUTF16LE(buffer.data(), written - 1);
+  }
+
+  TextSinkRecorder sink;
+  ASSERT_TRUE(FPDFText_StreamPageText(page, &sink));
+  ASSERT_EQ(2u, sink.pieces().size());
+  EXPECT_EQ(text, sink.pieces()[0] + sink.pieces()[1]);
+
+  UnloadPage(page);
+}
+
 TEST_F(FPDFTextEmbedderTest, TextSearch) {
   ASSERT_TRUE(OpenDocument("hello_world.pdf"));
   FPDF_PAGE page = LoadPage(0);
@@ -492,6 +649,177 @@ TEST_F(FPDFTextEmbedderTest, TextSearchConsecutive) {
   UnloadPage(page);
 }
 
+TEST_F(FPDFTextEmbedderTest, TextSearchIndex) {
+  ASSERT_TRUE(OpenDocument("hello_world_2_pages.pdf"));
+
+  FPDF_TEXTINDEX index = FPDFText_CreateIndex();
+  ASSERT_TRUE(index);
+  EXPECT_FALSE(FPDFText_AddPageToIndex(nullptr, nullptr, 0));
+  EXPECT_FALSE(FPDFText_AddPageToIndex(index, nullptr, 0));
+
+  // Rectangles of the first "world", as the text page gives them.
+  std::vector<FS_RECTF> expected_rects;
+  for (int i = 0; i < 2; ++i) {
+    FPDF_PAGE page = LoadPage(i);
+    ASSERT_TRUE(page);
+    FPDF_TEXTPAGE textpage = FPDFText_LoadPage(page);
+    ASSERT_TRUE(textpage);
+    EXPECT_FALSE(FPDFText_AddPageToIndex(index, textpage, -1));
+    EXPECT_TRUE(FPDFText_AddPageToIndex(index, textpage, i));
+    if (i == 0) {
+      int count = FPDFText_CountRects(textpage, 7, 5);
+      for (int j = 0; j < count; ++j) {
+        double left;
+        double top;
+        double right;
+        double bottom;
+        ASSERT_TRUE(
+            FPDFText_GetRect(textpage, j, &left, &top, &right, &bottom));
+        expected_rects.push_back({static_cast<float>(left),
+                                  static_cast<float>(top),
+                                  static_cast<float>(right),
+                                  static_cast<float>(bottom)});
+      }
+    }
+    FPDFText_ClosePage(textpage);
+    UnloadPage(page);
+  }
+
+  ScopedFPDFWideString world = GetFPDFWideString(L"world");
+  ScopedFPDFWideString goodbye = GetFPDFWideString(L"GOODBYE");
+  ScopedFPDFWideString nope = GetFPDFWideString(L"nope");
+  const FPDF_WIDESTRING terms[] = {world.get(), goodbye.get(), nope.get()};
+
+  EXPECT_EQ(-1, FPDFText_SearchIndex(nullptr, terms, 3, 0, nullptr, 0));
+  EXPECT_EQ(-1, FPDFText_SearchIndex(index, nullptr, 3, 0, nullptr, 0));
+  EXPECT_EQ(-1, FPDFText_SearchIndex(index, terms, 3, 0, nullptr, 1));
+  EXPECT_EQ(0, FPDFText_SearchIndex(index, terms, 0, 0, nullptr, 0));
+
+  // Counting only.
+  EXPECT_EQ(6, FPDFText_SearchIndex(index, terms, 3, 0, nullptr, 0));
+
+  FPDF_TEXT_INDEX_HIT hits[6];
+  ASSERT_EQ(6, FPDFText_SearchIndex(index, terms, 3, 0, hits, 6));
+  for (int i = 0; i < 6; i += 3) {
+    EXPECT_EQ(i / 3, hits[i].page_index);
+    EXPECT_EQ(0, hits[i].term_index);
+    EXPECT_EQ(7, hits[i].char_index);
+    EXPECT_EQ(5, hits[i].char_count);
+    EXPECT_EQ(i / 3, hits[i + 1].page_index);
+    EXPECT_EQ(1, hits[i + 1].term_index);
+    EXPECT_EQ(15, hits[i + 1].char_index);
+    EXPECT_EQ(7, hits[i + 1].char_count);
+    EXPECT_EQ(i / 3, hits[i + 2].page_index);
+    EXPECT_EQ(0, hits[i + 2].term_index);
+    EXPECT_EQ(24, hits[i + 2].char_index);
+    EXPECT_EQ(5, hits[i + 2].char_count);
+  }
+
+  // Case sensitive.
+  ASSERT_EQ(4, FPDFText_SearchIndex(index, terms, 3, FPDF_MATCHCASE, hits, 6));
+  EXPECT_EQ(0, hits[0].term_index);
+  EXPECT_EQ(0, hits[3].term_index);
+
+  // The same rectangles as the text page.
+  ASSERT_EQ(6, FPDFText_SearchIndex(index, terms, 3, 0, hits, 6));
+  EXPECT_EQ(-1, FPDFText_GetIndexHitRects(index, nullptr, nullptr, 0));
+  int rect_count = FPDFText_GetIndexHitRects(index, &hits[0], nullptr, 0);
+  ASSERT_EQ(static_cast<int>(expected_rects.size()), rect_count);
+  ASSERT_GT(rect_count, 0);
+  std::vector<FS_RECTF> rects(rect_count);
+  ASSERT_EQ(rect_count,
+            FPDFText_GetIndexHitRects(index, &hits[0], rects.data(),
+                                      rect_count));
+  for (int i = 0; i < rect_count; ++i) {
+    EXPECT_FLOAT_EQ(expected_rects[i].left, rects[i].left);
+    EXPECT_FLOAT_EQ(expected_rects[i].top, rects[i].top);
+    EXPECT_FLOAT_EQ(expected_rects[i].right, rects[i].right);
+    EXPECT_FLOAT_EQ(expected_rects[i].bottom, rects[i].bottom);
+  }
+
+  FPDFText_CloseIndex(index);
+}
+
+TEST_F(FPDFTextEmbedderTest, TextSnapshot) {
+  ASSERT_TRUE(OpenDocument("hello_world.pdf"));
+  FPDF_PAGE page = LoadPage(0);
+  ASSERT_TRUE(page);
+
+  FPDF_TEXTPAGE textpage = FPDFText_LoadPage(page);
+  ASSERT_TRUE(textpage);
+
+  static constexpr unsigned char kKey[] = {'d', 'o', 'c', '1'};
+  static constexpr unsigned char kOtherKey[] = {'d', 'o', 'c', '2'};
+  EXPECT_EQ(0u, FPDFText_SaveSnapshot(nullptr, kKey, 4, nullptr, 0));
+  EXPECT_EQ(0u, FPDFText_SaveSnapshot(textpage, nullptr, 4, nullptr, 0));
+
+  unsigned long size = FPDFText_SaveSnapshot(textpage, kKey, 4, nullptr, 0);
+  ASSERT_GT(size, 0u);
+  std::vector<uint8_t> snapshot(size);
+  EXPECT_EQ(size, FPDFText_SaveSnapshot(textpage, kKey, 4, snapshot.data(),
+                                        size - 1));
+  EXPECT_EQ(size, FPDFText_SaveSnapshot(textpage, kKey, 4, snapshot.data(),
+                                        size));
+
+  EXPECT_FALSE(
+      FPDFText_LoadPageFromSnapshot(nullptr, snapshot.data(), size, kKey, 4));
+  EXPECT_FALSE(FPDFText_LoadPageFromSnapshot(page, nullptr, size, kKey, 4));
+  EXPECT_FALSE(
+      FPDFText_LoadPageFromSnapshot(page, snapshot.data(), size, kOtherKey, 4));
+  EXPECT_FALSE(
+      FPDFText_LoadPageFromSnapshot(page, snapshot.data(), size, nullptr, 0));
+  EXPECT_FALSE(FPDFText_LoadPageFromSnapshot(page, snapshot.data(), size - 1,
+                                             kKey, 4));
+  std::vector<uint8_t> corrupt = snapshot;
+  corrupt[0] ^= 1;
+  EXPECT_FALSE(
+      FPDFText_LoadPageFromSnapshot(page, corrupt.data(), size, kKey, 4));
+
+  FPDF_TEXTPAGE reloaded =
+      FPDFText_LoadPageFromSnapshot(page, snapshot.data(), size, kKey, 4);
+  ASSERT_TRUE(reloaded);
+
+  // The reloaded page has the same characters, boxes and text.
+  const int char_count = FPDFText_CountChars(textpage);
+  ASSERT_GT(char_count, 0);
+  ASSERT_EQ(char_count, FPDFText_CountChars(reloaded));
+  for (int i = 0; i < char_count; ++i) {
+    EXPECT_EQ(FPDFText_GetUnicode(textpage, i), FPDFText_GetUnicode(reloaded, i));
+    EXPECT_EQ(FPDFText_IsGenerated(textpage, i),
+              FPDFText_IsGenerated(reloaded, i));
+    double expected[4];
+    double actual[4];
+    ASSERT_TRUE(FPDFText_GetCharBox(textpage, i, &expected[0], &expected[1],
+                                    &expected[2], &expected[3]));
+    ASSERT_TRUE(FPDFText_GetCharBox(reloaded, i, &actual[0], &actual[1],
+                                    &actual[2], &actual[3]));
+    for (int j = 0; j < 4; ++j)
+      EXPECT_DOUBLE_EQ(expected[j], actual[j]);
+  }
+
+  std::vector<unsigned short> expected_text(char_count + 1);
+  std::vector<unsigned short> actual_text(char_count + 1);
+  ASSERT_EQ(char_count + 1, FPDFText_GetText(textpage, 0, char_count,
+                                             expected_text.data()));
+  ASSERT_EQ(char_count + 1, FPDFText_GetText(reloaded, 0, char_count,
+                                             actual_text.data()));
+  EXPECT_EQ(expected_text, actual_text);
+
+  // Searching and font queries work on the reloaded page.
+  ScopedFPDFWideString world = GetFPDFWideString(L"world");
+  FPDF_SCHHANDLE search = FPDFText_FindStart(reloaded, world.get(), 0, 0);
+  ASSERT_TRUE(search);
+  EXPECT_TRUE(FPDFText_FindNext(search));
+  EXPECT_EQ(7, FPDFText_GetSchResultIndex(search));
+  FPDFText_FindClose(search);
+  EXPECT_DOUBLE_EQ(FPDFText_GetFontSize(textpage, 0),
+                   FPDFText_GetFontSize(reloaded, 0));
+
+  FPDFText_ClosePage(reloaded);
+  FPDFText_ClosePage(textpage);
+  UnloadPage(page);
+}
+
 // Fails on Windows. https://crbug.com/pdfium/1370
 #if BUILDFLAG(IS_WIN)
 #define MAYBE_TextSearchLatinExtended DISABLED_TextSearchLatinExtended
@@ -1763,3 +2091,25 @@ TEST_F(FPDFTextEmbedderTest, Bug1769) {
 
   UnloadPage(page);
 }
+
+TEST_F(FPDFTextEmbedderTest, EmbeddedCMapReleasedOnCloseDocument) {
+  auto* font_globals = CPDF_FontGlobals::GetInstance();
+  const size_t initial_count =
+      font_globals->GetLiveEmbeddedCMapCountForTesting();
+
+  ASSERT_TRUE(OpenDocument("embedded_cmap.pdf"));
+  FPDF_PAGE page = LoadPage(0);
+  ASSERT_TRUE(page);
+
+  {
+    ScopedFPDFTextPage text_page(FPDFText_LoadPage(page));
+    ASSERT_TRUE(text_page);
+    EXPECT_EQ(5, FPDFText_CountChars(text_page.get()));
+  }
+  EXPECT_EQ(initial_count + 1,
+            font_globals->GetLiveEmbeddedCMapCountForTesting());
+
+  UnloadPage(page);
+  CloseDocument();
+  EXPECT_EQ(initial_count, font_globals->GetLiveEmbeddedCMapCountForTesting());
+}
@@ -24,6 +24,7 @@
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/cpdf_string.h"
 #include "core/fpdfapi/parser/fpdf_parser_decode.h"
+#include "core/fpdfapi/render/cpdf_displaylist.h"
 #include "core/fpdfapi/render/cpdf_docrenderdata.h"
 #include "core/fpdfapi/render/cpdf_pagerendercontext.h"
 #include "core/fpdfapi/render/cpdf_rendercontext.h"
@@ -210,6 +211,46 @@ FPDF_DOCUMENT LoadDocumentImpl(RetainPtr<IFX_SeekableReadStream> pFileAccess,
   return FPDFDocumentFromCPDFDocument(pDocument.release());
 }
 
+void RenderPageBitmapImpl(FPDF_BITMAP bitmap,
+                          FPDF_PAGE page,
+                          int start_x,
+                          int start_y,
+                          int size_x,
+                          int size_y,
+                          int rotate,
+                          int flags,
+                          std::unique_ptr<CPDF_RenderOptions> options) {
+  if (!bitmap)
+    return;
+
+  CPDF_Page* pPage = CPDFPageFromFPDFPage(page);
+  if (!pPage)
+    return;
+
+  auto pOwnedContext = std::make_unique<CPDF_PageRenderContext>();
+  CPDF_PageRenderContext* pContext = pOwnedContext.get();
+  CPDF_Page::RenderContextClearer clearer(pPage);
+  pPage->SetRenderContext(std::move(pOwnedContext));
+  pContext->m_pOptions = std::move(options);
+
+  auto pOwnedDevice = std::make_unique<CFX_DefaultRenderDevice>();
+  CFX_DefaultRenderDevice* pDevice = pOwnedDevice.get();
+  pContext->m_pDevice = std::move(pOwnedDevice);
+
+  RetainPtr<CFX_DIBitmap> pBitmap(CFXDIBitmapFromFPDFBitmap(bitmap));
+  pDevice->AttachWithRgbByteOrder(pBitmap, !!(flags & FPDF_REVERSE_BYTE_ORDER));
+  CPDFSDK_RenderPageWithContext(pContext, pPage, start_x, start_y, size_x,
+                                size_y, rotate, flags, /*color_scheme=*/nullptr,
+                                /*need_to_restore=*/true,
+                                /*pause=*/nullptr);
+
+#if defined(_SKIA_SUPPORT_)
+  if (CFX_DefaultRenderDevice::SkiaIsDefaultRenderer()) {
+    pBitmap->UnPreMultiply();
+  }
+#endif
+}
+
 }  // namespace
 
 FPDF_EXPORT void FPDF_CALLCONV FPDF_InitLibrary() {
@@ -657,34 +698,99 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_RenderPageBitmap(FPDF_BITMAP bitmap,
                                                      int size_y,
                                                      int rotate,
                                                      int flags) {
-  if (!bitmap)
+  RenderPageBitmapImpl(bitmap, page, start_x, start_y, size_x, size_y, rotate,
+                       flags, /*options=*/nullptr);
+}
+
+FPDF_EXPORT void FPDF_CALLCONV
+FPDF_RenderPageBitmapWithLowDetail(FPDF_BITMAP bitmap,
+                                   FPDF_PAGE page,
+                                   int start_x,
+                                   int start_y,
+                                   int size_x,
+                                   int size_y,
+                                   int rotate,
+                                   int flags,
+                                   float threshold) {
+  if (!(threshold > 0))
     return;
 
+  auto options = std::make_unique<CPDF_RenderOptions>();
+  options->GetOptions().fLowDetailThreshold = threshold;
+  RenderPageBitmapImpl(bitmap, page, start_x, start_y, size_x, size_y, rotate,
+                       flags | FPDF_RENDER_LOW_DETAIL, std::move(options));
+}
+
+FPDF_EXPORT unsigned long FPDF_CALLCONV
+FPDF_SavePageDisplayList(FPDF_PAGE page,
+                         const unsigned char* key,
+                         unsigned long key_len,
+                         void* buffer,
+                         unsigned long buflen) {
   CPDF_Page* pPage = CPDFPageFromFPDFPage(page);
-  if (!pPage)
-    return;
+  if (!pPage || (!key && key_len))
+    return 0;
 
-  auto pOwnedContext = std::make_unique<CPDF_PageRenderContext>();
-  CPDF_PageRenderContext* pContext = pOwnedContext.get();
-  CPDF_Page::RenderContextClearer clearer(pPage);
-  pPage->SetRenderContext(std::move(pOwnedContext));
+  std::unique_ptr<CPDF_DisplayList> list = CPDF_DisplayList::Compile(pPage);
+  if (!list)
+    return 0;
 
-  auto pOwnedDevice = std::make_unique<CFX_DefaultRenderDevice>();
-  CFX_DefaultRenderDevice* pDevice = pOwnedDevice.get();
-  pContext->m_pDevice = std::move(pOwnedDevice);
+  DataVector<uint8_t> data = list->Serialize(pdfium::make_span(key, key_len));
+  const unsigned long data_len =
+      pdfium::base::checked_cast<unsigned long>(data.size());
+  if (buffer && buflen >= data_len)
+    memcpy(buffer, data.data(), data_len);
+
+  return data_len;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_RenderPageBitmapFromDisplayList(FPDF_BITMAP bitmap,
+                                     FPDF_DOCUMENT document,
+                                     int page_index,
+                                     const void* data,
+                                     unsigned long size,
+                                     const unsigned char* key,
+                                     unsigned long key_len,
+                                     int start_x,
+                                     int start_y,
+                                     int size_x,
+                                     int size_y,
+                                     int rotate,
+                                     int flags) {
+  CPDF_Document* pDoc = CPDFDocumentFromFPDFDocument(document);
+  if (!bitmap || !pDoc || !data || (!key && key_len))
+    return false;
 
+  if (page_index < 0 || page_index >= FPDF_GetPageCount(document))
+    return false;
+
+  std::unique_ptr<CPDF_DisplayList> list = CPDF_DisplayList::Deserialize(
+      pdfium::make_span(static_cast<const uint8_t*>(data), size),
+      pdfium::make_span(key, key_len));
+  if (!list)
+    return false;
+
+  RetainPtr<CPDF_Dictionary> pDict = pDoc->GetMutablePageDictionary(page_index);
+  if (!pDict || pDict->GetObjNum() != list->GetPageObjNum())
+    return false;
+
+  // The page provides the geometry and resources. Its content is not parsed.
+  auto pPage = pdfium::MakeRetain<CPDF_Page>(pDoc, std::move(pDict));
+  pPage->AddPageImageCache();
+
+  CFX_DefaultRenderDevice device;
   RetainPtr<CFX_DIBitmap> pBitmap(CFXDIBitmapFromFPDFBitmap(bitmap));
-  pDevice->AttachWithRgbByteOrder(pBitmap, !!(flags & FPDF_REVERSE_BYTE_ORDER));
-  CPDFSDK_RenderPageWithContext(pContext, pPage, start_x, start_y, size_x,
-                                size_y, rotate, flags, /*color_scheme=*/nullptr,
-                                /*need_to_restore=*/true,
-                                /*pause=*/nullptr);
+  device.AttachWithRgbByteOrder(pBitmap, !!(flags & FPDF_REVERSE_BYTE_ORDER));
+  CPDFSDK_RenderDisplayList(&device, pPage.Get(), *list, start_x, start_y,
+                            size_x, size_y, rotate, flags);
 
 #if defined(_SKIA_SUPPORT_)
   if (CFX_DefaultRenderDevice::SkiaIsDefaultRenderer()) {
     pBitmap->UnPreMultiply();
   }
 #endif
+  return true;
 }
 
 FPDF_EXPORT void FPDF_CALLCONV
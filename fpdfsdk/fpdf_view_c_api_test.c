@@ -404,9 +404,12 @@ int CheckPDFiumCApi() {
     CHK(FPDFLink_GetTextRange);
     CHK(FPDFLink_GetURL);
     CHK(FPDFLink_LoadWebLinks);
+    CHK(FPDFText_AddPageToIndex);
+    CHK(FPDFText_CloseIndex);
     CHK(FPDFText_ClosePage);
     CHK(FPDFText_CountChars);
     CHK(FPDFText_CountRects);
+    CHK(FPDFText_CreateIndex);
     CHK(FPDFText_FindClose);
     CHK(FPDFText_FindNext);
     CHK(FPDFText_FindPrev);
@@ -420,6 +423,7 @@ int CheckPDFiumCApi() {
     CHK(FPDFText_GetFontInfo);
     CHK(FPDFText_GetFontSize);
     CHK(FPDFText_GetFontWeight);
+    CHK(FPDFText_GetIndexHitRects);
     CHK(FPDFText_GetLooseCharBox);
     CHK(FPDFText_GetMatrix);
     CHK(FPDFText_GetRect);
@@ -432,6 +436,11 @@ int CheckPDFiumCApi() {
     CHK(FPDFText_HasUnicodeMapError);
     CHK(FPDFText_IsGenerated);
     CHK(FPDFText_LoadPage);
+    CHK(FPDFText_LoadPageFromSnapshot);
+    CHK(FPDFText_SaveSnapshot);
+    CHK(FPDFText_SearchIndex);
+    CHK(FPDFText_StreamDocumentText);
+    CHK(FPDFText_StreamPageText);
 
     // fpdf_thumbnail.h
     CHK(FPDFPage_GetDecodedThumbnailData);
@@ -516,10 +525,13 @@ int CheckPDFiumCApi() {
     CHK(FPDF_RenderPage);
 #endif
     CHK(FPDF_RenderPageBitmap);
+    CHK(FPDF_RenderPageBitmapFromDisplayList);
+    CHK(FPDF_RenderPageBitmapWithLowDetail);
     CHK(FPDF_RenderPageBitmapWithMatrix);
 #if defined(_SKIA_SUPPORT_)
     CHK(FPDF_RenderPageSkp);
 #endif
+    CHK(FPDF_SavePageDisplayList);
 #if defined(_WIN32)
     CHK(FPDF_SetPrintMode);
 #endif
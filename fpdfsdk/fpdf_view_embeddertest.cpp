@@ -16,6 +16,7 @@
 #include "fpdfsdk/cpdfsdk_helpers.h"
 #include "fpdfsdk/fpdf_view_c_api_test.h"
 #include "public/cpp/fpdf_scopers.h"
+#include "public/fpdf_edit.h"
 #include "public/fpdfview.h"
 #include "testing/embedder_test.h"
 #include "testing/embedder_test_constants.h"
@@ -2042,3 +2043,181 @@ TEST_F(FPDFViewEmbedderTest, NoSmoothTextItalicOverlappingGlyphs) {
                                 "4ef1f65ab1ac76acb97a3540dcb10b4e");
   UnloadPage(page);
 }
+
+TEST_F(FPDFViewEmbedderTest, RenderLowDetailThinPaths) {
+  ASSERT_TRUE(OpenDocument("low_detail.pdf"));
+  FPDF_PAGE page = LoadPage(0);
+  ASSERT_TRUE(page);
+
+  ScopedFPDFBitmap normal_bitmap = RenderLoadedPageWithFlags(page, 0);
+  ScopedFPDFBitmap low_detail_bitmap =
+      RenderLoadedPageWithFlags(page, FPDF_RENDER_LOW_DETAIL);
+  ASSERT_EQ(200, FPDFBitmap_GetWidth(low_detail_bitmap.get()));
+  ASSERT_EQ(200, FPDFBitmap_GetHeight(low_detail_bitmap.get()));
+
+  // The tiny curve is drawn as its bounding box.
+  EXPECT_NE(HashBitmap(normal_bitmap.get()),
+            HashBitmap(low_detail_bitmap.get()));
+
+  // Returns the BGRx pixel at (x, y).
+  auto get_pixel = [](FPDF_BITMAP bitmap, int x, int y) {
+    const uint8_t* buffer =
+        static_cast<const uint8_t*>(FPDFBitmap_GetBuffer(bitmap));
+    const uint8_t* pixel = buffer + y * FPDFBitmap_GetStride(bitmap) + x * 4;
+    return std::vector<uint8_t>(pixel, pixel + 3);
+  };
+  const std::vector<uint8_t> kWhite = {255, 255, 255};
+  const std::vector<uint8_t> kRed = {0, 0, 255};
+  const std::vector<uint8_t> kBlue = {255, 0, 0};
+
+  // The zero-width red line at y=150.5 keeps its one pixel hairline width.
+  for (int x : {21, 100, 178}) {
+    EXPECT_EQ(kRed, get_pixel(low_detail_bitmap.get(), x, 49));
+    EXPECT_EQ(kRed, get_pixel(normal_bitmap.get(), x, 49));
+  }
+  EXPECT_EQ(kWhite, get_pixel(low_detail_bitmap.get(), 100, 48));
+  EXPECT_EQ(kWhite, get_pixel(low_detail_bitmap.get(), 100, 50));
+
+  // The quarter point high blue bar is still drawn along its whole length, as
+  // a one pixel rule like the full path.
+  for (int x : {21, 100, 178}) {
+    EXPECT_EQ(kBlue, get_pixel(low_detail_bitmap.get(), x, 99));
+    EXPECT_EQ(kBlue, get_pixel(normal_bitmap.get(), x, 99));
+  }
+  EXPECT_EQ(kWhite, get_pixel(low_detail_bitmap.get(), 100, 98));
+  EXPECT_EQ(kWhite, get_pixel(low_detail_bitmap.get(), 100, 100));
+
+  UnloadPage(page);
+}
+
+TEST_F(FPDFViewEmbedderTest, RenderLowDetailThreshold) {
+  ASSERT_TRUE(OpenDocument("hello_world.pdf"));
+  FPDF_PAGE page = LoadPage(0);
+  ASSERT_TRUE(page);
+
+  auto render_with_threshold = [page](float threshold) {
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(200, 200, 0));
+    FPDFBitmap_FillRect(bitmap.get(), 0, 0, 200, 200, 0xFFFFFFFF);
+    FPDF_RenderPageBitmapWithLowDetail(bitmap.get(), page, 0, 0, 200, 200, 0,
+                                       0, threshold);
+    return HashBitmap(bitmap.get());
+  };
+
+  ScopedFPDFBitmap normal_bitmap = RenderLoadedPageWithFlags(page, 0);
+  ScopedFPDFBitmap low_detail_bitmap =
+      RenderLoadedPageWithFlags(page, FPDF_RENDER_LOW_DETAIL);
+
+  // The text is much larger than a pixel, so the default threshold leaves the
+  // page as it was.
+  const std::string normal_checksum = HashBitmap(normal_bitmap.get());
+  EXPECT_EQ(normal_checksum, HashBitmap(low_detail_bitmap.get()));
+  EXPECT_EQ(normal_checksum, render_with_threshold(1.0f));
+
+  // With a larger threshold, the text is greeked.
+  EXPECT_NE(normal_checksum, render_with_threshold(100.0f));
+
+  // Invalid thresholds render nothing.
+  ScopedFPDFBitmap blank_bitmap(FPDFBitmap_Create(200, 200, 0));
+  FPDFBitmap_FillRect(blank_bitmap.get(), 0, 0, 200, 200, 0xFFFFFFFF);
+  const std::string blank_checksum = HashBitmap(blank_bitmap.get());
+  EXPECT_EQ(blank_checksum, render_with_threshold(-1.0f));
+  EXPECT_EQ(blank_checksum, render_with_threshold(0.0f));
+
+  UnloadPage(page);
+}
+
+TEST_F(FPDFViewEmbedderTest, RenderPageFromDisplayList) {
+  static constexpr unsigned char kKey[] = {'d', 'o', 'c', '1'};
+  static constexpr unsigned char kOtherKey[] = {'d', 'o', 'c', '2'};
+
+  for (const char* file_name : {"rectangles.pdf", "hello_world.pdf"}) {
+    SCOPED_TRACE(file_name);
+    ASSERT_TRUE(OpenDocument(file_name));
+    FPDF_PAGE page = LoadPage(0);
+    ASSERT_TRUE(page);
+
+    const int width = static_cast<int>(FPDF_GetPageWidthF(page));
+    const int height = static_cast<int>(FPDF_GetPageHeightF(page));
+    ScopedFPDFBitmap expected_bitmap = RenderLoadedPageWithFlags(page, 0);
+    const std::string expected_checksum = HashBitmap(expected_bitmap.get());
+
+    EXPECT_EQ(0u, FPDF_SavePageDisplayList(nullptr, kKey, 4, nullptr, 0));
+    EXPECT_EQ(0u, FPDF_SavePageDisplayList(page, nullptr, 4, nullptr, 0));
+    const unsigned long size =
+        FPDF_SavePageDisplayList(page, kKey, 4, nullptr, 0);
+    ASSERT_GT(size, 0u);
+    std::vector<uint8_t> list(size);
+    ASSERT_EQ(size, FPDF_SavePageDisplayList(page, kKey, 4, list.data(), size));
+    UnloadPage(page);
+
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(width, height, 0));
+    FPDFBitmap_FillRect(bitmap.get(), 0, 0, width, height, 0xFFFFFFFF);
+    auto render = [&](int page_index, const std::vector<uint8_t>& data,
+                      const unsigned char* key) {
+      return FPDF_RenderPageBitmapFromDisplayList(
+          bitmap.get(), document(), page_index, data.data(), data.size(), key,
+          4, 0, 0, width, height, 0, 0);
+    };
+
+    // Lists that do not match are rejected without drawing anything.
+    EXPECT_FALSE(render(0, list, kOtherKey));
+    EXPECT_FALSE(render(1, list, kKey));
+    EXPECT_FALSE(render(0, std::vector<uint8_t>(list.begin(), list.end() - 1),
+                        kKey));
+    EXPECT_NE(expected_checksum, HashBitmap(bitmap.get()));
+
+    // The page is drawn without being loaded, just as it was from its
+    // objects.
+    EXPECT_TRUE(render(0, list, kKey));
+    EXPECT_EQ(expected_checksum, HashBitmap(bitmap.get()));
+
+    CloseDocument();
+  }
+}
+
+TEST_F(FPDFViewEmbedderTest, RenderPageFromDisplayListOfOtherPage) {
+  // Pages 0 and 2 have the same size and draw the same rectangles in different
+  // colors.
+  ASSERT_TRUE(OpenDocument("rectangles_multi_pages.pdf"));
+  FPDF_PAGE page = LoadPage(0);
+  ASSERT_TRUE(page);
+  const unsigned long size =
+      FPDF_SavePageDisplayList(page, nullptr, 0, nullptr, 0);
+  ASSERT_GT(size, 0u);
+  std::vector<uint8_t> list(size);
+  ASSERT_EQ(size,
+            FPDF_SavePageDisplayList(page, nullptr, 0, list.data(), size));
+  UnloadPage(page);
+
+  const int width = 200;
+  const int height = 250;
+  ScopedFPDFBitmap bitmap(FPDFBitmap_Create(width, height, 0));
+  FPDFBitmap_FillRect(bitmap.get(), 0, 0, width, height, 0xFFFFFFFF);
+  const std::string blank_checksum = HashBitmap(bitmap.get());
+  EXPECT_FALSE(FPDF_RenderPageBitmapFromDisplayList(
+      bitmap.get(), document(), 2, list.data(), size, nullptr, 0, 0, 0, width,
+      height, 0, 0));
+  EXPECT_EQ(blank_checksum, HashBitmap(bitmap.get()));
+
+  EXPECT_TRUE(FPDF_RenderPageBitmapFromDisplayList(
+      bitmap.get(), document(), 0, list.data(), size, nullptr, 0, 0, 0, width,
+      height, 0, 0));
+  EXPECT_NE(blank_checksum, HashBitmap(bitmap.get()));
+}
+
+TEST_F(FPDFViewEmbedderTest, SavePageDisplayListUnsupported) {
+  ASSERT_TRUE(OpenDocument("rectangles.pdf"));
+  FPDF_PAGE page = LoadPage(0);
+  ASSERT_TRUE(page);
+
+  // Blending reads the backdrop, which a display list does not capture.
+  FPDF_PAGEOBJECT obj = FPDFPage_GetObject(page, 0);
+  ASSERT_TRUE(obj);
+  FPDFPageObj_SetBlendMode(obj, "Multiply");
+  EXPECT_EQ(0u, FPDF_SavePageDisplayList(page, nullptr, 0, nullptr, 0));
+
+  FPDFPageObj_SetBlendMode(obj, "Normal");
+  EXPECT_GT(FPDF_SavePageDisplayList(page, nullptr, 0, nullptr, 0), 0u);
+
+  UnloadPage(page);
+}
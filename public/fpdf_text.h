@@ -41,6 +41,64 @@ FPDF_EXPORT FPDF_TEXTPAGE FPDF_CALLCONV FPDFText_LoadPage(FPDF_PAGE page);
 //
 FPDF_EXPORT void FPDF_CALLCONV FPDFText_ClosePage(FPDF_TEXTPAGE text_page);
 
+// Experimental API.
+// Function: FPDFText_SaveSnapshot
+//          Save the character layout of a text page, so it can be reloaded
+//          with FPDFText_LoadPageFromSnapshot() when the page is loaded again.
+// Parameters:
+//          text_page   -   Handle to a text page information structure.
+//                          Returned by FPDFText_LoadPage function.
+//          key         -   Bytes identifying the document, such as a hash of
+//                          its file. May be NULL if |key_len| is 0.
+//          key_len     -   Length of |key| in bytes.
+//          buffer      -   Buffer for the snapshot. May be NULL.
+//          buflen      -   Length of |buffer| in bytes.
+// Return Value:
+//          The length of the snapshot in bytes, or 0 on error. The snapshot is
+//          only copied into |buffer| if |buflen| is at least that length.
+// Comments:
+//          A snapshot takes about 46 bytes per character. It only fits the
+//          same page of the same document, and should be cached under |key|
+//          and the page index.
+//
+FPDF_EXPORT unsigned long FPDF_CALLCONV
+FPDFText_SaveSnapshot(FPDF_TEXTPAGE text_page,
+                      const unsigned char* key,
+                      unsigned long key_len,
+                      void* buffer,
+                      unsigned long buflen);
+
+// Experimental API.
+// Function: FPDFText_LoadPageFromSnapshot
+//          Prepare information about all characters in a page from a snapshot
+//          saved by FPDFText_SaveSnapshot().
+// Parameters:
+//          page        -   Handle to the page. Returned by FPDF_LoadPage
+//                          function.
+//          data        -   The snapshot.
+//          size        -   Length of |data| in bytes.
+//          key         -   Bytes identifying the document, as passed to
+//                          FPDFText_SaveSnapshot(). May be NULL if |key_len|
+//                          is 0.
+//          key_len     -   Length of |key| in bytes.
+// Return value:
+//          A handle to the text page information structure, which behaves as
+//          one returned by FPDFText_LoadPage(). NULL if the snapshot is
+//          corrupt, was saved by another version of PDFium, was saved with a
+//          different key, or does not match the page.
+// Comments:
+//          The page layout is not analyzed again, which makes this several
+//          times faster than FPDFText_LoadPage(). On failure, fall back to
+//          FPDFText_LoadPage(). Application must call FPDFText_ClosePage to
+//          release the text page information.
+//
+FPDF_EXPORT FPDF_TEXTPAGE FPDF_CALLCONV
+FPDFText_LoadPageFromSnapshot(FPDF_PAGE page,
+                              const void* data,
+                              unsigned long size,
+                              const unsigned char* key,
+                              unsigned long key_len);
+
 // Function: FPDFText_CountChars
 //          Get number of characters in a page.
 // Parameters:
@@ -381,6 +439,98 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFText_GetText(FPDF_TEXTPAGE text_page,
                                                int count,
                                                unsigned short* result);
 
+// Experimental API.
+// Structure for receiving the text of pages from FPDFText_StreamPageText() and
+// FPDFText_StreamDocumentText().
+typedef struct FPDF_TEXT_SINK_ {
+  //
+  // Version number of the interface. Must be 1 or 2. With version 2, EndPage()
+  // is also called.
+  //
+  int version;
+
+  // Method: WriteText
+  //          Receive the next piece of the page text.
+  // Interface Version:
+  //          1
+  // Implementation Required:
+  //          Yes
+  // Parameters:
+  //          pThis       -   Pointer to the structure itself.
+  //          text        -   The text, in UTF-16LE. It is not NUL-terminated
+  //                          and is only valid during the call.
+  //          count       -   The number of UTF-16 code units in |text|.
+  //          bounds      -   Box covering the characters in |text|, in PDF
+  //                          "user space", or NULL if all of them were
+  //                          generated by PDFium.
+  // Return value:
+  //          Non-zero to continue, zero to stop extracting text.
+  int (*WriteText)(struct FPDF_TEXT_SINK_* pThis,
+                   FPDF_WIDESTRING text,
+                   int count,
+                   const FS_RECTF* bounds);
+
+  // Method: EndPage
+  //          Called by FPDFText_StreamDocumentText() after all the text of a
+  //          page was passed to WriteText().
+  // Interface Version:
+  //          2
+  // Implementation Required:
+  //          No
+  // Parameters:
+  //          pThis       -   Pointer to the structure itself.
+  //          page_index  -   Zero-based index of the page.
+  // Return value:
+  //          Non-zero to continue, zero to stop extracting text.
+  int (*EndPage)(struct FPDF_TEXT_SINK_* pThis, int page_index);
+} FPDF_TEXT_SINK;
+
+// Experimental API.
+// Function: FPDFText_StreamPageText
+//          Extract the text of a page without loading a text page.
+// Parameters:
+//          page        -   Handle to the page. Returned by FPDF_LoadPage().
+//          sink        -   The structure receiving the text.
+// Return Value:
+//          TRUE if all the text was passed to |sink|. FALSE if |page| or |sink|
+//          is invalid, or if |sink| stopped the extraction.
+// Comments:
+//          The concatenated text is the same as FPDFText_GetText() returns for
+//          all characters of the page, and is passed to |sink| a line at a
+//          time, together with the line break that ends it. Only the current
+//          line is kept in memory, so this is much cheaper than
+//          FPDFText_LoadPage() when only the text is needed.
+//
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_StreamPageText(FPDF_PAGE page, FPDF_TEXT_SINK* sink);
+
+// Experimental API.
+// Function: FPDFText_StreamDocumentText
+//          Extract the text of a range of pages, in page order.
+// Parameters:
+//          document    -   Handle to the document.
+//          start_index -   Zero-based index of the first page.
+//          page_count  -   The number of pages.
+//          sink        -   The structure receiving the text.
+// Return Value:
+//          TRUE if the text of all the pages was passed to |sink|. FALSE if
+//          an argument is invalid, or if |sink| stopped the extraction.
+// Comments:
+//          Each page is passed to |sink| as by FPDFText_StreamPageText(),
+//          followed by a call to EndPage(). Pages are loaded one at a time and
+//          released before the next one, so memory use does not grow with the
+//          number of pages. Fonts stay cached in the document for the pages
+//          that follow.
+//          PDFium is not thread-safe. To extract a large document in
+//          parallel, open it once per worker process and give each worker a
+//          different range of pages.
+//
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_StreamDocumentText(FPDF_DOCUMENT document,
+                            int start_index,
+                            int page_count,
+                            FPDF_TEXT_SINK* sink);
+
 // Function: FPDFText_CountRects
 //          Counts number of rectangular areas occupied by a segment of text,
 //          and caches the result for subsequent FPDFText_GetRect() calls.
@@ -541,6 +691,116 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFText_GetSchCount(FPDF_SCHHANDLE handle);
 //
 FPDF_EXPORT void FPDF_CALLCONV FPDFText_FindClose(FPDF_SCHHANDLE handle);
 
+// Experimental API.
+// A match found by FPDFText_SearchIndex().
+typedef struct FPDF_TEXT_INDEX_HIT_ {
+  // Index of the page the match is on.
+  int page_index;
+  // Index of the matched term in the |terms| passed to FPDFText_SearchIndex().
+  int term_index;
+  // Index of the first matched character, as for FPDFText_GetSchResultIndex().
+  int char_index;
+  // Number of matched characters, as for FPDFText_GetSchCount().
+  int char_count;
+} FPDF_TEXT_INDEX_HIT;
+
+// Experimental API.
+// Function: FPDFText_CreateIndex
+//          Create an empty search index for the pages of a document.
+// Parameters:
+//          None.
+// Return Value:
+//          A handle to the index. FPDFText_CloseIndex must be called to
+//          release it.
+// Comments:
+//          Pages are added with FPDFText_AddPageToIndex(), typically as they
+//          are loaded, and can then be searched together without loading
+//          them again. The index keeps about 36 bytes per character of text.
+//
+FPDF_EXPORT FPDF_TEXTINDEX FPDF_CALLCONV FPDFText_CreateIndex();
+
+// Experimental API.
+// Function: FPDFText_AddPageToIndex
+//          Add the text of a page to a search index.
+// Parameters:
+//          index       -   Handle to an index returned by
+//                          FPDFText_CreateIndex.
+//          text_page   -   Handle to the text page information structure of
+//                          the page. Returned by FPDFText_LoadPage function.
+//          page_index  -   Index of the page in its document.
+// Return Value:
+//          TRUE on success, FALSE on invalid arguments.
+// Comments:
+//          Replaces anything indexed for |page_index| before. |text_page| is
+//          not used after this call returns.
+//
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_AddPageToIndex(FPDF_TEXTINDEX index,
+                        FPDF_TEXTPAGE text_page,
+                        int page_index);
+
+// Experimental API.
+// Function: FPDFText_SearchIndex
+//          Search all the pages of an index for several terms at once.
+// Parameters:
+//          index       -   Handle to an index returned by
+//                          FPDFText_CreateIndex.
+//          terms       -   Array of |term_count| unicode terms. Whitespace
+//                          in a term matches any run of whitespace in the
+//                          text.
+//          term_count  -   Number of terms.
+//          flags       -   Option flags, as for FPDFText_FindStart.
+//          hits        -   Buffer that receives up to |max_hits| matches,
+//                          ordered by page, then by |char_index|. May be
+//                          NULL if |max_hits| is 0.
+//          max_hits    -   Size of |hits|.
+// Return Value:
+//          The total number of matches, which may exceed |max_hits|, or -1 on
+//          invalid arguments.
+//
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFText_SearchIndex(FPDF_TEXTINDEX index,
+                     const FPDF_WIDESTRING* terms,
+                     int term_count,
+                     unsigned long flags,
+                     FPDF_TEXT_INDEX_HIT* hits,
+                     int max_hits);
+
+// Experimental API.
+// Function: FPDFText_GetIndexHitRects
+//          Get the rectangles covering a match, in page coordinates.
+// Parameters:
+//          index       -   Handle to an index returned by
+//                          FPDFText_CreateIndex.
+//          hit         -   A match returned by FPDFText_SearchIndex.
+//          rects       -   Buffer that receives up to |max_rects| rectangles.
+//                          May be NULL if |max_rects| is 0.
+//          max_rects   -   Size of |rects|.
+// Return Value:
+//          The number of rectangles, which may exceed |max_rects|, or -1 on
+//          invalid arguments.
+// Comments:
+//          There is one rectangle per text object the match spans, as with
+//          FPDFText_CountRects() and FPDFText_GetRect(), but the page does not
+//          have to be loaded.
+//
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFText_GetIndexHitRects(FPDF_TEXTINDEX index,
+                          const FPDF_TEXT_INDEX_HIT* hit,
+                          FS_RECTF* rects,
+                          int max_rects);
+
+// Experimental API.
+// Function: FPDFText_CloseIndex
+//          Release a search index.
+// Parameters:
+//          index       -   Handle to an index returned by
+//                          FPDFText_CreateIndex.
+// Return Value:
+//          None.
+//
+FPDF_EXPORT void FPDF_CALLCONV FPDFText_CloseIndex(FPDF_TEXTINDEX index);
+
 // Function: FPDFLink_LoadWebLinks
 //          Prepare information about weblinks in a page.
 // Parameters:
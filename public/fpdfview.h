@@ -77,6 +77,7 @@ typedef const struct fpdf_signature_t__* FPDF_SIGNATURE;
 typedef struct fpdf_structelement_t__* FPDF_STRUCTELEMENT;
 typedef const struct fpdf_structelement_attr_t__* FPDF_STRUCTELEMENT_ATTR;
 typedef struct fpdf_structtree_t__* FPDF_STRUCTTREE;
+typedef struct fpdf_textindex_t__* FPDF_TEXTINDEX;
 typedef struct fpdf_textpage_t__* FPDF_TEXTPAGE;
 typedef struct fpdf_widget_t__* FPDF_WIDGET;
 typedef struct fpdf_xobject_t__* FPDF_XOBJECT;
@@ -808,6 +809,15 @@ FPDF_EXPORT int FPDF_CALLCONV FPDF_GetPageSizeByIndex(FPDF_DOCUMENT document,
 // FPDF_COLORSCHEME is passed in, since with a single fill color for paths the
 // boundaries of adjacent fill paths are less visible.
 #define FPDF_CONVERT_FILL_TO_STROKE 0x20
+// Experimental. Set to reuse rasterized form XObjects that are drawn the same
+// way more than once, e.g. on every page of a document. The output may differ
+// from uncached rendering by rounding.
+#define FPDF_RENDER_CACHE_FORMS 0x8000
+// Experimental. Set to draw text with glyphs smaller than a device pixel as
+// bars of the text color, and paths less than a pixel wide or high as filled
+// rects, e.g. for thumbnails. The output is an approximation of the page. See
+// FPDF_RenderPageBitmapWithLowDetail() to change the size threshold.
+#define FPDF_RENDER_LOW_DETAIL 0x10000
 
 // Struct for color scheme.
 // Each should be a 32-bit value specifying the color, in 8888 ARGB format.
@@ -885,6 +895,43 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_RenderPageBitmap(FPDF_BITMAP bitmap,
                                                      int rotate,
                                                      int flags);
 
+// Experimental API.
+// Function: FPDF_RenderPageBitmapWithLowDetail
+//          Render contents of a page to a device independent bitmap with the
+//          FPDF_RENDER_LOW_DETAIL approximation, using a caller-chosen size
+//          threshold.
+// Parameters:
+//          bitmap      -   Handle to the device independent bitmap, as for
+//                          FPDF_RenderPageBitmap().
+//          page        -   Handle to the page. Returned by FPDF_LoadPage.
+//          start_x     -   Left pixel position of the display area in
+//                          bitmap coordinates.
+//          start_y     -   Top pixel position of the display area in bitmap
+//                          coordinates.
+//          size_x      -   Horizontal size (in pixels) for displaying the page.
+//          size_y      -   Vertical size (in pixels) for displaying the page.
+//          rotate      -   Page orientation, as for FPDF_RenderPageBitmap().
+//          flags       -   0 for normal display, or combination of the Page
+//                          Rendering flags defined above. FPDF_RENDER_LOW_DETAIL
+//                          is implied.
+//          threshold   -   Size in device pixels. Text with glyphs smaller
+//                          than this is drawn as bars, and paths narrower or
+//                          shorter than this are drawn as filled rects.
+//                          Must be positive. FPDF_RENDER_LOW_DETAIL alone
+//                          uses 1.
+// Return value:
+//          None.
+FPDF_EXPORT void FPDF_CALLCONV
+FPDF_RenderPageBitmapWithLowDetail(FPDF_BITMAP bitmap,
+                                   FPDF_PAGE page,
+                                   int start_x,
+                                   int start_y,
+                                   int size_x,
+                                   int size_y,
+                                   int rotate,
+                                   int flags,
+                                   float threshold);
+
 // Function: FPDF_RenderPageBitmapWithMatrix
 //          Render contents of a page to a device independent bitmap.
 // Parameters:
@@ -910,6 +957,84 @@ FPDF_RenderPageBitmapWithMatrix(FPDF_BITMAP bitmap,
                                 const FS_RECTF* clipping,
                                 int flags);
 
+// Experimental API.
+// Function: FPDF_SavePageDisplayList
+//          Save what a page draws as a display list, so later renderings of
+//          the page can skip parsing its content with
+//          FPDF_RenderPageBitmapFromDisplayList().
+// Parameters:
+//          page        -   Handle to the page. Returned by FPDF_LoadPage.
+//          key         -   Bytes identifying the document, such as a hash of
+//                          its file. May be NULL if |key_len| is 0.
+//          key_len     -   Length of |key| in bytes.
+//          buffer      -   Buffer for the display list. May be NULL.
+//          buflen      -   Length of |buffer| in bytes.
+// Return value:
+//          The length of the display list in bytes, or 0 on error or if the
+//          page draws something a display list cannot hold. The display list
+//          is only copied into |buffer| if |buflen| is at least that length.
+// Comments:
+//          Pages with transparency groups, soft masks, blend modes, patterns,
+//          shadings, optional content, Type 3 fonts, inline images, text
+//          clipping or stroked text cannot be saved. Fonts and images are
+//          loaded from the document again when the list is rendered, so it
+//          only fits the same page of the same document, and should be cached
+//          under |key| and the page index.
+FPDF_EXPORT unsigned long FPDF_CALLCONV
+FPDF_SavePageDisplayList(FPDF_PAGE page,
+                         const unsigned char* key,
+                         unsigned long key_len,
+                         void* buffer,
+                         unsigned long buflen);
+
+// Experimental API.
+// Function: FPDF_RenderPageBitmapFromDisplayList
+//          Render a page to a device independent bitmap from a display list
+//          saved by FPDF_SavePageDisplayList(), without loading the page.
+// Parameters:
+//          bitmap      -   Handle to the device independent bitmap, as for
+//                          FPDF_RenderPageBitmap().
+//          document    -   Handle to the document the list was saved from.
+//          page_index  -   Index number of the page the list was saved from.
+//                          0 for the first page.
+//          data        -   The display list.
+//          size        -   Length of |data| in bytes.
+//          key         -   Bytes identifying the document, as passed to
+//                          FPDF_SavePageDisplayList(). May be NULL if
+//                          |key_len| is 0.
+//          key_len     -   Length of |key| in bytes.
+//          start_x     -   Left pixel position of the display area in
+//                          bitmap coordinates.
+//          start_y     -   Top pixel position of the display area in bitmap
+//                          coordinates.
+//          size_x      -   Horizontal size (in pixels) for displaying the page.
+//          size_y      -   Vertical size (in pixels) for displaying the page.
+//          rotate      -   Page orientation, as for FPDF_RenderPageBitmap().
+//          flags       -   0 for normal display, or combination of the Page
+//                          Rendering flags defined above. FPDF_ANNOT is
+//                          ignored.
+// Return value:
+//          True if the page was rendered. False if the display list is
+//          corrupt, was saved from another page, by another version of PDFium
+//          or with a different key, in which case nothing is drawn.
+// Comments:
+//          On failure, fall back to FPDF_LoadPage() and
+//          FPDF_RenderPageBitmap().
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_RenderPageBitmapFromDisplayList(FPDF_BITMAP bitmap,
+                                     FPDF_DOCUMENT document,
+                                     int page_index,
+                                     const void* data,
+                                     unsigned long size,
+                                     const unsigned char* key,
+                                     unsigned long key_len,
+                                     int start_x,
+                                     int start_y,
+                                     int size_x,
+                                     int size_y,
+                                     int rotate,
+                                     int flags);
+
 #if defined(_SKIA_SUPPORT_)
 // Experimental API.
 // Function: FPDF_RenderPageSkp
@@ -135,6 +135,8 @@ struct Options {
   bool no_smoothimage = false;
   bool no_smoothpath = false;
   bool reverse_byte_order = false;
+  bool cache_forms = false;
+  bool low_detail = false;
   bool save_attachments = false;
   bool save_images = false;
   bool save_rendered_images = false;
@@ -193,6 +195,10 @@ int PageRenderFlagsFromOptions(const Options& options) {
     flags |= FPDF_RENDER_NO_SMOOTHPATH;
   if (options.reverse_byte_order)
     flags |= FPDF_REVERSE_BYTE_ORDER;
+  if (options.cache_forms)
+    flags |= FPDF_RENDER_CACHE_FORMS;
+  if (options.low_detail)
+    flags |= FPDF_RENDER_LOW_DETAIL;
   return flags;
 }
 
@@ -464,6 +470,10 @@ bool ParseCommandLine(const std::vector<std::string>& args,
       options->no_smoothpath = true;
     } else if (cur_arg == "--reverse-byte-order") {
       options->reverse_byte_order = true;
+    } else if (cur_arg == "--cache-forms") {
+      options->cache_forms = true;
+    } else if (cur_arg == "--low-detail") {
+      options->low_detail = true;
     } else if (cur_arg == "--save-attachments") {
       options->save_attachments = true;
     } else if (cur_arg == "--save-images") {
@@ -1373,6 +1383,8 @@ constexpr char kUsageString[] =
     "  --no-smoothpath        - render disabling path anti-aliasing\n"
     "  --reverse-byte-order   - render to BGRA, if supported by the output "
     "format\n"
+    "  --cache-forms          - render reusing rasterized form XObjects\n"
+    "  --low-detail           - render sub-pixel text and paths approximately\n"
     "  --save-attachments     - write embedded attachments "
     "<pdf-name>.attachment.<attachment-name>\n"
     "  --save-images          - write raw embedded images "
@@ -0,0 +1,188 @@
+// Copyright 2024 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Checks the content stream tokenizer and FX_Number against straightforward
+// reference versions of them, which follow the character-at-a-time code they
+// replaced. Any difference is a compatibility break.
+
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "core/fpdfapi/page/cpdf_streamparser.h"
+#include "core/fpdfapi/parser/fpdf_parser_utility.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/fx_extension.h"
+#include "core/fxcrt/fx_number.h"
+#include "core/fxcrt/fx_safe_types.h"
+#include "core/fxcrt/fx_string.h"
+#include "third_party/base/check.h"
+#include "third_party/base/check_op.h"
+#include "third_party/base/span.h"
+
+namespace {
+
+constexpr size_t kMaxWordLength = 255;
+
+struct ReferenceNumber {
+  bool is_integer = true;
+  bool is_signed = false;
+  int32_t signed_value = 0;
+  uint32_t unsigned_value = 0;
+  float float_value = 0.0f;
+};
+
+bool ReferenceIsDecimalDigit(char c) {
+  return !((c & 0x80) || !isdigit(c));
+}
+
+// FX_Number(ByteStringView), looking for a '.' before parsing the integer.
+ReferenceNumber ParseReferenceNumber(ByteStringView str) {
+  ReferenceNumber number;
+  if (str.IsEmpty())
+    return number;
+
+  if (str.Contains('.')) {
+    number.is_integer = false;
+    number.is_signed = true;
+    number.float_value = StringToFloat(str);
+    return number;
+  }
+
+  FX_SAFE_UINT32 unsigned_val = 0;
+  bool negative = false;
+  size_t cc = 0;
+  if (str[0] == '+') {
+    cc++;
+    number.is_signed = true;
+  } else if (str[0] == '-') {
+    negative = true;
+    number.is_signed = true;
+    cc++;
+  }
+  for (; cc < str.GetLength() && ReferenceIsDecimalDigit(str[cc]); ++cc)
+    unsigned_val = unsigned_val * 10 + (str[cc] - '0');
+
+  uint32_t value = unsigned_val.ValueOrDefault(0);
+  if (!number.is_signed) {
+    number.unsigned_value = value;
+    return number;
+  }
+
+  constexpr uint32_t kLimit =
+      static_cast<uint32_t>(std::numeric_limits<int32_t>::max());
+  if (value > (negative ? kLimit + 1 : kLimit))
+    value = 0;
+
+  // Negate in unsigned arithmetic so "-2147483648" does not overflow.
+  number.signed_value = static_cast<int32_t>(negative ? 0u - value : value);
+  return number;
+}
+
+void CheckNumber(ByteStringView str) {
+  const FX_Number number(str);
+  const ReferenceNumber reference = ParseReferenceNumber(str);
+  CHECK_EQ(reference.is_integer, number.IsInteger());
+  CHECK_EQ(reference.is_signed, number.IsSigned());
+  if (!reference.is_integer) {
+    // Compare the bits, so NaNs match.
+    const float value = number.GetFloat();
+    CHECK_EQ(0, memcmp(&reference.float_value, &value, sizeof(value)));
+  } else if (reference.is_signed) {
+    CHECK_EQ(reference.signed_value, number.GetSigned());
+  } else {
+    CHECK_EQ(static_cast<int32_t>(reference.unsigned_value),
+             number.GetSigned());
+  }
+}
+
+struct ReferenceElement {
+  CPDF_StreamParser::ElementType type = CPDF_StreamParser::kEndOfData;
+  // Set for elements starting with a delimiter other than '/', which are
+  // parsed as objects. Their words and end positions are not compared.
+  bool is_object = false;
+  ByteStringView word;
+  size_t end = 0;
+};
+
+// CPDF_StreamParser::ParseNextElement() starting at |pos|.
+ReferenceElement ReadReferenceElement(pdfium::span<const uint8_t> data,
+                                      size_t pos) {
+  ReferenceElement element;
+  while (true) {
+    while (pos < data.size() && PDFCharIsWhitespace(data[pos]))
+      ++pos;
+    if (pos >= data.size() || data[pos] != '%')
+      break;
+    while (pos < data.size() && !PDFCharIsLineEnding(data[pos]))
+      ++pos;
+  }
+  if (pos >= data.size()) {
+    element.end = data.size();
+    return element;
+  }
+
+  if (PDFCharIsDelimiter(data[pos]) && data[pos] != '/') {
+    element.type = CPDF_StreamParser::kOther;
+    element.is_object = true;
+    return element;
+  }
+
+  const size_t start = pos;
+  bool is_number = PDFCharIsNumeric(data[pos]);
+  for (++pos; pos < data.size(); ++pos) {
+    if (PDFCharIsDelimiter(data[pos]) || PDFCharIsWhitespace(data[pos]))
+      break;
+    if (!PDFCharIsNumeric(data[pos]))
+      is_number = false;
+  }
+  element.end = pos;
+  element.word = ByteStringView(
+      data.subspan(start, std::min(pos - start, kMaxWordLength)));
+  const bool is_constant = element.word == "true" ||
+                           element.word == "null" || element.word == "false";
+  if (is_number)
+    element.type = CPDF_StreamParser::kNumber;
+  else if (element.word[0] == '/')
+    element.type = CPDF_StreamParser::kName;
+  else if (is_constant)
+    element.type = CPDF_StreamParser::kOther;
+  else
+    element.type = CPDF_StreamParser::kKeyword;
+  return element;
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (size > std::numeric_limits<uint32_t>::max())
+    return 0;
+
+  pdfium::span<const uint8_t> span(data, size);
+  for (uint8_t ch : span) {
+    CHECK_EQ(ReferenceIsDecimalDigit(static_cast<char>(ch)),
+             FXSYS_IsDecimalDigit(static_cast<char>(ch)));
+  }
+  CheckNumber(ByteStringView(span));
+
+  CPDF_StreamParser parser(span);
+  while (true) {
+    const ReferenceElement reference =
+        ReadReferenceElement(span, parser.GetPos());
+    const CPDF_StreamParser::ElementType type = parser.ParseNextElement();
+    CHECK_EQ(reference.type, type);
+    if (type == CPDF_StreamParser::kEndOfData)
+      break;
+    if (reference.is_object)
+      continue;
+
+    CHECK(reference.word == parser.GetWord());
+    CHECK_EQ(reference.end, parser.GetPos());
+    CheckNumber(parser.GetWord());
+  }
+  return 0;
+}
@@ -228,6 +228,11 @@ class TestRunner:
         action='store_true',
         help='Run image-based tests using --reverse-byte-order.')
 
+    parser.add_argument(
+        '--cache-forms',
+        action='store_true',
+        help='Run image-based tests using --cache-forms.')
+
     parser.add_argument(
         '--ignore_errors',
         action='store_true',
@@ -714,6 +719,9 @@ class _TestCaseRunner:
     if self.options.reverse_byte_order:
       cmd_to_run.append('--reverse-byte-order')
 
+    if self.options.cache_forms:
+      cmd_to_run.append('--cache-forms')
+
     cmd_to_run.append(self.pdf_path)
 
     with BytesIO() as command_output: